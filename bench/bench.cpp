@@ -0,0 +1,458 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "common.h"
+#include "benchmarks.h"
+#include "device.h"
+#include "worksize.h"
+
+#include <CL/cl.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * \brief Timing statistics of one kernel at one size.
+ */
+struct BenchmarkResult
+{
+    string name; /**< \brief Name of the kernel. */
+    int size; /**< \brief Problem size. */
+    bool skipped; /**< \brief True if the device cannot run the kernel. */
+    int repetitions; /**< \brief Number of timed runs. */
+    double median; /**< \brief Median kernel time in milliseconds. */
+    double percentile95; /**< \brief 95th percentile kernel time in milliseconds. */
+    double mean; /**< \brief Mean kernel time in milliseconds. */
+    double variance; /**< \brief Variance of the kernel time in milliseconds squared. */
+    double gigabytesPerSecond; /**< \brief Bytes read and written per second at the median time, in GB/s. */
+    double gigaflopsPerSecond; /**< \brief Floating point operations per second at the median time, in GFLOP/s. */
+    double megapixelsPerSecond; /**< \brief Output pixels per second at the median time, in Mpix/s. */
+};
+
+/**
+ * \brief Calculate the statistics of a set of kernel times.
+ * \details The 95th percentile uses the nearest rank method, so it is always one of the measured times.
+ * \param[in] times Kernel times in milliseconds. Sorted by the function.
+ * \param[in] run The run the times were measured for, for the throughput.
+ * \param[out] result Where to store the statistics.
+ */
+void calculateStatistics(vector<double>& times, const BenchmarkRun& run, BenchmarkResult* result)
+{
+    sort(times.begin(), times.end());
+    const size_t count = times.size();
+
+    result->repetitions = count;
+    result->median = (count % 2 == 1) ? times[count / 2] : (times[count / 2 - 1] + times[count / 2]) / 2.0;
+    const size_t rank = (95 * count + 99) / 100;
+    result->percentile95 = times[rank > 0 ? rank - 1 : 0];
+
+    double sum = 0.0;
+    for (size_t index = 0; index < count; index++)
+    {
+        sum += times[index];
+    }
+    result->mean = sum / count;
+
+    double squaredDeviations = 0.0;
+    for (size_t index = 0; index < count; index++)
+    {
+        squaredDeviations += (times[index] - result->mean) * (times[index] - result->mean);
+    }
+    result->variance = count > 1 ? squaredDeviations / (count - 1) : 0.0;
+
+    /* Throughput is reported at the median time, which is not affected by the occasional slow run. */
+    const double seconds = result->median / 1000.0;
+    result->gigabytesPerSecond = seconds > 0.0 ? run.bytes / seconds / 1e9 : 0.0;
+    result->gigaflopsPerSecond = seconds > 0.0 ? run.flops / seconds / 1e9 : 0.0;
+    result->megapixelsPerSecond = seconds > 0.0 ? run.pixels / seconds / 1e6 : 0.0;
+}
+
+/**
+ * \brief Run a kernel repeatedly and measure the execution time of every run.
+ * \details The warmup runs are not timed; they let the driver finish any lazy compilation and allocation.
+ *          All the timed runs are enqueued before waiting, so the host does not add gaps between them,
+ *          and the time of each run is taken from the start and end of its profiling information.
+ * \param[in] commandQueue The command queue to use. Must have profiling enabled.
+ * \param[in] run The kernel to run.
+ * \param[in] warmup Number of untimed runs.
+ * \param[in] repetitions Number of timed runs.
+ * \param[out] times Kernel time of each timed run in milliseconds.
+ * \return False if an error occurred, otherwise true.
+ */
+bool timeBenchmarkRun(cl_command_queue commandQueue, const BenchmarkRun& run, int warmup, int repetitions, vector<double>* times)
+{
+    const size_t* localWorksize = run.localWorksize[0] != 0 ? run.localWorksize : NULL;
+    for (int index = 0; index < warmup; index++)
+    {
+        if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, run.kernel, run.workDimensions, NULL, run.globalWorksize, localWorksize, 0, NULL, NULL)))
+        {
+            cerr << "Failed enqueuing the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+    }
+    if (!checkSuccess(clFinish(commandQueue)))
+    {
+        cerr << "Failed waiting for kernel execution to finish. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    vector<cl_event> events(repetitions, (cl_event)0);
+    bool enqueueSuccess = true;
+    for (int index = 0; enqueueSuccess && index < repetitions; index++)
+    {
+        enqueueSuccess &= checkSuccess(clEnqueueNDRangeKernel(commandQueue, run.kernel, run.workDimensions, NULL, run.globalWorksize, localWorksize, 0, NULL, &events[index]));
+    }
+    enqueueSuccess &= checkSuccess(clFinish(commandQueue));
+
+    times->clear();
+    for (int index = 0; index < repetitions; index++)
+    {
+        if (events[index] == 0)
+        {
+            continue;
+        }
+        cl_ulong start = 0;
+        cl_ulong end = 0;
+        enqueueSuccess &= checkSuccess(clGetEventProfilingInfo(events[index], CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL));
+        enqueueSuccess &= checkSuccess(clGetEventProfilingInfo(events[index], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL));
+        enqueueSuccess &= checkSuccess(clReleaseEvent(events[index]));
+        times->push_back((double)(end - start) / 1000000.0);
+    }
+
+    if (!enqueueSuccess)
+    {
+        cerr << "Failed timing the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Escape a string for use in JSON.
+ * \param[in] text The string.
+ * \return The string in double quotes, with quotes, backslashes and control characters escaped.
+ */
+string jsonString(const string& text)
+{
+    ostringstream escaped;
+    escaped << '"';
+    for (size_t index = 0; index < text.size(); index++)
+    {
+        const char character = text[index];
+        if (character == '"' || character == '\\')
+        {
+            escaped << '\\' << character;
+        }
+        else if ((unsigned char)character < 0x20)
+        {
+            escaped << ' ';
+        }
+        else
+        {
+            escaped << character;
+        }
+    }
+    escaped << '"';
+    return escaped.str();
+}
+
+/**
+ * \brief Write the results as JSON.
+ * \details One object with the device, the settings and an array of results, so two builds can be compared with a JSON diff.
+ * \param[in] filename File to write.
+ * \param[in] deviceName Name of the OpenCL device.
+ * \param[in] driverVersion Version of the OpenCL driver.
+ * \param[in] warmup Number of untimed runs per size.
+ * \param[in] localMode How the local work sizes were chosen: driver, auto or measured.
+ * \param[in] results The results.
+ * \return False if an error occurred, otherwise true.
+ */
+bool writeJson(const string& filename, const string& deviceName, const string& driverVersion, int warmup, const string& localMode, const vector<BenchmarkResult>& results)
+{
+    ofstream file(filename.c_str());
+    if (!file)
+    {
+        cerr << "Unable to open " << filename << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    file << "{\n";
+    file << "  \"device\": " << jsonString(deviceName) << ",\n";
+    file << "  \"driver\": " << jsonString(driverVersion) << ",\n";
+    file << "  \"warmup\": " << warmup << ",\n";
+    file << "  \"local\": " << jsonString(localMode) << ",\n";
+    file << "  \"results\": [\n";
+    for (size_t index = 0; index < results.size(); index++)
+    {
+        const BenchmarkResult& result = results[index];
+        file << "    {\"kernel\": " << jsonString(result.name) << ", \"size\": " << result.size;
+        if (result.skipped)
+        {
+            file << ", \"skipped\": true}";
+        }
+        else
+        {
+            file << ", \"skipped\": false"
+                 << ", \"repetitions\": " << result.repetitions
+                 << ", \"median_ms\": " << result.median
+                 << ", \"p95_ms\": " << result.percentile95
+                 << ", \"mean_ms\": " << result.mean
+                 << ", \"variance_ms2\": " << result.variance
+                 << ", \"gb_per_s\": " << result.gigabytesPerSecond
+                 << ", \"gflop_per_s\": " << result.gigaflopsPerSecond
+                 << ", \"mpix_per_s\": " << result.megapixelsPerSecond << "}";
+        }
+        file << (index + 1 < results.size() ? ",\n" : "\n");
+    }
+    file << "  ]\n";
+    file << "}\n";
+    return file.good();
+}
+
+/**
+ * \brief Write the results as CSV, one line per kernel and size.
+ * \param[in] filename File to write.
+ * \param[in] results The results.
+ * \return False if an error occurred, otherwise true.
+ */
+bool writeCsv(const string& filename, const vector<BenchmarkResult>& results)
+{
+    ofstream file(filename.c_str());
+    if (!file)
+    {
+        cerr << "Unable to open " << filename << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    file << "kernel,size,skipped,repetitions,median_ms,p95_ms,mean_ms,variance_ms2,gb_per_s,gflop_per_s,mpix_per_s\n";
+    for (size_t index = 0; index < results.size(); index++)
+    {
+        const BenchmarkResult& result = results[index];
+        file << result.name << "," << result.size << ",";
+        if (result.skipped)
+        {
+            file << "1,0,,,,,,,\n";
+        }
+        else
+        {
+            file << "0," << result.repetitions << "," << result.median << "," << result.percentile95 << "," << result.mean << ","
+                 << result.variance << "," << result.gigabytesPerSecond << "," << result.gigaflopsPerSecond << "," << result.megapixelsPerSecond << "\n";
+        }
+    }
+    return file.good();
+}
+
+/**
+ * \brief Print how to use the benchmark.
+ * \param[in] program Name of the executable.
+ */
+void printUsage(const char* program)
+{
+    cerr << "Usage: " << program << " [options]" << endl
+         << "  --warmup N        untimed runs per size (default 3)" << endl
+         << "  --repetitions N   timed runs per size (default 20)" << endl
+         << "  --kernel NAME     only run the named kernel" << endl
+         << "  --local MODE      local work sizes: driver (NULL), auto (chosen from the kernel limits) or measured (default driver)" << endl
+         << "  --json FILE       JSON output (default bench.json)" << endl
+         << "  --csv FILE        CSV output (default bench.csv)" << endl
+         << "  --samples DIR     directory containing the samples (default ../samples, or .. when installed)" << endl;
+}
+
+/**
+ * \brief Benchmark harness for the sample kernels.
+ * \details Runs each sample kernel over a sweep of problem sizes, with untimed warmup runs followed by timed repetitions.
+ *          For every kernel and size it reports the median, 95th percentile, mean and variance of the kernel time,
+ *          and the throughput at the median time in GB/s, GFLOP/s (for floating point kernels) and Mpix/s.
+ *          The results are printed and written as JSON and CSV, so the results of two builds can be compared.
+ *          Kernels the device cannot run, such as long_vectors without cl_khr_int64_base_atomics, are reported as skipped.
+ * \return The exit code of the application, non-zero if a problem occurred.
+ */
+int main(int argc, char** argv)
+{
+    int warmup = 3;
+    int repetitions = 20;
+    string kernelFilter;
+    string localMode = "driver";
+    string jsonFilename = "bench.json";
+    string csvFilename = "bench.csv";
+    string samplesDirectory;
+
+    for (int index = 1; index < argc; index++)
+    {
+        const bool hasValue = index + 1 < argc;
+        if (strcmp(argv[index], "--warmup") == 0 && hasValue)
+        {
+            warmup = atoi(argv[++index]);
+        }
+        else if (strcmp(argv[index], "--repetitions") == 0 && hasValue)
+        {
+            repetitions = atoi(argv[++index]);
+        }
+        else if (strcmp(argv[index], "--kernel") == 0 && hasValue)
+        {
+            kernelFilter = argv[++index];
+        }
+        else if (strcmp(argv[index], "--local") == 0 && hasValue)
+        {
+            localMode = argv[++index];
+        }
+        else if (strcmp(argv[index], "--json") == 0 && hasValue)
+        {
+            jsonFilename = argv[++index];
+        }
+        else if (strcmp(argv[index], "--csv") == 0 && hasValue)
+        {
+            csvFilename = argv[++index];
+        }
+        else if (strcmp(argv[index], "--samples") == 0 && hasValue)
+        {
+            samplesDirectory = argv[++index];
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (warmup < 0 || repetitions < 1 || (localMode != "driver" && localMode != "auto" && localMode != "measured"))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    /*
+     * In the source tree the samples are next to the bench directory.
+     * When installed, every sample has its own directory (with its assets) next to the bench directory.
+     */
+    if (samplesDirectory.empty())
+    {
+        ifstream sourceTree("../samples/sgemm/assets/sgemm.cl");
+        samplesDirectory = sourceTree ? "../samples" : "..";
+    }
+
+    cl_context context = 0;
+    cl_command_queue commandQueue = 0;
+    cl_device_id device = 0;
+
+    if (!createContext(&context))
+    {
+        cleanUpOpenCL(context, commandQueue, 0, 0, NULL, 0);
+        cerr << "Failed to create an OpenCL context. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!createCommandQueue(context, &commandQueue, &device))
+    {
+        cleanUpOpenCL(context, commandQueue, 0, 0, NULL, 0);
+        cerr << "Failed to create the OpenCL command queue. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    const DeviceInfo* deviceInfo = NULL;
+    if (!getDeviceInfo(device, &deviceInfo))
+    {
+        cleanUpOpenCL(context, commandQueue, 0, 0, NULL, 0);
+        cerr << "Failed to query the OpenCL device. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    const string& deviceName = deviceInfo->name;
+    const string& driverVersion = deviceInfo->driverVersion;
+    cout << "Device: " << deviceName << " (driver " << driverVersion << ")" << endl;
+
+    vector<BenchmarkResult> results;
+    for (int benchmarkIndex = 0; benchmarkIndex < numberOfBenchmarks; benchmarkIndex++)
+    {
+        const Benchmark& benchmark = benchmarks[benchmarkIndex];
+        if (!kernelFilter.empty() && kernelFilter != benchmark.name)
+        {
+            continue;
+        }
+
+        for (int sizeIndex = 0; sizeIndex < benchmark.numberOfSizes; sizeIndex++)
+        {
+            BenchmarkResult result;
+            result.name = benchmark.name;
+            result.size = benchmark.sizes[sizeIndex];
+            result.skipped = false;
+
+            BenchmarkRun run;
+            vector<double> times;
+            bool runSuccess = benchmark.setup(context, device, commandQueue, samplesDirectory, result.size, &run);
+
+            /* The sample kernels don't all check their work-item IDs, so the global work size is never padded. */
+            size_t paddedGlobalWorksize[3] = {0, 0, 0};
+            if (runSuccess && !run.skipped && localMode == "auto")
+            {
+                runSuccess = chooseLocalWorksize(run.kernel, device, run.workDimensions, run.globalWorksize, false, run.localWorksize, paddedGlobalWorksize);
+            }
+            else if (runSuccess && !run.skipped && localMode == "measured")
+            {
+                runSuccess = measureLocalWorksize(commandQueue, run.kernel, device, run.workDimensions, run.globalWorksize, false, run.localWorksize, paddedGlobalWorksize);
+                forgetLocalWorksizes(run.kernel);
+            }
+
+            if (runSuccess && !run.skipped)
+            {
+                runSuccess = timeBenchmarkRun(commandQueue, run, warmup, repetitions, &times) && !times.empty();
+            }
+            const bool skipped = run.skipped;
+            runSuccess &= releaseBenchmarkRun(&run);
+            if (!runSuccess)
+            {
+                cleanUpOpenCL(context, commandQueue, 0, 0, NULL, 0);
+                cerr << "Failed running " << benchmark.name << " at size " << result.size << ". " << __FILE__ << ":"<< __LINE__ << endl;
+                return 1;
+            }
+
+            if (skipped)
+            {
+                result.skipped = true;
+                cout << benchmark.name << " " << result.size << ": skipped, not supported by the device." << endl;
+            }
+            else
+            {
+                calculateStatistics(times, run, &result);
+                cout << benchmark.name << " " << result.size << ": median " << result.median << " ms, p95 " << result.percentile95
+                     << " ms, variance " << result.variance << " ms^2, " << result.gigabytesPerSecond << " GB/s, "
+                     << result.gigaflopsPerSecond << " GFLOP/s, " << result.megapixelsPerSecond << " Mpix/s";
+                if (run.localWorksize[0] != 0)
+                {
+                    cout << ", local " << run.localWorksize[0];
+                    for (cl_uint dimension = 1; dimension < run.workDimensions; dimension++)
+                    {
+                        cout << "x" << run.localWorksize[dimension];
+                    }
+                }
+                cout << endl;
+            }
+            results.push_back(result);
+        }
+    }
+
+    bool writeSuccess = true;
+    writeSuccess &= writeJson(jsonFilename, deviceName, driverVersion, warmup, localMode, results);
+    writeSuccess &= writeCsv(csvFilename, results);
+
+    cleanUpOpenCL(context, commandQueue, 0, 0, NULL, 0);
+    if (!writeSuccess)
+    {
+        cerr << "Failed writing the results. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    cout << "Results written to " << jsonFilename << " and " << csvFilename << endl;
+    return 0;
+}
@@ -0,0 +1,519 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "benchmarks.h"
+#include "common.h"
+#include "device.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+/**
+ * \brief Initial contents of a benchmark buffer.
+ */
+enum BufferContents
+{
+    BUFFER_BYTES, /**< \brief Pseudo-random bytes, for image data. */
+    BUFFER_INTS, /**< \brief Pseudo-random integers in [0, 65535]. */
+    BUFFER_FLOATS, /**< \brief Pseudo-random floats in [0, 1), so no time is spent on denormals or NaNs. */
+    BUFFER_ZEROS /**< \brief Zeros. */
+};
+
+/**
+ * \brief Reset a run so releaseBenchmarkRun can be called on it at any point of the setup.
+ * \param[out] run The run to reset.
+ */
+static void initializeBenchmarkRun(BenchmarkRun* run)
+{
+    run->program = 0;
+    run->kernel = 0;
+    for (int index = 0; index < maximumBenchmarkMemoryObjects; index++)
+    {
+        run->memoryObjects[index] = 0;
+    }
+    run->workDimensions = 0;
+    run->globalWorksize[0] = 1;
+    run->globalWorksize[1] = 1;
+    run->globalWorksize[2] = 1;
+    run->localWorksize[0] = 0;
+    run->localWorksize[1] = 0;
+    run->localWorksize[2] = 0;
+    run->bytes = 0.0;
+    run->flops = 0.0;
+    run->pixels = 0.0;
+    run->skipped = false;
+}
+
+/**
+ * \brief Build the program of a sample and create the kernel to benchmark.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] device The OpenCL device to build the kernel for.
+ * \param[in] samplesDirectory Directory containing the samples.
+ * \param[in] sourceFile Path of the kernel source file, relative to samplesDirectory.
+ * \param[in] kernelName Name of the kernel.
+ * \param[in] buildOptions Options passed to clBuildProgram.
+ * \param[out] run The run to store the program and kernel in.
+ * \return False if an error occurred, otherwise true.
+ */
+static bool createBenchmarkKernel(cl_context context, cl_device_id device, const string& samplesDirectory, const string& sourceFile,
+                                  const char* kernelName, const string& buildOptions, BenchmarkRun* run)
+{
+    if (!createProgram(context, device, samplesDirectory + "/" + sourceFile, &run->program, buildOptions))
+    {
+        run->program = 0;
+        cerr << "Failed to create the program for " << kernelName << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    cl_int errorNumber = 0;
+    run->kernel = clCreateKernel(run->program, kernelName, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        run->kernel = 0;
+        cerr << "Failed to create OpenCL kernel " << kernelName << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Create a buffer and fill it with data.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] commandQueue The command queue used to map the buffer.
+ * \param[in] flags Memory flags of the buffer. CL_MEM_ALLOC_HOST_PTR is added.
+ * \param[in] size Size of the buffer in bytes.
+ * \param[in] contents What to fill the buffer with.
+ * \param[out] buffer The created buffer.
+ * \return False if an error occurred, otherwise true.
+ */
+static bool createBenchmarkBuffer(cl_context context, cl_command_queue commandQueue, cl_mem_flags flags, size_t size, BufferContents contents, cl_mem* buffer)
+{
+    cl_int errorNumber = 0;
+    *buffer = clCreateBuffer(context, flags | CL_MEM_ALLOC_HOST_PTR, size, NULL, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        *buffer = 0;
+        cerr << "Failed to create OpenCL buffer. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    void* data = clEnqueueMapBuffer(commandQueue, *buffer, CL_TRUE, CL_MAP_WRITE, 0, size, 0, NULL, NULL, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        cerr << "Mapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* A fixed linear congruential generator, so every build benchmarks the same data. */
+    unsigned int state = 12345;
+    switch (contents)
+    {
+        case BUFFER_BYTES:
+            for (size_t index = 0; index < size; index++)
+            {
+                state = state * 1103515245 + 12345;
+                ((cl_uchar*)data)[index] = (cl_uchar)(state >> 16);
+            }
+            break;
+        case BUFFER_INTS:
+            for (size_t index = 0; index < size / sizeof(cl_int); index++)
+            {
+                state = state * 1103515245 + 12345;
+                ((cl_int*)data)[index] = (cl_int)(state >> 16);
+            }
+            break;
+        case BUFFER_FLOATS:
+            for (size_t index = 0; index < size / sizeof(cl_float); index++)
+            {
+                state = state * 1103515245 + 12345;
+                ((cl_float*)data)[index] = (float)(state >> 16) / 65536.0f;
+            }
+            break;
+        default:
+            for (size_t index = 0; index < size; index++)
+            {
+                ((cl_uchar*)data)[index] = 0;
+            }
+            break;
+    }
+
+    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, *buffer, data, 0, NULL, NULL)))
+    {
+        cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return true;
+}
+
+bool releaseBenchmarkRun(BenchmarkRun* run)
+{
+    bool returnValue = true;
+    for (int index = 0; index < maximumBenchmarkMemoryObjects; index++)
+    {
+        if (run->memoryObjects[index] != 0)
+        {
+            returnValue &= checkSuccess(clReleaseMemObject(run->memoryObjects[index]));
+            run->memoryObjects[index] = 0;
+        }
+    }
+    if (run->kernel != 0)
+    {
+        returnValue &= checkSuccess(clReleaseKernel(run->kernel));
+        run->kernel = 0;
+    }
+    if (run->program != 0)
+    {
+        returnValue &= checkSuccess(clReleaseProgram(run->program));
+        run->program = 0;
+    }
+    return returnValue;
+}
+
+/**
+ * \brief sgemm: C = alpha * A * B + beta * C for square matrices of order size.
+ */
+static bool setupSgemm(cl_context context, cl_device_id device, cl_command_queue commandQueue, const string& samplesDirectory, int size, BenchmarkRun* run)
+{
+    initializeBenchmarkRun(run);
+    const size_t matrixSize = (size_t)size * size * sizeof(cl_float);
+    const cl_uint matrixOrder = size;
+    const cl_float alpha = 1.0f;
+    const cl_float beta = 0.1f;
+
+    bool setupSuccess = createBenchmarkKernel(context, device, samplesDirectory, "sgemm/assets/sgemm.cl", "sgemm", "", run);
+    for (int index = 0; setupSuccess && index < 3; index++)
+    {
+        setupSuccess &= createBenchmarkBuffer(context, commandQueue, index < 2 ? CL_MEM_READ_ONLY : CL_MEM_READ_WRITE, matrixSize, BUFFER_FLOATS, &run->memoryObjects[index]);
+    }
+    if (!setupSuccess)
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    for (int index = 0; index < 3; index++)
+    {
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, index, sizeof(cl_mem), &run->memoryObjects[index]));
+    }
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 3, sizeof(cl_uint), &matrixOrder));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 4, sizeof(cl_float), &alpha));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 5, sizeof(cl_float), &beta));
+
+    run->workDimensions = 2;
+    run->globalWorksize[0] = size;
+    run->globalWorksize[1] = size;
+    /* A and B are read, C is read and written. */
+    run->bytes = 4.0 * matrixSize;
+    /* A multiply and an add per term of each dot product, plus the scaling by alpha and beta and the final add. */
+    run->flops = 2.0 * size * size * size + 3.0 * size * size;
+    run->pixels = (double)size * size;
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief fir_float: 3x3 FIR filter of a size by size float image.
+ */
+static bool setupFirFloat(cl_context context, cl_device_id device, cl_command_queue commandQueue, const string& samplesDirectory, int size, BenchmarkRun* run)
+{
+    initializeBenchmarkRun(run);
+    const cl_int width = size;
+    const size_t imageSize = (size_t)size * size * sizeof(cl_float);
+    /* The kernel reads two rows and a few columns past each output pixel, as in the sample. */
+    const size_t paddedSize = imageSize + (2 * (size_t)size + 8) * sizeof(cl_float);
+
+    bool setupSuccess = createBenchmarkKernel(context, device, samplesDirectory, "fir_float/assets/fir_float.cl", "fir_float", "", run);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_READ_ONLY, paddedSize, BUFFER_FLOATS, &run->memoryObjects[0]);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_WRITE_ONLY, paddedSize, BUFFER_ZEROS, &run->memoryObjects[1]);
+    if (!setupSuccess)
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 0, sizeof(cl_mem), &run->memoryObjects[0]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 1, sizeof(cl_mem), &run->memoryObjects[1]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 2, sizeof(cl_int), &width));
+
+    run->workDimensions = 2;
+    run->globalWorksize[0] = size / 4;
+    run->globalWorksize[1] = size;
+    run->bytes = 2.0 * imageSize;
+    /* 9 multiply-adds per pixel. */
+    run->flops = 18.0 * size * size;
+    run->pixels = (double)size * size;
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief sobel: Sobel gradients of a size by size 8-bit image, 16 pixels per work-item.
+ */
+static bool setupSobel(cl_context context, cl_device_id device, cl_command_queue commandQueue, const string& samplesDirectory, int size, BenchmarkRun* run)
+{
+    initializeBenchmarkRun(run);
+    const cl_int width = size;
+    const cl_int height = size;
+    const size_t imageSize = (size_t)size * size;
+
+    bool setupSuccess = createBenchmarkKernel(context, device, samplesDirectory, "sobel/assets/sobel.cl", "sobel", "", run);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_READ_ONLY, imageSize, BUFFER_BYTES, &run->memoryObjects[0]);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_WRITE_ONLY, imageSize, BUFFER_ZEROS, &run->memoryObjects[1]);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_WRITE_ONLY, imageSize, BUFFER_ZEROS, &run->memoryObjects[2]);
+    if (!setupSuccess)
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 0, sizeof(cl_mem), &run->memoryObjects[0]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 1, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 2, sizeof(cl_int), &height));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 3, sizeof(cl_mem), &run->memoryObjects[1]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 4, sizeof(cl_mem), &run->memoryObjects[2]));
+
+    run->workDimensions = 2;
+    run->globalWorksize[0] = (size + 15) / 16;
+    run->globalWorksize[1] = size;
+    run->bytes = 3.0 * imageSize;
+    run->pixels = (double)imageSize;
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief sobel_no_vectors: Sobel gradients of a size by size 8-bit image, one pixel per work-item.
+ */
+static bool setupSobelNoVectors(cl_context context, cl_device_id device, cl_command_queue commandQueue, const string& samplesDirectory, int size, BenchmarkRun* run)
+{
+    initializeBenchmarkRun(run);
+    const cl_int width = size;
+    const size_t imageSize = (size_t)size * size;
+    /* The kernel reads and writes up to two rows and two columns past each work-item, as in the sample. */
+    const size_t paddedSize = imageSize + 2 * (size_t)size + 8;
+
+    bool setupSuccess = createBenchmarkKernel(context, device, samplesDirectory, "sobel_no_vectors/assets/sobel_no_vectors.cl", "sobel_no_vectors", "", run);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_READ_ONLY, paddedSize, BUFFER_BYTES, &run->memoryObjects[0]);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_WRITE_ONLY, paddedSize, BUFFER_ZEROS, &run->memoryObjects[1]);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_WRITE_ONLY, paddedSize, BUFFER_ZEROS, &run->memoryObjects[2]);
+    if (!setupSuccess)
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 0, sizeof(cl_mem), &run->memoryObjects[0]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 1, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 2, sizeof(cl_mem), &run->memoryObjects[1]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 3, sizeof(cl_mem), &run->memoryObjects[2]));
+
+    run->workDimensions = 2;
+    run->globalWorksize[0] = size;
+    run->globalWorksize[1] = size;
+    run->bytes = 3.0 * imageSize;
+    run->pixels = (double)imageSize;
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief mandelbrot: the original 4 pixels per work-item Mandelbrot kernel for a size by size image.
+ */
+static bool setupMandelbrot(cl_context context, cl_device_id device, cl_command_queue commandQueue, const string& samplesDirectory, int size, BenchmarkRun* run)
+{
+    initializeBenchmarkRun(run);
+    const cl_int width = size;
+    const cl_int height = size;
+    const size_t imageSize = (size_t)size * size;
+
+    bool setupSuccess = createBenchmarkKernel(context, device, samplesDirectory, "mandelbrot/assets/mandelbrot.cl", "mandelbrot", "", run);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_WRITE_ONLY, imageSize, BUFFER_ZEROS, &run->memoryObjects[0]);
+    if (!setupSuccess)
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 0, sizeof(cl_mem), &run->memoryObjects[0]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 1, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 2, sizeof(cl_int), &height));
+
+    run->workDimensions = 2;
+    run->globalWorksize[0] = size / 4;
+    run->globalWorksize[1] = size;
+    /* The number of iterations depends on the pixel, so no floating point operation count is reported. */
+    run->bytes = (double)imageSize;
+    run->pixels = (double)imageSize;
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief long_vectors: sum and sum of squares of size bytes with 64-bit atomics. Needs cl_khr_int64_base_atomics.
+ */
+static bool setupLongVectors(cl_context context, cl_device_id device, cl_command_queue commandQueue, const string& samplesDirectory, int size, BenchmarkRun* run)
+{
+    initializeBenchmarkRun(run);
+    if (!isExtensionSupported(device, "cl_khr_int64_base_atomics"))
+    {
+        run->skipped = true;
+        return true;
+    }
+
+    bool setupSuccess = createBenchmarkKernel(context, device, samplesDirectory, "64_bit_integer/assets/64_bit_integer.cl", "long_vectors", "", run);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_READ_ONLY, size, BUFFER_BYTES, &run->memoryObjects[0]);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_READ_WRITE, sizeof(cl_ulong), BUFFER_ZEROS, &run->memoryObjects[1]);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_READ_WRITE, sizeof(cl_ulong), BUFFER_ZEROS, &run->memoryObjects[2]);
+    if (!setupSuccess)
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    for (int index = 0; index < 3; index++)
+    {
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, index, sizeof(cl_mem), &run->memoryObjects[index]));
+    }
+
+    run->workDimensions = 1;
+    run->globalWorksize[0] = size / 8;
+    run->bytes = (double)size;
+    run->pixels = (double)size;
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief image_scaling: bilinear upscaling by 8 of an RGBA image to size by size, as in the sample.
+ */
+static bool setupImageScaling(cl_context context, cl_device_id device, cl_command_queue commandQueue, const string& samplesDirectory, int size, BenchmarkRun* run)
+{
+    initializeBenchmarkRun(run);
+    const DeviceInfo* deviceInfo = NULL;
+    if (!getDeviceInfo(device, &deviceInfo))
+    {
+        cerr << "Failed to query image support. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    if (!deviceInfo->imageSupport)
+    {
+        run->skipped = true;
+        return true;
+    }
+
+    const int scaleFactor = 8;
+    const int sourceSize = size / scaleFactor;
+
+    if (!createBenchmarkKernel(context, device, samplesDirectory, "image_scaling/assets/image_scaling.cl", "image_scaling", "", run))
+    {
+        return false;
+    }
+
+    cl_image_format format;
+    format.image_channel_data_type = CL_UNORM_INT8;
+    format.image_channel_order = CL_RGBA;
+
+    unsigned char* sourceData = new unsigned char[(size_t)sourceSize * sourceSize * 4];
+    unsigned int state = 12345;
+    for (size_t index = 0; index < (size_t)sourceSize * sourceSize * 4; index++)
+    {
+        state = state * 1103515245 + 12345;
+        sourceData[index] = (unsigned char)(state >> 16);
+    }
+
+    cl_int errorNumber = 0;
+    bool createMemoryObjectsSuccess = true;
+    run->memoryObjects[0] = clCreateImage2D(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, &format, sourceSize, sourceSize, 0, sourceData, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    run->memoryObjects[1] = clCreateImage2D(context, CL_MEM_WRITE_ONLY, &format, size, size, 0, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    delete [] sourceData;
+    if (!createMemoryObjectsSuccess)
+    {
+        cerr << "Failed to create OpenCL images. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    const cl_float widthNormalizationFactor = 1.0f / size;
+    const cl_float heightNormalizationFactor = 1.0f / size;
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 0, sizeof(cl_mem), &run->memoryObjects[0]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 1, sizeof(cl_mem), &run->memoryObjects[1]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 2, sizeof(cl_float), &widthNormalizationFactor));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 3, sizeof(cl_float), &heightNormalizationFactor));
+
+    run->workDimensions = 2;
+    run->globalWorksize[0] = size;
+    run->globalWorksize[1] = size;
+    run->bytes = 4.0 * sourceSize * sourceSize + 4.0 * size * size;
+    run->pixels = (double)size * size;
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief hello_world_vector: integer addition of two arrays of size elements, at the preferred vector width of the device.
+ */
+static bool setupHelloWorldVector(cl_context context, cl_device_id device, cl_command_queue commandQueue, const string& samplesDirectory, int size, BenchmarkRun* run)
+{
+    initializeBenchmarkRun(run);
+    const cl_int count = size;
+    const cl_int alpha = 0;
+    const size_t arraySize = (size_t)size * sizeof(cl_int);
+
+    /* The same build options as createElementwiseKernel in the sample uses for a single add step. */
+    const DeviceInfo* deviceInfo = NULL;
+    if (!getDeviceInfo(device, &deviceInfo))
+    {
+        cerr << "Failed to query the preferred vector width. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    const cl_uint preferredWidth = deviceInfo->preferredVectorWidthInt;
+    cl_uint vectorWidth = 1;
+    while (vectorWidth * 2 <= preferredWidth && vectorWidth * 2 <= 16)
+    {
+        vectorWidth *= 2;
+    }
+    ostringstream buildOptions;
+    buildOptions << "-DTYPE=int -DVEC=" << vectorWidth << " -DNUMBER_OF_INPUTS=2 -DEXPRESSION=(a+b)";
+
+    bool setupSuccess = createBenchmarkKernel(context, device, samplesDirectory, "hello_world_vector/assets/elementwise.cl", "elementwise", buildOptions.str(), run);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_READ_ONLY, arraySize, BUFFER_INTS, &run->memoryObjects[0]);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_READ_ONLY, arraySize, BUFFER_INTS, &run->memoryObjects[1]);
+    setupSuccess = setupSuccess && createBenchmarkBuffer(context, commandQueue, CL_MEM_WRITE_ONLY, arraySize, BUFFER_ZEROS, &run->memoryObjects[2]);
+    if (!setupSuccess)
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 0, sizeof(cl_mem), &run->memoryObjects[0]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 1, sizeof(cl_mem), &run->memoryObjects[1]));
+    /* The third input is not read by a single add. */
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 2, sizeof(cl_mem), &run->memoryObjects[1]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 3, sizeof(cl_int), &alpha));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 4, sizeof(cl_mem), &run->memoryObjects[2]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(run->kernel, 5, sizeof(cl_int), &count));
+
+    run->workDimensions = 1;
+    run->globalWorksize[0] = (size + vectorWidth - 1) / vectorWidth;
+    run->bytes = 3.0 * arraySize;
+    run->pixels = (double)size;
+    return setKernelArgumentsSuccess;
+}
+
+const Benchmark benchmarks[] =
+{
+    {"sgemm", setupSgemm, 3, {128, 256, 512}},
+    {"fir_float", setupFirFloat, 4, {256, 512, 1024, 2048}},
+    {"sobel", setupSobel, 4, {256, 512, 1024, 2048}},
+    {"sobel_no_vectors", setupSobelNoVectors, 4, {256, 512, 1024, 2048}},
+    {"mandelbrot", setupMandelbrot, 4, {256, 512, 1024, 2048}},
+    {"long_vectors", setupLongVectors, 3, {1 << 18, 1 << 20, 1 << 22}},
+    {"image_scaling", setupImageScaling, 4, {256, 512, 1024, 2048}},
+    {"hello_world_vector", setupHelloWorldVector, 3, {1 << 18, 1 << 20, 1 << 22}}
+};
+
+const int numberOfBenchmarks = sizeof(benchmarks) / sizeof(benchmarks[0]);
@@ -0,0 +1,90 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <CL/cl.h>
+#include <string>
+
+/**
+ * \file benchmarks.h
+ * \brief The sample kernels run by the benchmark harness, set up for a range of problem sizes.
+ */
+
+/**
+ * \brief Largest number of memory objects used by one benchmark.
+ */
+const int maximumBenchmarkMemoryObjects = 4;
+
+/**
+ * \brief A sample kernel set up for one problem size, ready to be enqueued repeatedly.
+ */
+struct BenchmarkRun
+{
+    cl_program program; /**< \brief The program of the sample. */
+    cl_kernel kernel; /**< \brief The kernel to time, with all its arguments set. */
+    cl_mem memoryObjects[maximumBenchmarkMemoryObjects]; /**< \brief Buffers and images used by the kernel. */
+    cl_uint workDimensions; /**< \brief Number of dimensions of the global work size. */
+    size_t globalWorksize[3]; /**< \brief Global work size, as used by the sample. */
+    size_t localWorksize[3]; /**< \brief Local work size, or 0 to leave the choice to the driver. */
+    double bytes; /**< \brief Bytes read and written by one run, counting every input and output once. */
+    double flops; /**< \brief Floating point operations of one run, 0 for integer kernels. */
+    double pixels; /**< \brief Output pixels (or elements) of one run. */
+    bool skipped; /**< \brief True if the device cannot run the kernel, for example because an extension is missing. */
+};
+
+/**
+ * \brief Set up a sample kernel for a problem size.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] device The OpenCL device to build the kernel for.
+ * \param[in] commandQueue The command queue used to initialize the inputs.
+ * \param[in] samplesDirectory Directory containing the samples, used to find the kernel source files.
+ * \param[in] size Problem size: width and height of an image, order of a matrix or number of array elements.
+ * \param[out] run The kernel and its memory objects. Must be released with releaseBenchmarkRun.
+ * \return False if an error occurred, otherwise true.
+ */
+typedef bool (*BenchmarkSetupFunction)(cl_context context, cl_device_id device, cl_command_queue commandQueue,
+                                       const std::string& samplesDirectory, int size, BenchmarkRun* run);
+
+/**
+ * \brief Largest number of sizes in the sweep of a benchmark.
+ */
+const int maximumBenchmarkSizes = 4;
+
+/**
+ * \brief A sample kernel and the sizes it is run at.
+ */
+struct Benchmark
+{
+    const char* name; /**< \brief Name of the kernel, used in the results. */
+    BenchmarkSetupFunction setup; /**< \brief Sets up the kernel for one size. */
+    int numberOfSizes; /**< \brief Number of sizes in the sweep. */
+    int sizes[maximumBenchmarkSizes]; /**< \brief The problem sizes, see BenchmarkSetupFunction. */
+};
+
+/**
+ * \brief All the benchmarks, in the order they are run.
+ */
+extern const Benchmark benchmarks[];
+
+/**
+ * \brief Number of entries in benchmarks.
+ */
+extern const int numberOfBenchmarks;
+
+/**
+ * \brief Release the OpenCL objects of a benchmark run.
+ * \param[in] run The run to release.
+ * \return False if an error occurred, otherwise true.
+ */
+bool releaseBenchmarkRun(BenchmarkRun* run);
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "batch.h"
+#include "common.h"
+
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+void initializeImageBatch(ImageBatch* batch)
+{
+    batch->table.clear();
+    batch->numberOfImages = 0;
+    batch->elements = 0;
+    batch->maximumWidth = 0;
+    batch->maximumHeight = 0;
+}
+
+size_t addImageToBatch(ImageBatch* batch, cl_int width, cl_int height)
+{
+    const size_t offset = batch->elements;
+
+    batch->table.push_back((int)offset);
+    batch->table.push_back(width);
+    batch->table.push_back(height);
+    batch->table.push_back(0);
+
+    batch->numberOfImages++;
+    batch->elements += (size_t)width * height;
+    batch->maximumWidth = max(batch->maximumWidth, width);
+    batch->maximumHeight = max(batch->maximumHeight, height);
+    return offset;
+}
+
+bool createImageBatchTable(cl_context context, const ImageBatch* batch, cl_mem* table)
+{
+    if (batch->numberOfImages == 0)
+    {
+        cerr << "The batch has no images. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    cl_int errorNumber = CL_SUCCESS;
+    *table = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, batch->table.size() * sizeof(cl_int),
+                            (void*)&batch->table[0], &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        cerr << "Failed to create the batch table buffer. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return true;
+}
+
+void getImageBatchWorksize(const ImageBatch* batch, size_t pixelsPerWorkItem, size_t* globalWorksize)
+{
+    globalWorksize[0] = ((size_t)batch->maximumWidth + pixelsPerWorkItem - 1) / pixelsPerWorkItem;
+    globalWorksize[1] = (size_t)batch->maximumHeight;
+    globalWorksize[2] = batch->numberOfImages;
+}
+
+double millisecondsBetween(const timeval& start, const timeval& end)
+{
+    return (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_usec - start.tv_usec) / 1000.0;
+}
+
+bool addKernelMilliseconds(cl_event event, double* milliseconds)
+{
+    cl_ulong start = 0;
+    cl_ulong end = 0;
+    bool returnValue = true;
+    returnValue &= checkSuccess(clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL));
+    returnValue &= checkSuccess(clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL));
+    *milliseconds += (double)(end - start) / 1000000.0;
+    return returnValue;
+}
+
+bool releaseBatchObjects(vector<cl_mem>& memoryObjects, vector<cl_event>& events)
+{
+    bool returnValue = true;
+    for (size_t index = 0; index < memoryObjects.size(); index++)
+    {
+        if (memoryObjects[index] != NULL)
+        {
+            returnValue &= checkSuccess(clReleaseMemObject(memoryObjects[index]));
+        }
+    }
+    for (size_t index = 0; index < events.size(); index++)
+    {
+        if (events[index] != NULL)
+        {
+            returnValue &= checkSuccess(clReleaseEvent(events[index]));
+        }
+    }
+    memoryObjects.clear();
+    events.clear();
+    return returnValue;
+}
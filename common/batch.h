@@ -0,0 +1,111 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <CL/cl.h>
+#include <cstddef>
+#include <vector>
+#include <sys/time.h>
+
+/**
+ * \file batch.h
+ * \brief Many small images packed into one buffer, so one kernel launch processes all of them.
+ * \details Launching a kernel once per small image (a thumbnail, say) costs more in launch overhead than the kernel takes to run.
+ *          An ImageBatch packs the images one after the other into a single buffer and keeps a table with
+ *          the offset, width and height of each, which the kernel reads as an int4 per image.
+ *          The batched kernel is launched over a 3D NDRange: the first two dimensions cover the largest image
+ *          and the third is the image index, so work-items past the edge of a smaller image must return without doing anything.
+ */
+
+/**
+ * \brief The layout of a batch of images.
+ */
+struct ImageBatch
+{
+    /** Four values per image: offset of its first pixel in elements, width, height, and an unused value, so the kernel can read an int4. */
+    std::vector<int> table;
+    size_t numberOfImages;
+    /** Total number of pixels, the size of the packed buffer in elements. */
+    size_t elements;
+    cl_int maximumWidth;
+    cl_int maximumHeight;
+};
+
+/**
+ * \brief Start an empty batch.
+ * \param[out] batch The batch.
+ */
+void initializeImageBatch(ImageBatch* batch);
+
+/**
+ * \brief Add an image to a batch.
+ * \param[in,out] batch The batch.
+ * \param[in] width Width of the image.
+ * \param[in] height Height of the image.
+ * \return Offset of the first pixel of the image in the packed buffer, in elements.
+ */
+size_t addImageToBatch(ImageBatch* batch, cl_int width, cl_int height);
+
+/**
+ * \brief Offset of the first pixel of an image in the packed buffer, in elements.
+ * \param[in] batch The batch.
+ * \param[in] index Index of the image.
+ * \return The offset.
+ */
+inline size_t getBatchImageOffset(const ImageBatch* batch, size_t index)
+{
+    return (size_t)batch->table[index * 4];
+}
+
+/**
+ * \brief Create the buffer holding the table of a batch, to pass to the batched kernel.
+ * \param[in] context The OpenCL context to create the buffer in.
+ * \param[in] batch The batch. Must not be empty.
+ * \param[out] table The buffer, read-only.
+ * \return False if an error occurred, otherwise true.
+ */
+bool createImageBatchTable(cl_context context, const ImageBatch* batch, cl_mem* table);
+
+/**
+ * \brief Global work size of a batched launch.
+ * \param[in] batch The batch.
+ * \param[in] pixelsPerWorkItem Number of pixels in a row each work-item processes.
+ * \param[out] globalWorksize Three values: the columns and rows of the largest image, and the number of images.
+ */
+void getImageBatchWorksize(const ImageBatch* batch, size_t pixelsPerWorkItem, size_t* globalWorksize);
+
+/**
+ * \brief Milliseconds between two host times, to compare the host time of batched and unbatched runs.
+ * \param[in] start The earlier time.
+ * \param[in] end The later time.
+ * \return The time between them in milliseconds.
+ */
+double millisecondsBetween(const timeval& start, const timeval& end);
+
+/**
+ * \brief Add the device time of a kernel to a total.
+ * \param[in] event Event of the kernel, from a command queue with profiling enabled.
+ * \param[in,out] milliseconds The total.
+ * \return False if an error occurred, otherwise true.
+ */
+bool addKernelMilliseconds(cl_event event, double* milliseconds);
+
+/**
+ * \brief Release the memory objects and events of a batched or unbatched run, and empty the lists.
+ * \details Null handles, left by failed create or enqueue calls, are skipped.
+ * \param[in,out] memoryObjects The memory objects.
+ * \param[in,out] events The events.
+ * \return False if an error occurred, otherwise true.
+ */
+bool releaseBatchObjects(std::vector<cl_mem>& memoryObjects, std::vector<cl_event>& events);
+
+#endif
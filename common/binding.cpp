@@ -0,0 +1,92 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "binding.h"
+#include "common.h"
+
+#include <iostream>
+#include <cstring>
+
+using namespace std;
+
+bool initializeKernelBinding(cl_kernel kernel, KernelBinding* binding)
+{
+    binding->kernel = kernel;
+    binding->numberOfArguments = 0;
+    binding->calls = 0;
+    binding->skipped = 0;
+    invalidateKernelBinding(binding);
+
+    if (!checkSuccess(clGetKernelInfo(kernel, CL_KERNEL_NUM_ARGS, sizeof(cl_uint), &binding->numberOfArguments, NULL)))
+    {
+        cerr << "Failed to get the number of kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return true;
+}
+
+void invalidateKernelBinding(KernelBinding* binding)
+{
+    for (cl_uint index = 0; index < maximumKernelArguments; index++)
+    {
+        binding->valid[index] = false;
+    }
+}
+
+void invalidateKernelBindingArgument(KernelBinding* binding, cl_uint index)
+{
+    if (index < maximumKernelArguments)
+    {
+        binding->valid[index] = false;
+    }
+}
+
+bool setKernelBindingArgument(KernelBinding* binding, cl_uint index, size_t size, const void* value)
+{
+    binding->calls++;
+
+    const bool local = value == NULL;
+    const bool tracked = index < maximumKernelArguments && size <= maximumKernelArgumentSize;
+    if (tracked && binding->valid[index] && binding->local[index] == local && binding->sizes[index] == size &&
+        (local || memcmp(binding->values[index], value, size) == 0))
+    {
+        binding->skipped++;
+        return true;
+    }
+
+    if (!checkSuccess(clSetKernelArg(binding->kernel, index, size, value)))
+    {
+        invalidateKernelBindingArgument(binding, index);
+        cerr << "Failed setting OpenCL kernel argument " << index << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    if (index < maximumKernelArguments)
+    {
+        binding->valid[index] = tracked;
+        binding->local[index] = local;
+        binding->sizes[index] = size;
+        if (tracked && !local)
+        {
+            memcpy(binding->values[index], value, size);
+        }
+    }
+    return true;
+}
+
+bool checkKernelBindingArity(const KernelBinding* binding, cl_uint numberOfArguments)
+{
+    if (binding->numberOfArguments != numberOfArguments)
+    {
+        cerr << "The kernel takes " << binding->numberOfArguments << " arguments but its signature declares " << numberOfArguments << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,479 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef BINDING_H
+#define BINDING_H
+
+#include <CL/cl.h>
+#include <cstddef>
+
+/**
+ * \file binding.h
+ * \brief Kernel arguments which are only passed to the driver when they change.
+ * \details A KernelBinding keeps a copy of the last value set for each argument of a kernel.
+ *          Setting an argument to the value it already has does not call clSetKernelArg,
+ *          which saves the driver overhead when a kernel is launched from a frame loop with mostly unchanged arguments.
+ *          Arguments must then only be set through the binding, or the copy goes stale; call invalidateKernelBinding after setting them directly.
+ *          A memory object handle can be reused by the implementation after the object is released,
+ *          so invalidate the binding when a bound memory object is released and replaced.
+ */
+
+/**
+ * \brief Most arguments of a kernel tracked by a binding.
+ */
+const cl_uint maximumKernelArguments = 16;
+
+/**
+ * \brief Largest argument value which is compared with its copy. Larger arguments are always set.
+ */
+const size_t maximumKernelArgumentSize = 64;
+
+/**
+ * \brief A kernel and copies of the values of its arguments.
+ */
+struct KernelBinding
+{
+    cl_kernel kernel; /**< \brief The kernel. Not owned by the binding. */
+    cl_uint numberOfArguments; /**< \brief Number of arguments of the kernel. */
+    bool valid[maximumKernelArguments]; /**< \brief Whether the copy of an argument holds the value the kernel has. */
+    size_t sizes[maximumKernelArguments]; /**< \brief Size of each argument as last set. */
+    bool local[maximumKernelArguments]; /**< \brief Whether the argument was last set as __local memory of sizes[index] bytes. */
+    unsigned char values[maximumKernelArguments][maximumKernelArgumentSize]; /**< \brief Copies of the argument values. */
+    unsigned long calls; /**< \brief Number of arguments set through the binding. */
+    unsigned long skipped; /**< \brief Number of those which did not need a clSetKernelArg call. */
+};
+
+/**
+ * \brief Bind a kernel.
+ * \param[in] kernel The kernel. It must stay valid for as long as the binding is used.
+ * \param[out] binding The binding, with no argument values known.
+ * \return False if an error occurred, otherwise true.
+ */
+bool initializeKernelBinding(cl_kernel kernel, KernelBinding* binding);
+
+/**
+ * \brief Forget the value of one argument, so it is set on next use.
+ * \param[in,out] binding The binding.
+ * \param[in] index Index of the argument.
+ */
+void invalidateKernelBindingArgument(KernelBinding* binding, cl_uint index);
+
+/**
+ * \brief Forget the argument values, so every argument is set on next use.
+ * \param[in,out] binding The binding.
+ */
+void invalidateKernelBinding(KernelBinding* binding);
+
+/**
+ * \brief Set one argument of the kernel if it differs from the value it has.
+ * \param[in,out] binding The binding.
+ * \param[in] index Index of the argument.
+ * \param[in] size Size of the argument, as for clSetKernelArg.
+ * \param[in] value The argument value, or NULL for __local memory of size bytes.
+ * \return False if an error occurred, otherwise true.
+ */
+bool setKernelBindingArgument(KernelBinding* binding, cl_uint index, size_t size, const void* value);
+
+/**
+ * \brief Check the kernel takes the number of arguments a signature declares.
+ * \param[in] binding The binding.
+ * \param[in] numberOfArguments Number of arguments in the signature.
+ * \return False if the kernel takes a different number of arguments, otherwise true.
+ */
+bool checkKernelBindingArity(const KernelBinding* binding, cl_uint numberOfArguments);
+
+/**
+ * \brief The value of a __local argument: the number of bytes to allocate.
+ */
+struct LocalMemory
+{
+    size_t size; /**< \brief Bytes of local memory. */
+
+    /**
+     * \brief Local memory of a number of bytes.
+     * \param[in] bytes Bytes of local memory.
+     */
+    explicit LocalMemory(size_t bytes) : size(bytes) {}
+};
+
+/**
+ * \brief Placeholder for the unused arguments of a KernelSignature.
+ */
+struct NoKernelArgument {};
+
+/**
+ * \brief The types of the arguments of a kernel, in order.
+ * \details Use the host type of each kernel argument: cl_mem for buffers and images, int, unsigned int and float for scalars,
+ *          cl_float4 and the other vector types for vectors, and LocalMemory for __local arguments.
+ *          The scalar typedefs cl_int, cl_float, ... carry alignment attributes which are ignored in template arguments, so use the plain types. Example:
+ *          typedef KernelSignature<cl_mem, int, int, cl_mem> SobelSignature;
+ *          setKernelArguments<SobelSignature>(&binding, input, width, height, output);
+ */
+template <typename T0 = NoKernelArgument, typename T1 = NoKernelArgument, typename T2 = NoKernelArgument, typename T3 = NoKernelArgument,
+          typename T4 = NoKernelArgument, typename T5 = NoKernelArgument, typename T6 = NoKernelArgument, typename T7 = NoKernelArgument>
+struct KernelSignature
+{
+    typedef T0 Argument0;
+    typedef T1 Argument1;
+    typedef T2 Argument2;
+    typedef T3 Argument3;
+    typedef T4 Argument4;
+    typedef T5 Argument5;
+    typedef T6 Argument6;
+    typedef T7 Argument7;
+};
+
+/**
+ * \brief 1 for a declared argument type, 0 for NoKernelArgument.
+ */
+template <typename T>
+struct IsKernelArgument
+{
+    static const cl_uint value = 1;
+};
+
+template <>
+struct IsKernelArgument<NoKernelArgument>
+{
+    static const cl_uint value = 0;
+};
+
+/**
+ * \brief Number of arguments a KernelSignature declares.
+ */
+template <typename Signature>
+struct KernelSignatureArity
+{
+    static const cl_uint value = IsKernelArgument<typename Signature::Argument0>::value + IsKernelArgument<typename Signature::Argument1>::value +
+                                 IsKernelArgument<typename Signature::Argument2>::value + IsKernelArgument<typename Signature::Argument3>::value +
+                                 IsKernelArgument<typename Signature::Argument4>::value + IsKernelArgument<typename Signature::Argument5>::value +
+                                 IsKernelArgument<typename Signature::Argument6>::value + IsKernelArgument<typename Signature::Argument7>::value;
+};
+
+/**
+ * \brief Only defined for true, so taking the size of KernelSignatureArityCheck<false> fails to compile
+ *        when setKernelArguments is given a different number of values than the signature declares.
+ */
+template <bool matches>
+struct KernelSignatureArityCheck;
+
+template <>
+struct KernelSignatureArityCheck<true> {};
+
+/**
+ * \brief Set an argument from a value of its declared type.
+ * \param[in,out] binding The binding.
+ * \param[in] index Index of the argument.
+ * \param[in] value The value.
+ * \return False if an error occurred, otherwise true.
+ */
+template <typename T>
+inline bool setKernelBindingValue(KernelBinding* binding, cl_uint index, const T& value)
+{
+    return setKernelBindingArgument(binding, index, sizeof(T), &value);
+}
+
+/**
+ * \brief Set a __local argument.
+ * \param[in,out] binding The binding.
+ * \param[in] index Index of the argument.
+ * \param[in] value The amount of local memory.
+ * \return False if an error occurred, otherwise true.
+ */
+inline bool setKernelBindingValue(KernelBinding* binding, cl_uint index, const LocalMemory& value)
+{
+    return setKernelBindingArgument(binding, index, value.size, NULL);
+}
+
+/**
+ * \brief Number of work items needed to cover a number of elements when each work item processes several of them.
+ * \param[in] elements Number of elements, for example the width of an image.
+ * \param[in] elementsPerWorkItem Number of elements each work item processes.
+ * \return The number of elements divided by elementsPerWorkItem, rounded up.
+ */
+inline size_t coveringWorksize(size_t elements, size_t elementsPerWorkItem)
+{
+    return (elements + elementsPerWorkItem - 1) / elementsPerWorkItem;
+}
+
+/**
+ * \brief Check a kernel with signature Signature takes no arguments.
+ * \details Fails to compile if Signature declares arguments.
+ * \param[in] binding The binding of the kernel.
+ * \return False if an error occurred, otherwise true.
+ */
+template <typename Signature>
+bool setKernelArguments(KernelBinding* binding)
+{
+    (void)sizeof(KernelSignatureArityCheck<KernelSignatureArity<Signature>::value == 0>);
+    return checkKernelBindingArity(binding, 0);
+}
+
+/**
+ * \brief Set the argument of a kernel with signature Signature, unless it has not changed.
+ * \details Fails to compile if Signature does not declare exactly 1 argument, or if an argument does not convert to its declared type.
+ * \param[in,out] binding The binding of the kernel.
+ * \param[in] argument0 Value of argument 0.
+ * \return False if an error occurred, otherwise true.
+ */
+template <typename Signature>
+bool setKernelArguments(KernelBinding* binding,
+                        const typename Signature::Argument0& argument0)
+{
+    (void)sizeof(KernelSignatureArityCheck<KernelSignatureArity<Signature>::value == 1>);
+    if (!checkKernelBindingArity(binding, 1))
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 0, argument0);
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief Set the 2 arguments of a kernel with signature Signature, skipping the ones which have not changed.
+ * \details Fails to compile if Signature does not declare 2 arguments, or if an argument does not convert to its declared type.
+ * \param[in,out] binding The binding of the kernel.
+ * \param[in] argument0 Value of argument 0.
+ * \param[in] argument1 Value of argument 1.
+ * \return False if an error occurred, otherwise true.
+ */
+template <typename Signature>
+bool setKernelArguments(KernelBinding* binding,
+                        const typename Signature::Argument0& argument0,
+                        const typename Signature::Argument1& argument1)
+{
+    (void)sizeof(KernelSignatureArityCheck<KernelSignatureArity<Signature>::value == 2>);
+    if (!checkKernelBindingArity(binding, 2))
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 0, argument0);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 1, argument1);
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief Set the 3 arguments of a kernel with signature Signature, skipping the ones which have not changed.
+ * \details Fails to compile if Signature does not declare 3 arguments, or if an argument does not convert to its declared type.
+ * \param[in,out] binding The binding of the kernel.
+ * \param[in] argument0 Value of argument 0.
+ * \param[in] argument1 Value of argument 1.
+ * \param[in] argument2 Value of argument 2.
+ * \return False if an error occurred, otherwise true.
+ */
+template <typename Signature>
+bool setKernelArguments(KernelBinding* binding,
+                        const typename Signature::Argument0& argument0,
+                        const typename Signature::Argument1& argument1,
+                        const typename Signature::Argument2& argument2)
+{
+    (void)sizeof(KernelSignatureArityCheck<KernelSignatureArity<Signature>::value == 3>);
+    if (!checkKernelBindingArity(binding, 3))
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 0, argument0);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 1, argument1);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 2, argument2);
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief Set the 4 arguments of a kernel with signature Signature, skipping the ones which have not changed.
+ * \details Fails to compile if Signature does not declare 4 arguments, or if an argument does not convert to its declared type.
+ * \param[in,out] binding The binding of the kernel.
+ * \param[in] argument0 Value of argument 0.
+ * \param[in] argument1 Value of argument 1.
+ * \param[in] argument2 Value of argument 2.
+ * \param[in] argument3 Value of argument 3.
+ * \return False if an error occurred, otherwise true.
+ */
+template <typename Signature>
+bool setKernelArguments(KernelBinding* binding,
+                        const typename Signature::Argument0& argument0,
+                        const typename Signature::Argument1& argument1,
+                        const typename Signature::Argument2& argument2,
+                        const typename Signature::Argument3& argument3)
+{
+    (void)sizeof(KernelSignatureArityCheck<KernelSignatureArity<Signature>::value == 4>);
+    if (!checkKernelBindingArity(binding, 4))
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 0, argument0);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 1, argument1);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 2, argument2);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 3, argument3);
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief Set the 5 arguments of a kernel with signature Signature, skipping the ones which have not changed.
+ * \details Fails to compile if Signature does not declare 5 arguments, or if an argument does not convert to its declared type.
+ * \param[in,out] binding The binding of the kernel.
+ * \param[in] argument0 Value of argument 0.
+ * \param[in] argument1 Value of argument 1.
+ * \param[in] argument2 Value of argument 2.
+ * \param[in] argument3 Value of argument 3.
+ * \param[in] argument4 Value of argument 4.
+ * \return False if an error occurred, otherwise true.
+ */
+template <typename Signature>
+bool setKernelArguments(KernelBinding* binding,
+                        const typename Signature::Argument0& argument0,
+                        const typename Signature::Argument1& argument1,
+                        const typename Signature::Argument2& argument2,
+                        const typename Signature::Argument3& argument3,
+                        const typename Signature::Argument4& argument4)
+{
+    (void)sizeof(KernelSignatureArityCheck<KernelSignatureArity<Signature>::value == 5>);
+    if (!checkKernelBindingArity(binding, 5))
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 0, argument0);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 1, argument1);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 2, argument2);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 3, argument3);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 4, argument4);
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief Set the 6 arguments of a kernel with signature Signature, skipping the ones which have not changed.
+ * \details Fails to compile if Signature does not declare 6 arguments, or if an argument does not convert to its declared type.
+ * \param[in,out] binding The binding of the kernel.
+ * \param[in] argument0 Value of argument 0.
+ * \param[in] argument1 Value of argument 1.
+ * \param[in] argument2 Value of argument 2.
+ * \param[in] argument3 Value of argument 3.
+ * \param[in] argument4 Value of argument 4.
+ * \param[in] argument5 Value of argument 5.
+ * \return False if an error occurred, otherwise true.
+ */
+template <typename Signature>
+bool setKernelArguments(KernelBinding* binding,
+                        const typename Signature::Argument0& argument0,
+                        const typename Signature::Argument1& argument1,
+                        const typename Signature::Argument2& argument2,
+                        const typename Signature::Argument3& argument3,
+                        const typename Signature::Argument4& argument4,
+                        const typename Signature::Argument5& argument5)
+{
+    (void)sizeof(KernelSignatureArityCheck<KernelSignatureArity<Signature>::value == 6>);
+    if (!checkKernelBindingArity(binding, 6))
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 0, argument0);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 1, argument1);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 2, argument2);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 3, argument3);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 4, argument4);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 5, argument5);
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief Set the 7 arguments of a kernel with signature Signature, skipping the ones which have not changed.
+ * \details Fails to compile if Signature does not declare 7 arguments, or if an argument does not convert to its declared type.
+ * \param[in,out] binding The binding of the kernel.
+ * \param[in] argument0 Value of argument 0.
+ * \param[in] argument1 Value of argument 1.
+ * \param[in] argument2 Value of argument 2.
+ * \param[in] argument3 Value of argument 3.
+ * \param[in] argument4 Value of argument 4.
+ * \param[in] argument5 Value of argument 5.
+ * \param[in] argument6 Value of argument 6.
+ * \return False if an error occurred, otherwise true.
+ */
+template <typename Signature>
+bool setKernelArguments(KernelBinding* binding,
+                        const typename Signature::Argument0& argument0,
+                        const typename Signature::Argument1& argument1,
+                        const typename Signature::Argument2& argument2,
+                        const typename Signature::Argument3& argument3,
+                        const typename Signature::Argument4& argument4,
+                        const typename Signature::Argument5& argument5,
+                        const typename Signature::Argument6& argument6)
+{
+    (void)sizeof(KernelSignatureArityCheck<KernelSignatureArity<Signature>::value == 7>);
+    if (!checkKernelBindingArity(binding, 7))
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 0, argument0);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 1, argument1);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 2, argument2);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 3, argument3);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 4, argument4);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 5, argument5);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 6, argument6);
+    return setKernelArgumentsSuccess;
+}
+
+/**
+ * \brief Set the 8 arguments of a kernel with signature Signature, skipping the ones which have not changed.
+ * \details Fails to compile if Signature does not declare 8 arguments, or if an argument does not convert to its declared type.
+ * \param[in,out] binding The binding of the kernel.
+ * \param[in] argument0 Value of argument 0.
+ * \param[in] argument1 Value of argument 1.
+ * \param[in] argument2 Value of argument 2.
+ * \param[in] argument3 Value of argument 3.
+ * \param[in] argument4 Value of argument 4.
+ * \param[in] argument5 Value of argument 5.
+ * \param[in] argument6 Value of argument 6.
+ * \param[in] argument7 Value of argument 7.
+ * \return False if an error occurred, otherwise true.
+ */
+template <typename Signature>
+bool setKernelArguments(KernelBinding* binding,
+                        const typename Signature::Argument0& argument0,
+                        const typename Signature::Argument1& argument1,
+                        const typename Signature::Argument2& argument2,
+                        const typename Signature::Argument3& argument3,
+                        const typename Signature::Argument4& argument4,
+                        const typename Signature::Argument5& argument5,
+                        const typename Signature::Argument6& argument6,
+                        const typename Signature::Argument7& argument7)
+{
+    (void)sizeof(KernelSignatureArityCheck<KernelSignatureArity<Signature>::value == 8>);
+    if (!checkKernelBindingArity(binding, 8))
+    {
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 0, argument0);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 1, argument1);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 2, argument2);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 3, argument3);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 4, argument4);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 5, argument5);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 6, argument6);
+    setKernelArgumentsSuccess &= setKernelBindingValue(binding, 7, argument7);
+    return setKernelArgumentsSuccess;
+}
+
+#endif
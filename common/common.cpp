@@ -9,9 +9,11 @@
  */
 
 #include "common.h"
+#include "device.h"
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <vector>
 
 using namespace std;
 
@@ -56,21 +58,13 @@ bool printProfilingInfo(cl_event event)
 
 bool printSupported2DImageFormats(cl_context context)
 {
-    /* Get the number of supported image formats in order to allocate the correct amount of memory. */
-    cl_uint numberOfImageFormats;
-    if (!checkSuccess(clGetSupportedImageFormats(context, 0, CL_MEM_OBJECT_IMAGE2D, 0, NULL, &numberOfImageFormats)))
+    /* The list is cached, so later format checks don't query the context again. */
+    const vector<cl_image_format>* imageFormats = NULL;
+    if (!getSupported2DImageFormats(context, &imageFormats))
     {
-        cerr << "Getting the number of supported 2D image formats failed. " << __FILE__ << ":"<< __LINE__ << endl;
-        return false;
-    }
-
-    /* Get the list of supported image formats. */
-    cl_image_format* imageFormats = new cl_image_format[numberOfImageFormats];
-    if (!checkSuccess(clGetSupportedImageFormats(context, 0, CL_MEM_OBJECT_IMAGE3D, numberOfImageFormats, imageFormats, NULL)))
-    {
-        cerr << "Getting the list of supported 2D image formats failed. " << __FILE__ << ":"<< __LINE__ << endl;
         return false;
     }
+    const size_t numberOfImageFormats = imageFormats->size();
 
     cout << numberOfImageFormats << " Image formats supported";
 
@@ -85,11 +79,9 @@ bool printSupported2DImageFormats(cl_context context)
 
     for (unsigned int i = 0; i < numberOfImageFormats; i++)
     {
-        cout << imageChannelOrderToString(imageFormats[i].image_channel_order) << ", " << imageChannelDataTypeToString(imageFormats[i].image_channel_data_type) << endl;
+        cout << imageChannelOrderToString((*imageFormats)[i].image_channel_order) << ", " << imageChannelDataTypeToString((*imageFormats)[i].image_channel_data_type) << endl;
     }
 
-    delete[] imageFormats;
-
     return true;
 }
 
@@ -172,6 +164,9 @@ bool cleanUpOpenCL(cl_context context, cl_command_queue commandQueue, cl_program
     bool returnValue = true;
     if (context != 0)
     {
+        /* The cached image formats are keyed by a handle the driver can reuse for the next context. */
+        invalidateImageFormats(context);
+
         if (!checkSuccess(clReleaseContext(context)))
         {
             cerr << "Releasing the OpenCL context failed. " << __FILE__ << ":"<< __LINE__ << endl;
@@ -295,9 +290,27 @@ bool createCommandQueue(cl_context context, cl_command_queue* commandQueue, cl_d
     return true;
 }
 
-bool createProgram(cl_context context, cl_device_id device, string filename, cl_program* program)
+/* Sources embedded in the executable, looked up by createProgram before it opens a file. */
+static const EmbeddedSource* embeddedSources = NULL;
+static int numberOfEmbeddedSources = 0;
+
+bool registerEmbeddedSources(const EmbeddedSource* sources, int numberOfSources)
 {
-    cl_int errorNumber = 0;
+    embeddedSources = sources;
+    numberOfEmbeddedSources = numberOfSources;
+    return true;
+}
+
+bool createProgram(cl_context context, cl_device_id device, string filename, cl_program* program, string buildOptions)
+{
+    for (int index = 0; index < numberOfEmbeddedSources; index++)
+    {
+        if (filename == embeddedSources[index].filename)
+        {
+            return createProgramFromSource(context, device, embeddedSources[index].source, embeddedSources[index].length, program, buildOptions);
+        }
+    }
+
     ifstream kernelFile(filename.c_str(), ios::in);
 
     if(!kernelFile.is_open())
@@ -313,9 +326,15 @@ bool createProgram(cl_context context, cl_device_id device, string filename, cl_
     ostringstream outputStringStream;
     outputStringStream << kernelFile.rdbuf();
     string srcStdStr = outputStringStream.str();
-    const char* charSource = srcStdStr.c_str();
 
-    *program = clCreateProgramWithSource(context, 1, &charSource, NULL, &errorNumber);
+    return createProgramFromSource(context, device, srcStdStr.c_str(), srcStdStr.size(), program, buildOptions);
+}
+
+bool createProgramFromSource(cl_context context, cl_device_id device, const char* source, size_t length, cl_program* program, string buildOptions)
+{
+    cl_int errorNumber = 0;
+
+    *program = clCreateProgramWithSource(context, 1, &source, &length, &errorNumber);
     if (!checkSuccess(errorNumber) || program == NULL)
     {
         cerr << "Failed to create OpenCL program. " << __FILE__ << ":"<< __LINE__ << endl;
@@ -323,7 +342,7 @@ bool createProgram(cl_context context, cl_device_id device, string filename, cl_
     }
 
     /* Try to build the OpenCL program. */
-    bool buildSuccess = checkSuccess(clBuildProgram(*program, 0, NULL, NULL, NULL, NULL));
+    bool buildSuccess = checkSuccess(clBuildProgram(*program, 0, NULL, buildOptions.empty() ? NULL : buildOptions.c_str(), NULL, NULL));
 
     /* Get the size of the build log. */
     size_t logSize = 0;
@@ -471,40 +490,11 @@ string errorNumberToString(cl_int errorNumber)
 
 bool isExtensionSupported(cl_device_id device, string extension)
 {
-    if (extension.empty())
+    const DeviceInfo* deviceInfo = NULL;
+    if (extension.empty() || !getDeviceInfo(device, &deviceInfo))
     {
         return false;
     }
 
-    /* First find out how large the ouput of the OpenCL device query will be. */
-    size_t extensionsReturnSize = 0;
-    if (!checkSuccess(clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, 0, NULL, &extensionsReturnSize)))
-    {
-        cerr << "Failed to get return size from clGetDeviceInfo for parameter CL_DEVICE_EXTENSIONS. " << __FILE__ << ":"<< __LINE__ << endl;
-        return false;
-    }
-
-    /* Allocate enough memory for the output. */
-    char* extensions = new char[extensionsReturnSize];
-
-    /* Get the list of all extensions supported. */
-    if (!checkSuccess(clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, extensionsReturnSize, extensions, NULL)))
-    {
-        cerr << "Failed to get data from clGetDeviceInfo for parameter CL_DEVICE_EXTENSIONS. " << __FILE__ << ":"<< __LINE__ << endl;
-        delete [] extensions;
-        return false;
-    }
-
-    /* See if the requested extension is in the list. */
-    string* extensionsString = new string(extensions);
-    bool returnResult = false;
-    if (extensionsString->find(extension) != string::npos)
-    {
-        returnResult = true;
-    }
-
-    delete [] extensions;
-    delete extensionsString;
-
-    return returnResult;
+    return hasExtension(deviceInfo, extension);
 }
@@ -53,6 +53,7 @@ std::string imageChannelDataTypeToString(cl_channel_type channelDataType);
 /**
  * \brief Release any OpenCL objects that have been created.
  * \details If any of the OpenCL objects passed in are not NULL, they will be freed using the appropriate OpenCL function.
+ *          The cached image formats of the context are forgotten (see invalidateImageFormats in device.h).
  * \return False if an error occurred, otherwise true.
  */
 bool cleanUpOpenCL(cl_context context, cl_command_queue commandQueue, cl_program program, cl_kernel kernel, cl_mem* memoryObjects, int numberOfMemoryObjects);
@@ -75,13 +76,46 @@ bool createCommandQueue(cl_context context, cl_command_queue* commandQueue, cl_d
 
 /**
  * \brief Create an OpenCL program from a given file and compile it.
+ * \details If the file was embedded in the executable (see registerEmbeddedSources), the embedded source is used and the file is not read.
  * \param[in] context The OpenCL context in use.
  * \param[in] device The OpenCL device to compile the kernel for.
  * \param[in] filename Name of the file containing the OpenCL kernel code to load.
  * \param[out] program The created OpenCL program object.
+ * \param[in] buildOptions Options passed to clBuildProgram, for example preprocessor definitions (-D name=value).
  * \return False if an error occurred, otherwise true.
  */
-bool createProgram(cl_context context, cl_device_id device, std::string filename, cl_program* program);
+bool createProgram(cl_context context, cl_device_id device, std::string filename, cl_program* program, std::string buildOptions = "");
+
+/**
+ * \brief An OpenCL C source compiled into the executable.
+ */
+struct EmbeddedSource
+{
+    const char* filename; /**< \brief File name the source was embedded from, as passed to createProgram. */
+    const char* source; /**< \brief The source text. */
+    size_t length; /**< \brief Length of the source in bytes. */
+};
+
+/**
+ * \brief Make embedded sources available to createProgram in place of their files.
+ * \details Called by the embedded_sources.cpp generated by tools/embed_sources when a sample is built with EMBED_KERNELS=1.
+ * \param[in] sources The sources. They must stay valid for the lifetime of the program.
+ * \param[in] numberOfSources Number of sources.
+ * \return True, so that the call can initialize a static variable.
+ */
+bool registerEmbeddedSources(const EmbeddedSource* sources, int numberOfSources);
+
+/**
+ * \brief Create an OpenCL program from source text in memory and compile it.
+ * \param[in] context The OpenCL context in use.
+ * \param[in] device The OpenCL device to compile the kernel for.
+ * \param[in] source The OpenCL C source.
+ * \param[in] length Length of the source in bytes.
+ * \param[out] program The created OpenCL program object.
+ * \param[in] buildOptions Options passed to clBuildProgram, for example preprocessor definitions (-D name=value).
+ * \return False if an error occurred, otherwise true.
+ */
+bool createProgramFromSource(cl_context context, cl_device_id device, const char* source, size_t length, cl_program* program, std::string buildOptions = "");
 
 /**
  * \brief Convert OpenCL error numbers to their string form.
@@ -101,6 +135,7 @@ bool checkSuccess(cl_int errorNumber);
 
 /**
  * \brief Query an OpenCL device to see if it supports an extension.
+ * \details Looks the name up in the cached capabilities of the device (see device.h), matching whole extension names only.
  * \param[in] device The device to query.
  * \param[in] extension The string name of the extension to query for.
  * \return True if the extension is supported on the given device, false otherwise.
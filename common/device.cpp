@@ -0,0 +1,183 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "device.h"
+#include "common.h"
+
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <pthread.h>
+
+using namespace std;
+
+/* Capabilities of the devices queried so far. */
+static map<cl_device_id, DeviceInfo> deviceInfoCache;
+
+/* 2D image formats of the contexts queried so far. */
+static map<cl_context, vector<cl_image_format> > imageFormatCache;
+
+/* Guards both caches. The driver is queried without holding it. */
+static pthread_mutex_t cacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * \brief Get a string property of a device.
+ * \param[in] device The device to query.
+ * \param[in] parameter The property, for example CL_DEVICE_NAME.
+ * \param[out] value The value.
+ * \return False if an error occurred, otherwise true.
+ */
+static bool getDeviceInfoString(cl_device_id device, cl_device_info parameter, string* value)
+{
+    size_t size = 0;
+    if (!checkSuccess(clGetDeviceInfo(device, parameter, 0, NULL, &size)))
+    {
+        return false;
+    }
+    vector<char> characters(size + 1, '\0');
+    if (size > 0 && !checkSuccess(clGetDeviceInfo(device, parameter, size, &characters[0], NULL)))
+    {
+        return false;
+    }
+    *value = &characters[0];
+    return true;
+}
+
+bool getDeviceInfo(cl_device_id device, const DeviceInfo** deviceInfo)
+{
+    pthread_mutex_lock(&cacheMutex);
+    map<cl_device_id, DeviceInfo>::iterator cached = deviceInfoCache.find(device);
+    if (cached != deviceInfoCache.end())
+    {
+        *deviceInfo = &cached->second;
+        pthread_mutex_unlock(&cacheMutex);
+        return true;
+    }
+    pthread_mutex_unlock(&cacheMutex);
+
+    DeviceInfo info;
+    info.device = device;
+
+    bool queryInfoSuccess = true;
+    string extensions;
+    queryInfoSuccess &= getDeviceInfoString(device, CL_DEVICE_NAME, &info.name);
+    queryInfoSuccess &= getDeviceInfoString(device, CL_DRIVER_VERSION, &info.driverVersion);
+    queryInfoSuccess &= getDeviceInfoString(device, CL_DEVICE_EXTENSIONS, &extensions);
+
+    cl_uint workItemDimensions = 0;
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(size_t), &info.maximumWorkGroupSize, NULL));
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS, sizeof(cl_uint), &workItemDimensions, NULL));
+    info.maximumWorkItemSizes.assign(workItemDimensions, 0);
+    if (workItemDimensions > 0)
+    {
+        queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES, workItemDimensions * sizeof(size_t), &info.maximumWorkItemSizes[0], NULL));
+    }
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(cl_ulong), &info.localMemorySize, NULL));
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(cl_ulong), &info.globalMemorySize, NULL));
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(cl_uint), &info.computeUnits, NULL));
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(cl_uint), &info.memoryBaseAddressAlignment, NULL));
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_IMAGE_SUPPORT, sizeof(cl_bool), &info.imageSupport, NULL));
+
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR, sizeof(cl_uint), &info.preferredVectorWidthChar, NULL));
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT, sizeof(cl_uint), &info.preferredVectorWidthShort, NULL));
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT, sizeof(cl_uint), &info.preferredVectorWidthInt, NULL));
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_LONG, sizeof(cl_uint), &info.preferredVectorWidthLong, NULL));
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT, sizeof(cl_uint), &info.preferredVectorWidthFloat, NULL));
+    queryInfoSuccess &= checkSuccess(clGetDeviceInfo(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE, sizeof(cl_uint), &info.preferredVectorWidthDouble, NULL));
+
+    if (!queryInfoSuccess)
+    {
+        cerr << "Failed to query the device capabilities. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* CL_DEVICE_EXTENSIONS is a space separated list of names. */
+    istringstream names(extensions);
+    string name;
+    while (names >> name)
+    {
+        info.extensions.insert(name);
+    }
+
+    /* Another thread may have queried the same device meanwhile, in which case its entry is kept. */
+    pthread_mutex_lock(&cacheMutex);
+    *deviceInfo = &deviceInfoCache.insert(make_pair(device, info)).first->second;
+    pthread_mutex_unlock(&cacheMutex);
+    return true;
+}
+
+bool hasExtension(const DeviceInfo* deviceInfo, const string& extension)
+{
+    return deviceInfo->extensions.find(extension) != deviceInfo->extensions.end();
+}
+
+bool getSupported2DImageFormats(cl_context context, const vector<cl_image_format>** imageFormats)
+{
+    pthread_mutex_lock(&cacheMutex);
+    map<cl_context, vector<cl_image_format> >::iterator cached = imageFormatCache.find(context);
+    if (cached != imageFormatCache.end())
+    {
+        *imageFormats = &cached->second;
+        pthread_mutex_unlock(&cacheMutex);
+        return true;
+    }
+    pthread_mutex_unlock(&cacheMutex);
+
+    cl_uint numberOfImageFormats = 0;
+    if (!checkSuccess(clGetSupportedImageFormats(context, CL_MEM_READ_WRITE, CL_MEM_OBJECT_IMAGE2D, 0, NULL, &numberOfImageFormats)))
+    {
+        cerr << "Getting the number of supported 2D image formats failed. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    vector<cl_image_format> formats(numberOfImageFormats);
+    if (numberOfImageFormats > 0 &&
+        !checkSuccess(clGetSupportedImageFormats(context, CL_MEM_READ_WRITE, CL_MEM_OBJECT_IMAGE2D, numberOfImageFormats, &formats[0], NULL)))
+    {
+        cerr << "Getting the list of supported 2D image formats failed. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    pthread_mutex_lock(&cacheMutex);
+    pair<map<cl_context, vector<cl_image_format> >::iterator, bool> inserted = imageFormatCache.insert(make_pair(context, vector<cl_image_format>()));
+    if (inserted.second)
+    {
+        inserted.first->second.swap(formats);
+    }
+    *imageFormats = &inserted.first->second;
+    pthread_mutex_unlock(&cacheMutex);
+    return true;
+}
+
+bool isImageFormatSupported(cl_context context, const cl_image_format& format)
+{
+    const vector<cl_image_format>* imageFormats = NULL;
+    if (!getSupported2DImageFormats(context, &imageFormats))
+    {
+        return false;
+    }
+
+    for (size_t index = 0; index < imageFormats->size(); index++)
+    {
+        if ((*imageFormats)[index].image_channel_order == format.image_channel_order &&
+            (*imageFormats)[index].image_channel_data_type == format.image_channel_data_type)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void invalidateImageFormats(cl_context context)
+{
+    pthread_mutex_lock(&cacheMutex);
+    imageFormatCache.erase(context);
+    pthread_mutex_unlock(&cacheMutex);
+}
@@ -0,0 +1,103 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <CL/cl.h>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * \file device.h
+ * \brief Device capabilities, queried once per device.
+ * \details Helpers and kernel variant selection ask the same questions of a device many times.
+ *          The first call to getDeviceInfo for a device queries everything below from the driver;
+ *          later calls return the cached answers. The caches can be used from any thread.
+ *          Devices belong to the platform and are not released with a context, so their capabilities are kept for the whole process.
+ *          Image formats are kept per context, whose handle the driver can reuse once it is released,
+ *          so they must be forgotten with invalidateImageFormats by the owner of the context; cleanUpOpenCL does this.
+ */
+
+/**
+ * \brief The capabilities of a device.
+ */
+struct DeviceInfo
+{
+    cl_device_id device;
+    std::string name;
+    /** CL_DRIVER_VERSION. */
+    std::string driverVersion;
+    /** The names in CL_DEVICE_EXTENSIONS. */
+    std::set<std::string> extensions;
+
+    size_t maximumWorkGroupSize;
+    /** CL_DEVICE_MAX_WORK_ITEM_SIZES, one entry per dimension. */
+    std::vector<size_t> maximumWorkItemSizes;
+    cl_ulong localMemorySize;
+    cl_ulong globalMemorySize;
+    cl_uint computeUnits;
+    /** CL_DEVICE_MEM_BASE_ADDR_ALIGN, in bits. */
+    cl_uint memoryBaseAddressAlignment;
+    cl_bool imageSupport;
+
+    cl_uint preferredVectorWidthChar;
+    cl_uint preferredVectorWidthShort;
+    cl_uint preferredVectorWidthInt;
+    cl_uint preferredVectorWidthLong;
+    cl_uint preferredVectorWidthFloat;
+    cl_uint preferredVectorWidthDouble;
+};
+
+/**
+ * \brief Get the capabilities of a device.
+ * \details Queries the device on the first call, and returns the cached values afterwards.
+ * \param[in] device The device to query.
+ * \param[out] deviceInfo The capabilities. Valid for the whole process.
+ * \return False if an error occurred, otherwise true.
+ */
+bool getDeviceInfo(cl_device_id device, const DeviceInfo** deviceInfo);
+
+/**
+ * \brief See if a device supports an extension.
+ * \details Compares whole extension names, so "cl_khr_fp16" does not match "cl_khr_fp16_extra".
+ * \param[in] deviceInfo The capabilities of the device.
+ * \param[in] extension The name of the extension.
+ * \return True if the extension is supported, false otherwise.
+ */
+bool hasExtension(const DeviceInfo* deviceInfo, const std::string& extension);
+
+/**
+ * \brief Get the 2D image formats a context supports.
+ * \details Queries the context on the first call, and returns the cached list afterwards.
+ * \param[in] context The context to query.
+ * \param[out] imageFormats The formats, for images with CL_MEM_READ_WRITE. Valid until invalidateImageFormats is called for the context.
+ * \return False if an error occurred, otherwise true.
+ */
+bool getSupported2DImageFormats(cl_context context, const std::vector<cl_image_format>** imageFormats);
+
+/**
+ * \brief See if a context supports a 2D image format.
+ * \param[in] context The context to query.
+ * \param[in] format The image format.
+ * \return True if the format is supported, false otherwise or if an error occurred.
+ */
+bool isImageFormatSupported(cl_context context, const cl_image_format& format);
+
+/**
+ * \brief Forget the cached image formats of a context.
+ * \details Call when releasing a context you created, before its handle can be reused. Pointers returned for it are no longer valid,
+ *          and the formats are queried again if the context is asked about later.
+ * \param[in] context The context.
+ */
+void invalidateImageFormats(cl_context context);
+
+#endif
@@ -9,6 +9,8 @@
  */
 
 #include "image.h"
+#include "parallel.h"
+#include "trace.h"
 #include <fstream>
 #include <iostream>
 
@@ -16,6 +18,8 @@ using namespace std;
 
 bool saveToBitmap(string filename, int width, int height, const unsigned char* imageData)
 {
+    TraceSpan span("saveToBitmap");
+
     /* Try and open the file for writing. */
     fstream imageFile(filename.c_str(), ios::out);
     if(!imageFile.is_open())
@@ -114,6 +118,8 @@ bool saveToBitmap(string filename, int width, int height, const unsigned char* i
 
 bool loadFromBitmap(const string filename, int* const width, int* const height, unsigned char **imageData)
 {
+    TraceSpan span("loadFromBitmap");
+
      /* Try and open the file for reading. */
     ifstream imageFile(filename.c_str(), ios::in);
     if(!imageFile.is_open())
@@ -240,8 +246,153 @@ bool loadFromBitmap(const string filename, int* const width, int* const height,
     return true;
 }
 
+/* Pixels per chunk of the conversion loops, enough that a chunk costs much more than handing it to a thread. */
+static const size_t conversionGrainSize = 16384;
+
+/**
+ * \brief Number of pixels of an image, zero if either size is negative.
+ */
+static size_t numberOfPixels(int width, int height)
+{
+    return width > 0 && height > 0 ? (size_t)width * height : 0;
+}
+
+/**
+ * \brief The buffers of a conversion, shared by the host threads converting it.
+ */
+struct ConversionBuffers
+{
+    const unsigned char* input;
+    unsigned char* output;
+};
+
+/**
+ * \brief Convert a range of pixels from luminance to RGB.
+ * \param[in] userData The ConversionBuffers.
+ * \param[in] begin First pixel.
+ * \param[in] end One past the last pixel.
+ */
+static void convertLuminanceToRGB(void* userData, size_t begin, size_t end)
+{
+    const ConversionBuffers* buffers = (const ConversionBuffers*)userData;
+    for (size_t n = begin; n < end; n++)
+    {
+        unsigned char d = buffers->input[n];
+        buffers->output[3 * n + 0] = d;
+        buffers->output[3 * n + 1] = d;
+        buffers->output[3 * n + 2] = d;
+    }
+}
+
+/**
+ * \brief Convert a range of pixels from RGB to luminance.
+ * \param[in] userData The ConversionBuffers.
+ * \param[in] begin First pixel.
+ * \param[in] end One past the last pixel.
+ */
+static void convertRGBToLuminance(void* userData, size_t begin, size_t end)
+{
+    const ConversionBuffers* buffers = (const ConversionBuffers*)userData;
+    for (size_t n = begin; n < end; n++)
+    {
+        float r = buffers->input[3 * n + 0];
+        float g = buffers->input[3 * n + 1];
+        float b = buffers->input[3 * n + 2];
+        buffers->output[n] = (unsigned char) (0.2126f * r + 0.7152f * g + 0.0722f * b);
+    }
+}
+
+/**
+ * \brief Convert a range of pixels from RGB to RGBA.
+ * \param[in] userData The ConversionBuffers.
+ * \param[in] begin First pixel.
+ * \param[in] end One past the last pixel.
+ */
+static void convertRGBToRGBA(void* userData, size_t begin, size_t end)
+{
+    const ConversionBuffers* buffers = (const ConversionBuffers*)userData;
+    for (size_t n = begin; n < end; n++)
+    {
+        /* Copy the RGB components directly. */
+        buffers->output[4 * n + 0] = buffers->input[3 * n + 0];
+        buffers->output[4 * n + 1] = buffers->input[3 * n + 1];
+        buffers->output[4 * n + 2] = buffers->input[3 * n + 2];
+
+        /* Set the alpha channel to 255 (fully opaque). */
+        buffers->output[4 * n + 3] = (unsigned char)255;
+    }
+}
+
+/**
+ * \brief Convert a range of pixels from RGBA to RGB.
+ * \param[in] userData The ConversionBuffers.
+ * \param[in] begin First pixel.
+ * \param[in] end One past the last pixel.
+ */
+static void convertRGBAToRGB(void* userData, size_t begin, size_t end)
+{
+    const ConversionBuffers* buffers = (const ConversionBuffers*)userData;
+    for (size_t n = begin; n < end; n++)
+    {
+        /* Copy the RGB components but throw away the alpha channel. */
+        buffers->output[3 * n + 0] = buffers->input[4 * n + 0];
+        buffers->output[3 * n + 1] = buffers->input[4 * n + 1];
+        buffers->output[3 * n + 2] = buffers->input[4 * n + 2];
+    }
+}
+
+/**
+ * \brief The buffers of a conversion from luminance to floats, shared by the host threads converting it.
+ */
+struct LuminanceToFloatBuffers
+{
+    const unsigned char* input;
+    float* output;
+};
+
+/**
+ * \brief The buffers of a conversion from floats to luminance, shared by the host threads converting it.
+ */
+struct FloatToLuminanceBuffers
+{
+    const float* input;
+    unsigned char* output;
+};
+
+/**
+ * \brief Convert a range of pixels from luminance to normalized floats.
+ * \param[in] userData The LuminanceToFloatBuffers.
+ * \param[in] begin First pixel.
+ * \param[in] end One past the last pixel.
+ */
+static void convertLuminanceToFloat(void* userData, size_t begin, size_t end)
+{
+    const LuminanceToFloatBuffers* buffers = (const LuminanceToFloatBuffers*)userData;
+    for (size_t n = begin; n < end; n++)
+    {
+        buffers->output[n] = (float)buffers->input[n] / 255.0f;
+    }
+}
+
+/**
+ * \brief Convert a range of pixels from normalized floats to luminance.
+ * \param[in] userData The FloatToLuminanceBuffers.
+ * \param[in] begin First pixel.
+ * \param[in] end One past the last pixel.
+ */
+static void convertFloatToLuminance(void* userData, size_t begin, size_t end)
+{
+    const FloatToLuminanceBuffers* buffers = (const FloatToLuminanceBuffers*)userData;
+    for (size_t n = begin; n < end; n++)
+    {
+        buffers->output[n] = (unsigned char)(buffers->input[n] * 255.0f);
+    }
+}
+
 bool luminanceToRGB(const unsigned char* luminanceData, unsigned char* rgbData, int width, int height)
 {
+    TraceSpan span("luminanceToRGB");
+
     if (luminanceData == NULL)
     {
         cerr << "luminanceData cannot be NULL. " << __FILE__ << ":"<< __LINE__ << endl;
@@ -254,18 +405,15 @@ bool luminanceToRGB(const unsigned char* luminanceData, unsigned char* rgbData,
         return false;
     }
 
-    for (int n = width * height - 1; n >= 0; --n)
-    {
-        unsigned char d = luminanceData[n];
-        rgbData[3 * n + 0] = d;
-        rgbData[3 * n + 1] = d;
-        rgbData[3 * n + 2] = d;
-    }
+    ConversionBuffers buffers = {luminanceData, rgbData};
+    parallelFor(0, numberOfPixels(width, height), conversionGrainSize, convertLuminanceToRGB, &buffers);
     return true;
 }
 
 bool RGBToLuminance(const unsigned char* const rgbData, unsigned char* const luminanceData, int width, int height)
 {
+    TraceSpan span("RGBToLuminance");
+
     if (rgbData == NULL)
     {
         cerr << "rgbData cannot be NULL. " << __FILE__ << ":"<< __LINE__ << endl;
@@ -278,18 +426,15 @@ bool RGBToLuminance(const unsigned char* const rgbData, unsigned char* const lum
         return false;
     }
 
-    for (int n = width * height - 1; n >= 0; --n)
-    {
-        float r = rgbData[3 * n + 0];
-        float g = rgbData[3 * n + 1];
-        float b = rgbData[3 * n + 2];
-        luminanceData[n] = (unsigned char) (0.2126f * r + 0.7152f * g + 0.0722f * b);
-    }
+    ConversionBuffers buffers = {rgbData, luminanceData};
+    parallelFor(0, numberOfPixels(width, height), conversionGrainSize, convertRGBToLuminance, &buffers);
     return true;
 }
 
 bool RGBToRGBA(const unsigned char* const rgbData, unsigned char* const rgbaData, int width, int height)
 {
+    TraceSpan span("RGBToRGBA");
+
     if (rgbData == NULL)
     {
         cerr << "rgbData cannot be NULL. " << __FILE__ << ":"<< __LINE__ << endl;
@@ -302,21 +447,15 @@ bool RGBToRGBA(const unsigned char* const rgbData, unsigned char* const rgbaData
         return false;
     }
 
-    for (int n = 0; n < width * height; n++)
-    {
-        /* Copy the RGB components directly. */
-        rgbaData[4 * n + 0] = rgbData[3 * n + 0];
-        rgbaData[4 * n + 1] = rgbData[3 * n + 1];
-        rgbaData[4 * n + 2] = rgbData[3 * n + 2];
-
-        /* Set the alpha channel to 255 (fully opaque). */
-        rgbaData[4 * n + 3] = (unsigned char)255;
-    }
+    ConversionBuffers buffers = {rgbData, rgbaData};
+    parallelFor(0, numberOfPixels(width, height), conversionGrainSize, convertRGBToRGBA, &buffers);
     return true;
 }
 
 bool RGBAToRGB(const unsigned char* const rgbaData, unsigned char* const rgbData, int width, int height)
 {
+    TraceSpan span("RGBAToRGB");
+
     if (rgbaData == NULL)
     {
         cerr << "rgbaData cannot be NULL. " << __FILE__ << ":"<< __LINE__ << endl;
@@ -329,12 +468,49 @@ bool RGBAToRGB(const unsigned char* const rgbaData, unsigned char* const rgbData
         return false;
     }
 
-    for (int n = 0; n < width * height; n++)
+    ConversionBuffers buffers = {rgbaData, rgbData};
+    parallelFor(0, numberOfPixels(width, height), conversionGrainSize, convertRGBAToRGB, &buffers);
+    return true;
+}
+
+bool luminanceToFloat(const unsigned char* luminanceData, float* floatData, int width, int height)
+{
+    TraceSpan span("luminanceToFloat");
+
+    if (luminanceData == NULL)
+    {
+        cerr << "luminanceData cannot be NULL. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    if (floatData == NULL)
     {
-        /* Copy the RGB components but throw away the alpha channel. */
-        rgbData[3 * n + 0] = rgbaData[4 * n + 0];
-        rgbData[3 * n + 1] = rgbaData[4 * n + 1];
-        rgbData[3 * n + 2] = rgbaData[4 * n + 2];
+        cerr << "floatData cannot be NULL. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    LuminanceToFloatBuffers buffers = {luminanceData, floatData};
+    parallelFor(0, numberOfPixels(width, height), conversionGrainSize, convertLuminanceToFloat, &buffers);
+    return true;
+}
+
+bool floatToLuminance(const float* floatData, unsigned char* luminanceData, int width, int height)
+{
+    TraceSpan span("floatToLuminance");
+
+    if (floatData == NULL)
+    {
+        cerr << "floatData cannot be NULL. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    if (luminanceData == NULL)
+    {
+        cerr << "luminanceData cannot be NULL. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
     }
+
+    FloatToLuminanceBuffers buffers = {floatData, luminanceData};
+    parallelFor(0, numberOfPixels(width, height), conversionGrainSize, convertFloatToLuminance, &buffers);
     return true;
 }
@@ -136,4 +136,28 @@ bool RGBToRGBA(const unsigned char* rgbData, unsigned char* rgbaData, int width,
  */
 bool RGBAToRGB(const unsigned char* rgbaData, unsigned char* rgbData, int width, int height);
 
+/**
+ * \brief Convert 8-bits per pixel luminance data to normalized floats.
+ * \details Each float is the luminance divided by 255, so it is between 0 and 1.
+ * \param[in] luminanceData Pointer to a block of 8-bits per pixel luminance data. Must be width * height bytes in size.
+ * \param[out] floatData Pointer to a data block containing the floats.
+ *                       The data block must be initialised with a size of width * height floats.
+ * \param[in] width The width of the image.
+ * \param[in] height The height of the image.
+ * \return False if an error occurred, true otherwise.
+ */
+bool luminanceToFloat(const unsigned char* luminanceData, float* floatData, int width, int height);
+
+/**
+ * \brief Convert normalized floats to 8-bits per pixel luminance data.
+ * \details Each luminance value is the float multiplied by 255, truncated. The floats must be between 0 and 1.
+ * \param[in] floatData Pointer to a block of floats. Must be width * height floats in size.
+ * \param[out] luminanceData Pointer to a data block containing the 8-bits per pixel luminance data.
+ *                           The data block must be initialised with a size of width * height bytes.
+ * \param[in] width The width of the image.
+ * \param[in] height The height of the image.
+ * \return False if an error occurred, true otherwise.
+ */
+bool floatToLuminance(const float* floatData, unsigned char* luminanceData, int width, int height);
+
 #endif
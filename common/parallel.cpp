@@ -0,0 +1,465 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "parallel.h"
+
+#include <pthread.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/* Chunks per thread when the caller leaves the grain size to parallelFor, so stealing can even out uneven chunks. */
+static const size_t chunksPerThread = 4;
+
+/* Most threads the pool starts, whatever the number of CPUs. */
+static const unsigned int maximumHostThreads = 64;
+
+/**
+ * \brief A loop run by the pool, split into numbered chunks.
+ */
+struct ParallelJob
+{
+    size_t numberOfChunks;
+    void* userData;
+
+    /* A 1D range, if rangeFunction is not NULL. */
+    ParallelRangeFunction rangeFunction;
+    size_t begin;
+    size_t end;
+    size_t grainSize;
+
+    /* Otherwise a 2D range, numbered across then down. */
+    ParallelTileFunction tileFunction;
+    size_t width;
+    size_t height;
+    size_t grainWidth;
+    size_t grainHeight;
+    size_t tilesAcross;
+};
+
+/**
+ * \brief The chunks a thread has left, from head up to tail.
+ * \details The owner takes from the head, other threads steal from the tail.
+ */
+struct ChunkQueue
+{
+    pthread_mutex_t mutex;
+    size_t head;
+    size_t tail;
+};
+
+/* Held while a loop runs on the pool, so only one does at a time. */
+static pthread_mutex_t runMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Guards the fields below which the workers read. */
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t startCondition = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t finishCondition = PTHREAD_COND_INITIALIZER;
+static unsigned long generation = 0;
+static size_t finishedWorkers = 0;
+/* Generation when the threads were started, the first one they wait to move past. */
+static unsigned long startGeneration = 0;
+static bool stopping = false;
+static const ParallelJob* currentJob = NULL;
+
+/*
+ * The pool: workers.size() threads plus the calling thread, which uses queue 0.
+ * poolStarted and numberOfQueues are written holding both runMutex and poolMutex, so either is enough to read them.
+ */
+static bool poolStarted = false;
+static vector<pthread_t> workers;
+static ChunkQueue* queues = NULL;
+static size_t allocatedQueues = 0;
+static size_t numberOfQueues = 1;
+
+/**
+ * \brief Number of threads to use when none is given: CL_HOST_THREADS, or one per online CPU.
+ */
+static unsigned int defaultHostThreadCount(void)
+{
+    long numberOfThreads = 0;
+    const char* environment = getenv("CL_HOST_THREADS");
+    if (environment != NULL && environment[0] != '\0')
+    {
+        numberOfThreads = atol(environment);
+    }
+    if (numberOfThreads <= 0)
+    {
+        numberOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (numberOfThreads <= 0)
+    {
+        numberOfThreads = 1;
+    }
+    return numberOfThreads > (long)maximumHostThreads ? maximumHostThreads : (unsigned int)numberOfThreads;
+}
+
+/**
+ * \brief Run one chunk of a job.
+ */
+static void runChunk(const ParallelJob* job, size_t chunk)
+{
+    if (job->rangeFunction != NULL)
+    {
+        const size_t begin = job->begin + chunk * job->grainSize;
+        const size_t end = job->end - begin > job->grainSize ? begin + job->grainSize : job->end;
+        job->rangeFunction(job->userData, begin, end);
+    }
+    else
+    {
+        const size_t beginX = (chunk % job->tilesAcross) * job->grainWidth;
+        const size_t beginY = (chunk / job->tilesAcross) * job->grainHeight;
+        const size_t endX = job->width - beginX > job->grainWidth ? beginX + job->grainWidth : job->width;
+        const size_t endY = job->height - beginY > job->grainHeight ? beginY + job->grainHeight : job->height;
+        job->tileFunction(job->userData, beginX, endX, beginY, endY);
+    }
+}
+
+/**
+ * \brief Take a chunk from a queue.
+ * \param[in,out] queue The queue.
+ * \param[in] steal True to take from the tail, as another thread, false to take from the head, as the owner.
+ * \param[out] chunk The chunk.
+ * \return False if the queue is empty, otherwise true.
+ */
+static bool takeChunk(ChunkQueue* queue, bool steal, size_t* chunk)
+{
+    bool taken = false;
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->head < queue->tail)
+    {
+        *chunk = steal ? --queue->tail : queue->head++;
+        taken = true;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return taken;
+}
+
+/**
+ * \brief Run chunks of a job until every queue is empty.
+ * \param[in] job The job.
+ * \param[in] self Index of the queue of the calling thread.
+ */
+static void runChunks(const ParallelJob* job, size_t self)
+{
+    for (;;)
+    {
+        size_t chunk = 0;
+        if (!takeChunk(&queues[self], false, &chunk))
+        {
+            bool stolen = false;
+            for (size_t step = 1; !stolen && step < numberOfQueues; step++)
+            {
+                stolen = takeChunk(&queues[(self + step) % numberOfQueues], true, &chunk);
+            }
+            if (!stolen)
+            {
+                return;
+            }
+        }
+        runChunk(job, chunk);
+    }
+}
+
+/**
+ * \brief Body of a pool thread: wait for a job, run chunks of it, report back.
+ * \param[in] argument Index of the queue of the thread.
+ */
+static void* runWorker(void* argument)
+{
+    const size_t self = (size_t)argument;
+
+    pthread_mutex_lock(&poolMutex);
+    unsigned long seenGeneration = startGeneration;
+    for (;;)
+    {
+        while (!stopping && generation == seenGeneration)
+        {
+            pthread_cond_wait(&startCondition, &poolMutex);
+        }
+        if (stopping)
+        {
+            break;
+        }
+        seenGeneration = generation;
+        const ParallelJob* job = currentJob;
+        pthread_mutex_unlock(&poolMutex);
+
+        runChunks(job, self);
+
+        pthread_mutex_lock(&poolMutex);
+        finishedWorkers++;
+        if (finishedWorkers == workers.size())
+        {
+            pthread_cond_signal(&finishCondition);
+        }
+    }
+    pthread_mutex_unlock(&poolMutex);
+    return NULL;
+}
+
+/**
+ * \brief Stop and join the pool threads. The caller holds runMutex.
+ */
+static void stopHostThreads(void)
+{
+    pthread_mutex_lock(&poolMutex);
+    stopping = true;
+    pthread_cond_broadcast(&startCondition);
+    pthread_mutex_unlock(&poolMutex);
+
+    for (size_t index = 0; index < workers.size(); index++)
+    {
+        pthread_join(workers[index], NULL);
+    }
+    workers.clear();
+
+    for (size_t index = 0; index < allocatedQueues; index++)
+    {
+        pthread_mutex_destroy(&queues[index].mutex);
+    }
+    delete [] queues;
+    queues = NULL;
+    allocatedQueues = 0;
+
+    pthread_mutex_lock(&poolMutex);
+    numberOfQueues = 1;
+    stopping = false;
+    poolStarted = false;
+    pthread_mutex_unlock(&poolMutex);
+}
+
+/**
+ * \brief Start the pool threads. The caller holds runMutex.
+ * \param[in] numberOfThreads Number of threads, including the calling thread.
+ * \return False if an error occurred, otherwise true.
+ */
+static bool startHostThreads(unsigned int numberOfThreads)
+{
+    queues = new ChunkQueue[numberOfThreads];
+    for (unsigned int index = 0; index < numberOfThreads; index++)
+    {
+        pthread_mutex_init(&queues[index].mutex, NULL);
+        queues[index].head = 0;
+        queues[index].tail = 0;
+    }
+    allocatedQueues = numberOfThreads;
+
+    /* A thread which is slow to start must still join the first loop, so it starts from the current generation rather than reading it later. */
+    pthread_mutex_lock(&poolMutex);
+    numberOfQueues = numberOfThreads;
+    poolStarted = true;
+    startGeneration = generation;
+    pthread_mutex_unlock(&poolMutex);
+
+    bool returnValue = true;
+    for (unsigned int index = 1; index < numberOfThreads; index++)
+    {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, runWorker, (void*)(size_t)index) != 0)
+        {
+            cerr << "Started " << index - 1 << " of " << numberOfThreads - 1 << " host threads. " << __FILE__ << ":"<< __LINE__ << endl;
+            returnValue = false;
+            break;
+        }
+        workers.push_back(thread);
+    }
+
+    /* Threads which could not be started leave their queues empty. */
+    pthread_mutex_lock(&poolMutex);
+    numberOfQueues = workers.size() + 1;
+    pthread_mutex_unlock(&poolMutex);
+    return returnValue;
+}
+
+/**
+ * \brief Stops the pool threads when the program exits.
+ */
+struct HostThreadsShutdown
+{
+    ~HostThreadsShutdown()
+    {
+        pthread_mutex_lock(&runMutex);
+        if (poolStarted)
+        {
+            stopHostThreads();
+        }
+        pthread_mutex_unlock(&runMutex);
+    }
+};
+static HostThreadsShutdown hostThreadsShutdown;
+
+/**
+ * \brief Run every chunk of a job, on the pool if it is free, otherwise on the calling thread.
+ */
+static void runJob(const ParallelJob* job)
+{
+    if (job->numberOfChunks == 0)
+    {
+        return;
+    }
+
+    if (pthread_mutex_trylock(&runMutex) != 0)
+    {
+        /* A loop is already running on the pool, maybe the one which made this call. */
+        for (size_t chunk = 0; chunk < job->numberOfChunks; chunk++)
+        {
+            runChunk(job, chunk);
+        }
+        return;
+    }
+
+    if (!poolStarted)
+    {
+        startHostThreads(defaultHostThreadCount());
+    }
+
+    if (numberOfQueues == 1 || job->numberOfChunks == 1)
+    {
+        for (size_t chunk = 0; chunk < job->numberOfChunks; chunk++)
+        {
+            runChunk(job, chunk);
+        }
+        pthread_mutex_unlock(&runMutex);
+        return;
+    }
+
+    /* Each thread starts with a contiguous share, so neighbouring chunks run on the same core unless they are stolen. */
+    for (size_t index = 0; index < numberOfQueues; index++)
+    {
+        queues[index].head = job->numberOfChunks * index / numberOfQueues;
+        queues[index].tail = job->numberOfChunks * (index + 1) / numberOfQueues;
+    }
+
+    pthread_mutex_lock(&poolMutex);
+    currentJob = job;
+    finishedWorkers = 0;
+    generation++;
+    pthread_cond_broadcast(&startCondition);
+    pthread_mutex_unlock(&poolMutex);
+
+    runChunks(job, 0);
+
+    pthread_mutex_lock(&poolMutex);
+    while (finishedWorkers < workers.size())
+    {
+        pthread_cond_wait(&finishCondition, &poolMutex);
+    }
+    currentJob = NULL;
+    pthread_mutex_unlock(&poolMutex);
+
+    pthread_mutex_unlock(&runMutex);
+}
+
+void parallelFor(size_t begin, size_t end, size_t grainSize, ParallelRangeFunction function, void* userData)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    const size_t size = end - begin;
+    if (grainSize == 0)
+    {
+        const size_t targetChunks = getHostThreadCount() * chunksPerThread;
+        grainSize = (size + targetChunks - 1) / targetChunks;
+    }
+
+    ParallelJob job;
+    job.numberOfChunks = (size + grainSize - 1) / grainSize;
+    job.userData = userData;
+    job.rangeFunction = function;
+    job.begin = begin;
+    job.end = end;
+    job.grainSize = grainSize;
+    job.tileFunction = NULL;
+    job.width = 0;
+    job.height = 0;
+    job.grainWidth = 0;
+    job.grainHeight = 0;
+    job.tilesAcross = 0;
+    runJob(&job);
+}
+
+void parallelFor2D(size_t width, size_t height, size_t grainWidth, size_t grainHeight, ParallelTileFunction function, void* userData)
+{
+    if (width == 0 || height == 0)
+    {
+        return;
+    }
+
+    if (grainWidth == 0 || grainWidth > width)
+    {
+        grainWidth = width;
+    }
+    const size_t tilesAcross = (width + grainWidth - 1) / grainWidth;
+
+    if (grainHeight == 0)
+    {
+        const size_t targetChunks = getHostThreadCount() * chunksPerThread;
+        const size_t tilesDown = (targetChunks + tilesAcross - 1) / tilesAcross;
+        grainHeight = (height + tilesDown - 1) / tilesDown;
+    }
+    const size_t tilesDown = (height + grainHeight - 1) / grainHeight;
+
+    ParallelJob job;
+    job.numberOfChunks = tilesAcross * tilesDown;
+    job.userData = userData;
+    job.rangeFunction = NULL;
+    job.begin = 0;
+    job.end = 0;
+    job.grainSize = 0;
+    job.tileFunction = function;
+    job.width = width;
+    job.height = height;
+    job.grainWidth = grainWidth;
+    job.grainHeight = grainHeight;
+    job.tilesAcross = tilesAcross;
+    runJob(&job);
+}
+
+bool setHostThreadCount(unsigned int numberOfThreads)
+{
+    if (numberOfThreads == 0)
+    {
+        numberOfThreads = defaultHostThreadCount();
+    }
+    if (numberOfThreads > maximumHostThreads)
+    {
+        numberOfThreads = maximumHostThreads;
+    }
+
+    pthread_mutex_lock(&runMutex);
+    if (poolStarted)
+    {
+        stopHostThreads();
+    }
+    const bool returnValue = startHostThreads(numberOfThreads);
+    pthread_mutex_unlock(&runMutex);
+
+    if (!returnValue)
+    {
+        cerr << "Failed to start the host threads. " << __FILE__ << ":"<< __LINE__ << endl;
+    }
+    return returnValue;
+}
+
+unsigned int getHostThreadCount(void)
+{
+    /* Not runMutex, which is held by the thread running a loop, and this can be called from inside one. */
+    pthread_mutex_lock(&poolMutex);
+    const bool started = poolStarted;
+    const unsigned int numberOfThreads = (unsigned int)numberOfQueues;
+    pthread_mutex_unlock(&poolMutex);
+    return started ? numberOfThreads : defaultHostThreadCount();
+}
@@ -0,0 +1,84 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+
+/**
+ * \file parallel.h
+ * \brief Running host loops on all the CPU cores.
+ * \details The host work around the kernels (converting images, filling inputs, post-processing outputs) is small per element,
+ *          but done by a single thread it can take as long as the kernel itself.
+ *          parallelFor splits a range into chunks of grainSize elements and runs them on a pool of threads, one per CPU core,
+ *          with the calling thread as one of them. Each thread starts with a contiguous share of the chunks and,
+ *          when it runs out, steals chunks from the end of the share of another thread.
+ *
+ *          The pool is created by the first call, with one thread per online CPU,
+ *          or the number of threads in the CL_HOST_THREADS environment variable.
+ *          A parallelFor called while another one is running (from inside a chunk, or from another thread) runs on the calling thread.
+ *          The function must not depend on the order the chunks run in.
+ */
+
+/**
+ * \brief Process one chunk of a 1D range.
+ * \param[in] userData The userData passed to parallelFor.
+ * \param[in] begin First index of the chunk.
+ * \param[in] end One past the last index of the chunk.
+ */
+typedef void (*ParallelRangeFunction)(void* userData, size_t begin, size_t end);
+
+/**
+ * \brief Process one tile of a 2D range.
+ * \param[in] userData The userData passed to parallelFor2D.
+ * \param[in] beginX First column of the tile.
+ * \param[in] endX One past the last column of the tile.
+ * \param[in] beginY First row of the tile.
+ * \param[in] endY One past the last row of the tile.
+ */
+typedef void (*ParallelTileFunction)(void* userData, size_t beginX, size_t endX, size_t beginY, size_t endY);
+
+/**
+ * \brief Run a function over a range on all the host threads, returning when every chunk is done.
+ * \param[in] begin First index of the range.
+ * \param[in] end One past the last index of the range.
+ * \param[in] grainSize Number of indices per chunk. Zero picks about four chunks per thread.
+ * \param[in] function Called once per chunk, from any of the threads.
+ * \param[in] userData Passed to function.
+ */
+void parallelFor(size_t begin, size_t end, size_t grainSize, ParallelRangeFunction function, void* userData);
+
+/**
+ * \brief Run a function over a 2D range on all the host threads, returning when every tile is done.
+ * \param[in] width Number of columns of the range.
+ * \param[in] height Number of rows of the range.
+ * \param[in] grainWidth Number of columns per tile. Zero uses the whole width, so tiles are bands of rows.
+ * \param[in] grainHeight Number of rows per tile. Zero picks about four tiles per thread.
+ * \param[in] function Called once per tile, from any of the threads.
+ * \param[in] userData Passed to function.
+ */
+void parallelFor2D(size_t width, size_t height, size_t grainWidth, size_t grainHeight, ParallelTileFunction function, void* userData);
+
+/**
+ * \brief Change the number of host threads used by parallelFor.
+ * \details Must not be called while a parallelFor is running. One thread runs every loop on the calling thread.
+ * \param[in] numberOfThreads Number of threads, including the calling thread. Zero uses one per online CPU.
+ * \return False if an error occurred, otherwise true. Fewer threads than asked for may have been started.
+ */
+bool setHostThreadCount(unsigned int numberOfThreads);
+
+/**
+ * \brief Number of host threads used by parallelFor, including the calling thread.
+ * \return The number of threads.
+ */
+unsigned int getHostThreadCount(void);
+
+#endif
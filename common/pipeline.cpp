@@ -0,0 +1,360 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "pipeline.h"
+#include "common.h"
+#include "trace.h"
+
+#include <iostream>
+
+using namespace std;
+
+/**
+ * \brief Wait for the oldest frame in flight, pass its outputs to the consume function and free its slot.
+ * \param[in] pipeline The pipeline.
+ * \return False if an error occurred, otherwise true.
+ */
+static bool consumeOldestFrame(Pipeline* pipeline)
+{
+    const PipelineDescription& description = pipeline->description;
+    PipelineSlot& slot = pipeline->slots[pipeline->oldestFrame % description.depth];
+
+    if (slot.frame != pipeline->oldestFrame)
+    {
+        cerr << "No frame in flight to consume. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* The outputs were mapped after the kernel on the in-order queue, so this also waits for the kernel. */
+    traceHostBegin("wait for frame");
+    const bool waitSuccess = checkSuccess(clWaitForEvents(1, &slot.readEvent));
+    traceHostEnd();
+    if (!waitSuccess)
+    {
+        cerr << "Failed waiting for the frame readback. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    traceHostBegin("consume frame");
+    bool returnValue = description.consume == NULL || description.consume(description.userData, slot.frame, slot.mappedOutputs, slot.kernelEvent);
+    traceHostEnd();
+
+    for (int index = 0; index < description.numberOfOutputs; index++)
+    {
+        cl_event unmapEvent = 0;
+        returnValue &= checkSuccess(clEnqueueUnmapMemObject(pipeline->commandQueue, slot.outputs[index], slot.mappedOutputs[index], 0, NULL, traceEvent(&unmapEvent)));
+        returnValue &= traceAndReleaseCommand(unmapEvent, "unmap output", description.outputSizes[index]);
+        slot.mappedOutputs[index] = NULL;
+    }
+    returnValue &= checkSuccess(clReleaseEvent(slot.kernelEvent));
+    returnValue &= checkSuccess(clReleaseEvent(slot.readEvent));
+    slot.kernelEvent = 0;
+    slot.readEvent = 0;
+    slot.frame = -1;
+    pipeline->oldestFrame++;
+
+    if (!returnValue)
+    {
+        cerr << "Failed consuming frame " << pipeline->oldestFrame - 1 << ". " << __FILE__ << ":"<< __LINE__ << endl;
+    }
+    return returnValue;
+}
+
+bool releasePipeline(Pipeline* pipeline)
+{
+    bool returnValue = true;
+
+    /* Nothing may still be using the buffers when they are released. */
+    if (pipeline->commandQueue != 0)
+    {
+        returnValue &= checkSuccess(clFinish(pipeline->commandQueue));
+    }
+    if (pipeline->transferQueue != 0)
+    {
+        returnValue &= checkSuccess(clFinish(pipeline->transferQueue));
+    }
+
+    for (int slotIndex = 0; slotIndex < maximumPipelineDepth; slotIndex++)
+    {
+        PipelineSlot& slot = pipeline->slots[slotIndex];
+        for (int index = 0; index < maximumPipelineBuffers; index++)
+        {
+            if (slot.mappedOutputs[index] != NULL)
+            {
+                returnValue &= checkSuccess(clEnqueueUnmapMemObject(pipeline->commandQueue, slot.outputs[index], slot.mappedOutputs[index], 0, NULL, NULL));
+                slot.mappedOutputs[index] = NULL;
+            }
+        }
+        if (pipeline->commandQueue != 0)
+        {
+            returnValue &= checkSuccess(clFinish(pipeline->commandQueue));
+        }
+        for (int index = 0; index < maximumPipelineBuffers; index++)
+        {
+            if (slot.inputs[index] != 0)
+            {
+                returnValue &= checkSuccess(clReleaseMemObject(slot.inputs[index]));
+                slot.inputs[index] = 0;
+            }
+            if (slot.outputs[index] != 0)
+            {
+                returnValue &= checkSuccess(clReleaseMemObject(slot.outputs[index]));
+                slot.outputs[index] = 0;
+            }
+        }
+        if (slot.kernelEvent != 0)
+        {
+            returnValue &= checkSuccess(clReleaseEvent(slot.kernelEvent));
+            slot.kernelEvent = 0;
+        }
+        if (slot.readEvent != 0)
+        {
+            returnValue &= checkSuccess(clReleaseEvent(slot.readEvent));
+            slot.readEvent = 0;
+        }
+        if (slot.kernel != 0)
+        {
+            returnValue &= checkSuccess(clReleaseKernel(slot.kernel));
+            slot.kernel = 0;
+        }
+        slot.frame = -1;
+    }
+
+    if (pipeline->program != 0)
+    {
+        returnValue &= checkSuccess(clReleaseProgram(pipeline->program));
+        pipeline->program = 0;
+    }
+    if (pipeline->transferQueue != 0)
+    {
+        returnValue &= checkSuccess(clReleaseCommandQueue(pipeline->transferQueue));
+        pipeline->transferQueue = 0;
+    }
+
+    /* The main command queue belongs to the caller. */
+    pipeline->commandQueue = 0;
+    return returnValue;
+}
+
+bool createPipeline(cl_context context, cl_device_id device, cl_command_queue commandQueue, const PipelineDescription* description, Pipeline* pipeline)
+{
+    cl_int errorNumber = 0;
+
+    pipeline->description = *description;
+    pipeline->commandQueue = commandQueue;
+    pipeline->transferQueue = 0;
+    pipeline->program = 0;
+    pipeline->nextFrame = 0;
+    pipeline->oldestFrame = 0;
+    for (int slotIndex = 0; slotIndex < maximumPipelineDepth; slotIndex++)
+    {
+        PipelineSlot& slot = pipeline->slots[slotIndex];
+        slot.kernel = 0;
+        for (int index = 0; index < maximumPipelineBuffers; index++)
+        {
+            slot.inputs[index] = 0;
+            slot.outputs[index] = 0;
+            slot.mappedOutputs[index] = NULL;
+        }
+        slot.kernelEvent = 0;
+        slot.readEvent = 0;
+        slot.frame = -1;
+    }
+
+    /* With a single slot the host would wait for every frame before preparing the next, so nothing would overlap. */
+    if (description->depth < 2 || description->depth > maximumPipelineDepth)
+    {
+        cerr << "The pipeline depth must be between 2 and " << maximumPipelineDepth << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    if (description->numberOfInputs < 0 || description->numberOfInputs > maximumPipelineBuffers ||
+        description->numberOfOutputs < 1 || description->numberOfOutputs > maximumPipelineBuffers ||
+        description->workDimensions < 1 || description->workDimensions > 3)
+    {
+        cerr << "Invalid pipeline description. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    if (!createProgram(context, device, description->filename, &pipeline->program, description->buildOptions))
+    {
+        pipeline->program = 0;
+        cerr << "Failed to create the pipeline program. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /*
+     * Mapping on the main in-order queue would wait for every kernel already enqueued.
+     * The inputs are mapped on a second queue instead, so the host can fill the inputs of a frame while the previous frames run.
+     * It is profiled when the main queue is, so the traced input transfers have timestamps.
+     */
+    cl_command_queue_properties properties = 0;
+    if (!checkSuccess(clGetCommandQueueInfo(commandQueue, CL_QUEUE_PROPERTIES, sizeof(properties), &properties, NULL)))
+    {
+        releasePipeline(pipeline);
+        cerr << "Failed to query the command queue properties. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    pipeline->transferQueue = clCreateCommandQueue(context, device, properties & CL_QUEUE_PROFILING_ENABLE, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        pipeline->transferQueue = 0;
+        releasePipeline(pipeline);
+        cerr << "Failed to create the pipeline transfer queue. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* Every slot has its own kernel object, so the buffer arguments are set once here rather than for every frame. */
+    bool createSlotsSuccess = true;
+    for (int slotIndex = 0; slotIndex < description->depth; slotIndex++)
+    {
+        PipelineSlot& slot = pipeline->slots[slotIndex];
+        slot.kernel = clCreateKernel(pipeline->program, description->kernelName.c_str(), &errorNumber);
+        createSlotsSuccess &= checkSuccess(errorNumber);
+        if (!createSlotsSuccess)
+        {
+            slot.kernel = 0;
+            break;
+        }
+
+        for (int index = 0; index < description->numberOfInputs; index++)
+        {
+            slot.inputs[index] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, description->inputSizes[index], NULL, &errorNumber);
+            createSlotsSuccess &= checkSuccess(errorNumber);
+            createSlotsSuccess &= checkSuccess(clSetKernelArg(slot.kernel, description->inputArguments[index], sizeof(cl_mem), &slot.inputs[index]));
+        }
+        for (int index = 0; index < description->numberOfOutputs; index++)
+        {
+            slot.outputs[index] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, description->outputSizes[index], NULL, &errorNumber);
+            createSlotsSuccess &= checkSuccess(errorNumber);
+            createSlotsSuccess &= checkSuccess(clSetKernelArg(slot.kernel, description->outputArguments[index], sizeof(cl_mem), &slot.outputs[index]));
+        }
+    }
+    if (!createSlotsSuccess)
+    {
+        releasePipeline(pipeline);
+        cerr << "Failed to create the pipeline kernels and buffers. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool setPipelineKernelArgument(Pipeline* pipeline, cl_uint index, size_t size, const void* value)
+{
+    bool setKernelArgumentsSuccess = true;
+    for (int slotIndex = 0; slotIndex < pipeline->description.depth; slotIndex++)
+    {
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pipeline->slots[slotIndex].kernel, index, size, value));
+    }
+    if (!setKernelArgumentsSuccess)
+    {
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+    }
+    return setKernelArgumentsSuccess;
+}
+
+bool submitPipelineFrame(Pipeline* pipeline)
+{
+    const PipelineDescription& description = pipeline->description;
+    PipelineSlot& slot = pipeline->slots[pipeline->nextFrame % description.depth];
+    cl_int errorNumber = 0;
+
+    /* Frames are consumed in order, so a busy slot always holds the oldest frame. */
+    if (slot.frame != -1 && !consumeOldestFrame(pipeline))
+    {
+        return false;
+    }
+
+    void* mappedInputs[maximumPipelineBuffers] = {NULL};
+    traceHostBegin("prepare frame");
+    bool mapMemoryObjectsSuccess = true;
+    for (int index = 0; index < description.numberOfInputs; index++)
+    {
+        cl_event mapEvent = 0;
+        mappedInputs[index] = clEnqueueMapBuffer(pipeline->transferQueue, slot.inputs[index], CL_TRUE, CL_MAP_WRITE, 0, description.inputSizes[index], 0, NULL, traceEvent(&mapEvent), &errorNumber);
+        mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
+        mapMemoryObjectsSuccess &= traceAndReleaseCommand(mapEvent, "map input", description.inputSizes[index]);
+    }
+
+    bool prepareSuccess = mapMemoryObjectsSuccess && (description.prepare == NULL || description.prepare(description.userData, pipeline->nextFrame, mappedInputs));
+
+    /* The kernel must not start before the inputs are unmapped. */
+    cl_event inputEvent = 0;
+    bool unmapMemoryObjectsSuccess = true;
+    for (int index = 0; index < description.numberOfInputs; index++)
+    {
+        if (mappedInputs[index] != NULL)
+        {
+            cl_event unmapEvent = 0;
+            unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(pipeline->transferQueue, slot.inputs[index], mappedInputs[index], 0, NULL, traceEvent(&unmapEvent)));
+            unmapMemoryObjectsSuccess &= traceAndReleaseCommand(unmapEvent, "unmap input", description.inputSizes[index]);
+        }
+    }
+    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueMarker(pipeline->transferQueue, &inputEvent));
+    unmapMemoryObjectsSuccess &= checkSuccess(clFlush(pipeline->transferQueue));
+    traceHostEnd();
+    if (!prepareSuccess || !unmapMemoryObjectsSuccess)
+    {
+        if (inputEvent != 0)
+        {
+            clReleaseEvent(inputEvent);
+        }
+        cerr << "Failed preparing frame " << pipeline->nextFrame << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    bool enqueueSuccess = checkSuccess(clEnqueueNDRangeKernel(pipeline->commandQueue, slot.kernel, description.workDimensions, NULL, description.globalWorksize, NULL, 1, &inputEvent, &slot.kernelEvent));
+    enqueueSuccess &= checkSuccess(clReleaseEvent(inputEvent));
+    if (enqueueSuccess)
+    {
+        traceKernel(slot.kernelEvent, slot.kernel, description.workDimensions, description.globalWorksize, NULL);
+    }
+
+    /* Non-blocking maps: the host carries on with the next frame while this one runs and is read back. */
+    for (int index = 0; enqueueSuccess && index < description.numberOfOutputs; index++)
+    {
+        cl_event mapEvent = 0;
+        slot.mappedOutputs[index] = clEnqueueMapBuffer(pipeline->commandQueue, slot.outputs[index], CL_FALSE, CL_MAP_READ, 0, description.outputSizes[index], 0, NULL, &mapEvent, &errorNumber);
+        enqueueSuccess &= checkSuccess(errorNumber);
+        if (enqueueSuccess)
+        {
+            traceCommand(mapEvent, "map output", description.outputSizes[index]);
+        }
+        if (slot.readEvent != 0)
+        {
+            /* The queue is in order, so the event of the last map is enough to wait on. */
+            enqueueSuccess &= checkSuccess(clReleaseEvent(slot.readEvent));
+        }
+        slot.readEvent = mapEvent;
+    }
+    enqueueSuccess &= checkSuccess(clFlush(pipeline->commandQueue));
+    if (!enqueueSuccess)
+    {
+        cerr << "Failed enqueuing frame " << pipeline->nextFrame << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    slot.frame = pipeline->nextFrame;
+    pipeline->nextFrame++;
+    return true;
+}
+
+bool finishPipeline(Pipeline* pipeline)
+{
+    while (pipeline->oldestFrame < pipeline->nextFrame)
+    {
+        if (!consumeOldestFrame(pipeline))
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,151 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <CL/cl.h>
+#include <string>
+
+/**
+ * \file pipeline.h
+ * \brief A kernel which is built once and run on a stream of frames through a ring of buffers.
+ */
+
+/**
+ * \brief Largest number of frames a pipeline can have in flight.
+ */
+const int maximumPipelineDepth = 3;
+
+/**
+ * \brief Largest number of input or output buffers of a pipeline kernel.
+ */
+const int maximumPipelineBuffers = 4;
+
+/**
+ * \brief Fill the input buffers of a frame on the host.
+ * \param[in] userData The userData of the pipeline.
+ * \param[in] frame Index of the frame, counting from 0.
+ * \param[out] inputs Host pointers to the mapped input buffers of the frame.
+ * \return False if an error occurred, otherwise true. An error stops the pipeline.
+ */
+typedef bool (*PipelinePrepareFunction)(void* userData, int frame, void* const* inputs);
+
+/**
+ * \brief Use the output buffers of a frame on the host.
+ * \details The pointers are only valid during the call: the buffers are reused for a later frame afterwards.
+ * \param[in] userData The userData of the pipeline.
+ * \param[in] frame Index of the frame, counting from 0.
+ * \param[in] outputs Host pointers to the mapped output buffers of the frame.
+ * \param[in] kernelEvent Event of the kernel of the frame, for profiling. Owned by the pipeline.
+ * \return False if an error occurred, otherwise true. An error stops the pipeline.
+ */
+typedef bool (*PipelineConsumeFunction)(void* userData, int frame, void* const* outputs, cl_event kernelEvent);
+
+/**
+ * \brief Everything needed to create a pipeline.
+ * \details The buffers are created by the pipeline, one set per frame in flight,
+ *          and bound to the kernel arguments given in inputArguments and outputArguments.
+ *          Any other kernel arguments are set with setPipelineKernelArgument.
+ */
+struct PipelineDescription
+{
+    std::string filename; /**< \brief File containing the OpenCL kernel code. */
+    std::string kernelName; /**< \brief Name of the kernel to run for every frame. */
+    std::string buildOptions; /**< \brief Options passed to clBuildProgram. */
+    int depth; /**< \brief Number of frames in flight: 2 for double buffering, 3 for triple buffering. Must be at least 2. */
+    int numberOfInputs; /**< \brief Number of input buffers of a frame. */
+    size_t inputSizes[maximumPipelineBuffers]; /**< \brief Size of each input buffer in bytes. */
+    cl_uint inputArguments[maximumPipelineBuffers]; /**< \brief Kernel argument index of each input buffer. */
+    int numberOfOutputs; /**< \brief Number of output buffers of a frame. */
+    size_t outputSizes[maximumPipelineBuffers]; /**< \brief Size of each output buffer in bytes. */
+    cl_uint outputArguments[maximumPipelineBuffers]; /**< \brief Kernel argument index of each output buffer. */
+    cl_uint workDimensions; /**< \brief Number of dimensions of the global work size. */
+    size_t globalWorksize[3]; /**< \brief Global work size of the kernel. */
+    PipelinePrepareFunction prepare; /**< \brief Called to fill the inputs of each frame. */
+    PipelineConsumeFunction consume; /**< \brief Called with the outputs of each frame, in order. */
+    void* userData; /**< \brief Passed to prepare and consume. */
+};
+
+/**
+ * \brief One set of buffers of a pipeline and the frame currently using it.
+ */
+struct PipelineSlot
+{
+    cl_kernel kernel; /**< \brief Kernel with the buffers of this slot bound, so the arguments are only set once. */
+    cl_mem inputs[maximumPipelineBuffers]; /**< \brief Input buffers. */
+    cl_mem outputs[maximumPipelineBuffers]; /**< \brief Output buffers. */
+    void* mappedOutputs[maximumPipelineBuffers]; /**< \brief Host pointers of the outputs while they are mapped for reading. */
+    cl_event kernelEvent; /**< \brief Event of the kernel of the frame in flight. */
+    cl_event readEvent; /**< \brief Event of the last map of the outputs of the frame in flight. */
+    int frame; /**< \brief Frame using the slot, or -1 if it is free. */
+};
+
+/**
+ * \brief A kernel built once with a ring of buffers for streaming frames through it.
+ */
+struct Pipeline
+{
+    PipelineDescription description; /**< \brief The description the pipeline was created from. */
+    cl_command_queue commandQueue; /**< \brief In-order command queue the kernels and readbacks are enqueued on. */
+    cl_command_queue transferQueue; /**< \brief Second queue for the input maps, so they do not wait for the kernels in flight. */
+    cl_program program; /**< \brief The built program. */
+    PipelineSlot slots[maximumPipelineDepth]; /**< \brief description.depth sets of buffers. */
+    int nextFrame; /**< \brief Index of the next frame to submit. */
+    int oldestFrame; /**< \brief Index of the oldest frame which has not been consumed. */
+};
+
+/**
+ * \brief Build the kernel of a pipeline and allocate its buffers.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] device The OpenCL device to build the kernel for.
+ * \param[in] commandQueue An in-order command queue to enqueue the frames on.
+ * \param[in] description What to run and how many frames to keep in flight.
+ * \param[out] pipeline The created pipeline. Must be released with releasePipeline.
+ * \return False if an error occurred, otherwise true. A depth below 2 or above maximumPipelineDepth is an error.
+ */
+bool createPipeline(cl_context context, cl_device_id device, cl_command_queue commandQueue, const PipelineDescription* description, Pipeline* pipeline);
+
+/**
+ * \brief Set a kernel argument which is the same for every frame, such as the width of the image.
+ * \param[in] pipeline The pipeline.
+ * \param[in] index Index of the argument.
+ * \param[in] size Size of the argument in bytes.
+ * \param[in] value Pointer to the value of the argument.
+ * \return False if an error occurred, otherwise true.
+ */
+bool setPipelineKernelArgument(Pipeline* pipeline, cl_uint index, size_t size, const void* value);
+
+/**
+ * \brief Prepare the next frame and enqueue its kernel and readback.
+ * \details If all the slots are in use, the oldest frame is consumed first to free its slot.
+ *          The host then prepares this frame while the kernels of the frames in flight run on the device,
+ *          and the outputs are mapped without blocking, so the host only waits when the ring is full.
+ * \param[in] pipeline The pipeline.
+ * \return False if an error occurred, otherwise true.
+ */
+bool submitPipelineFrame(Pipeline* pipeline);
+
+/**
+ * \brief Consume all the frames in flight.
+ * \param[in] pipeline The pipeline.
+ * \return False if an error occurred, otherwise true.
+ */
+bool finishPipeline(Pipeline* pipeline);
+
+/**
+ * \brief Release the OpenCL objects of a pipeline.
+ * \details Frames still in flight are waited for but not consumed.
+ * \param[in] pipeline The pipeline to release.
+ * \return False if an error occurred, otherwise true.
+ */
+bool releasePipeline(Pipeline* pipeline);
+
+#endif
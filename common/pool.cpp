@@ -0,0 +1,230 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "pool.h"
+#include "common.h"
+#include "device.h"
+
+#include <iostream>
+
+using namespace std;
+
+/* Smallest size class, unless the device alignment is larger. */
+static const size_t minimumPoolBufferSize = 256;
+
+bool createBufferPool(cl_context context, cl_device_id device, cl_mem_flags flags, size_t slabSize, BufferPool* pool)
+{
+    const DeviceInfo* deviceInfo = NULL;
+    if (!getDeviceInfo(device, &deviceInfo))
+    {
+        cerr << "Failed to get the base address alignment of the device. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    /* CL_DEVICE_MEM_BASE_ADDR_ALIGN is in bits. */
+    const cl_uint alignmentBits = deviceInfo->memoryBaseAddressAlignment;
+
+    pool->context = context;
+    pool->flags = flags;
+    pool->alignment = alignmentBits / 8 > 0 ? alignmentBits / 8 : 1;
+
+    pool->minimumSize = pool->alignment;
+    while (pool->minimumSize < minimumPoolBufferSize)
+    {
+        pool->minimumSize *= 2;
+    }
+
+    /* The slab is the largest size class, so every request no larger than a slab has a class which fits in one. */
+    pool->slabSize = pool->minimumSize;
+    while (pool->slabSize < slabSize)
+    {
+        pool->slabSize *= 2;
+    }
+
+    /* Size classes are minimumSize * 2^n, up to the slab size. */
+    size_t numberOfSizeClasses = 1;
+    while ((pool->minimumSize << numberOfSizeClasses) <= pool->slabSize)
+    {
+        numberOfSizeClasses++;
+    }
+
+    pool->slabs.clear();
+    pool->slabOffset = pool->slabSize;
+    pool->freeBuffers.assign(numberOfSizeClasses, vector<cl_mem>());
+    pool->sizeClasses.clear();
+
+    pool->bytesInUse = 0;
+    pool->highWaterMark = 0;
+    pool->allocations = 0;
+    pool->reuses = 0;
+    pool->slabAllocations = 0;
+    pool->largeAllocations = 0;
+
+    return true;
+}
+
+/**
+ * \brief Account for a buffer handed out by a pool.
+ * \param[in,out] pool The pool.
+ * \param[in] buffer The buffer.
+ * \param[in] sizeClass Size class of the buffer, or -1 for a buffer larger than a slab.
+ * \param[in] size Size of the buffer in bytes.
+ */
+static void addPoolBuffer(BufferPool* pool, cl_mem buffer, int sizeClass, size_t size)
+{
+    pool->sizeClasses[buffer] = sizeClass;
+    pool->allocations++;
+    pool->bytesInUse += size;
+    if (pool->bytesInUse > pool->highWaterMark)
+    {
+        pool->highWaterMark = pool->bytesInUse;
+    }
+}
+
+bool allocatePoolBuffer(BufferPool* pool, size_t size, cl_mem* buffer)
+{
+    cl_int errorNumber = CL_SUCCESS;
+
+    if (size > pool->slabSize)
+    {
+        *buffer = clCreateBuffer(pool->context, pool->flags, size, NULL, &errorNumber);
+        if (!checkSuccess(errorNumber))
+        {
+            cerr << "Failed to create a pool buffer of " << size << " bytes. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+        pool->largeAllocations++;
+        addPoolBuffer(pool, *buffer, -1, size);
+        return true;
+    }
+
+    int sizeClass = 0;
+    size_t classSize = pool->minimumSize;
+    while (classSize < size)
+    {
+        classSize *= 2;
+        sizeClass++;
+    }
+
+    vector<cl_mem>& freeBuffers = pool->freeBuffers[sizeClass];
+    if (!freeBuffers.empty())
+    {
+        *buffer = freeBuffers.back();
+        freeBuffers.pop_back();
+        pool->reuses++;
+        addPoolBuffer(pool, *buffer, sizeClass, classSize);
+        return true;
+    }
+
+    if (pool->slabOffset + classSize > pool->slabSize)
+    {
+        /* The remainder of the full slab is left unused. */
+        cl_mem slab = clCreateBuffer(pool->context, pool->flags, pool->slabSize, NULL, &errorNumber);
+        if (!checkSuccess(errorNumber))
+        {
+            cerr << "Failed to create a pool slab of " << pool->slabSize << " bytes. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+        pool->slabs.push_back(slab);
+        pool->slabOffset = 0;
+        pool->slabAllocations++;
+    }
+
+    /*
+     * Regions are whole size classes, which are multiples of the alignment, so every origin is aligned.
+     * Sub-buffers can't have host pointer flags, they take them from the slab.
+     */
+    cl_buffer_region region;
+    region.origin = pool->slabOffset;
+    region.size = classSize;
+    const cl_mem_flags accessFlags = pool->flags & (CL_MEM_READ_WRITE | CL_MEM_READ_ONLY | CL_MEM_WRITE_ONLY);
+    *buffer = clCreateSubBuffer(pool->slabs.back(), accessFlags, CL_BUFFER_CREATE_TYPE_REGION, &region, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        cerr << "Failed to create a sub-buffer of " << classSize << " bytes at offset " << region.origin << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    pool->slabOffset += classSize;
+
+    addPoolBuffer(pool, *buffer, sizeClass, classSize);
+    return true;
+}
+
+bool releasePoolBuffer(BufferPool* pool, cl_mem buffer)
+{
+    map<cl_mem, int>::iterator entry = pool->sizeClasses.find(buffer);
+    if (entry == pool->sizeClasses.end())
+    {
+        cerr << "Memory object was not allocated from this pool. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    const int sizeClass = entry->second;
+    pool->sizeClasses.erase(entry);
+
+    if (sizeClass < 0)
+    {
+        size_t size = 0;
+        bool returnValue = checkSuccess(clGetMemObjectInfo(buffer, CL_MEM_SIZE, sizeof(size_t), &size, NULL));
+        pool->bytesInUse -= size;
+        returnValue &= checkSuccess(clReleaseMemObject(buffer));
+        if (!returnValue)
+        {
+            cerr << "Failed to release a pool buffer. " << __FILE__ << ":"<< __LINE__ << endl;
+        }
+        return returnValue;
+    }
+
+    pool->bytesInUse -= pool->minimumSize << sizeClass;
+    pool->freeBuffers[sizeClass].push_back(buffer);
+    return true;
+}
+
+bool releaseBufferPool(BufferPool* pool)
+{
+    bool returnValue = true;
+
+    /* Sub-buffers are released before the slabs they were created from. */
+    for (map<cl_mem, int>::iterator entry = pool->sizeClasses.begin(); entry != pool->sizeClasses.end(); ++entry)
+    {
+        returnValue &= checkSuccess(clReleaseMemObject(entry->first));
+    }
+    pool->sizeClasses.clear();
+
+    for (size_t sizeClass = 0; sizeClass < pool->freeBuffers.size(); sizeClass++)
+    {
+        for (size_t index = 0; index < pool->freeBuffers[sizeClass].size(); index++)
+        {
+            returnValue &= checkSuccess(clReleaseMemObject(pool->freeBuffers[sizeClass][index]));
+        }
+        pool->freeBuffers[sizeClass].clear();
+    }
+
+    for (size_t index = 0; index < pool->slabs.size(); index++)
+    {
+        returnValue &= checkSuccess(clReleaseMemObject(pool->slabs[index]));
+    }
+    pool->slabs.clear();
+    pool->slabOffset = pool->slabSize;
+    pool->bytesInUse = 0;
+
+    if (!returnValue)
+    {
+        cerr << "Failed to release the buffer pool. " << __FILE__ << ":"<< __LINE__ << endl;
+    }
+    return returnValue;
+}
+
+void printBufferPoolStatistics(const BufferPool* pool)
+{
+    cout << "Buffer pool: " << pool->allocations << " allocations, " << pool->reuses << " recycled, "
+         << pool->largeAllocations << " larger than a slab\n";
+    cout << "Slabs: \t\t" << pool->slabAllocations << " of " << pool->slabSize << " bytes, " << pool->alignment << " byte alignment\n";
+    cout << "Memory: \t" << pool->bytesInUse << " bytes in use, " << pool->highWaterMark << " bytes high-water mark" << endl;
+}
@@ -0,0 +1,114 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <CL/cl.h>
+#include <cstddef>
+#include <map>
+#include <vector>
+
+/**
+ * \file pool.h
+ * \brief Memory buffers carved out of large slabs as sub-buffers.
+ * \details Creating a memory buffer is expensive, and a frame loop which creates and releases short-lived buffers
+ *          pays that cost every frame. A BufferPool creates a few large slab buffers and hands out regions of them with clCreateSubBuffer.
+ *          Requests are rounded up to power of two size classes, starting at the device's base address alignment
+ *          (CL_DEVICE_MEM_BASE_ADDR_ALIGN), so every region is correctly aligned for a sub-buffer.
+ *          Released buffers are kept on a free list for their size class and handed out again without any call to OpenCL.
+ *          Requests larger than a slab get a buffer of their own.
+ *
+ *          A recycled buffer is the same memory object as before, so kernel bindings of it stay valid.
+ *          Its contents are whatever was last written to it.
+ */
+
+/**
+ * \brief A pool of memory buffers of one set of flags.
+ */
+struct BufferPool
+{
+    cl_context context;
+    /** Access flags of the buffers in the pool. */
+    cl_mem_flags flags;
+    /** Base address alignment of the device, in bytes. */
+    size_t alignment;
+    size_t slabSize;
+    /** Size of the smallest size class. */
+    size_t minimumSize;
+
+    std::vector<cl_mem> slabs;
+    /** Bytes of the newest slab which have been handed out. */
+    size_t slabOffset;
+    /** Released buffers of each size class, ready for reuse. */
+    std::vector<std::vector<cl_mem> > freeBuffers;
+    /** Size class of each buffer handed out by the pool, or -1 for a buffer larger than a slab. */
+    std::map<cl_mem, int> sizeClasses;
+
+    /** Bytes of the buffers currently handed out, after rounding up to the size class. */
+    size_t bytesInUse;
+    size_t highWaterMark;
+    cl_ulong allocations;
+    /** Allocations served from a free list. */
+    cl_ulong reuses;
+    cl_ulong slabAllocations;
+    /** Allocations too large for a slab. */
+    cl_ulong largeAllocations;
+};
+
+/**
+ * \brief Create an empty buffer pool.
+ * \details No memory is allocated until the first call to allocatePoolBuffer.
+ * \param[in] context The OpenCL context to create the buffers in.
+ * \param[in] device The device whose base address alignment the buffers are aligned to.
+ * \param[in] flags Access flags of the buffers: CL_MEM_READ_WRITE, CL_MEM_READ_ONLY or CL_MEM_WRITE_ONLY,
+ *                  optionally with CL_MEM_ALLOC_HOST_PTR for mappable slabs.
+ * \param[in] slabSize Size of each slab in bytes. Rounded up to a power of two multiple of the smallest size class.
+ * \param[out] pool The pool.
+ * \return False if an error occurred, otherwise true.
+ */
+bool createBufferPool(cl_context context, cl_device_id device, cl_mem_flags flags, size_t slabSize, BufferPool* pool);
+
+/**
+ * \brief Get a memory buffer from a pool.
+ * \details The buffer is at least size bytes. It is recycled from the free list of its size class when possible,
+ *          otherwise carved out of the newest slab, starting a new slab when that one is full.
+ * \param[in,out] pool The pool.
+ * \param[in] size Number of bytes needed.
+ * \param[out] buffer The buffer. Return it with releasePoolBuffer, not clReleaseMemObject.
+ * \return False if an error occurred, otherwise true.
+ */
+bool allocatePoolBuffer(BufferPool* pool, size_t size, cl_mem* buffer);
+
+/**
+ * \brief Return a memory buffer to its pool.
+ * \details Buffers from a slab go on the free list of their size class. Buffers too large for a slab are released.
+ *          Commands using the buffer which are still in flight must be on the same in-order queue as its next use.
+ * \param[in,out] pool The pool the buffer came from.
+ * \param[in] buffer The buffer.
+ * \return False if an error occurred, otherwise true.
+ */
+bool releasePoolBuffer(BufferPool* pool, cl_mem buffer);
+
+/**
+ * \brief Release all the memory of a pool.
+ * \details Buffers still handed out are released as well.
+ * \param[in,out] pool The pool.
+ * \return False if an error occurred, otherwise true.
+ */
+bool releaseBufferPool(BufferPool* pool);
+
+/**
+ * \brief Print the allocation statistics of a pool.
+ * \param[in] pool The pool.
+ */
+void printBufferPoolStatistics(const BufferPool* pool);
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "roofline.h"
+#include "common.h"
+
+#include <iostream>
+#include <cstdlib>
+
+using namespace std;
+
+/**
+ * \brief Read a positive number from an environment variable.
+ * \param[in] name Name of the variable.
+ * \return The value, or 0 if the variable is not set or not a positive number.
+ */
+static double environmentPeak(const char* name)
+{
+    const char* value = getenv(name);
+    if (value == NULL)
+    {
+        return 0.0;
+    }
+    const double peak = atof(value);
+    return peak > 0.0 ? peak : 0.0;
+}
+
+void initializeKernelStats(KernelStats* stats, const string& name, double bytesRead, double bytesWritten, double operations)
+{
+    stats->name = name;
+    stats->bytesRead = bytesRead;
+    stats->bytesWritten = bytesWritten;
+    stats->operations = operations;
+    stats->peakGigabytesPerSecond = environmentPeak("CL_PEAK_GBPS");
+    stats->peakGigaopsPerSecond = environmentPeak("CL_PEAK_GOPS");
+    stats->launches = 0;
+    stats->totalTime = 0;
+    stats->minimumTime = 0;
+    stats->maximumTime = 0;
+}
+
+void setKernelStatsPeak(KernelStats* stats, double gigabytesPerSecond, double gigaopsPerSecond)
+{
+    stats->peakGigabytesPerSecond = gigabytesPerSecond;
+    stats->peakGigaopsPerSecond = gigaopsPerSecond;
+}
+
+bool addKernelStatsEvent(KernelStats* stats, cl_event event)
+{
+    cl_ulong startTime = 0;
+    cl_ulong endTime = 0;
+    if (!checkSuccess(clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &startTime, NULL)) ||
+        !checkSuccess(clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &endTime, NULL)))
+    {
+        cerr << "Retrieving OpenCL profiling information failed. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    const cl_ulong time = endTime - startTime;
+    if (stats->launches == 0 || time < stats->minimumTime)
+    {
+        stats->minimumTime = time;
+    }
+    if (stats->launches == 0 || time > stats->maximumTime)
+    {
+        stats->maximumTime = time;
+    }
+    stats->totalTime += time;
+    stats->launches++;
+    return true;
+}
+
+bool getKernelMetrics(const KernelStats* stats, KernelMetrics* metrics)
+{
+    if (stats->launches == 0 || stats->totalTime == 0)
+    {
+        return false;
+    }
+
+    /* Rates are the total work of all the launches over their total execution time. OpenCL times are in nanoseconds. */
+    const double seconds = stats->totalTime / 1e9;
+    const double bytes = (stats->bytesRead + stats->bytesWritten) * stats->launches;
+    const double operations = stats->operations * stats->launches;
+
+    metrics->meanTime = stats->totalTime / 1e6 / stats->launches;
+    metrics->gigabytesPerSecond = bytes / seconds / 1e9;
+    metrics->gigaopsPerSecond = operations / seconds / 1e9;
+    metrics->arithmeticIntensity = bytes > 0.0 ? operations / bytes : 0.0;
+    metrics->bandwidthFraction = stats->peakGigabytesPerSecond > 0.0 ? metrics->gigabytesPerSecond / stats->peakGigabytesPerSecond : 0.0;
+    metrics->operationsFraction = stats->peakGigaopsPerSecond > 0.0 ? metrics->gigaopsPerSecond / stats->peakGigaopsPerSecond : 0.0;
+
+    /* A kernel cannot do more operations per second than its intensity allows at the peak bandwidth, nor more than the peak operation rate. */
+    metrics->attainableGigaopsPerSecond = 0.0;
+    metrics->memoryBound = false;
+    if (stats->peakGigabytesPerSecond > 0.0 && stats->peakGigaopsPerSecond > 0.0)
+    {
+        const double bandwidthBound = metrics->arithmeticIntensity * stats->peakGigabytesPerSecond;
+        metrics->memoryBound = bandwidthBound < stats->peakGigaopsPerSecond;
+        metrics->attainableGigaopsPerSecond = metrics->memoryBound ? bandwidthBound : stats->peakGigaopsPerSecond;
+    }
+
+    return true;
+}
+
+bool printKernelStats(const KernelStats* stats)
+{
+    KernelMetrics metrics;
+    if (!getKernelMetrics(stats, &metrics))
+    {
+        cerr << "No profiling information for " << stats->name << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    cout << "Kernel statistics for " << stats->name << " (" << stats->launches << " launches):\n";
+    cout << "Run time: \t" << metrics.meanTime << "ms mean, " << stats->minimumTime / 1000000.0 << "ms min, " << stats->maximumTime / 1000000.0 << "ms max\n";
+    cout << "Bandwidth: \t" << metrics.gigabytesPerSecond << " GB/s";
+    if (stats->peakGigabytesPerSecond > 0.0)
+    {
+        cout << " (" << metrics.bandwidthFraction * 100.0 << "% of peak)";
+    }
+    cout << "\nOperations: \t" << metrics.gigaopsPerSecond << " Gop/s";
+    if (stats->peakGigaopsPerSecond > 0.0)
+    {
+        cout << " (" << metrics.operationsFraction * 100.0 << "% of peak)";
+    }
+    cout << "\nIntensity: \t" << metrics.arithmeticIntensity << " op/byte";
+    if (metrics.attainableGigaopsPerSecond > 0.0)
+    {
+        cout << ", " << (metrics.memoryBound ? "memory" : "compute") << " bound at " << metrics.attainableGigaopsPerSecond << " Gop/s";
+    }
+    cout << endl;
+    return true;
+}
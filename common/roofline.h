@@ -0,0 +1,99 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef ROOFLINE_H
+#define ROOFLINE_H
+
+#include <CL/cl.h>
+#include <string>
+
+/**
+ * \file roofline.h
+ * \brief Roofline metrics of kernels: achieved bandwidth, operation rate and arithmetic intensity, relative to a device peak.
+ */
+
+/**
+ * \brief Execution times of a kernel and the work it does per launch.
+ * \details The caller declares the bytes and operations of one launch, then adds the event of every launch.
+ *          Sums over the launches give metrics which are comparable between variants of a kernel, such as sobel and sobel_no_vectors.
+ */
+struct KernelStats
+{
+    std::string name; /**< \brief Name printed with the metrics. */
+    double bytesRead; /**< \brief Bytes read from global memory by one launch. */
+    double bytesWritten; /**< \brief Bytes written to global memory by one launch. */
+    double operations; /**< \brief Arithmetic operations of one launch. Floating point operations for float kernels. */
+    double peakGigabytesPerSecond; /**< \brief Peak memory bandwidth of the device in GB/s, 0 if unknown. */
+    double peakGigaopsPerSecond; /**< \brief Peak operation rate of the device in Gop/s, 0 if unknown. */
+    int launches; /**< \brief Number of events added. */
+    cl_ulong totalTime; /**< \brief Sum of the execution times of the launches, in nanoseconds. */
+    cl_ulong minimumTime; /**< \brief Shortest execution time, in nanoseconds. */
+    cl_ulong maximumTime; /**< \brief Longest execution time, in nanoseconds. */
+};
+
+/**
+ * \brief Metrics derived from a KernelStats.
+ */
+struct KernelMetrics
+{
+    double meanTime; /**< \brief Mean execution time in milliseconds. */
+    double gigabytesPerSecond; /**< \brief Achieved bandwidth in GB/s. */
+    double gigaopsPerSecond; /**< \brief Achieved operation rate in Gop/s. */
+    double arithmeticIntensity; /**< \brief Operations per byte of memory traffic. */
+    double bandwidthFraction; /**< \brief Fraction of the peak bandwidth achieved, 0 if the peak is unknown. */
+    double operationsFraction; /**< \brief Fraction of the peak operation rate achieved, 0 if the peak is unknown. */
+    double attainableGigaopsPerSecond; /**< \brief Roofline bound min(peak operation rate, intensity * peak bandwidth), 0 if a peak is unknown. */
+    bool memoryBound; /**< \brief True if the roofline bound is set by the bandwidth rather than the operation rate. */
+};
+
+/**
+ * \brief Start collecting statistics for a kernel.
+ * \details The device peak is read from the environment variables CL_PEAK_GBPS and CL_PEAK_GOPS if they are set,
+ *          otherwise it is unknown and only the achieved rates are reported. Use setKernelStatsPeak to set it in code.
+ * \param[out] stats The statistics to initialize.
+ * \param[in] name Name printed with the metrics.
+ * \param[in] bytesRead Bytes read from global memory by one launch.
+ * \param[in] bytesWritten Bytes written to global memory by one launch.
+ * \param[in] operations Arithmetic operations of one launch.
+ */
+void initializeKernelStats(KernelStats* stats, const std::string& name, double bytesRead, double bytesWritten, double operations);
+
+/**
+ * \brief Set the peak of the device the kernel runs on.
+ * \param[in,out] stats The statistics.
+ * \param[in] gigabytesPerSecond Peak memory bandwidth in GB/s, 0 if unknown.
+ * \param[in] gigaopsPerSecond Peak operation rate in Gop/s, 0 if unknown.
+ */
+void setKernelStatsPeak(KernelStats* stats, double gigabytesPerSecond, double gigaopsPerSecond);
+
+/**
+ * \brief Add the execution time of one launch.
+ * \param[in,out] stats The statistics.
+ * \param[in] event Event of a completed launch, from a command queue with profiling enabled.
+ * \return False if an error occurred, otherwise true.
+ */
+bool addKernelStatsEvent(KernelStats* stats, cl_event event);
+
+/**
+ * \brief Calculate the metrics of the launches added so far.
+ * \param[in] stats The statistics.
+ * \param[out] metrics The metrics.
+ * \return False if no launches have been added, otherwise true.
+ */
+bool getKernelMetrics(const KernelStats* stats, KernelMetrics* metrics);
+
+/**
+ * \brief Print the metrics of the launches added so far.
+ * \param[in] stats The statistics.
+ * \return False if an error occurred, otherwise true.
+ */
+bool printKernelStats(const KernelStats* stats);
+
+#endif
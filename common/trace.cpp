@@ -0,0 +1,335 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "trace.h"
+#include "common.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <sys/time.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * \brief A command recorded on a device timeline.
+ */
+struct TracedCommand
+{
+    cl_event event; /**< \brief Retained event of the command. */
+    string name; /**< \brief Name shown on the timeline. */
+    string category; /**< \brief "kernel" or "memory". */
+    string arguments; /**< \brief JSON object members shown with the command. */
+    double hostTime; /**< \brief Host time in microseconds at which the command was traced. */
+    int queueIndex; /**< \brief Index of the command queue in tracedQueues. */
+};
+
+/**
+ * \brief A host span which has been started but not ended.
+ */
+struct OpenSpan
+{
+    string name; /**< \brief Name shown on the timeline. */
+    double startTime; /**< \brief Host time in microseconds at which the span started. */
+};
+
+/* State of the trace. Tracing is only done from the host thread which drives OpenCL. */
+static bool tracingChecked = false;
+static bool tracingEnabled = false;
+static bool traceWritten = false;
+static string traceFilename;
+/* Host time at which tracing was enabled. Trace times are relative to it. */
+static double traceOrigin = 0.0;
+static vector<TracedCommand> tracedCommands;
+static vector<cl_command_queue> tracedQueues;
+static vector<OpenSpan> openSpans;
+/* Chrome trace events of the completed host spans. */
+static ostringstream hostEvents;
+
+/**
+ * \brief Current host time.
+ * \return Microseconds since the epoch.
+ */
+static double hostTime(void)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec * 1e6 + now.tv_usec - traceOrigin;
+}
+
+/**
+ * \brief Escape a string for use in a JSON string literal.
+ * \param[in] text The string to escape.
+ * \return The escaped string, without quotes.
+ */
+static string escapeJson(const string& text)
+{
+    string escaped;
+    for (size_t index = 0; index < text.size(); index++)
+    {
+        const char character = text[index];
+        if (character == '"' || character == '\\')
+        {
+            escaped += '\\';
+        }
+        if ((unsigned char)character >= 0x20)
+        {
+            escaped += character;
+        }
+    }
+    return escaped;
+}
+
+static void writeTraceAtExit(void)
+{
+    /* Don't replace a trace written explicitly with an empty one. */
+    if (!traceWritten || !tracedCommands.empty() || !hostEvents.str().empty())
+    {
+        writeTrace();
+    }
+}
+
+void enableTracing(const string& filename)
+{
+    if (!tracingEnabled)
+    {
+        traceOrigin = hostTime();
+        atexit(writeTraceAtExit);
+    }
+    tracingChecked = true;
+    tracingEnabled = true;
+    traceFilename = filename;
+}
+
+bool isTracingEnabled(void)
+{
+    if (!tracingChecked)
+    {
+        tracingChecked = true;
+        const char* filename = getenv("CL_TRACE_FILE");
+        if (filename != NULL && filename[0] != '\0')
+        {
+            enableTracing(filename);
+        }
+    }
+    return tracingEnabled;
+}
+
+/**
+ * \brief Retain an event and add it to the trace.
+ * \param[in] event The event of the command.
+ * \param[in] name Name shown on the timeline.
+ * \param[in] category Category of the command.
+ * \param[in] arguments JSON object members shown with the command.
+ * \return False if an error occurred, otherwise true.
+ */
+static bool addTracedCommand(cl_event event, const string& name, const string& category, const string& arguments)
+{
+    TracedCommand command;
+    command.hostTime = hostTime();
+
+    cl_command_queue queue = 0;
+    if (!checkSuccess(clGetEventInfo(event, CL_EVENT_COMMAND_QUEUE, sizeof(cl_command_queue), &queue, NULL)) ||
+        !checkSuccess(clRetainEvent(event)))
+    {
+        cerr << "Failed tracing the command " << name << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    command.queueIndex = (int)tracedQueues.size();
+    for (size_t index = 0; index < tracedQueues.size(); index++)
+    {
+        if (tracedQueues[index] == queue)
+        {
+            command.queueIndex = (int)index;
+        }
+    }
+    if (command.queueIndex == (int)tracedQueues.size())
+    {
+        tracedQueues.push_back(queue);
+    }
+
+    command.event = event;
+    command.name = name;
+    command.category = category;
+    command.arguments = arguments;
+    tracedCommands.push_back(command);
+    return true;
+}
+
+bool traceKernel(cl_event event, cl_kernel kernel, cl_uint workDimensions, const size_t* globalWorksize, const size_t* localWorksize)
+{
+    if (!isTracingEnabled())
+    {
+        return true;
+    }
+
+    size_t nameSize = 0;
+    string name = "kernel";
+    if (checkSuccess(clGetKernelInfo(kernel, CL_KERNEL_FUNCTION_NAME, 0, NULL, &nameSize)) && nameSize > 1)
+    {
+        vector<char> kernelName(nameSize);
+        if (checkSuccess(clGetKernelInfo(kernel, CL_KERNEL_FUNCTION_NAME, nameSize, &kernelName[0], NULL)))
+        {
+            name = &kernelName[0];
+        }
+    }
+
+    ostringstream arguments;
+    arguments << "\"global\":\"";
+    for (cl_uint dimension = 0; dimension < workDimensions; dimension++)
+    {
+        arguments << (dimension == 0 ? "" : "x") << globalWorksize[dimension];
+    }
+    arguments << "\",\"local\":\"";
+    for (cl_uint dimension = 0; dimension < workDimensions; dimension++)
+    {
+        if (localWorksize == NULL)
+        {
+            arguments << "auto";
+            break;
+        }
+        arguments << (dimension == 0 ? "" : "x") << localWorksize[dimension];
+    }
+    arguments << "\"";
+
+    return addTracedCommand(event, name, "kernel", arguments.str());
+}
+
+bool traceCommand(cl_event event, const string& name, size_t bytes)
+{
+    if (!isTracingEnabled())
+    {
+        return true;
+    }
+
+    ostringstream arguments;
+    arguments << "\"bytes\":" << bytes;
+    return addTracedCommand(event, name, "memory", arguments.str());
+}
+
+cl_event* traceEvent(cl_event* event)
+{
+    *event = 0;
+    return isTracingEnabled() ? event : NULL;
+}
+
+bool traceAndReleaseCommand(cl_event event, const string& name, size_t bytes)
+{
+    if (event == 0)
+    {
+        return true;
+    }
+
+    bool returnValue = traceCommand(event, name, bytes);
+    returnValue &= checkSuccess(clReleaseEvent(event));
+    return returnValue;
+}
+
+void traceHostBegin(const string& name)
+{
+    if (!isTracingEnabled())
+    {
+        return;
+    }
+
+    OpenSpan span;
+    span.name = name;
+    span.startTime = hostTime();
+    openSpans.push_back(span);
+}
+
+void traceHostEnd(void)
+{
+    if (!isTracingEnabled() || openSpans.empty())
+    {
+        return;
+    }
+
+    const OpenSpan& span = openSpans.back();
+    hostEvents << ",\n{\"name\":\"" << escapeJson(span.name) << "\",\"cat\":\"host\",\"ph\":\"X\",\"pid\":" << getpid()
+               << ",\"tid\":0,\"ts\":" << span.startTime << ",\"dur\":" << hostTime() - span.startTime << "}";
+    openSpans.pop_back();
+}
+
+bool writeTrace(void)
+{
+    if (!isTracingEnabled())
+    {
+        return true;
+    }
+
+    ofstream traceFile(traceFilename.c_str());
+    if (!traceFile.is_open())
+    {
+        cerr << "Unable to open " << traceFilename << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    traceFile.setf(ios::fixed);
+    traceFile.precision(3);
+
+    const int processId = getpid();
+    traceFile << "{\"traceEvents\":[\n";
+    traceFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << processId << ",\"tid\":0,\"args\":{\"name\":\"Host\"}}";
+    for (size_t index = 0; index < tracedQueues.size(); index++)
+    {
+        traceFile << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << processId << ",\"tid\":" << index + 1
+                  << ",\"args\":{\"name\":\"Command queue " << index << "\"}}";
+    }
+    traceFile << hostEvents.str();
+
+    bool returnValue = true;
+    for (size_t index = 0; index < tracedCommands.size(); index++)
+    {
+        TracedCommand& command = tracedCommands[index];
+
+        /*
+         * Profiling times are on the device clock. The command was queued just before it was traced,
+         * so its start on the host clock is the host trace time plus the time it spent queued and submitted.
+         */
+        cl_ulong queuedTime = 0;
+        cl_ulong startTime = 0;
+        cl_ulong endTime = 0;
+        if (checkSuccess(clWaitForEvents(1, &command.event)) &&
+            checkSuccess(clGetEventProfilingInfo(command.event, CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &queuedTime, NULL)) &&
+            checkSuccess(clGetEventProfilingInfo(command.event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &startTime, NULL)) &&
+            checkSuccess(clGetEventProfilingInfo(command.event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &endTime, NULL)))
+        {
+            traceFile << ",\n{\"name\":\"" << escapeJson(command.name) << "\",\"cat\":\"" << command.category
+                      << "\",\"ph\":\"X\",\"pid\":" << processId << ",\"tid\":" << command.queueIndex + 1
+                      << ",\"ts\":" << command.hostTime + (startTime - queuedTime) / 1000.0
+                      << ",\"dur\":" << (endTime - startTime) / 1000.0
+                      << ",\"args\":{" << command.arguments << ",\"queued\":" << (startTime - queuedTime) / 1000.0 << "}}";
+        }
+        else
+        {
+            cerr << "No profiling information for the traced command " << command.name << ". " << __FILE__ << ":"<< __LINE__ << endl;
+            returnValue = false;
+        }
+
+        returnValue &= checkSuccess(clReleaseEvent(command.event));
+    }
+    traceFile << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    tracedCommands.clear();
+    tracedQueues.clear();
+    hostEvents.str("");
+    traceWritten = true;
+
+    if (traceFile.bad())
+    {
+        cerr << "Failed writing " << traceFilename << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return returnValue;
+}
@@ -0,0 +1,114 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <CL/cl.h>
+#include <string>
+
+/**
+ * \file trace.h
+ * \brief Timeline of OpenCL commands and host work, written as a Chrome trace (chrome://tracing, Perfetto).
+ * \details Tracing is off unless enableTracing is called or the environment variable CL_TRACE_FILE names an output file.
+ *          While it is off every function here returns immediately.
+ *          Traced events are retained and their profiling information is read when the trace is written,
+ *          which happens at exit or when writeTrace is called. Command queues must have profiling enabled.
+ *          Device commands are placed on the host timeline by the host time at which they were traced,
+ *          which should be straight after the enqueue call, so overlap between host work and commands is visible.
+ */
+
+/**
+ * \brief Turn on tracing and write the trace to a file at exit.
+ * \param[in] filename The file to write the Chrome trace JSON to.
+ */
+void enableTracing(const std::string& filename);
+
+/**
+ * \brief Whether commands and host spans are being recorded.
+ * \return True if enableTracing was called or CL_TRACE_FILE is set.
+ */
+bool isTracingEnabled(void);
+
+/**
+ * \brief Record a kernel launch.
+ * \param[in] event Event returned by clEnqueueNDRangeKernel. It is retained until the trace is written.
+ * \param[in] kernel The kernel launched, used for its name.
+ * \param[in] workDimensions Number of work dimensions.
+ * \param[in] globalWorksize Global work size of each dimension.
+ * \param[in] localWorksize Local work size of each dimension, or NULL if the implementation chose it.
+ * \return False if an error occurred, otherwise true.
+ */
+bool traceKernel(cl_event event, cl_kernel kernel, cl_uint workDimensions, const size_t* globalWorksize, const size_t* localWorksize);
+
+/**
+ * \brief Record a memory command such as a map, unmap, read, write or copy.
+ * \param[in] event Event returned by the enqueue call. It is retained until the trace is written.
+ * \param[in] name Name shown on the timeline.
+ * \param[in] bytes Size of the transfer or mapped region.
+ * \return False if an error occurred, otherwise true.
+ */
+bool traceCommand(cl_event event, const std::string& name, size_t bytes);
+
+/**
+ * \brief Event argument of an enqueue call to be recorded with traceAndReleaseCommand.
+ * \details Commands which don't otherwise need an event only get one while tracing is enabled.
+ * \param[out] event Set to 0, then to the event of the command by the enqueue call.
+ * \return event if tracing is enabled, otherwise NULL.
+ */
+cl_event* traceEvent(cl_event* event);
+
+/**
+ * \brief Record a memory command enqueued with traceEvent, then release its event.
+ * \details Does nothing if event is 0, so it can follow a failed enqueue or one made with tracing disabled.
+ * \param[in] event Event set by the enqueue call.
+ * \param[in] name Name shown on the timeline.
+ * \param[in] bytes Size of the transfer or mapped region.
+ * \return False if an error occurred, otherwise true.
+ */
+bool traceAndReleaseCommand(cl_event event, const std::string& name, size_t bytes);
+
+/**
+ * \brief Start a span of host work on the host timeline. Spans nest.
+ * \param[in] name Name shown on the timeline.
+ */
+void traceHostBegin(const std::string& name);
+
+/**
+ * \brief End the most recently started host span.
+ */
+void traceHostEnd(void);
+
+/**
+ * \brief A host span which lasts for the scope of the object, so it is ended on every return path.
+ */
+struct TraceSpan
+{
+    /**
+     * \brief Start the span.
+     * \param[in] name Name shown on the timeline.
+     */
+    TraceSpan(const std::string& name) { traceHostBegin(name); }
+
+    /**
+     * \brief End the span.
+     */
+    ~TraceSpan() { traceHostEnd(); }
+};
+
+/**
+ * \brief Write everything recorded so far to the trace file and release the traced events.
+ * \details Called at exit when tracing is enabled. Waits for the traced commands to complete.
+ *          Each call replaces the trace file, so call it once, after the work of interest.
+ * \return False if an error occurred, otherwise true.
+ */
+bool writeTrace(void);
+
+#endif
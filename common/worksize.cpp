@@ -0,0 +1,353 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "worksize.h"
+#include "common.h"
+#include "device.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * \brief A possible local work size and what it costs.
+ */
+struct WorksizeCandidate
+{
+    size_t localWorksize[3];
+    size_t paddedGlobalWorksize[3];
+    /** Number of work-items in a work-group. */
+    size_t product;
+    /** Fraction of padded work-items, which do no work. */
+    double waste;
+    /** How far the shape of the work-group is from the shape of the global work size, as a difference of logarithms. */
+    double aspectError;
+};
+
+/**
+ * \brief Orders candidates from best to worst.
+ */
+struct WorksizeOrder
+{
+    size_t preferredMultiple;
+
+    bool operator()(const WorksizeCandidate& first, const WorksizeCandidate& second) const
+    {
+        const bool firstPreferred = first.product % preferredMultiple == 0;
+        const bool secondPreferred = second.product % preferredMultiple == 0;
+        if (firstPreferred != secondPreferred)
+        {
+            return firstPreferred;
+        }
+
+        /* Padding more than an eighth of the work costs more than a larger work-group gains. */
+        const bool firstCheap = first.waste <= 0.125;
+        const bool secondCheap = second.waste <= 0.125;
+        if (firstCheap != secondCheap)
+        {
+            return firstCheap;
+        }
+
+        if (first.product != second.product)
+        {
+            return first.product > second.product;
+        }
+        if (first.waste != second.waste)
+        {
+            return first.waste < second.waste;
+        }
+        if (first.aspectError != second.aspectError)
+        {
+            return first.aspectError < second.aspectError;
+        }
+
+        /* Work-items next to each other in dimension 0 usually access memory next to each other. */
+        return first.localWorksize[0] > second.localWorksize[0];
+    }
+};
+
+/**
+ * \brief A kernel launch whose local work size has been measured.
+ */
+struct MeasuredWorksizeKey
+{
+    cl_kernel kernel;
+    cl_uint workDimensions;
+    size_t globalWorksize[3];
+    bool allowPadding;
+
+    bool operator<(const MeasuredWorksizeKey& other) const
+    {
+        if (kernel != other.kernel)
+        {
+            return kernel < other.kernel;
+        }
+        if (workDimensions != other.workDimensions)
+        {
+            return workDimensions < other.workDimensions;
+        }
+        for (int dimension = 0; dimension < 3; dimension++)
+        {
+            if (globalWorksize[dimension] != other.globalWorksize[dimension])
+            {
+                return globalWorksize[dimension] < other.globalWorksize[dimension];
+            }
+        }
+        return allowPadding < other.allowPadding;
+    }
+};
+
+/* The fastest local work size of each kernel launch measured so far. */
+static map<MeasuredWorksizeKey, WorksizeCandidate> measuredWorksizes;
+
+/**
+ * \brief List the local work sizes a kernel launch can use, best first.
+ * \param[in] kernel The kernel to launch.
+ * \param[in] device The device the kernel runs on.
+ * \param[in] workDimensions Number of dimensions of the work sizes, 1 to 3.
+ * \param[in] globalWorksize The global work size the kernel needs.
+ * \param[in] allowPadding True if the global work size can be padded.
+ * \param[out] candidates The local work sizes. Never empty, as a work-group of 1 is always possible.
+ * \return False if an error occurred, otherwise true.
+ */
+static bool findWorksizeCandidates(cl_kernel kernel, cl_device_id device, cl_uint workDimensions, const size_t* globalWorksize,
+                                   bool allowPadding, vector<WorksizeCandidate>* candidates)
+{
+    if (workDimensions < 1 || workDimensions > 3)
+    {
+        cerr << "Work sizes must have 1 to 3 dimensions. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    size_t global[3] = {1, 1, 1};
+    for (cl_uint dimension = 0; dimension < workDimensions; dimension++)
+    {
+        if (globalWorksize[dimension] == 0)
+        {
+            cerr << "The global work size must not be 0. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+        global[dimension] = globalWorksize[dimension];
+    }
+
+    const DeviceInfo* deviceInfo = NULL;
+    size_t maximumWorkGroupSize = 0;
+    size_t preferredMultiple = 0;
+    bool queryInfoSuccess = getDeviceInfo(device, &deviceInfo);
+    queryInfoSuccess &= checkSuccess(clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &maximumWorkGroupSize, NULL));
+    queryInfoSuccess &= checkSuccess(clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof(size_t), &preferredMultiple, NULL));
+    if (!queryInfoSuccess)
+    {
+        cerr << "Failed to query the work-group limits of the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    maximumWorkGroupSize = max((size_t)1, maximumWorkGroupSize);
+    preferredMultiple = max((size_t)1, preferredMultiple);
+
+    /*
+     * The sizes each dimension can have: divisors of the global work size, or powers of 2 up to it when it can be padded.
+     * The third dimension is usually a small count of images or planes, so its work-groups are 1 deep.
+     */
+    vector<size_t> sizes[2];
+    for (cl_uint dimension = 0; dimension < 2; dimension++)
+    {
+        size_t limit = dimension < workDimensions ? maximumWorkGroupSize : 1;
+        if (dimension < deviceInfo->maximumWorkItemSizes.size())
+        {
+            limit = max((size_t)1, min(limit, deviceInfo->maximumWorkItemSizes[dimension]));
+        }
+
+        if (allowPadding)
+        {
+            /* Up to the first power of 2 which covers the global work size. */
+            for (size_t size = 1; size <= limit && size / 2 < global[dimension]; size *= 2)
+            {
+                sizes[dimension].push_back(size);
+            }
+        }
+        else
+        {
+            for (size_t size = 1; size <= min(limit, global[dimension]); size++)
+            {
+                if (global[dimension] % size == 0)
+                {
+                    sizes[dimension].push_back(size);
+                }
+            }
+        }
+    }
+
+    const double globalItems = (double)global[0] * global[1] * global[2];
+    const double globalAspect = log((double)global[0] / global[1]);
+
+    candidates->clear();
+    for (size_t first = 0; first < sizes[0].size(); first++)
+    {
+        for (size_t second = 0; second < sizes[1].size() && sizes[0][first] * sizes[1][second] <= maximumWorkGroupSize; second++)
+        {
+            WorksizeCandidate candidate;
+            candidate.localWorksize[0] = sizes[0][first];
+            candidate.localWorksize[1] = sizes[1][second];
+            candidate.localWorksize[2] = 1;
+            double paddedItems = 1.0;
+            for (int dimension = 0; dimension < 3; dimension++)
+            {
+                const size_t local = candidate.localWorksize[dimension];
+                candidate.paddedGlobalWorksize[dimension] = ((global[dimension] + local - 1) / local) * local;
+                paddedItems *= candidate.paddedGlobalWorksize[dimension];
+            }
+            candidate.product = candidate.localWorksize[0] * candidate.localWorksize[1];
+            candidate.waste = paddedItems / globalItems - 1.0;
+            candidate.aspectError = workDimensions > 1 ? fabs(log((double)candidate.localWorksize[0] / candidate.localWorksize[1]) - globalAspect) : 0.0;
+            candidates->push_back(candidate);
+        }
+    }
+
+    WorksizeOrder order;
+    order.preferredMultiple = preferredMultiple;
+    sort(candidates->begin(), candidates->end(), order);
+    return true;
+}
+
+/**
+ * \brief Copy a candidate to the outputs of chooseLocalWorksize.
+ */
+static void returnWorksize(const WorksizeCandidate& candidate, cl_uint workDimensions, size_t* localWorksize, size_t* paddedGlobalWorksize)
+{
+    for (cl_uint dimension = 0; dimension < workDimensions; dimension++)
+    {
+        localWorksize[dimension] = candidate.localWorksize[dimension];
+        paddedGlobalWorksize[dimension] = candidate.paddedGlobalWorksize[dimension];
+    }
+}
+
+bool chooseLocalWorksize(cl_kernel kernel, cl_device_id device, cl_uint workDimensions, const size_t* globalWorksize,
+                         bool allowPadding, size_t* localWorksize, size_t* paddedGlobalWorksize)
+{
+    vector<WorksizeCandidate> candidates;
+    if (!findWorksizeCandidates(kernel, device, workDimensions, globalWorksize, allowPadding, &candidates))
+    {
+        return false;
+    }
+
+    returnWorksize(candidates[0], workDimensions, localWorksize, paddedGlobalWorksize);
+    return true;
+}
+
+bool measureLocalWorksize(cl_command_queue commandQueue, cl_kernel kernel, cl_device_id device, cl_uint workDimensions, const size_t* globalWorksize,
+                          bool allowPadding, size_t* localWorksize, size_t* paddedGlobalWorksize)
+{
+    MeasuredWorksizeKey key;
+    key.kernel = kernel;
+    key.workDimensions = workDimensions;
+    key.allowPadding = allowPadding;
+    for (cl_uint dimension = 0; dimension < 3; dimension++)
+    {
+        key.globalWorksize[dimension] = dimension < workDimensions ? globalWorksize[dimension] : 1;
+    }
+
+    map<MeasuredWorksizeKey, WorksizeCandidate>::iterator measured = measuredWorksizes.find(key);
+    if (measured != measuredWorksizes.end())
+    {
+        returnWorksize(measured->second, workDimensions, localWorksize, paddedGlobalWorksize);
+        return true;
+    }
+
+    vector<WorksizeCandidate> candidates;
+    if (!findWorksizeCandidates(kernel, device, workDimensions, globalWorksize, allowPadding, &candidates))
+    {
+        return false;
+    }
+
+    cl_command_queue_properties properties = 0;
+    if (!checkSuccess(clGetCommandQueueInfo(commandQueue, CL_QUEUE_PROPERTIES, sizeof(properties), &properties, NULL)))
+    {
+        cerr << "Failed to query the command queue properties. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    if ((properties & CL_QUEUE_PROFILING_ENABLE) == 0)
+    {
+        measuredWorksizes[key] = candidates[0];
+        returnWorksize(candidates[0], workDimensions, localWorksize, paddedGlobalWorksize);
+        return true;
+    }
+
+    /* Time the best shape of each work-group size, as the size matters more than the shape. */
+    const WorksizeCandidate* fastest = &candidates[0];
+    cl_ulong fastestTime = 0;
+    bool timed = false;
+    vector<size_t> timedProducts;
+    for (size_t index = 0; index < candidates.size() && (int)timedProducts.size() < maximumMeasuredWorksizes; index++)
+    {
+        const WorksizeCandidate& candidate = candidates[index];
+        if (find(timedProducts.begin(), timedProducts.end(), candidate.product) != timedProducts.end())
+        {
+            continue;
+        }
+        timedProducts.push_back(candidate.product);
+
+        /* A work-group size can fail if the kernel uses too much local memory or too many registers for it, that candidate is skipped. */
+        cl_event event = 0;
+        if (clEnqueueNDRangeKernel(commandQueue, kernel, workDimensions, NULL, candidate.paddedGlobalWorksize, candidate.localWorksize, 0, NULL, NULL) != CL_SUCCESS ||
+            clEnqueueNDRangeKernel(commandQueue, kernel, workDimensions, NULL, candidate.paddedGlobalWorksize, candidate.localWorksize, 0, NULL, &event) != CL_SUCCESS)
+        {
+            continue;
+        }
+
+        cl_ulong start = 0;
+        cl_ulong end = 0;
+        bool timeSuccess = checkSuccess(clWaitForEvents(1, &event));
+        timeSuccess &= checkSuccess(clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL));
+        timeSuccess &= checkSuccess(clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL));
+        clReleaseEvent(event);
+        if (!timeSuccess)
+        {
+            cerr << "Failed timing a local work size. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+
+        if (!timed || end - start < fastestTime)
+        {
+            fastest = &candidate;
+            fastestTime = end - start;
+            timed = true;
+        }
+    }
+
+    if (!timed)
+    {
+        cerr << "Failed to run the kernel with any of the candidate local work sizes. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    measuredWorksizes[key] = *fastest;
+    returnWorksize(*fastest, workDimensions, localWorksize, paddedGlobalWorksize);
+    return true;
+}
+
+void forgetLocalWorksizes(cl_kernel kernel)
+{
+    map<MeasuredWorksizeKey, WorksizeCandidate>::iterator entry = measuredWorksizes.begin();
+    while (entry != measuredWorksizes.end())
+    {
+        if (entry->first.kernel == kernel)
+        {
+            measuredWorksizes.erase(entry++);
+        }
+        else
+        {
+            ++entry;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef WORKSIZE_H
+#define WORKSIZE_H
+
+#include <CL/cl.h>
+#include <cstddef>
+
+/**
+ * \file worksize.h
+ * \brief Choosing the local work size of a kernel launch.
+ * \details Passing NULL as the local work size leaves the choice to the driver, which knows nothing about how the kernel accesses memory.
+ *          chooseLocalWorksize picks a work-group shape from the limits of the kernel (CL_KERNEL_WORK_GROUP_SIZE),
+ *          its preferred work-group size multiple (CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE) and the aspect ratio of the global work size:
+ *          the largest work-group which is a multiple of the preferred size, shaped like the global work size
+ *          so there are about as many work-groups across as down.
+ *          measureLocalWorksize times a few candidates once and remembers the fastest for each kernel and global work size.
+ *
+ *          In OpenCL 1.1 the global work size must be a multiple of the local work size.
+ *          Kernels which check their work-item IDs against the problem size can have the global work size padded up,
+ *          which leaves more freedom in the choice; the others only get local work sizes which divide the global work size.
+ */
+
+/**
+ * \brief Largest number of local work sizes timed by measureLocalWorksize.
+ */
+const int maximumMeasuredWorksizes = 8;
+
+/**
+ * \brief Choose a local work size for a kernel launch.
+ * \param[in] kernel The kernel to launch.
+ * \param[in] device The device the kernel runs on.
+ * \param[in] workDimensions Number of dimensions of the work sizes, 1 to 3. The third dimension always gets a local size of 1.
+ * \param[in] globalWorksize The global work size the kernel needs.
+ * \param[in] allowPadding True if the kernel checks its work-item IDs, so the global work size can be padded.
+ * \param[out] localWorksize The local work size, workDimensions values.
+ * \param[out] paddedGlobalWorksize The global work size to enqueue, a multiple of localWorksize. Equal to globalWorksize if allowPadding is false.
+ * \return False if an error occurred, otherwise true.
+ */
+bool chooseLocalWorksize(cl_kernel kernel, cl_device_id device, cl_uint workDimensions, const size_t* globalWorksize,
+                         bool allowPadding, size_t* localWorksize, size_t* paddedGlobalWorksize);
+
+/**
+ * \brief Choose a local work size for a kernel launch by timing candidates.
+ * \details The first call for a kernel and global work size runs the kernel once with each candidate local work size
+ *          (after one untimed run) and remembers the fastest. Later calls return the remembered size without running anything.
+ *          The kernel runs with the arguments already set, so it must give the same results when it is run several times.
+ *          If the command queue does not have profiling enabled, the choice of chooseLocalWorksize is used.
+ * \param[in] commandQueue The command queue to time the kernel on.
+ * \param[in] kernel The kernel to launch, with all its arguments set.
+ * \param[in] device The device the kernel runs on.
+ * \param[in] workDimensions Number of dimensions of the work sizes, 1 to 3.
+ * \param[in] globalWorksize The global work size the kernel needs.
+ * \param[in] allowPadding True if the kernel checks its work-item IDs, so the global work size can be padded.
+ * \param[out] localWorksize The local work size, workDimensions values.
+ * \param[out] paddedGlobalWorksize The global work size to enqueue, a multiple of localWorksize.
+ * \return False if an error occurred or the kernel could not be run with any of the candidates, otherwise true.
+ */
+bool measureLocalWorksize(cl_command_queue commandQueue, cl_kernel kernel, cl_device_id device, cl_uint workDimensions, const size_t* globalWorksize,
+                          bool allowPadding, size_t* localWorksize, size_t* paddedGlobalWorksize);
+
+/**
+ * \brief Forget the measured local work sizes of a kernel.
+ * \details Call before releasing a kernel which was passed to measureLocalWorksize, as its handle can be reused by a new kernel.
+ * \param[in] kernel The kernel.
+ */
+void forgetLocalWorksizes(cl_kernel kernel);
+
+#endif
@@ -0,0 +1,32 @@
+# This confidential and proprietary software may be used only as
+# authorised by a licensing agreement from ARM Limited
+#   (C) COPYRIGHT 2013 ARM Limited
+#       ALL RIGHTS RESERVED
+# The entire notice above must be reproduced on all authorised
+# copies and copies may only be made to the extent permitted
+# by a licensing agreement from ARM Limited.
+
+# Embedded kernel sources, included at the end of a sample Makefile.
+# Building with "make EMBED_KERNELS=1" compiles assets/*.cl into the executable,
+# so createProgram does not read them at startup and the executable runs from any directory.
+
+EMBEDDED_SOURCES:=embedded_sources.cpp
+
+ifdef EMBED_KERNELS
+OBJECTS+=$(EMBEDDED_SOURCES:.cpp=.o)
+
+$(EXECUTABLE): $(EMBEDDED_SOURCES:.cpp=.o)
+
+$(EMBEDDED_SOURCES): $(wildcard assets/*.cl) embedSources
+	$(ROOT)/tools/embed_sources $@ $(wildcard assets/*.cl)
+endif
+
+.PHONY: embedSources cleanEmbeddedSources
+
+embedSources:
+	cd $(ROOT)/tools $(CONCATENATE) $(MAKE) embed_sources
+
+clean: cleanEmbeddedSources
+
+cleanEmbeddedSources:
+	$(RM) $(EMBEDDED_SOURCES) $(EMBEDDED_SOURCES:.cpp=.o)
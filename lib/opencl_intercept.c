@@ -0,0 +1,2434 @@
+/*
+ * Copyright:
+ * ----------------------------------------------------------------------------
+ * This confidential and proprietary software may be used only as authorized
+ * by a licensing agreement from ARM Limited.
+ *      (C) COPYRIGHT 2013 ARM Limited, ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorized copies and
+ * copies may only be made to the extent permitted by a licensing agreement
+ * from ARM Limited.
+ * ----------------------------------------------------------------------------
+ */
+
+/*
+ * OpenCL interception layer.
+ *
+ * Load it in front of the real OpenCL library to profile a binary which can't be modified:
+ *
+ *     LD_PRELOAD=libOpenCLIntercept.so ./application
+ *
+ * Every entry point declared in CL/cl.h is wrapped. The wrapper counts the call, measures its host-side latency
+ * and forwards it to the next definition of the function (the real library). At exit a summary is printed to stderr,
+ * or appended to the file named by the environment variable CL_INTERCEPT_OUTPUT. It lists the calls per API,
+ * sorted by total time, followed by any anti-patterns seen:
+ *  - the same memory object mapped with a blocking map over and over, as happens in a loop;
+ *  - clFinish called after every single enqueue, which serialises the host and the device;
+ *  - the same program source built more than once with the same options.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <CL/cl.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Number of blocking maps of one memory object after which it is reported. */
+#define REPEATED_BLOCKING_MAP_THRESHOLD 8
+/* Number of clFinish calls following a single enqueue after which they are reported. */
+#define FINISH_AFTER_ENQUEUE_THRESHOLD 4
+/* Sizes of the tables used to track memory objects, command queues and programs. */
+#define MAXIMUM_TRACKED_OBJECTS 256
+
+/* Calls and host time spent in one entry point. */
+struct ApiStatistics
+{
+	const char * name;
+	unsigned long calls;
+	double totalTime;
+	double maximumTime;
+};
+
+/* An object and a count or a hash associated with it. */
+struct TrackedObject
+{
+	const void * object;
+	unsigned long count;
+	unsigned long hash;
+};
+
+/* A program source and build options which have been built, and how often. */
+struct TrackedBuild
+{
+	unsigned long sourceHash;
+	unsigned long optionsHash;
+	unsigned long count;
+};
+
+enum ApiIndex
+{
+	API_clGetPlatformIDs,
+	API_clGetPlatformInfo,
+	API_clGetDeviceIDs,
+	API_clGetDeviceInfo,
+	API_clCreateContext,
+	API_clCreateContextFromType,
+	API_clRetainContext,
+	API_clReleaseContext,
+	API_clGetContextInfo,
+	API_clCreateCommandQueue,
+	API_clRetainCommandQueue,
+	API_clReleaseCommandQueue,
+	API_clGetCommandQueueInfo,
+	API_clSetCommandQueueProperty,
+	API_clCreateBuffer,
+	API_clCreateSubBuffer,
+	API_clCreateImage2D,
+	API_clCreateImage3D,
+	API_clRetainMemObject,
+	API_clReleaseMemObject,
+	API_clGetSupportedImageFormats,
+	API_clGetMemObjectInfo,
+	API_clGetImageInfo,
+	API_clSetMemObjectDestructorCallback,
+	API_clCreateSampler,
+	API_clRetainSampler,
+	API_clReleaseSampler,
+	API_clGetSamplerInfo,
+	API_clCreateProgramWithSource,
+	API_clCreateProgramWithBinary,
+	API_clRetainProgram,
+	API_clReleaseProgram,
+	API_clBuildProgram,
+	API_clUnloadCompiler,
+	API_clGetProgramInfo,
+	API_clGetProgramBuildInfo,
+	API_clCreateKernel,
+	API_clCreateKernelsInProgram,
+	API_clRetainKernel,
+	API_clReleaseKernel,
+	API_clSetKernelArg,
+	API_clGetKernelInfo,
+	API_clGetKernelWorkGroupInfo,
+	API_clWaitForEvents,
+	API_clGetEventInfo,
+	API_clCreateUserEvent,
+	API_clRetainEvent,
+	API_clReleaseEvent,
+	API_clSetUserEventStatus,
+	API_clSetEventCallback,
+	API_clGetEventProfilingInfo,
+	API_clFlush,
+	API_clFinish,
+	API_clEnqueueReadBuffer,
+	API_clEnqueueReadBufferRect,
+	API_clEnqueueWriteBuffer,
+	API_clEnqueueWriteBufferRect,
+	API_clEnqueueCopyBuffer,
+	API_clEnqueueCopyBufferRect,
+	API_clEnqueueReadImage,
+	API_clEnqueueWriteImage,
+	API_clEnqueueCopyImage,
+	API_clEnqueueCopyImageToBuffer,
+	API_clEnqueueCopyBufferToImage,
+	API_clEnqueueMapBuffer,
+	API_clEnqueueMapImage,
+	API_clEnqueueUnmapMemObject,
+	API_clEnqueueNDRangeKernel,
+	API_clEnqueueTask,
+	API_clEnqueueNativeKernel,
+	API_clEnqueueMarker,
+	API_clEnqueueWaitForEvents,
+	API_clEnqueueBarrier,
+	API_clGetExtensionFunctionAddress,
+	NUMBER_OF_APIS
+};
+
+static struct ApiStatistics statistics[NUMBER_OF_APIS] =
+{
+	{ "clGetPlatformIDs", 0, 0.0, 0.0 },
+	{ "clGetPlatformInfo", 0, 0.0, 0.0 },
+	{ "clGetDeviceIDs", 0, 0.0, 0.0 },
+	{ "clGetDeviceInfo", 0, 0.0, 0.0 },
+	{ "clCreateContext", 0, 0.0, 0.0 },
+	{ "clCreateContextFromType", 0, 0.0, 0.0 },
+	{ "clRetainContext", 0, 0.0, 0.0 },
+	{ "clReleaseContext", 0, 0.0, 0.0 },
+	{ "clGetContextInfo", 0, 0.0, 0.0 },
+	{ "clCreateCommandQueue", 0, 0.0, 0.0 },
+	{ "clRetainCommandQueue", 0, 0.0, 0.0 },
+	{ "clReleaseCommandQueue", 0, 0.0, 0.0 },
+	{ "clGetCommandQueueInfo", 0, 0.0, 0.0 },
+	{ "clSetCommandQueueProperty", 0, 0.0, 0.0 },
+	{ "clCreateBuffer", 0, 0.0, 0.0 },
+	{ "clCreateSubBuffer", 0, 0.0, 0.0 },
+	{ "clCreateImage2D", 0, 0.0, 0.0 },
+	{ "clCreateImage3D", 0, 0.0, 0.0 },
+	{ "clRetainMemObject", 0, 0.0, 0.0 },
+	{ "clReleaseMemObject", 0, 0.0, 0.0 },
+	{ "clGetSupportedImageFormats", 0, 0.0, 0.0 },
+	{ "clGetMemObjectInfo", 0, 0.0, 0.0 },
+	{ "clGetImageInfo", 0, 0.0, 0.0 },
+	{ "clSetMemObjectDestructorCallback", 0, 0.0, 0.0 },
+	{ "clCreateSampler", 0, 0.0, 0.0 },
+	{ "clRetainSampler", 0, 0.0, 0.0 },
+	{ "clReleaseSampler", 0, 0.0, 0.0 },
+	{ "clGetSamplerInfo", 0, 0.0, 0.0 },
+	{ "clCreateProgramWithSource", 0, 0.0, 0.0 },
+	{ "clCreateProgramWithBinary", 0, 0.0, 0.0 },
+	{ "clRetainProgram", 0, 0.0, 0.0 },
+	{ "clReleaseProgram", 0, 0.0, 0.0 },
+	{ "clBuildProgram", 0, 0.0, 0.0 },
+	{ "clUnloadCompiler", 0, 0.0, 0.0 },
+	{ "clGetProgramInfo", 0, 0.0, 0.0 },
+	{ "clGetProgramBuildInfo", 0, 0.0, 0.0 },
+	{ "clCreateKernel", 0, 0.0, 0.0 },
+	{ "clCreateKernelsInProgram", 0, 0.0, 0.0 },
+	{ "clRetainKernel", 0, 0.0, 0.0 },
+	{ "clReleaseKernel", 0, 0.0, 0.0 },
+	{ "clSetKernelArg", 0, 0.0, 0.0 },
+	{ "clGetKernelInfo", 0, 0.0, 0.0 },
+	{ "clGetKernelWorkGroupInfo", 0, 0.0, 0.0 },
+	{ "clWaitForEvents", 0, 0.0, 0.0 },
+	{ "clGetEventInfo", 0, 0.0, 0.0 },
+	{ "clCreateUserEvent", 0, 0.0, 0.0 },
+	{ "clRetainEvent", 0, 0.0, 0.0 },
+	{ "clReleaseEvent", 0, 0.0, 0.0 },
+	{ "clSetUserEventStatus", 0, 0.0, 0.0 },
+	{ "clSetEventCallback", 0, 0.0, 0.0 },
+	{ "clGetEventProfilingInfo", 0, 0.0, 0.0 },
+	{ "clFlush", 0, 0.0, 0.0 },
+	{ "clFinish", 0, 0.0, 0.0 },
+	{ "clEnqueueReadBuffer", 0, 0.0, 0.0 },
+	{ "clEnqueueReadBufferRect", 0, 0.0, 0.0 },
+	{ "clEnqueueWriteBuffer", 0, 0.0, 0.0 },
+	{ "clEnqueueWriteBufferRect", 0, 0.0, 0.0 },
+	{ "clEnqueueCopyBuffer", 0, 0.0, 0.0 },
+	{ "clEnqueueCopyBufferRect", 0, 0.0, 0.0 },
+	{ "clEnqueueReadImage", 0, 0.0, 0.0 },
+	{ "clEnqueueWriteImage", 0, 0.0, 0.0 },
+	{ "clEnqueueCopyImage", 0, 0.0, 0.0 },
+	{ "clEnqueueCopyImageToBuffer", 0, 0.0, 0.0 },
+	{ "clEnqueueCopyBufferToImage", 0, 0.0, 0.0 },
+	{ "clEnqueueMapBuffer", 0, 0.0, 0.0 },
+	{ "clEnqueueMapImage", 0, 0.0, 0.0 },
+	{ "clEnqueueUnmapMemObject", 0, 0.0, 0.0 },
+	{ "clEnqueueNDRangeKernel", 0, 0.0, 0.0 },
+	{ "clEnqueueTask", 0, 0.0, 0.0 },
+	{ "clEnqueueNativeKernel", 0, 0.0, 0.0 },
+	{ "clEnqueueMarker", 0, 0.0, 0.0 },
+	{ "clEnqueueWaitForEvents", 0, 0.0, 0.0 },
+	{ "clEnqueueBarrier", 0, 0.0, 0.0 },
+	{ "clGetExtensionFunctionAddress", 0, 0.0, 0.0 },
+};
+
+static pthread_mutex_t statisticsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct TrackedObject blockingMaps[MAXIMUM_TRACKED_OBJECTS];
+static struct TrackedObject enqueuesSinceFinish[MAXIMUM_TRACKED_OBJECTS];
+static struct TrackedObject programSources[MAXIMUM_TRACKED_OBJECTS];
+static struct TrackedBuild builds[MAXIMUM_TRACKED_OBJECTS];
+static unsigned long finishCalls = 0;
+static unsigned long finishAfterSingleEnqueue = 0;
+
+/* The next definition of every entry point, normally the one in the real OpenCL library, indexed by ApiIndex. */
+static void * nextFunctions[NUMBER_OF_APIS];
+static pthread_once_t resolveOnce = PTHREAD_ONCE_INIT;
+
+/* Look up all the next definitions at once, so threads making their first calls together don't race to fill them in. */
+static void resolveFunctions(void)
+{
+	int index;
+	for (index = 0; index < NUMBER_OF_APIS; index++)
+	{
+		nextFunctions[index] = dlsym(RTLD_NEXT, statistics[index].name);
+	}
+}
+
+/* The next definition of an entry point. An entry point missing from the next library is only an error if it is called. */
+static void * nextFunction(enum ApiIndex api)
+{
+	pthread_once(&resolveOnce, resolveFunctions);
+	if (nextFunctions[api] == NULL)
+	{
+		fprintf(stderr, "OpenCL intercept: %s not found in the next library.\n", statistics[api].name);
+		abort();
+	}
+	return nextFunctions[api];
+}
+
+static double currentTime(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+static void recordCall(enum ApiIndex api, double startTime)
+{
+	const double time = currentTime() - startTime;
+	pthread_mutex_lock(&statisticsMutex);
+	statistics[api].calls++;
+	statistics[api].totalTime += time;
+	if (time > statistics[api].maximumTime)
+	{
+		statistics[api].maximumTime = time;
+	}
+	pthread_mutex_unlock(&statisticsMutex);
+}
+
+/* Find the entry of an object in a table, adding it if it isn't there. Returns NULL if the table is full. Call with the mutex held. */
+static struct TrackedObject * findTrackedObject(struct TrackedObject * table, const void * object)
+{
+	int index;
+	for (index = 0; index < MAXIMUM_TRACKED_OBJECTS; index++)
+	{
+		if (table[index].object == object)
+		{
+			return &table[index];
+		}
+	}
+	for (index = 0; index < MAXIMUM_TRACKED_OBJECTS; index++)
+	{
+		if (table[index].object == NULL)
+		{
+			table[index].object = object;
+			table[index].count = 0;
+			table[index].hash = 0;
+			return &table[index];
+		}
+	}
+	return NULL;
+}
+
+/* FNV-1a hash of a block of memory, continuing from hash. */
+static unsigned long hashBytes(unsigned long hash, const char * bytes, size_t size)
+{
+	size_t index;
+	for (index = 0; index < size; index++)
+	{
+		hash = (hash ^ (unsigned char)bytes[index]) * 16777619UL;
+	}
+	return hash;
+}
+
+static void noteEnqueue(cl_command_queue queue)
+{
+	struct TrackedObject * tracked;
+	pthread_mutex_lock(&statisticsMutex);
+	tracked = findTrackedObject(enqueuesSinceFinish, queue);
+	if (tracked != NULL)
+	{
+		tracked->count++;
+	}
+	pthread_mutex_unlock(&statisticsMutex);
+}
+
+static void noteFinish(cl_command_queue queue)
+{
+	struct TrackedObject * tracked;
+	pthread_mutex_lock(&statisticsMutex);
+	finishCalls++;
+	tracked = findTrackedObject(enqueuesSinceFinish, queue);
+	if (tracked != NULL)
+	{
+		if (tracked->count == 1)
+		{
+			finishAfterSingleEnqueue++;
+		}
+		tracked->count = 0;
+	}
+	pthread_mutex_unlock(&statisticsMutex);
+}
+
+static void noteMap(cl_bool blocking, cl_mem memoryObject)
+{
+	struct TrackedObject * tracked;
+	if (!blocking)
+	{
+		return;
+	}
+	pthread_mutex_lock(&statisticsMutex);
+	tracked = findTrackedObject(blockingMaps, memoryObject);
+	if (tracked != NULL)
+	{
+		tracked->count++;
+	}
+	pthread_mutex_unlock(&statisticsMutex);
+}
+
+static void noteProgramSource(cl_program program, cl_uint count, const char ** strings, const size_t * lengths)
+{
+	struct TrackedObject * tracked;
+	unsigned long hash = 2166136261UL;
+	cl_uint index;
+	if (program == NULL || strings == NULL)
+	{
+		return;
+	}
+	for (index = 0; index < count; index++)
+	{
+		const size_t length = (lengths == NULL || lengths[index] == 0) ? strlen(strings[index]) : lengths[index];
+		hash = hashBytes(hash, strings[index], length);
+	}
+	pthread_mutex_lock(&statisticsMutex);
+	tracked = findTrackedObject(programSources, program);
+	if (tracked != NULL)
+	{
+		tracked->hash = hash;
+	}
+	pthread_mutex_unlock(&statisticsMutex);
+}
+
+static void noteBuild(cl_program program, const char * options)
+{
+	struct TrackedObject * tracked;
+	unsigned long optionsHash;
+	int index;
+	pthread_mutex_lock(&statisticsMutex);
+	tracked = findTrackedObject(programSources, program);
+	/* Programs created from binaries have no source hash and are not tracked. */
+	if (tracked != NULL && tracked->hash != 0)
+	{
+		optionsHash = options == NULL ? 0 : hashBytes(2166136261UL, options, strlen(options));
+		for (index = 0; index < MAXIMUM_TRACKED_OBJECTS; index++)
+		{
+			if (builds[index].count == 0 || (builds[index].sourceHash == tracked->hash && builds[index].optionsHash == optionsHash))
+			{
+				builds[index].sourceHash = tracked->hash;
+				builds[index].optionsHash = optionsHash;
+				builds[index].count++;
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock(&statisticsMutex);
+}
+
+/* Blocking map counts of released memory objects which were mapped too often, kept for the summary. */
+static struct TrackedObject releasedBlockingMaps[MAXIMUM_TRACKED_OBJECTS];
+static int numberOfReleasedBlockingMaps = 0;
+
+/*
+ * A released handle can be reused for a new object, so forget what was tracked for it.
+ * Call once the last reference has gone. A memory object which was mapped too often is kept for the summary first.
+ */
+static void forgetObject(struct TrackedObject * table, const void * object)
+{
+	int index;
+	pthread_mutex_lock(&statisticsMutex);
+	for (index = 0; index < MAXIMUM_TRACKED_OBJECTS; index++)
+	{
+		if (table[index].object == object)
+		{
+			if (table == blockingMaps && table[index].count >= REPEATED_BLOCKING_MAP_THRESHOLD
+			    && numberOfReleasedBlockingMaps < MAXIMUM_TRACKED_OBJECTS)
+			{
+				releasedBlockingMaps[numberOfReleasedBlockingMaps++] = table[index];
+			}
+			table[index].object = NULL;
+			table[index].count = 0;
+			table[index].hash = 0;
+		}
+	}
+	pthread_mutex_unlock(&statisticsMutex);
+}
+
+/*
+ * Reference counts of objects about to be released, queried from the next library without being counted.
+ * A count which can't be queried is returned as 0.
+ */
+static cl_uint memObjectReferenceCount(cl_mem memobj)
+{
+	typedef cl_int (CL_API_CALL * GetInfoFunction)(cl_mem, cl_mem_info, size_t, void *, size_t *);
+	cl_uint referenceCount = 0;
+	if (((GetInfoFunction)nextFunction(API_clGetMemObjectInfo))(memobj, CL_MEM_REFERENCE_COUNT, sizeof(referenceCount), &referenceCount, NULL) != CL_SUCCESS)
+	{
+		return 0;
+	}
+	return referenceCount;
+}
+
+static cl_uint commandQueueReferenceCount(cl_command_queue command_queue)
+{
+	typedef cl_int (CL_API_CALL * GetInfoFunction)(cl_command_queue, cl_command_queue_info, size_t, void *, size_t *);
+	cl_uint referenceCount = 0;
+	if (((GetInfoFunction)nextFunction(API_clGetCommandQueueInfo))(command_queue, CL_QUEUE_REFERENCE_COUNT, sizeof(referenceCount), &referenceCount, NULL) != CL_SUCCESS)
+	{
+		return 0;
+	}
+	return referenceCount;
+}
+
+static cl_uint programReferenceCount(cl_program program)
+{
+	typedef cl_int (CL_API_CALL * GetInfoFunction)(cl_program, cl_program_info, size_t, void *, size_t *);
+	cl_uint referenceCount = 0;
+	if (((GetInfoFunction)nextFunction(API_clGetProgramInfo))(program, CL_PROGRAM_REFERENCE_COUNT, sizeof(referenceCount), &referenceCount, NULL) != CL_SUCCESS)
+	{
+		return 0;
+	}
+	return referenceCount;
+}
+
+static void printRepeatedBlockingMap(FILE * output, const struct TrackedObject * tracked, const char * state)
+{
+	fprintf(output, "Warning: memory object %p%s was mapped with a blocking map %lu times. "
+	        "Map it once outside the loop or use non-blocking maps with events.\n", tracked->object, state, tracked->count);
+}
+
+static int compareTotalTime(const void * first, const void * second)
+{
+	const double firstTime = ((const struct ApiStatistics *)first)->totalTime;
+	const double secondTime = ((const struct ApiStatistics *)second)->totalTime;
+	return (firstTime < secondTime) - (firstTime > secondTime);
+}
+
+static void __attribute__((destructor)) printSummary(void)
+{
+	struct ApiStatistics sorted[NUMBER_OF_APIS];
+	const char * filename = getenv("CL_INTERCEPT_OUTPUT");
+	FILE * output = stderr;
+	unsigned long repeatedBuilds = 0;
+	int index;
+
+	if (filename != NULL && filename[0] != '\0')
+	{
+		output = fopen(filename, "a");
+		if (output == NULL)
+		{
+			fprintf(stderr, "OpenCL intercept: unable to open %s, writing the summary to stderr.\n", filename);
+			output = stderr;
+		}
+	}
+
+	memcpy(sorted, statistics, sizeof(sorted));
+	qsort(sorted, NUMBER_OF_APIS, sizeof(sorted[0]), compareTotalTime);
+
+	fprintf(output, "OpenCL intercept summary\n");
+	fprintf(output, "%-32s %10s %14s %12s %12s\n", "Function", "Calls", "Total (ms)", "Mean (us)", "Max (us)");
+	for (index = 0; index < NUMBER_OF_APIS && sorted[index].calls > 0; index++)
+	{
+		fprintf(output, "%-32s %10lu %14.3f %12.2f %12.2f\n", sorted[index].name, sorted[index].calls,
+		        sorted[index].totalTime / 1e3, sorted[index].totalTime / sorted[index].calls, sorted[index].maximumTime);
+	}
+
+	for (index = 0; index < MAXIMUM_TRACKED_OBJECTS; index++)
+	{
+		if (blockingMaps[index].object != NULL && blockingMaps[index].count >= REPEATED_BLOCKING_MAP_THRESHOLD)
+		{
+			printRepeatedBlockingMap(output, &blockingMaps[index], "");
+		}
+		if (index < numberOfReleasedBlockingMaps)
+		{
+			printRepeatedBlockingMap(output, &releasedBlockingMaps[index], " (since released)");
+		}
+		if (builds[index].count > 1)
+		{
+			repeatedBuilds += builds[index].count - 1;
+		}
+	}
+	if (finishAfterSingleEnqueue >= FINISH_AFTER_ENQUEUE_THRESHOLD && 2 * finishAfterSingleEnqueue > finishCalls)
+	{
+		fprintf(output, "Warning: %lu of %lu clFinish calls followed a single enqueue. "
+		        "Batch the work and wait on events instead of finishing after every command.\n", finishAfterSingleEnqueue, finishCalls);
+	}
+	if (repeatedBuilds > 0)
+	{
+		fprintf(output, "Warning: %lu clBuildProgram calls rebuilt a source with the same options. "
+		        "Build each program once and keep it, or cache the binary.\n", repeatedBuilds);
+	}
+
+	if (output != stderr)
+	{
+		fclose(output);
+	}
+}
+
+typedef cl_int (CL_API_CALL * clGetPlatformIDsFunction)(
+	cl_uint num_entries,
+	cl_platform_id * platforms,
+	cl_uint * num_platforms
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetPlatformIDs(
+	cl_uint num_entries,
+	cl_platform_id * platforms,
+	cl_uint * num_platforms
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetPlatformIDsFunction next = (clGetPlatformIDsFunction)nextFunction(API_clGetPlatformIDs);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(num_entries, platforms, num_platforms);
+	recordCall(API_clGetPlatformIDs, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetPlatformInfoFunction)(
+	cl_platform_id platform,
+	cl_platform_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetPlatformInfo(
+	cl_platform_id platform,
+	cl_platform_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetPlatformInfoFunction next = (clGetPlatformInfoFunction)nextFunction(API_clGetPlatformInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(platform, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetPlatformInfo, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetDeviceIDsFunction)(
+	cl_platform_id platform,
+	cl_device_type device_type,
+	cl_uint num_entries,
+	cl_device_id * devices,
+	cl_uint * num_devices
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetDeviceIDs(
+	cl_platform_id platform,
+	cl_device_type device_type,
+	cl_uint num_entries,
+	cl_device_id * devices,
+	cl_uint * num_devices
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetDeviceIDsFunction next = (clGetDeviceIDsFunction)nextFunction(API_clGetDeviceIDs);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(platform, device_type, num_entries, devices, num_devices);
+	recordCall(API_clGetDeviceIDs, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetDeviceInfoFunction)(
+	cl_device_id device,
+	cl_device_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetDeviceInfo(
+	cl_device_id device,
+	cl_device_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetDeviceInfoFunction next = (clGetDeviceInfoFunction)nextFunction(API_clGetDeviceInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(device, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetDeviceInfo, startTime);
+	return result;
+}
+
+typedef cl_context (CL_API_CALL * clCreateContextFunction)(
+	const cl_context_properties * properties,
+	cl_uint num_devices,
+	const cl_device_id * devices,
+	void ( CL_CALLBACK * pfn_notify )( const char *, const void *, size_t, void * ),
+	void * user_data,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_context CL_API_CALL clCreateContext(
+	const cl_context_properties * properties,
+	cl_uint num_devices,
+	const cl_device_id * devices,
+	void ( CL_CALLBACK * pfn_notify )( const char *, const void *, size_t, void * ),
+	void * user_data,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateContextFunction next = (clCreateContextFunction)nextFunction(API_clCreateContext);
+	double startTime;
+	cl_context result;
+	startTime = currentTime();
+	result = next(properties, num_devices, devices, pfn_notify, user_data, errcode_ret);
+	recordCall(API_clCreateContext, startTime);
+	return result;
+}
+
+typedef cl_context (CL_API_CALL * clCreateContextFromTypeFunction)(
+	const cl_context_properties * properties,
+	cl_device_type device_type,
+	void ( CL_CALLBACK * pfn_notify )( const char *, const void *, size_t, void * ),
+	void * user_data,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_context CL_API_CALL clCreateContextFromType(
+	const cl_context_properties * properties,
+	cl_device_type device_type,
+	void ( CL_CALLBACK * pfn_notify )( const char *, const void *, size_t, void * ),
+	void * user_data,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateContextFromTypeFunction next = (clCreateContextFromTypeFunction)nextFunction(API_clCreateContextFromType);
+	double startTime;
+	cl_context result;
+	startTime = currentTime();
+	result = next(properties, device_type, pfn_notify, user_data, errcode_ret);
+	recordCall(API_clCreateContextFromType, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clRetainContextFunction)(
+	cl_context context
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clRetainContext(
+	cl_context context
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clRetainContextFunction next = (clRetainContextFunction)nextFunction(API_clRetainContext);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(context);
+	recordCall(API_clRetainContext, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clReleaseContextFunction)(
+	cl_context context
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clReleaseContext(
+	cl_context context
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clReleaseContextFunction next = (clReleaseContextFunction)nextFunction(API_clReleaseContext);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(context);
+	recordCall(API_clReleaseContext, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetContextInfoFunction)(
+	cl_context context,
+	cl_context_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetContextInfo(
+	cl_context context,
+	cl_context_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetContextInfoFunction next = (clGetContextInfoFunction)nextFunction(API_clGetContextInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(context, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetContextInfo, startTime);
+	return result;
+}
+
+typedef cl_command_queue (CL_API_CALL * clCreateCommandQueueFunction)(
+	cl_context context,
+	cl_device_id device,
+	cl_command_queue_properties properties,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_command_queue CL_API_CALL clCreateCommandQueue(
+	cl_context context,
+	cl_device_id device,
+	cl_command_queue_properties properties,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateCommandQueueFunction next = (clCreateCommandQueueFunction)nextFunction(API_clCreateCommandQueue);
+	double startTime;
+	cl_command_queue result;
+	startTime = currentTime();
+	result = next(context, device, properties, errcode_ret);
+	recordCall(API_clCreateCommandQueue, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clRetainCommandQueueFunction)(
+	cl_command_queue command_queue
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clRetainCommandQueue(
+	cl_command_queue command_queue
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clRetainCommandQueueFunction next = (clRetainCommandQueueFunction)nextFunction(API_clRetainCommandQueue);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(command_queue);
+	recordCall(API_clRetainCommandQueue, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clReleaseCommandQueueFunction)(
+	cl_command_queue command_queue
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clReleaseCommandQueue(
+	cl_command_queue command_queue
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clReleaseCommandQueueFunction next = (clReleaseCommandQueueFunction)nextFunction(API_clReleaseCommandQueue);
+	const int lastReference = commandQueueReferenceCount(command_queue) <= 1;
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(command_queue);
+	recordCall(API_clReleaseCommandQueue, startTime);
+	if (result == CL_SUCCESS && lastReference)
+	{
+		forgetObject(enqueuesSinceFinish, command_queue);
+	}
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetCommandQueueInfoFunction)(
+	cl_command_queue command_queue,
+	cl_command_queue_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetCommandQueueInfo(
+	cl_command_queue command_queue,
+	cl_command_queue_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetCommandQueueInfoFunction next = (clGetCommandQueueInfoFunction)nextFunction(API_clGetCommandQueueInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(command_queue, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetCommandQueueInfo, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clSetCommandQueuePropertyFunction)(
+	cl_command_queue command_queue,
+	cl_command_queue_properties properties,
+	cl_bool enable,
+	cl_command_queue_properties * old_properties
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clSetCommandQueueProperty(
+	cl_command_queue command_queue,
+	cl_command_queue_properties properties,
+	cl_bool enable,
+	cl_command_queue_properties * old_properties
+) CL_EXT_SUFFIX__VERSION_1_0_DEPRECATED
+{
+	const clSetCommandQueuePropertyFunction next = (clSetCommandQueuePropertyFunction)nextFunction(API_clSetCommandQueueProperty);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(command_queue, properties, enable, old_properties);
+	recordCall(API_clSetCommandQueueProperty, startTime);
+	return result;
+}
+
+typedef cl_mem (CL_API_CALL * clCreateBufferFunction)(
+	cl_context context,
+	cl_mem_flags flags,
+	size_t size,
+	void * host_ptr,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_mem CL_API_CALL clCreateBuffer(
+	cl_context context,
+	cl_mem_flags flags,
+	size_t size,
+	void * host_ptr,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateBufferFunction next = (clCreateBufferFunction)nextFunction(API_clCreateBuffer);
+	double startTime;
+	cl_mem result;
+	startTime = currentTime();
+	result = next(context, flags, size, host_ptr, errcode_ret);
+	recordCall(API_clCreateBuffer, startTime);
+	return result;
+}
+
+typedef cl_mem (CL_API_CALL * clCreateSubBufferFunction)(
+	cl_mem buffer,
+	cl_mem_flags flags,
+	cl_buffer_create_type buffer_create_type,
+	const void * buffer_create_info,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_mem CL_API_CALL clCreateSubBuffer(
+	cl_mem buffer,
+	cl_mem_flags flags,
+	cl_buffer_create_type buffer_create_type,
+	const void * buffer_create_info,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_1
+{
+	const clCreateSubBufferFunction next = (clCreateSubBufferFunction)nextFunction(API_clCreateSubBuffer);
+	double startTime;
+	cl_mem result;
+	startTime = currentTime();
+	result = next(buffer, flags, buffer_create_type, buffer_create_info, errcode_ret);
+	recordCall(API_clCreateSubBuffer, startTime);
+	return result;
+}
+
+typedef cl_mem (CL_API_CALL * clCreateImage2DFunction)(
+	cl_context context,
+	cl_mem_flags flags,
+	const cl_image_format * image_format,
+	size_t image_width,
+	size_t image_height,
+	size_t image_row_pitch,
+	void * host_ptr,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_mem CL_API_CALL clCreateImage2D(
+	cl_context context,
+	cl_mem_flags flags,
+	const cl_image_format * image_format,
+	size_t image_width,
+	size_t image_height,
+	size_t image_row_pitch,
+	void * host_ptr,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateImage2DFunction next = (clCreateImage2DFunction)nextFunction(API_clCreateImage2D);
+	double startTime;
+	cl_mem result;
+	startTime = currentTime();
+	result = next(context, flags, image_format, image_width, image_height, image_row_pitch, host_ptr, errcode_ret);
+	recordCall(API_clCreateImage2D, startTime);
+	return result;
+}
+
+typedef cl_mem (CL_API_CALL * clCreateImage3DFunction)(
+	cl_context context,
+	cl_mem_flags flags,
+	const cl_image_format * image_format,
+	size_t image_width,
+	size_t image_height,
+	size_t image_depth,
+	size_t image_row_pitch,
+	size_t image_slice_pitch,
+	void * host_ptr,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_mem CL_API_CALL clCreateImage3D(
+	cl_context context,
+	cl_mem_flags flags,
+	const cl_image_format * image_format,
+	size_t image_width,
+	size_t image_height,
+	size_t image_depth,
+	size_t image_row_pitch,
+	size_t image_slice_pitch,
+	void * host_ptr,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateImage3DFunction next = (clCreateImage3DFunction)nextFunction(API_clCreateImage3D);
+	double startTime;
+	cl_mem result;
+	startTime = currentTime();
+	result = next(context, flags, image_format, image_width, image_height, image_depth, image_row_pitch, image_slice_pitch, host_ptr, errcode_ret);
+	recordCall(API_clCreateImage3D, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clRetainMemObjectFunction)(
+	cl_mem memobj
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clRetainMemObject(
+	cl_mem memobj
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clRetainMemObjectFunction next = (clRetainMemObjectFunction)nextFunction(API_clRetainMemObject);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(memobj);
+	recordCall(API_clRetainMemObject, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clReleaseMemObjectFunction)(
+	cl_mem memobj
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clReleaseMemObject(
+	cl_mem memobj
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clReleaseMemObjectFunction next = (clReleaseMemObjectFunction)nextFunction(API_clReleaseMemObject);
+	const int lastReference = memObjectReferenceCount(memobj) <= 1;
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(memobj);
+	recordCall(API_clReleaseMemObject, startTime);
+	if (result == CL_SUCCESS && lastReference)
+	{
+		forgetObject(blockingMaps, memobj);
+	}
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetSupportedImageFormatsFunction)(
+	cl_context context,
+	cl_mem_flags flags,
+	cl_mem_object_type image_type,
+	cl_uint num_entries,
+	cl_image_format * image_formats,
+	cl_uint * num_image_formats
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetSupportedImageFormats(
+	cl_context context,
+	cl_mem_flags flags,
+	cl_mem_object_type image_type,
+	cl_uint num_entries,
+	cl_image_format * image_formats,
+	cl_uint * num_image_formats
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetSupportedImageFormatsFunction next = (clGetSupportedImageFormatsFunction)nextFunction(API_clGetSupportedImageFormats);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(context, flags, image_type, num_entries, image_formats, num_image_formats);
+	recordCall(API_clGetSupportedImageFormats, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetMemObjectInfoFunction)(
+	cl_mem memobj,
+	cl_mem_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetMemObjectInfo(
+	cl_mem memobj,
+	cl_mem_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetMemObjectInfoFunction next = (clGetMemObjectInfoFunction)nextFunction(API_clGetMemObjectInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(memobj, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetMemObjectInfo, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetImageInfoFunction)(
+	cl_mem image,
+	cl_image_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetImageInfo(
+	cl_mem image,
+	cl_image_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetImageInfoFunction next = (clGetImageInfoFunction)nextFunction(API_clGetImageInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(image, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetImageInfo, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clSetMemObjectDestructorCallbackFunction)(
+	cl_mem memobj,
+	void ( CL_CALLBACK * pfn_notify )( cl_mem memobj, void * user_data ),
+	void * user_data
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clSetMemObjectDestructorCallback(
+	cl_mem memobj,
+	void ( CL_CALLBACK * pfn_notify )( cl_mem memobj, void * user_data ),
+	void * user_data
+) CL_API_SUFFIX__VERSION_1_1
+{
+	const clSetMemObjectDestructorCallbackFunction next = (clSetMemObjectDestructorCallbackFunction)nextFunction(API_clSetMemObjectDestructorCallback);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(memobj, pfn_notify, user_data);
+	recordCall(API_clSetMemObjectDestructorCallback, startTime);
+	return result;
+}
+
+typedef cl_sampler (CL_API_CALL * clCreateSamplerFunction)(
+	cl_context context,
+	cl_bool normalized_coords,
+	cl_addressing_mode addressing_mode,
+	cl_filter_mode filter_mode,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_sampler CL_API_CALL clCreateSampler(
+	cl_context context,
+	cl_bool normalized_coords,
+	cl_addressing_mode addressing_mode,
+	cl_filter_mode filter_mode,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateSamplerFunction next = (clCreateSamplerFunction)nextFunction(API_clCreateSampler);
+	double startTime;
+	cl_sampler result;
+	startTime = currentTime();
+	result = next(context, normalized_coords, addressing_mode, filter_mode, errcode_ret);
+	recordCall(API_clCreateSampler, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clRetainSamplerFunction)(
+	cl_sampler sampler
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clRetainSampler(
+	cl_sampler sampler
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clRetainSamplerFunction next = (clRetainSamplerFunction)nextFunction(API_clRetainSampler);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(sampler);
+	recordCall(API_clRetainSampler, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clReleaseSamplerFunction)(
+	cl_sampler sampler
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clReleaseSampler(
+	cl_sampler sampler
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clReleaseSamplerFunction next = (clReleaseSamplerFunction)nextFunction(API_clReleaseSampler);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(sampler);
+	recordCall(API_clReleaseSampler, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetSamplerInfoFunction)(
+	cl_sampler sampler,
+	cl_sampler_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetSamplerInfo(
+	cl_sampler sampler,
+	cl_sampler_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetSamplerInfoFunction next = (clGetSamplerInfoFunction)nextFunction(API_clGetSamplerInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(sampler, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetSamplerInfo, startTime);
+	return result;
+}
+
+typedef cl_program (CL_API_CALL * clCreateProgramWithSourceFunction)(
+	cl_context context,
+	cl_uint count,
+	const char ** strings,
+	const size_t * lengths,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_program CL_API_CALL clCreateProgramWithSource(
+	cl_context context,
+	cl_uint count,
+	const char ** strings,
+	const size_t * lengths,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateProgramWithSourceFunction next = (clCreateProgramWithSourceFunction)nextFunction(API_clCreateProgramWithSource);
+	double startTime;
+	cl_program result;
+	startTime = currentTime();
+	result = next(context, count, strings, lengths, errcode_ret);
+	recordCall(API_clCreateProgramWithSource, startTime);
+	noteProgramSource(result, count, strings, lengths);
+	return result;
+}
+
+typedef cl_program (CL_API_CALL * clCreateProgramWithBinaryFunction)(
+	cl_context context,
+	cl_uint num_devices,
+	const cl_device_id * device_list,
+	const size_t * lengths,
+	const unsigned char ** binaries,
+	cl_int * binary_status,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_program CL_API_CALL clCreateProgramWithBinary(
+	cl_context context,
+	cl_uint num_devices,
+	const cl_device_id * device_list,
+	const size_t * lengths,
+	const unsigned char ** binaries,
+	cl_int * binary_status,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateProgramWithBinaryFunction next = (clCreateProgramWithBinaryFunction)nextFunction(API_clCreateProgramWithBinary);
+	double startTime;
+	cl_program result;
+	startTime = currentTime();
+	result = next(context, num_devices, device_list, lengths, binaries, binary_status, errcode_ret);
+	recordCall(API_clCreateProgramWithBinary, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clRetainProgramFunction)(
+	cl_program program
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clRetainProgram(
+	cl_program program
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clRetainProgramFunction next = (clRetainProgramFunction)nextFunction(API_clRetainProgram);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(program);
+	recordCall(API_clRetainProgram, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clReleaseProgramFunction)(
+	cl_program program
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clReleaseProgram(
+	cl_program program
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clReleaseProgramFunction next = (clReleaseProgramFunction)nextFunction(API_clReleaseProgram);
+	const int lastReference = programReferenceCount(program) <= 1;
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(program);
+	recordCall(API_clReleaseProgram, startTime);
+	if (result == CL_SUCCESS && lastReference)
+	{
+		forgetObject(programSources, program);
+	}
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clBuildProgramFunction)(
+	cl_program program,
+	cl_uint num_devices,
+	const cl_device_id * device_list,
+	const char * options,
+	void ( CL_CALLBACK * pfn_notify )( cl_program program, void * user_data ),
+	void * user_data
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clBuildProgram(
+	cl_program program,
+	cl_uint num_devices,
+	const cl_device_id * device_list,
+	const char * options,
+	void ( CL_CALLBACK * pfn_notify )( cl_program program, void * user_data ),
+	void * user_data
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clBuildProgramFunction next = (clBuildProgramFunction)nextFunction(API_clBuildProgram);
+	double startTime;
+	cl_int result;
+	noteBuild(program, options);
+	startTime = currentTime();
+	result = next(program, num_devices, device_list, options, pfn_notify, user_data);
+	recordCall(API_clBuildProgram, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clUnloadCompilerFunction)(
+	void
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clUnloadCompiler(
+	void
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clUnloadCompilerFunction next = (clUnloadCompilerFunction)nextFunction(API_clUnloadCompiler);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next();
+	recordCall(API_clUnloadCompiler, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetProgramInfoFunction)(
+	cl_program program,
+	cl_program_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetProgramInfo(
+	cl_program program,
+	cl_program_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetProgramInfoFunction next = (clGetProgramInfoFunction)nextFunction(API_clGetProgramInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(program, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetProgramInfo, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetProgramBuildInfoFunction)(
+	cl_program program,
+	cl_device_id device,
+	cl_program_build_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetProgramBuildInfo(
+	cl_program program,
+	cl_device_id device,
+	cl_program_build_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetProgramBuildInfoFunction next = (clGetProgramBuildInfoFunction)nextFunction(API_clGetProgramBuildInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(program, device, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetProgramBuildInfo, startTime);
+	return result;
+}
+
+typedef cl_kernel (CL_API_CALL * clCreateKernelFunction)(
+	cl_program program,
+	const char * kernel_name,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_kernel CL_API_CALL clCreateKernel(
+	cl_program program,
+	const char * kernel_name,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateKernelFunction next = (clCreateKernelFunction)nextFunction(API_clCreateKernel);
+	double startTime;
+	cl_kernel result;
+	startTime = currentTime();
+	result = next(program, kernel_name, errcode_ret);
+	recordCall(API_clCreateKernel, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clCreateKernelsInProgramFunction)(
+	cl_program program,
+	cl_uint num_kernels,
+	cl_kernel * kernels,
+	cl_uint * num_kernels_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clCreateKernelsInProgram(
+	cl_program program,
+	cl_uint num_kernels,
+	cl_kernel * kernels,
+	cl_uint * num_kernels_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clCreateKernelsInProgramFunction next = (clCreateKernelsInProgramFunction)nextFunction(API_clCreateKernelsInProgram);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(program, num_kernels, kernels, num_kernels_ret);
+	recordCall(API_clCreateKernelsInProgram, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clRetainKernelFunction)(
+	cl_kernel kernel
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clRetainKernel(
+	cl_kernel kernel
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clRetainKernelFunction next = (clRetainKernelFunction)nextFunction(API_clRetainKernel);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(kernel);
+	recordCall(API_clRetainKernel, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clReleaseKernelFunction)(
+	cl_kernel kernel
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clReleaseKernel(
+	cl_kernel kernel
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clReleaseKernelFunction next = (clReleaseKernelFunction)nextFunction(API_clReleaseKernel);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(kernel);
+	recordCall(API_clReleaseKernel, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clSetKernelArgFunction)(
+	cl_kernel kernel,
+	cl_uint arg_index,
+	size_t arg_size,
+	const void * arg_value
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clSetKernelArg(
+	cl_kernel kernel,
+	cl_uint arg_index,
+	size_t arg_size,
+	const void * arg_value
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clSetKernelArgFunction next = (clSetKernelArgFunction)nextFunction(API_clSetKernelArg);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(kernel, arg_index, arg_size, arg_value);
+	recordCall(API_clSetKernelArg, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetKernelInfoFunction)(
+	cl_kernel kernel,
+	cl_kernel_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetKernelInfo(
+	cl_kernel kernel,
+	cl_kernel_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetKernelInfoFunction next = (clGetKernelInfoFunction)nextFunction(API_clGetKernelInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(kernel, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetKernelInfo, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetKernelWorkGroupInfoFunction)(
+	cl_kernel kernel,
+	cl_device_id device,
+	cl_kernel_work_group_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetKernelWorkGroupInfo(
+	cl_kernel kernel,
+	cl_device_id device,
+	cl_kernel_work_group_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetKernelWorkGroupInfoFunction next = (clGetKernelWorkGroupInfoFunction)nextFunction(API_clGetKernelWorkGroupInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(kernel, device, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetKernelWorkGroupInfo, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clWaitForEventsFunction)(
+	cl_uint num_events,
+	const cl_event * event_list
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clWaitForEvents(
+	cl_uint num_events,
+	const cl_event * event_list
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clWaitForEventsFunction next = (clWaitForEventsFunction)nextFunction(API_clWaitForEvents);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(num_events, event_list);
+	recordCall(API_clWaitForEvents, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetEventInfoFunction)(
+	cl_event event,
+	cl_event_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetEventInfo(
+	cl_event event,
+	cl_event_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetEventInfoFunction next = (clGetEventInfoFunction)nextFunction(API_clGetEventInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(event, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetEventInfo, startTime);
+	return result;
+}
+
+typedef cl_event (CL_API_CALL * clCreateUserEventFunction)(
+	cl_context context,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY cl_event CL_API_CALL clCreateUserEvent(
+	cl_context context,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_1
+{
+	const clCreateUserEventFunction next = (clCreateUserEventFunction)nextFunction(API_clCreateUserEvent);
+	double startTime;
+	cl_event result;
+	startTime = currentTime();
+	result = next(context, errcode_ret);
+	recordCall(API_clCreateUserEvent, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clRetainEventFunction)(
+	cl_event event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clRetainEvent(
+	cl_event event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clRetainEventFunction next = (clRetainEventFunction)nextFunction(API_clRetainEvent);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(event);
+	recordCall(API_clRetainEvent, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clReleaseEventFunction)(
+	cl_event event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clReleaseEvent(
+	cl_event event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clReleaseEventFunction next = (clReleaseEventFunction)nextFunction(API_clReleaseEvent);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(event);
+	recordCall(API_clReleaseEvent, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clSetUserEventStatusFunction)(
+	cl_event event,
+	cl_int execution_status
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clSetUserEventStatus(
+	cl_event event,
+	cl_int execution_status
+) CL_API_SUFFIX__VERSION_1_1
+{
+	const clSetUserEventStatusFunction next = (clSetUserEventStatusFunction)nextFunction(API_clSetUserEventStatus);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(event, execution_status);
+	recordCall(API_clSetUserEventStatus, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clSetEventCallbackFunction)(
+	cl_event event,
+	cl_int command_exec_callback_type,
+	void ( CL_CALLBACK * pfn_notify )( cl_event, cl_int, void * ),
+	void * user_data
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clSetEventCallback(
+	cl_event event,
+	cl_int command_exec_callback_type,
+	void ( CL_CALLBACK * pfn_notify )( cl_event, cl_int, void * ),
+	void * user_data
+) CL_API_SUFFIX__VERSION_1_1
+{
+	const clSetEventCallbackFunction next = (clSetEventCallbackFunction)nextFunction(API_clSetEventCallback);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(event, command_exec_callback_type, pfn_notify, user_data);
+	recordCall(API_clSetEventCallback, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clGetEventProfilingInfoFunction)(
+	cl_event event,
+	cl_profiling_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clGetEventProfilingInfo(
+	cl_event event,
+	cl_profiling_info param_name,
+	size_t param_value_size,
+	void * param_value,
+	size_t * param_value_size_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetEventProfilingInfoFunction next = (clGetEventProfilingInfoFunction)nextFunction(API_clGetEventProfilingInfo);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(event, param_name, param_value_size, param_value, param_value_size_ret);
+	recordCall(API_clGetEventProfilingInfo, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clFlushFunction)(
+	cl_command_queue command_queue
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clFlush(
+	cl_command_queue command_queue
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clFlushFunction next = (clFlushFunction)nextFunction(API_clFlush);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(command_queue);
+	recordCall(API_clFlush, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clFinishFunction)(
+	cl_command_queue command_queue
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clFinish(
+	cl_command_queue command_queue
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clFinishFunction next = (clFinishFunction)nextFunction(API_clFinish);
+	double startTime;
+	cl_int result;
+	noteFinish(command_queue);
+	startTime = currentTime();
+	result = next(command_queue);
+	recordCall(API_clFinish, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueReadBufferFunction)(
+	cl_command_queue command_queue,
+	cl_mem buffer,
+	cl_bool blocking_read,
+	size_t offset,
+	size_t cb,
+	void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueReadBuffer(
+	cl_command_queue command_queue,
+	cl_mem buffer,
+	cl_bool blocking_read,
+	size_t offset,
+	size_t cb,
+	void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueReadBufferFunction next = (clEnqueueReadBufferFunction)nextFunction(API_clEnqueueReadBuffer);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, buffer, blocking_read, offset, cb, ptr, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueReadBuffer, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueReadBufferRectFunction)(
+	cl_command_queue command_queue,
+	cl_mem buffer,
+	cl_bool blocking_read,
+	const size_t * buffer_offset,
+	const size_t * host_offset,
+	const size_t * region,
+	size_t buffer_row_pitch,
+	size_t buffer_slice_pitch,
+	size_t host_row_pitch,
+	size_t host_slice_pitch,
+	void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueReadBufferRect(
+	cl_command_queue command_queue,
+	cl_mem buffer,
+	cl_bool blocking_read,
+	const size_t * buffer_offset,
+	const size_t * host_offset,
+	const size_t * region,
+	size_t buffer_row_pitch,
+	size_t buffer_slice_pitch,
+	size_t host_row_pitch,
+	size_t host_slice_pitch,
+	void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_1
+{
+	const clEnqueueReadBufferRectFunction next = (clEnqueueReadBufferRectFunction)nextFunction(API_clEnqueueReadBufferRect);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, buffer, blocking_read, buffer_offset, host_offset, region, buffer_row_pitch, buffer_slice_pitch, host_row_pitch, host_slice_pitch, ptr, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueReadBufferRect, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueWriteBufferFunction)(
+	cl_command_queue command_queue,
+	cl_mem buffer,
+	cl_bool blocking_write,
+	size_t offset,
+	size_t cb,
+	const void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueWriteBuffer(
+	cl_command_queue command_queue,
+	cl_mem buffer,
+	cl_bool blocking_write,
+	size_t offset,
+	size_t cb,
+	const void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueWriteBufferFunction next = (clEnqueueWriteBufferFunction)nextFunction(API_clEnqueueWriteBuffer);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, buffer, blocking_write, offset, cb, ptr, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueWriteBuffer, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueWriteBufferRectFunction)(
+	cl_command_queue command_queue,
+	cl_mem buffer,
+	cl_bool blocking_read,
+	const size_t * buffer_offset,
+	const size_t * host_offset,
+	const size_t * region,
+	size_t buffer_row_pitch,
+	size_t buffer_slice_pitch,
+	size_t host_row_pitch,
+	size_t host_slice_pitch,
+	const void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueWriteBufferRect(
+	cl_command_queue command_queue,
+	cl_mem buffer,
+	cl_bool blocking_read,
+	const size_t * buffer_offset,
+	const size_t * host_offset,
+	const size_t * region,
+	size_t buffer_row_pitch,
+	size_t buffer_slice_pitch,
+	size_t host_row_pitch,
+	size_t host_slice_pitch,
+	const void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_1
+{
+	const clEnqueueWriteBufferRectFunction next = (clEnqueueWriteBufferRectFunction)nextFunction(API_clEnqueueWriteBufferRect);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, buffer, blocking_read, buffer_offset, host_offset, region, buffer_row_pitch, buffer_slice_pitch, host_row_pitch, host_slice_pitch, ptr, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueWriteBufferRect, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueCopyBufferFunction)(
+	cl_command_queue command_queue,
+	cl_mem src_buffer,
+	cl_mem dst_buffer,
+	size_t src_offset,
+	size_t dst_offset,
+	size_t cb,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyBuffer(
+	cl_command_queue command_queue,
+	cl_mem src_buffer,
+	cl_mem dst_buffer,
+	size_t src_offset,
+	size_t dst_offset,
+	size_t cb,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueCopyBufferFunction next = (clEnqueueCopyBufferFunction)nextFunction(API_clEnqueueCopyBuffer);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, src_buffer, dst_buffer, src_offset, dst_offset, cb, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueCopyBuffer, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueCopyBufferRectFunction)(
+	cl_command_queue command_queue,
+	cl_mem src_buffer,
+	cl_mem dst_buffer,
+	const size_t * src_origin,
+	const size_t * dst_origin,
+	const size_t * region,
+	size_t src_row_pitch,
+	size_t src_slice_pitch,
+	size_t dst_row_pitch,
+	size_t dst_slice_pitch,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyBufferRect(
+	cl_command_queue command_queue,
+	cl_mem src_buffer,
+	cl_mem dst_buffer,
+	const size_t * src_origin,
+	const size_t * dst_origin,
+	const size_t * region,
+	size_t src_row_pitch,
+	size_t src_slice_pitch,
+	size_t dst_row_pitch,
+	size_t dst_slice_pitch,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_1
+{
+	const clEnqueueCopyBufferRectFunction next = (clEnqueueCopyBufferRectFunction)nextFunction(API_clEnqueueCopyBufferRect);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, src_buffer, dst_buffer, src_origin, dst_origin, region, src_row_pitch, src_slice_pitch, dst_row_pitch, dst_slice_pitch, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueCopyBufferRect, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueReadImageFunction)(
+	cl_command_queue command_queue,
+	cl_mem image,
+	cl_bool blocking_read,
+	const size_t * origin,
+	const size_t * region,
+	size_t row_pitch,
+	size_t slice_pitch,
+	void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueReadImage(
+	cl_command_queue command_queue,
+	cl_mem image,
+	cl_bool blocking_read,
+	const size_t * origin,
+	const size_t * region,
+	size_t row_pitch,
+	size_t slice_pitch,
+	void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueReadImageFunction next = (clEnqueueReadImageFunction)nextFunction(API_clEnqueueReadImage);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, image, blocking_read, origin, region, row_pitch, slice_pitch, ptr, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueReadImage, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueWriteImageFunction)(
+	cl_command_queue command_queue,
+	cl_mem image,
+	cl_bool blocking_write,
+	const size_t * origin,
+	const size_t * region,
+	size_t input_row_pitch,
+	size_t input_slice_pitch,
+	const void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueWriteImage(
+	cl_command_queue command_queue,
+	cl_mem image,
+	cl_bool blocking_write,
+	const size_t * origin,
+	const size_t * region,
+	size_t input_row_pitch,
+	size_t input_slice_pitch,
+	const void * ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueWriteImageFunction next = (clEnqueueWriteImageFunction)nextFunction(API_clEnqueueWriteImage);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, image, blocking_write, origin, region, input_row_pitch, input_slice_pitch, ptr, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueWriteImage, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueCopyImageFunction)(
+	cl_command_queue command_queue,
+	cl_mem src_image,
+	cl_mem dst_image,
+	const size_t * src_origin,
+	const size_t * dst_origin,
+	const size_t * region,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyImage(
+	cl_command_queue command_queue,
+	cl_mem src_image,
+	cl_mem dst_image,
+	const size_t * src_origin,
+	const size_t * dst_origin,
+	const size_t * region,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueCopyImageFunction next = (clEnqueueCopyImageFunction)nextFunction(API_clEnqueueCopyImage);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, src_image, dst_image, src_origin, dst_origin, region, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueCopyImage, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueCopyImageToBufferFunction)(
+	cl_command_queue command_queue,
+	cl_mem src_image,
+	cl_mem dst_buffer,
+	const size_t * src_origin,
+	const size_t * region,
+	size_t dst_offset,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyImageToBuffer(
+	cl_command_queue command_queue,
+	cl_mem src_image,
+	cl_mem dst_buffer,
+	const size_t * src_origin,
+	const size_t * region,
+	size_t dst_offset,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueCopyImageToBufferFunction next = (clEnqueueCopyImageToBufferFunction)nextFunction(API_clEnqueueCopyImageToBuffer);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, src_image, dst_buffer, src_origin, region, dst_offset, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueCopyImageToBuffer, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueCopyBufferToImageFunction)(
+	cl_command_queue command_queue,
+	cl_mem src_buffer,
+	cl_mem dst_image,
+	size_t src_offset,
+	const size_t * dst_origin,
+	const size_t * region,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyBufferToImage(
+	cl_command_queue command_queue,
+	cl_mem src_buffer,
+	cl_mem dst_image,
+	size_t src_offset,
+	const size_t * dst_origin,
+	const size_t * region,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueCopyBufferToImageFunction next = (clEnqueueCopyBufferToImageFunction)nextFunction(API_clEnqueueCopyBufferToImage);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, src_buffer, dst_image, src_offset, dst_origin, region, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueCopyBufferToImage, startTime);
+	return result;
+}
+
+typedef void * (CL_API_CALL * clEnqueueMapBufferFunction)(
+	cl_command_queue command_queue,
+	cl_mem buffer,
+	cl_bool blocking_map,
+	cl_map_flags map_flags,
+	size_t offset,
+	size_t cb,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY void * CL_API_CALL clEnqueueMapBuffer(
+	cl_command_queue command_queue,
+	cl_mem buffer,
+	cl_bool blocking_map,
+	cl_map_flags map_flags,
+	size_t offset,
+	size_t cb,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueMapBufferFunction next = (clEnqueueMapBufferFunction)nextFunction(API_clEnqueueMapBuffer);
+	double startTime;
+	void * result;
+	noteEnqueue(command_queue);
+	noteMap(blocking_map, buffer);
+	startTime = currentTime();
+	result = next(command_queue, buffer, blocking_map, map_flags, offset, cb, num_events_in_wait_list, event_wait_list, event, errcode_ret);
+	recordCall(API_clEnqueueMapBuffer, startTime);
+	return result;
+}
+
+typedef void * (CL_API_CALL * clEnqueueMapImageFunction)(
+	cl_command_queue command_queue,
+	cl_mem image,
+	cl_bool blocking_map,
+	cl_map_flags map_flags,
+	const size_t * origin,
+	const size_t * region,
+	size_t * image_row_pitch,
+	size_t * image_slice_pitch,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event,
+	cl_int * errcode_ret
+);
+
+CL_API_ENTRY void * CL_API_CALL clEnqueueMapImage(
+	cl_command_queue command_queue,
+	cl_mem image,
+	cl_bool blocking_map,
+	cl_map_flags map_flags,
+	const size_t * origin,
+	const size_t * region,
+	size_t * image_row_pitch,
+	size_t * image_slice_pitch,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event,
+	cl_int * errcode_ret
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueMapImageFunction next = (clEnqueueMapImageFunction)nextFunction(API_clEnqueueMapImage);
+	double startTime;
+	void * result;
+	noteEnqueue(command_queue);
+	noteMap(blocking_map, image);
+	startTime = currentTime();
+	result = next(command_queue, image, blocking_map, map_flags, origin, region, image_row_pitch, image_slice_pitch, num_events_in_wait_list, event_wait_list, event, errcode_ret);
+	recordCall(API_clEnqueueMapImage, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueUnmapMemObjectFunction)(
+	cl_command_queue command_queue,
+	cl_mem memobj,
+	void * mapped_ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueUnmapMemObject(
+	cl_command_queue command_queue,
+	cl_mem memobj,
+	void * mapped_ptr,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueUnmapMemObjectFunction next = (clEnqueueUnmapMemObjectFunction)nextFunction(API_clEnqueueUnmapMemObject);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, memobj, mapped_ptr, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueUnmapMemObject, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueNDRangeKernelFunction)(
+	cl_command_queue command_queue,
+	cl_kernel kernel,
+	cl_uint work_dim,
+	const size_t * global_work_offset,
+	const size_t * global_work_size,
+	const size_t * local_work_size,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueNDRangeKernel(
+	cl_command_queue command_queue,
+	cl_kernel kernel,
+	cl_uint work_dim,
+	const size_t * global_work_offset,
+	const size_t * global_work_size,
+	const size_t * local_work_size,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueNDRangeKernelFunction next = (clEnqueueNDRangeKernelFunction)nextFunction(API_clEnqueueNDRangeKernel);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, kernel, work_dim, global_work_offset, global_work_size, local_work_size, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueNDRangeKernel, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueTaskFunction)(
+	cl_command_queue command_queue,
+	cl_kernel kernel,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueTask(
+	cl_command_queue command_queue,
+	cl_kernel kernel,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueTaskFunction next = (clEnqueueTaskFunction)nextFunction(API_clEnqueueTask);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, kernel, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueTask, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueNativeKernelFunction)(
+	cl_command_queue command_queue,
+	void ( * user_func ) ( void * ),
+	void * args,
+	size_t cb_args,
+	cl_uint num_mem_objects,
+	const cl_mem * mem_list,
+	const void ** args_mem_loc,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueNativeKernel(
+	cl_command_queue command_queue,
+	void ( * user_func ) ( void * ),
+	void * args,
+	size_t cb_args,
+	cl_uint num_mem_objects,
+	const cl_mem * mem_list,
+	const void ** args_mem_loc,
+	cl_uint num_events_in_wait_list,
+	const cl_event * event_wait_list,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueNativeKernelFunction next = (clEnqueueNativeKernelFunction)nextFunction(API_clEnqueueNativeKernel);
+	double startTime;
+	cl_int result;
+	noteEnqueue(command_queue);
+	startTime = currentTime();
+	result = next(command_queue, user_func, args, cb_args, num_mem_objects, mem_list, args_mem_loc, num_events_in_wait_list, event_wait_list, event);
+	recordCall(API_clEnqueueNativeKernel, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueMarkerFunction)(
+	cl_command_queue command_queue,
+	cl_event * event
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueMarker(
+	cl_command_queue command_queue,
+	cl_event * event
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueMarkerFunction next = (clEnqueueMarkerFunction)nextFunction(API_clEnqueueMarker);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(command_queue, event);
+	recordCall(API_clEnqueueMarker, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueWaitForEventsFunction)(
+	cl_command_queue command_queue,
+	cl_uint num_events,
+	const cl_event * event_list
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueWaitForEvents(
+	cl_command_queue command_queue,
+	cl_uint num_events,
+	const cl_event * event_list
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueWaitForEventsFunction next = (clEnqueueWaitForEventsFunction)nextFunction(API_clEnqueueWaitForEvents);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(command_queue, num_events, event_list);
+	recordCall(API_clEnqueueWaitForEvents, startTime);
+	return result;
+}
+
+typedef cl_int (CL_API_CALL * clEnqueueBarrierFunction)(
+	cl_command_queue command_queue
+);
+
+CL_API_ENTRY cl_int CL_API_CALL clEnqueueBarrier(
+	cl_command_queue command_queue
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clEnqueueBarrierFunction next = (clEnqueueBarrierFunction)nextFunction(API_clEnqueueBarrier);
+	double startTime;
+	cl_int result;
+	startTime = currentTime();
+	result = next(command_queue);
+	recordCall(API_clEnqueueBarrier, startTime);
+	return result;
+}
+
+typedef void * (CL_API_CALL * clGetExtensionFunctionAddressFunction)(
+	const char * func_name
+);
+
+CL_API_ENTRY void * CL_API_CALL clGetExtensionFunctionAddress(
+	const char * func_name
+) CL_API_SUFFIX__VERSION_1_0
+{
+	const clGetExtensionFunctionAddressFunction next = (clGetExtensionFunctionAddressFunction)nextFunction(API_clGetExtensionFunctionAddress);
+	double startTime;
+	void * result;
+	startTime = currentTime();
+	result = next(func_name);
+	recordCall(API_clGetExtensionFunctionAddress, startTime);
+	return result;
+}
@@ -10,7 +10,411 @@
  * ----------------------------------------------------------------------------
  */
 
-#include <CL/cl.h>
+#include "opencl_stubs.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Host runtime for memory objects.
+ *
+ * Buffers and images are held in host memory, so they can be created, mapped, read, written and copied
+ * without a device, which lets the host side of the samples (the buffer pool, for example) be exercised.
+ * Images are stored in 4x4 pixel tiles, as GPUs do, unless they use a host pointer;
+ * mapping a tiled image copies the region to a linear staging area, and unmapping copies it back.
+ * Samplers hold their settings, which stubReadImagef (opencl_stubs.h) uses to sample images on the host.
+ * Kernels are not executed, the other entry points are still empty stubs.
+ */
+
+/* Alignment of sub-buffer origins, in bits, reported as CL_DEVICE_MEM_BASE_ADDR_ALIGN. */
+#define STUB_MEM_BASE_ADDR_ALIGN 1024
+
+/* Width and height of the pixel tiles of an image. */
+#define STUB_IMAGE_TILE 4
+
+#define STUB_IMAGE2D_MAX_SIZE 8192
+#define STUB_IMAGE3D_MAX_SIZE 2048
+#define STUB_MAX_SAMPLERS 16
+
+/* The other device limits, enough for the device capability cache (common/device.h) to be filled. */
+#define STUB_DEVICE_NAME "Stub device"
+#define STUB_DRIVER_VERSION "1.1"
+#define STUB_DEVICE_EXTENSIONS "cl_khr_byte_addressable_store cl_khr_global_int32_base_atomics"
+#define STUB_MAX_WORK_GROUP_SIZE 256
+#define STUB_LOCAL_MEM_SIZE 32768
+#define STUB_GLOBAL_MEM_SIZE 268435456
+#define STUB_MAX_COMPUTE_UNITS 4
+#define STUB_PREFERRED_VECTOR_WIDTH 4
+
+/* A region of an image mapped with clEnqueueMapImage. */
+typedef struct StubMapping
+{
+	char * pointer;
+	/* The pointer is a staging copy of a tiled image, owned by the mapping. */
+	int staged;
+	cl_map_flags flags;
+	size_t origin[3];
+	size_t region[3];
+	size_t rowPitch;
+	size_t slicePitch;
+	struct StubMapping * next;
+} StubMapping;
+
+struct _cl_mem
+{
+	cl_mem_object_type type;
+	cl_mem_flags flags;
+	size_t size;
+	char * data;
+	int ownsData;
+	void * hostPointer;
+	cl_mem parent;
+	size_t offset;
+	cl_uint referenceCount;
+	cl_uint mapCount;
+
+	/* Images only. */
+	cl_image_format format;
+	size_t elementSize;
+	size_t width;
+	size_t height;
+	size_t depth;
+	/* Pitches of a linear image, or of the host pointer an image was created from. */
+	size_t rowPitch;
+	size_t slicePitch;
+	int tiled;
+	size_t tilesAcross;
+	size_t tilesDown;
+	StubMapping * mappings;
+};
+
+struct _cl_sampler
+{
+	cl_bool normalizedCoords;
+	cl_addressing_mode addressingMode;
+	cl_filter_mode filterMode;
+	cl_uint referenceCount;
+};
+
+static void setError(cl_int * errcode_ret, cl_int error)
+{
+	if (errcode_ret != NULL)
+	{
+		*errcode_ret = error;
+	}
+}
+
+/* Copy a value to the param_value of a clGet*Info call. */
+static cl_int returnInfo(const void * value, size_t size, size_t param_value_size, void * param_value, size_t * param_value_size_ret)
+{
+	if (param_value != NULL)
+	{
+		if (param_value_size < size)
+		{
+			return CL_INVALID_VALUE;
+		}
+		memcpy(param_value, value, size);
+	}
+	if (param_value_size_ret != NULL)
+	{
+		*param_value_size_ret = size;
+	}
+	return CL_SUCCESS;
+}
+
+/* Commands complete immediately, so there are no events to return. */
+static void noEvent(cl_event * event)
+{
+	if (event != NULL)
+	{
+		*event = NULL;
+	}
+}
+
+static const cl_channel_order imageChannelOrders[] =
+{
+	CL_R, CL_A, CL_RG, CL_RA, CL_RGB, CL_RGBA, CL_BGRA, CL_ARGB, CL_INTENSITY, CL_LUMINANCE, CL_Rx, CL_RGx, CL_RGBx
+};
+
+static const cl_channel_type imageChannelTypes[] =
+{
+	CL_SNORM_INT8, CL_SNORM_INT16, CL_UNORM_INT8, CL_UNORM_INT16, CL_UNORM_SHORT_565, CL_UNORM_SHORT_555, CL_UNORM_INT_101010,
+	CL_SIGNED_INT8, CL_SIGNED_INT16, CL_SIGNED_INT32, CL_UNSIGNED_INT8, CL_UNSIGNED_INT16, CL_UNSIGNED_INT32, CL_HALF_FLOAT, CL_FLOAT
+};
+
+/*
+ * Size in bytes of a pixel of an image format, or 0 if the combination of channel order and type is not allowed.
+ * Every allowed combination is supported.
+ */
+static size_t imageElementSize(const cl_image_format * format)
+{
+	size_t channels = 0;
+	size_t channelSize = 0;
+	int packed = 0;
+
+	if (format == NULL)
+	{
+		return 0;
+	}
+
+	switch (format->image_channel_data_type)
+	{
+		case CL_UNORM_SHORT_565:
+		case CL_UNORM_SHORT_555:
+			packed = 2;
+			break;
+		case CL_UNORM_INT_101010:
+			packed = 4;
+			break;
+		case CL_SNORM_INT8:
+		case CL_UNORM_INT8:
+		case CL_SIGNED_INT8:
+		case CL_UNSIGNED_INT8:
+			channelSize = 1;
+			break;
+		case CL_SNORM_INT16:
+		case CL_UNORM_INT16:
+		case CL_SIGNED_INT16:
+		case CL_UNSIGNED_INT16:
+		case CL_HALF_FLOAT:
+			channelSize = 2;
+			break;
+		case CL_SIGNED_INT32:
+		case CL_UNSIGNED_INT32:
+		case CL_FLOAT:
+			channelSize = 4;
+			break;
+		default:
+			return 0;
+	}
+
+	switch (format->image_channel_order)
+	{
+		/* The packed types are only allowed with these orders, and these orders only with the packed types. */
+		case CL_RGB:
+		case CL_RGBx:
+			return (size_t)packed;
+		case CL_BGRA:
+		case CL_ARGB:
+			return channelSize == 1 ? 4 : 0;
+		case CL_INTENSITY:
+		case CL_LUMINANCE:
+			if (format->image_channel_data_type != CL_UNORM_INT8 && format->image_channel_data_type != CL_UNORM_INT16 &&
+				format->image_channel_data_type != CL_SNORM_INT8 && format->image_channel_data_type != CL_SNORM_INT16 &&
+				format->image_channel_data_type != CL_HALF_FLOAT && format->image_channel_data_type != CL_FLOAT)
+			{
+				return 0;
+			}
+			channels = 1;
+			break;
+		case CL_R:
+		case CL_A:
+		case CL_Rx:
+			channels = 1;
+			break;
+		case CL_RG:
+		case CL_RA:
+		case CL_RGx:
+			channels = 2;
+			break;
+		case CL_RGBA:
+			channels = 4;
+			break;
+		default:
+			return 0;
+	}
+	return channels * channelSize;
+}
+
+static int isImage(cl_mem memobj)
+{
+	return memobj != NULL && (memobj->type == CL_MEM_OBJECT_IMAGE2D || memobj->type == CL_MEM_OBJECT_IMAGE3D);
+}
+
+/* Address of a pixel of an image. Pixels of a tile row are contiguous. */
+static char * imagePixel(cl_mem image, size_t x, size_t y, size_t z)
+{
+	if (image->tiled)
+	{
+		size_t tile = (z * image->tilesDown + y / STUB_IMAGE_TILE) * image->tilesAcross + x / STUB_IMAGE_TILE;
+		size_t pixel = tile * STUB_IMAGE_TILE * STUB_IMAGE_TILE + (y % STUB_IMAGE_TILE) * STUB_IMAGE_TILE + x % STUB_IMAGE_TILE;
+		return image->data + pixel * image->elementSize;
+	}
+	return image->data + z * image->slicePitch + y * image->rowPitch + x * image->elementSize;
+}
+
+static cl_int checkImageRegion(cl_mem image, const size_t * origin, const size_t * region)
+{
+	if (origin == NULL || region == NULL || region[0] == 0 || region[1] == 0 || region[2] == 0 ||
+		origin[0] > image->width || region[0] > image->width - origin[0] ||
+		origin[1] > image->height || region[1] > image->height - origin[1] ||
+		origin[2] > image->depth || region[2] > image->depth - origin[2])
+	{
+		return CL_INVALID_VALUE;
+	}
+	return CL_SUCCESS;
+}
+
+/* Copy a region of an image to or from linear host memory, a run of contiguous pixels at a time. */
+static void copyImageRegion(cl_mem image, const size_t * origin, const size_t * region, char * host, size_t rowPitch, size_t slicePitch, int toImage)
+{
+	size_t x;
+	size_t y;
+	size_t z;
+	for (z = 0; z < region[2]; z++)
+	{
+		for (y = 0; y < region[1]; y++)
+		{
+			char * row = host + z * slicePitch + y * rowPitch;
+			for (x = 0; x < region[0];)
+			{
+				size_t run = image->tiled ? STUB_IMAGE_TILE - (origin[0] + x) % STUB_IMAGE_TILE : region[0] - x;
+				char * pixel = imagePixel(image, origin[0] + x, origin[1] + y, origin[2] + z);
+				if (run > region[0] - x)
+				{
+					run = region[0] - x;
+				}
+				if (toImage)
+				{
+					memcpy(pixel, row + x * image->elementSize, run * image->elementSize);
+				}
+				else
+				{
+					memcpy(row + x * image->elementSize, pixel, run * image->elementSize);
+				}
+				x += run;
+			}
+		}
+	}
+}
+
+static cl_mem createImage(
+	cl_mem_object_type type,
+	cl_mem_flags flags,
+	const cl_image_format * image_format,
+	size_t image_width,
+	size_t image_height,
+	size_t image_depth,
+	size_t image_row_pitch,
+	size_t image_slice_pitch,
+	void * host_ptr,
+	cl_int * errcode_ret)
+{
+	const size_t elementSize = imageElementSize(image_format);
+	const size_t maximumSize = type == CL_MEM_OBJECT_IMAGE2D ? STUB_IMAGE2D_MAX_SIZE : STUB_IMAGE3D_MAX_SIZE;
+	const size_t linearRowPitch = image_width * elementSize;
+	cl_mem image;
+
+	if (elementSize == 0)
+	{
+		setError(errcode_ret, image_format == NULL ? CL_INVALID_IMAGE_FORMAT_DESCRIPTOR : CL_IMAGE_FORMAT_NOT_SUPPORTED);
+		return NULL;
+	}
+	if (image_width == 0 || image_height == 0 || image_depth == 0 ||
+		image_width > maximumSize || image_height > maximumSize || image_depth > maximumSize ||
+		(type == CL_MEM_OBJECT_IMAGE3D && image_depth < 2))
+	{
+		setError(errcode_ret, CL_INVALID_IMAGE_SIZE);
+		return NULL;
+	}
+	if (((flags & (CL_MEM_USE_HOST_PTR | CL_MEM_COPY_HOST_PTR)) != 0) != (host_ptr != NULL))
+	{
+		setError(errcode_ret, CL_INVALID_HOST_PTR);
+		return NULL;
+	}
+
+	if (image_row_pitch == 0)
+	{
+		image_row_pitch = linearRowPitch;
+	}
+	if (image_slice_pitch == 0)
+	{
+		image_slice_pitch = image_row_pitch * image_height;
+	}
+	if ((host_ptr == NULL && (image_row_pitch != linearRowPitch || image_slice_pitch != linearRowPitch * image_height)) ||
+		image_row_pitch < linearRowPitch || image_row_pitch % elementSize != 0 ||
+		image_slice_pitch < image_row_pitch * image_height || image_slice_pitch % image_row_pitch != 0)
+	{
+		setError(errcode_ret, CL_INVALID_IMAGE_SIZE);
+		return NULL;
+	}
+
+	image = (cl_mem)calloc(1, sizeof(struct _cl_mem));
+	if (image == NULL)
+	{
+		setError(errcode_ret, CL_OUT_OF_HOST_MEMORY);
+		return NULL;
+	}
+	image->type = type;
+	image->flags = flags;
+	image->referenceCount = 1;
+	image->format = *image_format;
+	image->elementSize = elementSize;
+	image->width = image_width;
+	image->height = image_height;
+	image->depth = image_depth;
+	image->rowPitch = image_row_pitch;
+	image->slicePitch = image_slice_pitch;
+
+	/* An image using a host pointer must keep its layout, so only the others are tiled. */
+	if (flags & CL_MEM_USE_HOST_PTR)
+	{
+		image->size = image_slice_pitch * image_depth;
+		image->data = (char *)host_ptr;
+		image->hostPointer = host_ptr;
+	}
+	else
+	{
+		image->tiled = 1;
+		image->tilesAcross = (image_width + STUB_IMAGE_TILE - 1) / STUB_IMAGE_TILE;
+		image->tilesDown = (image_height + STUB_IMAGE_TILE - 1) / STUB_IMAGE_TILE;
+		image->size = image->tilesAcross * image->tilesDown * image_depth * STUB_IMAGE_TILE * STUB_IMAGE_TILE * elementSize;
+		image->data = (char *)calloc(1, image->size);
+		image->ownsData = 1;
+		if (image->data == NULL)
+		{
+			free(image);
+			setError(errcode_ret, CL_MEM_OBJECT_ALLOCATION_FAILURE);
+			return NULL;
+		}
+		if (flags & CL_MEM_COPY_HOST_PTR)
+		{
+			const size_t origin[3] = {0, 0, 0};
+			const size_t region[3] = {image_width, image_height, image_depth};
+			copyImageRegion(image, origin, region, (char *)host_ptr, image_row_pitch, image_slice_pitch, 1);
+		}
+	}
+	setError(errcode_ret, CL_SUCCESS);
+	return image;
+}
+
+static void releaseMemObject(cl_mem memobj)
+{
+	if (--memobj->referenceCount > 0)
+	{
+		return;
+	}
+	while (memobj->mappings != NULL)
+	{
+		StubMapping * mapping = memobj->mappings;
+		memobj->mappings = mapping->next;
+		if (mapping->staged)
+		{
+			free(mapping->pointer);
+		}
+		free(mapping);
+	}
+	if (memobj->parent != NULL)
+	{
+		releaseMemObject(memobj->parent);
+	}
+	if (memobj->ownsData)
+	{
+		free(memobj->data);
+	}
+	free(memobj);
+}
 
 CL_API_ENTRY cl_int CL_API_CALL clGetPlatformIDs(
 	cl_uint num_entries,
@@ -48,6 +452,63 @@ CL_API_ENTRY cl_int CL_API_CALL clGetDeviceInfo(
 	size_t * param_value_size_ret
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	cl_uint alignment = STUB_MEM_BASE_ADDR_ALIGN;
+	cl_bool imageSupport = CL_TRUE;
+	size_t image2DMaximumSize = STUB_IMAGE2D_MAX_SIZE;
+	size_t image3DMaximumSize = STUB_IMAGE3D_MAX_SIZE;
+	cl_uint maximumSamplers = STUB_MAX_SAMPLERS;
+	size_t maximumWorkGroupSize = STUB_MAX_WORK_GROUP_SIZE;
+	cl_uint workItemDimensions = 3;
+	size_t maximumWorkItemSizes[3] = {STUB_MAX_WORK_GROUP_SIZE, STUB_MAX_WORK_GROUP_SIZE, STUB_MAX_WORK_GROUP_SIZE};
+	cl_ulong localMemorySize = STUB_LOCAL_MEM_SIZE;
+	cl_ulong globalMemorySize = STUB_GLOBAL_MEM_SIZE;
+	cl_uint computeUnits = STUB_MAX_COMPUTE_UNITS;
+	cl_uint preferredVectorWidth = STUB_PREFERRED_VECTOR_WIDTH;
+	switch (param_name)
+	{
+		case CL_DEVICE_NAME:
+			return returnInfo(STUB_DEVICE_NAME, sizeof(STUB_DEVICE_NAME), param_value_size, param_value, param_value_size_ret);
+		case CL_DRIVER_VERSION:
+			return returnInfo(STUB_DRIVER_VERSION, sizeof(STUB_DRIVER_VERSION), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_EXTENSIONS:
+			return returnInfo(STUB_DEVICE_EXTENSIONS, sizeof(STUB_DEVICE_EXTENSIONS), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_MAX_WORK_GROUP_SIZE:
+			return returnInfo(&maximumWorkGroupSize, sizeof(maximumWorkGroupSize), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS:
+			return returnInfo(&workItemDimensions, sizeof(workItemDimensions), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_MAX_WORK_ITEM_SIZES:
+			return returnInfo(maximumWorkItemSizes, sizeof(maximumWorkItemSizes), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_LOCAL_MEM_SIZE:
+			return returnInfo(&localMemorySize, sizeof(localMemorySize), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_GLOBAL_MEM_SIZE:
+			return returnInfo(&globalMemorySize, sizeof(globalMemorySize), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_MAX_COMPUTE_UNITS:
+			return returnInfo(&computeUnits, sizeof(computeUnits), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR:
+		case CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT:
+		case CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT:
+		case CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT:
+			return returnInfo(&preferredVectorWidth, sizeof(preferredVectorWidth), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_PREFERRED_VECTOR_WIDTH_LONG:
+		case CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE:
+			preferredVectorWidth /= 2;
+			return returnInfo(&preferredVectorWidth, sizeof(preferredVectorWidth), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_MEM_BASE_ADDR_ALIGN:
+			return returnInfo(&alignment, sizeof(alignment), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_IMAGE_SUPPORT:
+			return returnInfo(&imageSupport, sizeof(imageSupport), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_IMAGE2D_MAX_WIDTH:
+		case CL_DEVICE_IMAGE2D_MAX_HEIGHT:
+			return returnInfo(&image2DMaximumSize, sizeof(image2DMaximumSize), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_IMAGE3D_MAX_WIDTH:
+		case CL_DEVICE_IMAGE3D_MAX_HEIGHT:
+		case CL_DEVICE_IMAGE3D_MAX_DEPTH:
+			return returnInfo(&image3DMaximumSize, sizeof(image3DMaximumSize), param_value_size, param_value, param_value_size_ret);
+		case CL_DEVICE_MAX_SAMPLERS:
+			return returnInfo(&maximumSamplers, sizeof(maximumSamplers), param_value_size, param_value, param_value_size_ret);
+		default:
+			return CL_INVALID_VALUE;
+	}
 }
 
 CL_API_ENTRY cl_context CL_API_CALL clCreateContext(
@@ -141,6 +602,44 @@ CL_API_ENTRY cl_mem CL_API_CALL clCreateBuffer(
 	cl_int * errcode_ret
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	cl_mem memobj;
+	if (size == 0 || ((flags & (CL_MEM_USE_HOST_PTR | CL_MEM_COPY_HOST_PTR)) != 0) != (host_ptr != NULL))
+	{
+		setError(errcode_ret, size == 0 ? CL_INVALID_BUFFER_SIZE : CL_INVALID_HOST_PTR);
+		return NULL;
+	}
+	memobj = (cl_mem)calloc(1, sizeof(struct _cl_mem));
+	if (memobj == NULL)
+	{
+		setError(errcode_ret, CL_OUT_OF_HOST_MEMORY);
+		return NULL;
+	}
+	memobj->type = CL_MEM_OBJECT_BUFFER;
+	memobj->flags = flags;
+	memobj->size = size;
+	memobj->referenceCount = 1;
+	if (flags & CL_MEM_USE_HOST_PTR)
+	{
+		memobj->data = (char *)host_ptr;
+		memobj->hostPointer = host_ptr;
+	}
+	else
+	{
+		memobj->data = (char *)malloc(size);
+		memobj->ownsData = 1;
+		if (memobj->data == NULL)
+		{
+			free(memobj);
+			setError(errcode_ret, CL_MEM_OBJECT_ALLOCATION_FAILURE);
+			return NULL;
+		}
+		if (flags & CL_MEM_COPY_HOST_PTR)
+		{
+			memcpy(memobj->data, host_ptr, size);
+		}
+	}
+	setError(errcode_ret, CL_SUCCESS);
+	return memobj;
 }
 
 CL_API_ENTRY cl_mem CL_API_CALL clCreateSubBuffer(
@@ -151,6 +650,53 @@ CL_API_ENTRY cl_mem CL_API_CALL clCreateSubBuffer(
 	cl_int * errcode_ret
 ) CL_API_SUFFIX__VERSION_1_1
 {
+	const cl_buffer_region * region = (const cl_buffer_region *)buffer_create_info;
+	cl_mem memobj;
+	if (buffer == NULL || buffer->type != CL_MEM_OBJECT_BUFFER || buffer->parent != NULL)
+	{
+		setError(errcode_ret, CL_INVALID_MEM_OBJECT);
+		return NULL;
+	}
+	if (buffer_create_type != CL_BUFFER_CREATE_TYPE_REGION || region == NULL ||
+		(flags & (CL_MEM_USE_HOST_PTR | CL_MEM_ALLOC_HOST_PTR | CL_MEM_COPY_HOST_PTR)) != 0)
+	{
+		setError(errcode_ret, CL_INVALID_VALUE);
+		return NULL;
+	}
+	if (region->size == 0)
+	{
+		setError(errcode_ret, CL_INVALID_BUFFER_SIZE);
+		return NULL;
+	}
+	if (region->origin > buffer->size || region->size > buffer->size - region->origin)
+	{
+		setError(errcode_ret, CL_INVALID_VALUE);
+		return NULL;
+	}
+	if (region->origin % (STUB_MEM_BASE_ADDR_ALIGN / 8) != 0)
+	{
+		setError(errcode_ret, CL_MISALIGNED_SUB_BUFFER_OFFSET);
+		return NULL;
+	}
+	memobj = (cl_mem)calloc(1, sizeof(struct _cl_mem));
+	if (memobj == NULL)
+	{
+		setError(errcode_ret, CL_OUT_OF_HOST_MEMORY);
+		return NULL;
+	}
+	memobj->type = CL_MEM_OBJECT_BUFFER;
+	/* The access flags default to those of the parent, the host pointer flags are always inherited. */
+	memobj->flags = (flags != 0 ? flags : (buffer->flags & (CL_MEM_READ_WRITE | CL_MEM_READ_ONLY | CL_MEM_WRITE_ONLY))) |
+		(buffer->flags & (CL_MEM_USE_HOST_PTR | CL_MEM_ALLOC_HOST_PTR | CL_MEM_COPY_HOST_PTR));
+	memobj->size = region->size;
+	memobj->data = buffer->data + region->origin;
+	memobj->hostPointer = buffer->hostPointer != NULL ? (char *)buffer->hostPointer + region->origin : NULL;
+	memobj->parent = buffer;
+	memobj->offset = region->origin;
+	memobj->referenceCount = 1;
+	buffer->referenceCount++;
+	setError(errcode_ret, CL_SUCCESS);
+	return memobj;
 }
 
 CL_API_ENTRY cl_mem CL_API_CALL clCreateImage2D(
@@ -164,6 +710,7 @@ CL_API_ENTRY cl_mem CL_API_CALL clCreateImage2D(
 	cl_int * errcode_ret
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	return createImage(CL_MEM_OBJECT_IMAGE2D, flags, image_format, image_width, image_height, 1, image_row_pitch, 0, host_ptr, errcode_ret);
 }
 
 CL_API_ENTRY cl_mem CL_API_CALL clCreateImage3D(
@@ -179,18 +726,31 @@ CL_API_ENTRY cl_mem CL_API_CALL clCreateImage3D(
 	cl_int * errcode_ret
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	return createImage(CL_MEM_OBJECT_IMAGE3D, flags, image_format, image_width, image_height, image_depth, image_row_pitch, image_slice_pitch, host_ptr, errcode_ret);
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clRetainMemObject(
 	cl_mem memobj
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	if (memobj == NULL)
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	memobj->referenceCount++;
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clReleaseMemObject(
 	cl_mem memobj
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	if (memobj == NULL)
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	releaseMemObject(memobj);
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clGetSupportedImageFormats(
@@ -202,6 +762,36 @@ CL_API_ENTRY cl_int CL_API_CALL clGetSupportedImageFormats(
 	cl_uint * num_image_formats
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	cl_uint count = 0;
+	size_t order;
+	size_t type;
+	if ((image_type != CL_MEM_OBJECT_IMAGE2D && image_type != CL_MEM_OBJECT_IMAGE3D) || (num_entries == 0 && image_formats != NULL))
+	{
+		return CL_INVALID_VALUE;
+	}
+	for (order = 0; order < sizeof(imageChannelOrders) / sizeof(imageChannelOrders[0]); order++)
+	{
+		for (type = 0; type < sizeof(imageChannelTypes) / sizeof(imageChannelTypes[0]); type++)
+		{
+			cl_image_format format;
+			format.image_channel_order = imageChannelOrders[order];
+			format.image_channel_data_type = imageChannelTypes[type];
+			if (imageElementSize(&format) == 0)
+			{
+				continue;
+			}
+			if (image_formats != NULL && count < num_entries)
+			{
+				image_formats[count] = format;
+			}
+			count++;
+		}
+	}
+	if (num_image_formats != NULL)
+	{
+		*num_image_formats = count;
+	}
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clGetMemObjectInfo(
@@ -212,6 +802,34 @@ CL_API_ENTRY cl_int CL_API_CALL clGetMemObjectInfo(
 	size_t * param_value_size_ret
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	cl_context context = NULL;
+	if (memobj == NULL)
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	switch (param_name)
+	{
+		case CL_MEM_TYPE:
+			return returnInfo(&memobj->type, sizeof(memobj->type), param_value_size, param_value, param_value_size_ret);
+		case CL_MEM_FLAGS:
+			return returnInfo(&memobj->flags, sizeof(memobj->flags), param_value_size, param_value, param_value_size_ret);
+		case CL_MEM_SIZE:
+			return returnInfo(&memobj->size, sizeof(memobj->size), param_value_size, param_value, param_value_size_ret);
+		case CL_MEM_HOST_PTR:
+			return returnInfo(&memobj->hostPointer, sizeof(memobj->hostPointer), param_value_size, param_value, param_value_size_ret);
+		case CL_MEM_MAP_COUNT:
+			return returnInfo(&memobj->mapCount, sizeof(memobj->mapCount), param_value_size, param_value, param_value_size_ret);
+		case CL_MEM_REFERENCE_COUNT:
+			return returnInfo(&memobj->referenceCount, sizeof(memobj->referenceCount), param_value_size, param_value, param_value_size_ret);
+		case CL_MEM_CONTEXT:
+			return returnInfo(&context, sizeof(context), param_value_size, param_value, param_value_size_ret);
+		case CL_MEM_ASSOCIATED_MEMOBJECT:
+			return returnInfo(&memobj->parent, sizeof(memobj->parent), param_value_size, param_value, param_value_size_ret);
+		case CL_MEM_OFFSET:
+			return returnInfo(&memobj->offset, sizeof(memobj->offset), param_value_size, param_value, param_value_size_ret);
+		default:
+			return CL_INVALID_VALUE;
+	}
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clGetImageInfo(
@@ -222,6 +840,35 @@ CL_API_ENTRY cl_int CL_API_CALL clGetImageInfo(
 	size_t * param_value_size_ret
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	if (!isImage(image))
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	switch (param_name)
+	{
+		case CL_IMAGE_FORMAT:
+			return returnInfo(&image->format, sizeof(image->format), param_value_size, param_value, param_value_size_ret);
+		case CL_IMAGE_ELEMENT_SIZE:
+			return returnInfo(&image->elementSize, sizeof(image->elementSize), param_value_size, param_value, param_value_size_ret);
+		case CL_IMAGE_ROW_PITCH:
+			return returnInfo(&image->rowPitch, sizeof(image->rowPitch), param_value_size, param_value, param_value_size_ret);
+		case CL_IMAGE_SLICE_PITCH:
+		{
+			size_t slicePitch = image->type == CL_MEM_OBJECT_IMAGE3D ? image->slicePitch : 0;
+			return returnInfo(&slicePitch, sizeof(slicePitch), param_value_size, param_value, param_value_size_ret);
+		}
+		case CL_IMAGE_WIDTH:
+			return returnInfo(&image->width, sizeof(image->width), param_value_size, param_value, param_value_size_ret);
+		case CL_IMAGE_HEIGHT:
+			return returnInfo(&image->height, sizeof(image->height), param_value_size, param_value, param_value_size_ret);
+		case CL_IMAGE_DEPTH:
+		{
+			size_t depth = image->type == CL_MEM_OBJECT_IMAGE3D ? image->depth : 0;
+			return returnInfo(&depth, sizeof(depth), param_value_size, param_value, param_value_size_ret);
+		}
+		default:
+			return CL_INVALID_VALUE;
+	}
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clSetMemObjectDestructorCallback(
@@ -240,18 +887,60 @@ CL_API_ENTRY cl_sampler CL_API_CALL clCreateSampler(
 	cl_int * errcode_ret
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	cl_sampler sampler;
+	if ((normalized_coords != CL_TRUE && normalized_coords != CL_FALSE) ||
+		(addressing_mode != CL_ADDRESS_NONE && addressing_mode != CL_ADDRESS_CLAMP_TO_EDGE && addressing_mode != CL_ADDRESS_CLAMP &&
+		 addressing_mode != CL_ADDRESS_REPEAT && addressing_mode != CL_ADDRESS_MIRRORED_REPEAT) ||
+		(filter_mode != CL_FILTER_NEAREST && filter_mode != CL_FILTER_LINEAR))
+	{
+		setError(errcode_ret, CL_INVALID_VALUE);
+		return NULL;
+	}
+	/* Repeating addressing modes are only defined for normalized coordinates. */
+	if (!normalized_coords && (addressing_mode == CL_ADDRESS_REPEAT || addressing_mode == CL_ADDRESS_MIRRORED_REPEAT))
+	{
+		setError(errcode_ret, CL_INVALID_VALUE);
+		return NULL;
+	}
+	sampler = (cl_sampler)calloc(1, sizeof(struct _cl_sampler));
+	if (sampler == NULL)
+	{
+		setError(errcode_ret, CL_OUT_OF_HOST_MEMORY);
+		return NULL;
+	}
+	sampler->normalizedCoords = normalized_coords;
+	sampler->addressingMode = addressing_mode;
+	sampler->filterMode = filter_mode;
+	sampler->referenceCount = 1;
+	setError(errcode_ret, CL_SUCCESS);
+	return sampler;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clRetainSampler(
 	cl_sampler sampler
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	if (sampler == NULL)
+	{
+		return CL_INVALID_SAMPLER;
+	}
+	sampler->referenceCount++;
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clReleaseSampler(
 	cl_sampler sampler
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	if (sampler == NULL)
+	{
+		return CL_INVALID_SAMPLER;
+	}
+	if (--sampler->referenceCount == 0)
+	{
+		free(sampler);
+	}
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clGetSamplerInfo(
@@ -262,6 +951,305 @@ CL_API_ENTRY cl_int CL_API_CALL clGetSamplerInfo(
 	size_t * param_value_size_ret
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	cl_context context = NULL;
+	if (sampler == NULL)
+	{
+		return CL_INVALID_SAMPLER;
+	}
+	switch (param_name)
+	{
+		case CL_SAMPLER_REFERENCE_COUNT:
+			return returnInfo(&sampler->referenceCount, sizeof(sampler->referenceCount), param_value_size, param_value, param_value_size_ret);
+		case CL_SAMPLER_CONTEXT:
+			return returnInfo(&context, sizeof(context), param_value_size, param_value, param_value_size_ret);
+		case CL_SAMPLER_NORMALIZED_COORDS:
+			return returnInfo(&sampler->normalizedCoords, sizeof(sampler->normalizedCoords), param_value_size, param_value, param_value_size_ret);
+		case CL_SAMPLER_ADDRESSING_MODE:
+			return returnInfo(&sampler->addressingMode, sizeof(sampler->addressingMode), param_value_size, param_value, param_value_size_ret);
+		case CL_SAMPLER_FILTER_MODE:
+			return returnInfo(&sampler->filterMode, sizeof(sampler->filterMode), param_value_size, param_value, param_value_size_ret);
+		default:
+			return CL_INVALID_VALUE;
+	}
+}
+
+/* Alpha is 0 in the border colour of channel orders with an alpha channel, and 1 in the others. */
+static int hasAlpha(cl_channel_order order)
+{
+	return order == CL_A || order == CL_RA || order == CL_RGBA || order == CL_BGRA || order == CL_ARGB || order == CL_INTENSITY;
+}
+
+static int isIntegerType(cl_channel_type type)
+{
+	return type == CL_SIGNED_INT8 || type == CL_SIGNED_INT16 || type == CL_SIGNED_INT32 ||
+		type == CL_UNSIGNED_INT8 || type == CL_UNSIGNED_INT16 || type == CL_UNSIGNED_INT32;
+}
+
+/* IEEE 754 binary16, with its subnormals, infinities and NaNs. */
+static float halfToFloat(cl_half half)
+{
+	const int exponent = (half >> 10) & 0x1f;
+	const int mantissa = half & 0x3ff;
+	float value;
+
+	if (exponent == 0)
+	{
+		value = (float)ldexp((double)mantissa, -24);
+	}
+	else if (exponent == 0x1f)
+	{
+		value = mantissa == 0 ? (float)HUGE_VAL : NAN;
+	}
+	else
+	{
+		value = (float)ldexp((double)(mantissa | 0x400), exponent - 25);
+	}
+	return (half & 0x8000) != 0 ? -value : value;
+}
+
+/* Value of a channel of a pixel, normalized for the normalized types. The channel types are the ones imageElementSize allows. */
+static float channelValue(const char * pixel, cl_channel_type type, size_t channel)
+{
+	switch (type)
+	{
+		case CL_SNORM_INT8:
+		{
+			const float value = ((const cl_char *)pixel)[channel] / 127.0f;
+			return value < -1.0f ? -1.0f : value;
+		}
+		case CL_SNORM_INT16:
+		{
+			const float value = ((const cl_short *)pixel)[channel] / 32767.0f;
+			return value < -1.0f ? -1.0f : value;
+		}
+		case CL_UNORM_INT8:
+			return ((const cl_uchar *)pixel)[channel] / 255.0f;
+		case CL_UNORM_INT16:
+			return ((const cl_ushort *)pixel)[channel] / 65535.0f;
+		case CL_SIGNED_INT8:
+			return ((const cl_char *)pixel)[channel];
+		case CL_SIGNED_INT16:
+			return ((const cl_short *)pixel)[channel];
+		case CL_SIGNED_INT32:
+			return (float)((const cl_int *)pixel)[channel];
+		case CL_UNSIGNED_INT8:
+			return ((const cl_uchar *)pixel)[channel];
+		case CL_UNSIGNED_INT16:
+			return ((const cl_ushort *)pixel)[channel];
+		case CL_UNSIGNED_INT32:
+			return (float)((const cl_uint *)pixel)[channel];
+		case CL_HALF_FLOAT:
+			return halfToFloat(((const cl_half *)pixel)[channel]);
+		default:
+			return ((const cl_float *)pixel)[channel];
+	}
+}
+
+/* Read a pixel as (r, g, b, a). Coordinates outside the image, left by CL_ADDRESS_CLAMP, read the border colour. */
+static void readTexel(cl_mem image, long x, long y, long z, float * color)
+{
+	const cl_channel_order order = image->format.image_channel_order;
+	const cl_channel_type type = image->format.image_channel_data_type;
+	const char * pixel;
+	cl_ushort packed;
+	cl_uint packed32;
+
+	color[0] = 0.0f;
+	color[1] = 0.0f;
+	color[2] = 0.0f;
+	color[3] = hasAlpha(order) ? 0.0f : 1.0f;
+	if (x < 0 || y < 0 || z < 0 || x >= (long)image->width || y >= (long)image->height || z >= (long)image->depth)
+	{
+		return;
+	}
+	pixel = imagePixel(image, (size_t)x, (size_t)y, (size_t)z);
+
+	switch (type)
+	{
+		case CL_UNORM_SHORT_565:
+			memcpy(&packed, pixel, sizeof(packed));
+			color[0] = ((packed >> 11) & 0x1f) / 31.0f;
+			color[1] = ((packed >> 5) & 0x3f) / 63.0f;
+			color[2] = (packed & 0x1f) / 31.0f;
+			return;
+		case CL_UNORM_SHORT_555:
+			memcpy(&packed, pixel, sizeof(packed));
+			color[0] = ((packed >> 10) & 0x1f) / 31.0f;
+			color[1] = ((packed >> 5) & 0x1f) / 31.0f;
+			color[2] = (packed & 0x1f) / 31.0f;
+			return;
+		case CL_UNORM_INT_101010:
+			memcpy(&packed32, pixel, sizeof(packed32));
+			color[0] = ((packed32 >> 20) & 0x3ff) / 1023.0f;
+			color[1] = ((packed32 >> 10) & 0x3ff) / 1023.0f;
+			color[2] = (packed32 & 0x3ff) / 1023.0f;
+			return;
+		default:
+			break;
+	}
+
+	switch (order)
+	{
+		case CL_A:
+			color[3] = channelValue(pixel, type, 0);
+			break;
+		case CL_RA:
+			color[0] = channelValue(pixel, type, 0);
+			color[3] = channelValue(pixel, type, 1);
+			break;
+		case CL_RG:
+		case CL_RGx:
+			color[0] = channelValue(pixel, type, 0);
+			color[1] = channelValue(pixel, type, 1);
+			break;
+		case CL_RGBA:
+			color[0] = channelValue(pixel, type, 0);
+			color[1] = channelValue(pixel, type, 1);
+			color[2] = channelValue(pixel, type, 2);
+			color[3] = channelValue(pixel, type, 3);
+			break;
+		case CL_BGRA:
+			color[2] = channelValue(pixel, type, 0);
+			color[1] = channelValue(pixel, type, 1);
+			color[0] = channelValue(pixel, type, 2);
+			color[3] = channelValue(pixel, type, 3);
+			break;
+		case CL_ARGB:
+			color[3] = channelValue(pixel, type, 0);
+			color[0] = channelValue(pixel, type, 1);
+			color[1] = channelValue(pixel, type, 2);
+			color[2] = channelValue(pixel, type, 3);
+			break;
+		case CL_INTENSITY:
+			color[0] = color[1] = color[2] = color[3] = channelValue(pixel, type, 0);
+			break;
+		case CL_LUMINANCE:
+			color[0] = color[1] = color[2] = channelValue(pixel, type, 0);
+			break;
+		default:
+			color[0] = channelValue(pixel, type, 0);
+			break;
+	}
+}
+
+/*
+ * Apply the addressing mode of a sampler to a coordinate along one dimension of an image of size pixels.
+ * Gives the pixels either side of the coordinate and the weight of the second for linear filtering,
+ * or the nearest pixel as both with a weight of 0. CL_ADDRESS_CLAMP (and CL_ADDRESS_NONE, which is undefined outside the image)
+ * leaves coordinates of -1 or size, which read the border colour.
+ */
+static void addressCoordinate(cl_sampler sampler, float coordinate, size_t size, long * first, long * second, float * weight)
+{
+	const long last = (long)size - 1;
+	double u;
+	long index;
+
+	/* Repeating modes are only allowed with normalized coordinates. */
+	if (sampler->addressingMode == CL_ADDRESS_REPEAT)
+	{
+		u = (coordinate - floor(coordinate)) * size;
+	}
+	else if (sampler->addressingMode == CL_ADDRESS_MIRRORED_REPEAT)
+	{
+		/* Distance to the nearest even integer, so the image is flipped every other repeat. */
+		u = fabs(coordinate - 2.0 * floor(0.5 * coordinate + 0.5)) * size;
+	}
+	else
+	{
+		u = sampler->normalizedCoords ? (double)coordinate * size : coordinate;
+	}
+
+	if (sampler->filterMode == CL_FILTER_NEAREST)
+	{
+		index = (long)floor(u);
+		*weight = 0.0f;
+	}
+	else
+	{
+		index = (long)floor(u - 0.5);
+		*weight = (float)(u - 0.5 - floor(u - 0.5));
+	}
+	*first = index;
+	*second = sampler->filterMode == CL_FILTER_NEAREST ? index : index + 1;
+
+	switch (sampler->addressingMode)
+	{
+		case CL_ADDRESS_REPEAT:
+			*first = *first < 0 ? *first + (long)size : *first;
+			*second = *second > last ? *second - (long)size : *second;
+			break;
+		case CL_ADDRESS_MIRRORED_REPEAT:
+			*first = *first < 0 ? 0 : (*first > last ? last : *first);
+			*second = *second > last ? last : *second;
+			break;
+		case CL_ADDRESS_CLAMP_TO_EDGE:
+			*first = *first < 0 ? 0 : (*first > last ? last : *first);
+			*second = *second < 0 ? 0 : (*second > last ? last : *second);
+			break;
+		default:
+			*first = *first < -1 ? -1 : (*first > last + 1 ? last + 1 : *first);
+			*second = *second < -1 ? -1 : (*second > last + 1 ? last + 1 : *second);
+			break;
+	}
+}
+
+cl_int stubReadImagef(cl_mem image, cl_sampler sampler, const float * coordinates, float * color)
+{
+	const size_t sizes[3] = {image != NULL ? image->width : 0, image != NULL ? image->height : 0, image != NULL ? image->depth : 0};
+	long pixels[3][2] = {{0, 0}, {0, 0}, {0, 0}};
+	float weights[3] = {0.0f, 0.0f, 0.0f};
+	int dimensions;
+	int dimension;
+	int corner;
+	int channel;
+
+	if (!isImage(image))
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	if (sampler == NULL)
+	{
+		return CL_INVALID_SAMPLER;
+	}
+	if (coordinates == NULL || color == NULL)
+	{
+		return CL_INVALID_VALUE;
+	}
+	if (sampler->filterMode == CL_FILTER_LINEAR && isIntegerType(image->format.image_channel_data_type))
+	{
+		return CL_INVALID_OPERATION;
+	}
+
+	dimensions = image->type == CL_MEM_OBJECT_IMAGE3D ? 3 : 2;
+	for (dimension = 0; dimension < dimensions; dimension++)
+	{
+		addressCoordinate(sampler, coordinates[dimension], sizes[dimension], &pixels[dimension][0], &pixels[dimension][1], &weights[dimension]);
+	}
+
+	/* Blend the (up to) eight surrounding pixels, skipping those with no weight. */
+	for (channel = 0; channel < 4; channel++)
+	{
+		color[channel] = 0.0f;
+	}
+	for (corner = 0; corner < 8; corner++)
+	{
+		float weight = 1.0f;
+		float texel[4];
+		for (dimension = 0; dimension < 3; dimension++)
+		{
+			weight *= (corner >> dimension) & 1 ? weights[dimension] : 1.0f - weights[dimension];
+		}
+		if (weight == 0.0f)
+		{
+			continue;
+		}
+		readTexel(image, pixels[0][(corner >> 0) & 1], pixels[1][(corner >> 1) & 1], pixels[2][(corner >> 2) & 1], texel);
+		for (channel = 0; channel < 4; channel++)
+		{
+			color[channel] += weight * texel[channel];
+		}
+	}
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_program CL_API_CALL clCreateProgramWithSource(
@@ -481,6 +1469,17 @@ CL_API_ENTRY cl_int CL_API_CALL clEnqueueReadBuffer(
 	cl_event * event
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	if (buffer == NULL || buffer->type != CL_MEM_OBJECT_BUFFER)
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	if (ptr == NULL || offset > buffer->size || cb > buffer->size - offset)
+	{
+		return CL_INVALID_VALUE;
+	}
+	memcpy(ptr, buffer->data + offset, cb);
+	noEvent(event);
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clEnqueueReadBufferRect(
@@ -514,6 +1513,17 @@ CL_API_ENTRY cl_int CL_API_CALL clEnqueueWriteBuffer(
 	cl_event * event
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	if (buffer == NULL || buffer->type != CL_MEM_OBJECT_BUFFER)
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	if (ptr == NULL || offset > buffer->size || cb > buffer->size - offset)
+	{
+		return CL_INVALID_VALUE;
+	}
+	memcpy(buffer->data + offset, ptr, cb);
+	noEvent(event);
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clEnqueueWriteBufferRect(
@@ -581,6 +1591,27 @@ CL_API_ENTRY cl_int CL_API_CALL clEnqueueReadImage(
 	cl_event * event
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	cl_int error;
+	if (!isImage(image))
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	error = checkImageRegion(image, origin, region);
+	if (error != CL_SUCCESS || ptr == NULL)
+	{
+		return CL_INVALID_VALUE;
+	}
+	if (row_pitch == 0)
+	{
+		row_pitch = region[0] * image->elementSize;
+	}
+	if (slice_pitch == 0)
+	{
+		slice_pitch = row_pitch * region[1];
+	}
+	copyImageRegion(image, origin, region, (char *)ptr, row_pitch, slice_pitch, 0);
+	noEvent(event);
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clEnqueueWriteImage(
@@ -597,6 +1628,27 @@ CL_API_ENTRY cl_int CL_API_CALL clEnqueueWriteImage(
 	cl_event * event
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	cl_int error;
+	if (!isImage(image))
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	error = checkImageRegion(image, origin, region);
+	if (error != CL_SUCCESS || ptr == NULL)
+	{
+		return CL_INVALID_VALUE;
+	}
+	if (input_row_pitch == 0)
+	{
+		input_row_pitch = region[0] * image->elementSize;
+	}
+	if (input_slice_pitch == 0)
+	{
+		input_slice_pitch = input_row_pitch * region[1];
+	}
+	copyImageRegion(image, origin, region, (char *)ptr, input_row_pitch, input_slice_pitch, 1);
+	noEvent(event);
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyImage(
@@ -611,6 +1663,33 @@ CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyImage(
 	cl_event * event
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	char * staging;
+	size_t rowPitch;
+	if (!isImage(src_image) || !isImage(dst_image))
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	if (src_image->format.image_channel_order != dst_image->format.image_channel_order ||
+		src_image->format.image_channel_data_type != dst_image->format.image_channel_data_type)
+	{
+		return CL_IMAGE_FORMAT_MISMATCH;
+	}
+	if (checkImageRegion(src_image, src_origin, region) != CL_SUCCESS || checkImageRegion(dst_image, dst_origin, region) != CL_SUCCESS)
+	{
+		return CL_INVALID_VALUE;
+	}
+	/* Copying through a staging area handles tiled and linear images, and overlapping regions. */
+	rowPitch = region[0] * src_image->elementSize;
+	staging = (char *)malloc(rowPitch * region[1] * region[2]);
+	if (staging == NULL)
+	{
+		return CL_OUT_OF_HOST_MEMORY;
+	}
+	copyImageRegion(src_image, src_origin, region, staging, rowPitch, rowPitch * region[1], 0);
+	copyImageRegion(dst_image, dst_origin, region, staging, rowPitch, rowPitch * region[1], 1);
+	free(staging);
+	noEvent(event);
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyImageToBuffer(
@@ -625,6 +1704,23 @@ CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyImageToBuffer(
 	cl_event * event
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	size_t rowPitch;
+	if (!isImage(src_image) || dst_buffer == NULL || dst_buffer->type != CL_MEM_OBJECT_BUFFER)
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	if (checkImageRegion(src_image, src_origin, region) != CL_SUCCESS)
+	{
+		return CL_INVALID_VALUE;
+	}
+	rowPitch = region[0] * src_image->elementSize;
+	if (dst_offset > dst_buffer->size || rowPitch * region[1] * region[2] > dst_buffer->size - dst_offset)
+	{
+		return CL_INVALID_VALUE;
+	}
+	copyImageRegion(src_image, src_origin, region, dst_buffer->data + dst_offset, rowPitch, rowPitch * region[1], 0);
+	noEvent(event);
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyBufferToImage(
@@ -639,6 +1735,23 @@ CL_API_ENTRY cl_int CL_API_CALL clEnqueueCopyBufferToImage(
 	cl_event * event
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	size_t rowPitch;
+	if (src_buffer == NULL || src_buffer->type != CL_MEM_OBJECT_BUFFER || !isImage(dst_image))
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	if (checkImageRegion(dst_image, dst_origin, region) != CL_SUCCESS)
+	{
+		return CL_INVALID_VALUE;
+	}
+	rowPitch = region[0] * dst_image->elementSize;
+	if (src_offset > src_buffer->size || rowPitch * region[1] * region[2] > src_buffer->size - src_offset)
+	{
+		return CL_INVALID_VALUE;
+	}
+	copyImageRegion(dst_image, dst_origin, region, src_buffer->data + src_offset, rowPitch, rowPitch * region[1], 1);
+	noEvent(event);
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY void * CL_API_CALL clEnqueueMapBuffer(
@@ -654,6 +1767,20 @@ CL_API_ENTRY void * CL_API_CALL clEnqueueMapBuffer(
 	cl_int * errcode_ret
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	if (buffer == NULL || buffer->type != CL_MEM_OBJECT_BUFFER)
+	{
+		setError(errcode_ret, CL_INVALID_MEM_OBJECT);
+		return NULL;
+	}
+	if (offset > buffer->size || cb > buffer->size - offset)
+	{
+		setError(errcode_ret, CL_INVALID_VALUE);
+		return NULL;
+	}
+	buffer->mapCount++;
+	noEvent(event);
+	setError(errcode_ret, CL_SUCCESS);
+	return buffer->data + offset;
 }
 
 CL_API_ENTRY void * CL_API_CALL clEnqueueMapImage(
@@ -671,6 +1798,61 @@ CL_API_ENTRY void * CL_API_CALL clEnqueueMapImage(
 	cl_int * errcode_ret
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	StubMapping * mapping;
+	if (!isImage(image))
+	{
+		setError(errcode_ret, CL_INVALID_MEM_OBJECT);
+		return NULL;
+	}
+	if (checkImageRegion(image, origin, region) != CL_SUCCESS || image_row_pitch == NULL ||
+		(image->type == CL_MEM_OBJECT_IMAGE3D && image_slice_pitch == NULL))
+	{
+		setError(errcode_ret, CL_INVALID_VALUE);
+		return NULL;
+	}
+	mapping = (StubMapping *)calloc(1, sizeof(StubMapping));
+	if (mapping == NULL)
+	{
+		setError(errcode_ret, CL_OUT_OF_HOST_MEMORY);
+		return NULL;
+	}
+	mapping->flags = map_flags;
+	memcpy(mapping->origin, origin, sizeof(mapping->origin));
+	memcpy(mapping->region, region, sizeof(mapping->region));
+
+	if (image->tiled)
+	{
+		mapping->staged = 1;
+		mapping->rowPitch = region[0] * image->elementSize;
+		mapping->slicePitch = mapping->rowPitch * region[1];
+		mapping->pointer = (char *)malloc(mapping->slicePitch * region[2]);
+		if (mapping->pointer == NULL)
+		{
+			free(mapping);
+			setError(errcode_ret, CL_OUT_OF_HOST_MEMORY);
+			return NULL;
+		}
+		copyImageRegion(image, origin, region, mapping->pointer, mapping->rowPitch, mapping->slicePitch, 0);
+	}
+	else
+	{
+		mapping->rowPitch = image->rowPitch;
+		mapping->slicePitch = image->slicePitch;
+		mapping->pointer = imagePixel(image, origin[0], origin[1], origin[2]);
+	}
+
+	mapping->next = image->mappings;
+	image->mappings = mapping;
+	image->mapCount++;
+
+	*image_row_pitch = mapping->rowPitch;
+	if (image_slice_pitch != NULL)
+	{
+		*image_slice_pitch = image->type == CL_MEM_OBJECT_IMAGE3D ? mapping->slicePitch : 0;
+	}
+	noEvent(event);
+	setError(errcode_ret, CL_SUCCESS);
+	return mapping->pointer;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clEnqueueUnmapMemObject(
@@ -682,6 +1864,40 @@ CL_API_ENTRY cl_int CL_API_CALL clEnqueueUnmapMemObject(
 	cl_event * event
 ) CL_API_SUFFIX__VERSION_1_0
 {
+	StubMapping ** link;
+	StubMapping * mapping;
+	if (memobj == NULL)
+	{
+		return CL_INVALID_MEM_OBJECT;
+	}
+	if (memobj->mapCount == 0)
+	{
+		return CL_INVALID_VALUE;
+	}
+	if (isImage(memobj))
+	{
+		for (link = &memobj->mappings; *link != NULL && (*link)->pointer != mapped_ptr; link = &(*link)->next)
+		{
+		}
+		if (*link == NULL)
+		{
+			return CL_INVALID_VALUE;
+		}
+		mapping = *link;
+		*link = mapping->next;
+		if (mapping->staged)
+		{
+			if (mapping->flags & CL_MAP_WRITE)
+			{
+				copyImageRegion(memobj, mapping->origin, mapping->region, mapping->pointer, mapping->rowPitch, mapping->slicePitch, 1);
+			}
+			free(mapping->pointer);
+		}
+		free(mapping);
+	}
+	memobj->mapCount--;
+	noEvent(event);
+	return CL_SUCCESS;
 }
 
 CL_API_ENTRY cl_int CL_API_CALL clEnqueueNDRangeKernel(
@@ -0,0 +1,43 @@
+/*
+ * Copyright:
+ * ----------------------------------------------------------------------------
+ * This confidential and proprietary software may be used only as authorized
+ * by a licensing agreement from ARM Limited.
+ *      (C) COPYRIGHT 2013 ARM Limited, ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorized copies and
+ * copies may only be made to the extent permitted by a licensing agreement
+ * from ARM Limited.
+ * ----------------------------------------------------------------------------
+ */
+
+#ifndef OPENCL_STUBS_H
+#define OPENCL_STUBS_H
+
+#include <CL/cl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Entry points of the stub libOpenCL.so which are not part of OpenCL, for host-side tests.
+ * They are not in a real OpenCL library, so only call them from code which links against the stub.
+ */
+
+/*
+ * Sample an image on the host as read_imagef does in a kernel, with the addressing and filtering of a sampler
+ * (section 8.2 of the OpenCL 1.1 specification).
+ * coordinates holds x, y and, for 3D images, z; color receives (r, g, b, a).
+ * Integer formats can only be sampled with CL_FILTER_NEAREST, and give the integer channel values.
+ * The image is read as it is in the runtime,
+ * so writes to a mapped region of a tiled image are not seen until it is unmapped.
+ * Returns CL_SUCCESS, CL_INVALID_MEM_OBJECT, CL_INVALID_SAMPLER, CL_INVALID_VALUE, or CL_INVALID_OPERATION for linear filtering
+ * of an integer format.
+ */
+cl_int stubReadImagef(cl_mem image, cl_sampler sampler, const float * coordinates, float * color);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
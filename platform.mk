@@ -17,6 +17,9 @@ AR:=arm-linux-gnueabihf-ar
 #CC:=arm-none-linux-gnueabi-g++
 #AR=arm-none-linux-gnueabi-ar
 
+#Build machine compiler, for the tools which run during the build (tools/)
+HOSTCC:=g++
+
 # Test to see if the platform is Windows (it's Windows if the shell has the .exe extention).
 ifeq (.exe, $(suffix $(SHELL)))
 	RM:=del /f
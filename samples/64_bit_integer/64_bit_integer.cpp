@@ -10,6 +10,8 @@
 
 #include "common.h"
 #include "image.h"
+#include "reduction.h"
+#include "statistics.h"
 
 #include <CL/cl.h>
 #include <iostream>
@@ -17,16 +19,220 @@
 #include <sstream>
 #include <cstddef>
 #include <cmath>
+#include <vector>
 
 using namespace std;
 
+/**
+ * \brief Number of reductions run by the sample: moments, minimum and maximum.
+ */
+const int numberOfReductions = 3;
+
+/**
+ * \brief Release the reductions and the other OpenCL objects used by the sample.
+ * \param[in] context The OpenCL context to release.
+ * \param[in] commandQueue The OpenCL command queue to release.
+ * \param[in] reductions The numberOfReductions reductions to release.
+ * \param[in] memoryObjects An array of OpenCL memory objects to release.
+ * \param[in] numberOfMemoryObjects The number of memory objects in memoryObjects.
+ * \return False if an error occurred, otherwise true.
+ */
+bool cleanUpReductions(cl_context context, cl_command_queue commandQueue, Reduction* reductions, cl_mem* memoryObjects, int numberOfMemoryObjects)
+{
+    bool returnValue = true;
+    for (int index = 0; index < numberOfReductions; index++)
+    {
+        returnValue &= releaseReduction(&reductions[index]);
+    }
+    returnValue &= cleanUpOpenCL(context, commandQueue, 0, 0, memoryObjects, numberOfMemoryObjects);
+    return returnValue;
+}
+
+/**
+ * \brief Calculate the sum and sum of squares with the original long_vectors kernel, for comparison.
+ * \details long_vectors adds the results of every 8 pixels to two global accumulators with 64-bit atomics,
+ *          so all work-items contend for the same two addresses. Requires cl_khr_int64_base_atomics.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] device The OpenCL device to build the kernel for.
+ * \param[in] commandQueue The command queue to use.
+ * \param[in] imagePixels Buffer holding the luminance values.
+ * \param[in] count Number of values in imagePixels. Must be a multiple of 8.
+ * \param[out] sumOfPixels Sum of the values.
+ * \param[out] squareOfPixels Sum of the squares of the values.
+ * \return False if an error occurred, otherwise true.
+ */
+bool runAtomicBaseline(cl_context context, cl_device_id device, cl_command_queue commandQueue, cl_mem imagePixels, int count,
+                       cl_ulong* sumOfPixels, cl_ulong* squareOfPixels)
+{
+    cl_program program = 0;
+    cl_kernel kernel = 0;
+    const int numberOfMemoryObjects = 2;
+    const unsigned int squareIndex = 0;
+    const unsigned int sumIndex = 1;
+    cl_mem memoryObjects[numberOfMemoryObjects] = {0, 0};
+    cl_int errorNumber;
+
+    if (!createProgram(context, device, "assets/64_bit_integer.cl", &program))
+    {
+        cerr << "Failed to create OpenCL program." << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    kernel = clCreateKernel(program, "long_vectors", &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        cleanUpOpenCL(0, 0, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create OpenCL kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* The accumulators must start at zero. */
+    cl_ulong zero = 0;
+    bool createMemoryObjectsSuccess = true;
+    memoryObjects[squareIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(cl_ulong), &zero, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[sumIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(cl_ulong), &zero, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    if (!createMemoryObjectsSuccess)
+    {
+        cleanUpOpenCL(0, 0, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create OpenCL buffer. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 0, sizeof(cl_mem), &imagePixels));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 1, sizeof(cl_mem), &memoryObjects[squareIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 2, sizeof(cl_mem), &memoryObjects[sumIndex]));
+    if (!setKernelArgumentsSuccess)
+    {
+        cleanUpOpenCL(0, 0, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* Each instance of the kernel operates on a 8 * 1 portion of the image. */
+    cl_event event = 0;
+    size_t globalWorksize[1] = {(size_t)count / 8};
+    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernel, 1, NULL, globalWorksize, NULL, 0, NULL, &event)))
+    {
+        cleanUpOpenCL(0, 0, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed enqueuing the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    bool readResultsSuccess = true;
+    readResultsSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, memoryObjects[squareIndex], CL_TRUE, 0, sizeof(cl_ulong), squareOfPixels, 0, NULL, NULL));
+    readResultsSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, memoryObjects[sumIndex], CL_TRUE, 0, sizeof(cl_ulong), sumOfPixels, 0, NULL, NULL));
+
+    cout << "long_vectors (atomics): ";
+    printProfilingInfo(event);
+    clReleaseEvent(event);
+
+    cleanUpOpenCL(0, 0, program, kernel, memoryObjects, numberOfMemoryObjects);
+    if (!readResultsSuccess)
+    {
+        cerr << "Failed to read the results. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Calculate and print the statistics of the image, for the whole frame and for tiles.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] device The OpenCL device to build the kernels for.
+ * \param[in] commandQueue The command queue to use.
+ * \param[in] imagePixels Buffer holding the luminance values.
+ * \param[in] width Width of the image.
+ * \param[in] height Height of the image.
+ * \param[in] expectedSum Sum of the pixel values from the reduction, to check the frame statistics against.
+ * \return False if an error occurred, otherwise true.
+ */
+bool printImageStatistics(cl_context context, cl_device_id device, cl_command_queue commandQueue, cl_mem imagePixels, int width, int height, cl_ulong expectedSum)
+{
+    /* Percentiles used by exposure control: the dark and bright ends and the median. */
+    const int numberOfPercentiles = 3;
+    const float percentiles[numberOfPercentiles] = {0.05f, 0.5f, 0.95f};
+
+    /* Tiles for local exposure control, and the whole frame as a single tile. */
+    const int tileSize = 128;
+    const int numberOfTilings = 2;
+    const char* tilingNames[numberOfTilings] = {"Frame", "Tile"};
+    const int tileWidths[numberOfTilings] = {width, tileSize};
+    const int tileHeights[numberOfTilings] = {height, tileSize};
+
+    for (int tiling = 0; tiling < numberOfTilings; tiling++)
+    {
+        ImageStatistics statistics;
+        if (!createImageStatistics(context, device, width, height, tileWidths[tiling], tileHeights[tiling], percentiles, numberOfPercentiles, &statistics))
+        {
+            cerr << "Failed to create the image statistics. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+
+        cl_event events[2] = {0, 0};
+        vector<TileStatistics> tiles;
+        if (!enqueueImageStatistics(commandQueue, &statistics, imagePixels, events))
+        {
+            releaseImageStatistics(&statistics);
+            cerr << "Failed to calculate the image statistics. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+        if (!readImageStatistics(commandQueue, &statistics, tiles))
+        {
+            clReleaseEvent(events[0]);
+            clReleaseEvent(events[1]);
+            releaseImageStatistics(&statistics);
+            cerr << "Failed to calculate the image statistics. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+
+        cout << tilingNames[tiling] << " histogram pass: ";
+        printProfilingInfo(events[0]);
+        cout << tilingNames[tiling] << " statistics pass: ";
+        printProfilingInfo(events[1]);
+        clReleaseEvent(events[0]);
+        clReleaseEvent(events[1]);
+        releaseImageStatistics(&statistics);
+
+        /* [Print the statistics] */
+        for (size_t index = 0; index < tiles.size(); index++)
+        {
+            const TileStatistics& tile = tiles[index];
+            cout << tilingNames[tiling] << " (" << tile.x << ", " << tile.y << ") " << tile.width << "x" << tile.height
+                 << ": min = " << tile.moments.minimum << ", max = " << tile.moments.maximum
+                 << ", mean = " << tile.mean << ", stddev = " << tile.standardDeviation
+                 << ", percentiles (5%, 50%, 95%) = " << (int)tile.percentiles[0] << ", " << (int)tile.percentiles[1] << ", " << (int)tile.percentiles[2] << endl;
+        }
+        /* [Print the statistics] */
+
+        if (tiling == 0 && tiles[0].moments.sum != expectedSum)
+        {
+            cerr << "The histogram does not match the sum of the pixel values. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * \brief  Long data type (64-bit integer) OpenCL example.
  * \details An example to calculate, for an image:
  *          - the sum of the squares of the pixels values
- *          - sum of the pixels values.
- *          Makes use of the long data type and 64-bit atomics.
- *          The main calculation code is in an OpenCL kernel which is executed on a GPU device.
+ *          - sum of the pixels values
+ *          - the mean and variance which follow from them
+ *          - the smallest and largest pixel values.
+ *          Makes use of the long data type to accumulate the sums.
+ *          The sums are calculated by a hierarchical reduction (see reduction.h) instead of 64-bit atomics:
+ *          each work-item sums vectors of 8 pixels, each work-group sums its work-items in local memory,
+ *          and a final single work-group pass sums the results of the work-groups.
+ *          The sum and the sum of squares are calculated in the same pass.
+ *          Histograms, percentiles and the other statistics of the frame and of 128x128 tiles are then calculated by the
+ *          statistics module (see statistics.h).
+ *          Where cl_khr_int64_base_atomics is supported, the original long_vectors kernel, which uses 64-bit atomics,
+ *          is also run for comparison.
+ *          The main calculation code is in OpenCL kernels which are executed on a GPU device.
  * \return The exit code of the application, non-zero if a problem occurred.
  */
 int main(void)
@@ -35,54 +241,50 @@ int main(void)
 
     cl_context context = 0;
     cl_command_queue commandQueue = 0;
-    cl_program program = 0;
     cl_device_id device = 0;
-    cl_kernel kernel = 0;
-    const int numberOfMemoryObjects = 3;
+    const int numberOfMemoryObjects = 1;
     /* Index values for the memory objects. */
     const unsigned int imagePixelsIndex = 0;
-    const unsigned int squareIndex = 1;
-    const  unsigned int sumIndex = 2;
-    cl_mem memoryObjects[3] = {0, 0, 0};
+    cl_mem memoryObjects[numberOfMemoryObjects] = {0};
     cl_int errorNumber;
 
+    /* Index values for the reductions. */
+    const int momentsIndex = 0;
+    const int minimumIndex = 1;
+    const int maximumIndex = 2;
+    Reduction reductions[numberOfReductions] = {Reduction(), Reduction(), Reduction()};
+    const char* reductionNames[numberOfReductions] = {"Moments", "Minimum", "Maximum"};
 
     if (!createContext(&context))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create an OpenCL context. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
     if (!createCommandQueue(context, &commandQueue, &device))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create the OpenCL command queue. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
-    /* Checking 64-bit integer atomics extension support. */
-    if (!isExtensionSupported (device, "cl_khr_int64_base_atomics"))
-    {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "cl_khr_int64_base_atomics is not supported on this device. " << __FILE__ << ":"<< __LINE__ << endl;
-        return 1;
-    }
-
-    if (!createProgram(context, device, "assets/64_bit_integer.cl", &program))
-    {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed to create OpenCL program." << __FILE__ << ":"<< __LINE__ << endl;
-        return 1;
-    }
-
-    kernel = clCreateKernel(program, "long_vectors", &errorNumber);
-    if (!checkSuccess(errorNumber))
+    /* [Create the reductions] */
+    /*
+     * The sums of a large image do not fit in 32 bits, so they are accumulated in ulong.
+     * The minimum and maximum are pixel values, so they are accumulated in uchar.
+     */
+    bool createReductionsSuccess = true;
+    createReductionsSuccess &= createReduction(context, device, REDUCTION_MOMENTS, REDUCTION_TYPE_UCHAR, REDUCTION_TYPE_ULONG, &reductions[momentsIndex]);
+    createReductionsSuccess &= createReduction(context, device, REDUCTION_MIN, REDUCTION_TYPE_UCHAR, REDUCTION_TYPE_UCHAR, &reductions[minimumIndex]);
+    createReductionsSuccess &= createReduction(context, device, REDUCTION_MAX, REDUCTION_TYPE_UCHAR, REDUCTION_TYPE_UCHAR, &reductions[maximumIndex]);
+    if (!createReductionsSuccess)
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed to create OpenCL kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create the reductions. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
+    /* [Create the reductions] */
 
     /* Load 24-bits per pixel RGB data from a bitmap. */
     cl_int width;
@@ -90,15 +292,13 @@ int main(void)
     unsigned char* loadedRGBData = NULL;
     if (!loadFromBitmap(filename, &width, &height, &loadedRGBData))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed loading bitmap. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
     /* Buffer for the image pixels. */
     size_t bufferSizeChar = width * height * sizeof(unsigned char);
-    /* Buffer for the accumulators*/
-    size_t bufferSizeLong = sizeof(cl_ulong);
 
     /*
      * Ask the OpenCL implementation to allocate buffers for the data.
@@ -106,36 +306,21 @@ int main(void)
      * it on the CPU to avoid having to copy the data later.
      * The read/write flags relate to accesses to the memory from within the kernel.
      */
-    bool createMemoryObjectsSuccess = true;
-
     memoryObjects[imagePixelsIndex] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, bufferSizeChar, NULL, &errorNumber);
-    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
-
-    memoryObjects[squareIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE| CL_MEM_ALLOC_HOST_PTR, bufferSizeLong, NULL, &errorNumber);
-    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
-
-    memoryObjects[sumIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE| CL_MEM_ALLOC_HOST_PTR, bufferSizeLong, NULL, &errorNumber);
-    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
-
-    if (!createMemoryObjectsSuccess)
+    if (!checkSuccess(errorNumber))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        delete [] loadedRGBData;
+        cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create OpenCL buffer. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
-    /* Map the input memory objects to a host side pointers. */
-    bool mapMemoryObjectsSuccess = true;
+    /* Map the input memory object to a host side pointer. */
     cl_uchar* inputImagePixels = (cl_uchar*)clEnqueueMapBuffer(commandQueue, memoryObjects[imagePixelsIndex], CL_TRUE, CL_MAP_WRITE, 0, bufferSizeChar, 0, NULL, NULL, &errorNumber);
-    mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
-    cl_ulong* inputSquareOfPixels = (cl_ulong*)clEnqueueMapBuffer(commandQueue, memoryObjects[squareIndex], CL_TRUE, CL_MAP_WRITE, 0, bufferSizeLong, 0, NULL, NULL, &errorNumber);
-    mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
-    cl_ulong* inputSumOfPixels = (cl_ulong*)clEnqueueMapBuffer(commandQueue, memoryObjects[sumIndex], CL_TRUE, CL_MAP_WRITE, 0, bufferSizeLong, 0, NULL, NULL, &errorNumber);
-    mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
-
-    if (!mapMemoryObjectsSuccess)
+    if (!checkSuccess(errorNumber))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        delete [] loadedRGBData;
+        cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
         cerr << "Mapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
@@ -147,102 +332,117 @@ int main(void)
     RGBToLuminance(loadedRGBData, inputImagePixels, width, height);
     delete [] loadedRGBData;
 
-    /* Ensure the accumulators are initialized to zero. */
-    *inputSquareOfPixels = 0;
-    *inputSumOfPixels = 0;
-
     /* Unmap the memory so we can pass it to the kernel. */
-    bool unmapMemoryObjectsSuccess = true;
-    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[imagePixelsIndex], inputImagePixels, 0, NULL, NULL));
-    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[squareIndex], inputSquareOfPixels, 0, NULL, NULL));
-    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[sumIndex], inputSumOfPixels, 0, NULL, NULL));
-
-    if (!unmapMemoryObjectsSuccess)
+    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[imagePixelsIndex], inputImagePixels, 0, NULL, NULL)))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
         cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
-    /* Set the kernel arguments */
-    bool setKernelArgumentsSuccess = true;
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, imagePixelsIndex, sizeof(cl_mem), &memoryObjects[imagePixelsIndex]));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, squareIndex, sizeof(cl_mem), &memoryObjects[squareIndex]));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, sumIndex, sizeof(cl_mem), &memoryObjects[sumIndex]));
-
-    if (!setKernelArgumentsSuccess)
-    {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
-        return 1;
-    }
-
-    /* An event to associate with the Kernel. Allows us to retrieve profiling information later. */
-    cl_event event = 0;
-
     /*
-      * Each instance of the kernel operates on a 8 * 1 portion of the image.
-     * Therefore, the global work size must be 1.
+     * Enqueue all the reductions before waiting for any of them.
+     * Each one writes only to its own buffers, so no accumulators need to be cleared beforehand.
      */
-    size_t globalWorksize[1] = {(width * height) / 8};
-    int work_dim = 1;
-    /* Enqueue the kernel */
-    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernel, work_dim, NULL, globalWorksize, NULL, 0, NULL, &event)))
+    cl_event events[numberOfReductions][2];
+    for (int index = 0; index < numberOfReductions; index++)
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed enqueuing the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
-        return 1;
+        if (!enqueueReduction(commandQueue, &reductions[index], memoryObjects[imagePixelsIndex], width * height, events[index]))
+        {
+            for (int enqueued = 0; enqueued < index; enqueued++)
+            {
+                clReleaseEvent(events[enqueued][0]);
+                clReleaseEvent(events[enqueued][1]);
+            }
+            cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
+            cerr << "Failed enqueuing the reduction. " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
     }
 
     /* Wait for kernel execution completion. */
     if (!checkSuccess(clFinish(commandQueue)))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        for (int index = 0; index < numberOfReductions; index++)
+        {
+            clReleaseEvent(events[index][0]);
+            clReleaseEvent(events[index][1]);
+        }
+        cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed waiting for kernel execution to finish. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
-    /* Print the profiling information for the event. */
-    printProfilingInfo(event);
-    /* Release the event object. */
-    if (!checkSuccess(clReleaseEvent(event)))
+    /* Print the profiling information for the events. */
+    for (int index = 0; index < numberOfReductions; index++)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-       cerr << "Failed releasing the event object. " << __FILE__ << ":"<< __LINE__ << endl;
-       return 1;
+        cout << reductionNames[index] << " partial pass: ";
+        printProfilingInfo(events[index][0]);
+        cout << reductionNames[index] << " final pass: ";
+        printProfilingInfo(events[index][1]);
+
+        /* Release the event objects. */
+        if (!checkSuccess(clReleaseEvent(events[index][0])) || !checkSuccess(clReleaseEvent(events[index][1])))
+        {
+           cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
+           cerr << "Failed releasing the event object. " << __FILE__ << ":"<< __LINE__ << endl;
+           return 1;
+        }
     }
 
-    /* Get pointers to the output data. */
-    mapMemoryObjectsSuccess = true;
-    cl_ulong* squareOfPixels = (cl_ulong*)clEnqueueMapBuffer(commandQueue, memoryObjects[squareIndex], CL_TRUE, CL_MAP_READ, 0, bufferSizeLong, 0, NULL, NULL, &errorNumber);
-    mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
-
-    cl_ulong* sumOfPixels = (cl_ulong*)clEnqueueMapBuffer(commandQueue, memoryObjects[sumIndex], CL_TRUE, CL_MAP_READ, 0, bufferSizeLong, 0, NULL, NULL, &errorNumber);
-    mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
-    if (!mapMemoryObjectsSuccess)
+    /* Get the results. REDUCTION_MOMENTS returns the sum followed by the sum of squares. */
+    cl_ulong moments[2] = {0, 0};
+    cl_uchar minimum = 0;
+    cl_uchar maximum = 0;
+    bool readResultsSuccess = true;
+    readResultsSuccess &= readReductionResult(commandQueue, &reductions[momentsIndex], moments);
+    readResultsSuccess &= readReductionResult(commandQueue, &reductions[minimumIndex], &minimum);
+    readResultsSuccess &= readReductionResult(commandQueue, &reductions[maximumIndex], &maximum);
+    if (!readResultsSuccess)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-       cerr << "Failed to map buffer. " << __FILE__ << ":"<< __LINE__ << endl;
+       cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
+       cerr << "Failed to read the results. " << __FILE__ << ":"<< __LINE__ << endl;
        return 1;
     }
 
+    const cl_ulong sumOfPixels = moments[0];
+    const cl_ulong squareOfPixels = moments[1];
+    const double pixelCount = (double)width * height;
+    const double mean = sumOfPixels / pixelCount;
+    const double variance = squareOfPixels / pixelCount - mean * mean;
+
     /* [Output the results] */
-    cout << "Square of the pixel values = " <<  *squareOfPixels << "\n";
-    cout << "Sum of the pixel values = " <<  *sumOfPixels << endl;
+    cout << "Square of the pixel values = " <<  squareOfPixels << "\n";
+    cout << "Sum of the pixel values = " <<  sumOfPixels << endl;
+    cout << "Mean = " << mean << ", variance = " << variance << endl;
+    cout << "Minimum = " << (int)minimum << ", maximum = " << (int)maximum << endl;
     /* [Output the results] */
 
-    /* Unmap the memory object as we are finished using them from the CPU side. */
-    unmapMemoryObjectsSuccess = true;
-    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[squareIndex], squareOfPixels, 0, NULL, NULL));
-    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[sumIndex], sumOfPixels, 0, NULL, NULL));
+    if (!printImageStatistics(context, device, commandQueue, memoryObjects[imagePixelsIndex], width, height, sumOfPixels))
+    {
+        cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to calculate the image statistics. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
 
-    if (!unmapMemoryObjectsSuccess)
+    /* [Atomic baseline] */
+    if (isExtensionSupported(device, "cl_khr_int64_base_atomics") && (width * height) % 8 == 0)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-       cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
-       return 1;
+        cl_ulong atomicSumOfPixels = 0;
+        cl_ulong atomicSquareOfPixels = 0;
+        if (!runAtomicBaseline(context, device, commandQueue, memoryObjects[imagePixelsIndex], width * height, &atomicSumOfPixels, &atomicSquareOfPixels))
+        {
+            cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
+            cerr << "Failed to run the atomic baseline. " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
+        const bool match = (atomicSumOfPixels == sumOfPixels && atomicSquareOfPixels == squareOfPixels);
+        cout << "Atomic results " << (match ? "match" : "do not match") << " the reduction." << endl;
     }
+    /* [Atomic baseline] */
 
     /* Release OpenCL objects. */
-    cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+    cleanUpReductions(context, commandQueue, reductions, memoryObjects, numberOfMemoryObjects);
+
+    return 0;
 }
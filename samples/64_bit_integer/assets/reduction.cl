@@ -0,0 +1,206 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+/*
+ * Hierarchical reduction kernels.
+ * The operation and the types are chosen when the program is built (see createReduction in reduction.cpp):
+ * - REDUCTION_OPERATION: one of the operations below.
+ * - INPUT_TYPE: scalar type of the input array, for example uchar.
+ * - REDUCTION_TYPE: scalar type the values are accumulated in, for example ulong.
+ * - REDUCTION_IDENTITY: value which does not change the result, for example 0 for a sum or ULONG_MAX for a minimum.
+ */
+
+/* [Operations] */
+/* Must match ReductionOperation in reduction.h. */
+#define REDUCTION_SUM 0
+#define REDUCTION_SUM_OF_SQUARES 1
+#define REDUCTION_MIN 2
+#define REDUCTION_MAX 3
+#define REDUCTION_MOMENTS 4
+/* [Operations] */
+
+#define CONCATENATE_EXPANDED(a, b) a##b
+#define CONCATENATE(a, b) CONCATENATE_EXPANDED(a, b)
+
+/* Vector versions of the types. */
+#define INPUT_TYPE8 CONCATENATE(INPUT_TYPE, 8)
+#define REDUCTION_TYPE2 CONCATENATE(REDUCTION_TYPE, 2)
+#define REDUCTION_TYPE4 CONCATENATE(REDUCTION_TYPE, 4)
+#define REDUCTION_TYPE8 CONCATENATE(REDUCTION_TYPE, 8)
+#define CONVERT_REDUCTION_TYPE8 CONCATENATE(convert_, REDUCTION_TYPE8)
+
+/* [Sum operations] */
+/**
+ * \brief Add the 8 components of a vector together.
+ * \details Uses the vector data type suffixes (.lo and .hi) to get smaller vector types, until there is one value.
+ * \param[in] values The vector to sum.
+ * \return The sum of the components.
+ */
+REDUCTION_TYPE horizontalSum(REDUCTION_TYPE8 values)
+{
+    REDUCTION_TYPE4 sum4 = values.lo + values.hi;
+    REDUCTION_TYPE2 sum2 = sum4.lo + sum4.hi;
+    return sum2.lo + sum2.hi;
+}
+/* [Sum operations] */
+
+/**
+ * \brief Find the smallest of the 8 components of a vector.
+ * \param[in] values The vector to search.
+ * \return The smallest component.
+ */
+REDUCTION_TYPE horizontalMin(REDUCTION_TYPE8 values)
+{
+    REDUCTION_TYPE4 min4 = min(values.lo, values.hi);
+    REDUCTION_TYPE2 min2 = min(min4.lo, min4.hi);
+    return min(min2.lo, min2.hi);
+}
+
+/**
+ * \brief Find the largest of the 8 components of a vector.
+ * \param[in] values The vector to search.
+ * \return The largest component.
+ */
+REDUCTION_TYPE horizontalMax(REDUCTION_TYPE8 values)
+{
+    REDUCTION_TYPE4 max4 = max(values.lo, values.hi);
+    REDUCTION_TYPE2 max2 = max(max4.lo, max4.hi);
+    return max(max2.lo, max2.hi);
+}
+
+/*
+ * For each operation:
+ * - ACCUMULATOR is the type of the partial results.
+ * - MAP(x) converts one input value (already converted to REDUCTION_TYPE) to an accumulator.
+ * - MAP8(x) converts 8 input values to a single accumulator.
+ * - COMBINE(a, b) combines two accumulators. It must be associative, as the order of the reduction is not defined.
+ * The moments operation accumulates the sum and the sum of squares in the same pass, from which the mean and variance follow.
+ */
+#if REDUCTION_OPERATION == REDUCTION_SUM
+    #define ACCUMULATOR REDUCTION_TYPE
+    #define MAP(x) (x)
+    #define MAP8(x) horizontalSum(x)
+    #define COMBINE(a, b) ((a) + (b))
+#elif REDUCTION_OPERATION == REDUCTION_SUM_OF_SQUARES
+    #define ACCUMULATOR REDUCTION_TYPE
+    #define MAP(x) ((x) * (x))
+    #define MAP8(x) horizontalSum((x) * (x))
+    #define COMBINE(a, b) ((a) + (b))
+#elif REDUCTION_OPERATION == REDUCTION_MIN
+    #define ACCUMULATOR REDUCTION_TYPE
+    #define MAP(x) (x)
+    #define MAP8(x) horizontalMin(x)
+    #define COMBINE(a, b) min(a, b)
+#elif REDUCTION_OPERATION == REDUCTION_MAX
+    #define ACCUMULATOR REDUCTION_TYPE
+    #define MAP(x) (x)
+    #define MAP8(x) horizontalMax(x)
+    #define COMBINE(a, b) max(a, b)
+#elif REDUCTION_OPERATION == REDUCTION_MOMENTS
+    #define ACCUMULATOR REDUCTION_TYPE2
+    #define MAP(x) ((REDUCTION_TYPE2)((x), (x) * (x)))
+    #define MAP8(x) ((REDUCTION_TYPE2)(horizontalSum(x), horizontalSum((x) * (x))))
+    #define COMBINE(a, b) ((a) + (b))
+#else
+    #error "REDUCTION_OPERATION must be defined as one of the operations in reduction.cl."
+#endif
+
+#define IDENTITY ((ACCUMULATOR)(REDUCTION_IDENTITY))
+
+/**
+ * \brief Reduce the values held by the work-items of a work-group in local memory.
+ * \details The work-group size must be a power of 2. Halves the number of active work-items each step.
+ * \param[in] value The value of this work-item.
+ * \param[in] scratch Local memory for one accumulator per work-item.
+ * \return The result of the work-group. Only valid in work-item 0.
+ */
+ACCUMULATOR reduceWorkGroup(ACCUMULATOR value, __local ACCUMULATOR* scratch)
+{
+    const int localId = get_local_id(0);
+    scratch[localId] = value;
+
+    for (int offset = get_local_size(0) / 2; offset > 0; offset /= 2)
+    {
+        barrier(CLK_LOCAL_MEM_FENCE);
+        if (localId < offset)
+        {
+            scratch[localId] = COMBINE(scratch[localId], scratch[localId + offset]);
+        }
+    }
+    return scratch[0];
+}
+
+/**
+ * \brief First pass of the reduction.
+ * \details Every work-item reduces 8 values at a time from the input, striding over the whole array,
+ *          so any size of input is handled by a fixed number of work-groups. The work-group then reduces
+ *          its values in local memory and writes one partial result. Nothing is written to global memory
+ *          by more than one work-item, so no atomics are needed.
+ * \param[in] input Array to reduce.
+ * \param[in] count Number of values in input.
+ * \param[out] partials One partial result per work-group.
+ * \param[in] scratch Local memory for one accumulator per work-item.
+ */
+__kernel void reduce_partial(__global const INPUT_TYPE* restrict input,
+                             const int count,
+                             __global ACCUMULATOR* restrict partials,
+                             __local ACCUMULATOR* restrict scratch)
+{
+    const int globalId = get_global_id(0);
+    const int globalSize = get_global_size(0);
+
+    /* [Vector loop] */
+    ACCUMULATOR value = IDENTITY;
+    const int vectorCount = count / 8;
+    for (int index = globalId; index < vectorCount; index += globalSize)
+    {
+        REDUCTION_TYPE8 values = CONVERT_REDUCTION_TYPE8(vload8(index, input));
+        value = COMBINE(value, MAP8(values));
+    }
+    /* [Vector loop] */
+
+    /* The values after the last whole vector. */
+    for (int index = vectorCount * 8 + globalId; index < count; index += globalSize)
+    {
+        value = COMBINE(value, MAP((REDUCTION_TYPE)input[index]));
+    }
+
+    value = reduceWorkGroup(value, scratch);
+    if (get_local_id(0) == 0)
+    {
+        partials[get_group_id(0)] = value;
+    }
+}
+
+/**
+ * \brief Final pass of the reduction.
+ * \details Must be run as a single work-group. Combines the partial results of reduce_partial into one result.
+ * \param[in] partials Partial results from reduce_partial.
+ * \param[in] count Number of partial results.
+ * \param[out] result The result of the reduction.
+ * \param[in] scratch Local memory for one accumulator per work-item.
+ */
+__kernel void reduce_final(__global const ACCUMULATOR* restrict partials,
+                           const int count,
+                           __global ACCUMULATOR* restrict result,
+                           __local ACCUMULATOR* restrict scratch)
+{
+    ACCUMULATOR value = IDENTITY;
+    for (int index = get_local_id(0); index < count; index += get_local_size(0))
+    {
+        value = COMBINE(value, partials[index]);
+    }
+
+    value = reduceWorkGroup(value, scratch);
+    if (get_local_id(0) == 0)
+    {
+        *result = value;
+    }
+}
@@ -0,0 +1,185 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+/* Number of bins in a histogram of 8-bit luminance. */
+#define HISTOGRAM_BINS 256
+
+/*
+ * Number of copies of the histogram each work-group keeps in local memory.
+ * Work-items update the copy selected by their local ID, so neighbouring work-items which read similar values
+ * do not all contend for the same local atomic.
+ */
+#define SUB_HISTOGRAMS 4
+
+/**
+ * \brief Statistics of one tile which follow from its histogram. Must match TileMoments in statistics.h.
+ */
+typedef struct
+{
+    ulong sum;
+    ulong sumOfSquares;
+    uint count;
+    uint minimum;
+    uint maximum;
+    uint padding;
+} TileMoments;
+
+/**
+ * \brief Histogram kernel function.
+ * \details The image is divided into tiles of tileWidth x tileHeight pixels (clipped at the right and bottom edges),
+ *          and each tile into slicesPerTile slices. Each work-group histograms one slice of one tile into
+ *          privatized local memory sub-histograms, merges them and writes the result as a partial histogram.
+ *          No global atomics are used and every pixel is read exactly once.
+ * \param[in] luminance Input image, one byte per pixel.
+ * \param[in] width Width of the image.
+ * \param[in] height Height of the image.
+ * \param[in] tileWidth Width of the tiles.
+ * \param[in] tileHeight Height of the tiles.
+ * \param[in] slicesPerTile Number of work-groups which share each tile.
+ * \param[out] partialHistograms HISTOGRAM_BINS counts for every slice of every tile.
+ */
+__kernel void histogram_tiles(__global const uchar* restrict luminance,
+                              const int width,
+                              const int height,
+                              const int tileWidth,
+                              const int tileHeight,
+                              const int slicesPerTile,
+                              __global uint* restrict partialHistograms)
+{
+    __local uint subHistograms[SUB_HISTOGRAMS * HISTOGRAM_BINS];
+
+    const int localId = get_local_id(0);
+    const int localSize = get_local_size(0);
+    const int group = get_group_id(0);
+    const int tile = group / slicesPerTile;
+    const int slice = group % slicesPerTile;
+
+    const int tilesPerRow = (width + tileWidth - 1) / tileWidth;
+    const int tileX = (tile % tilesPerRow) * tileWidth;
+    const int tileY = (tile / tilesPerRow) * tileHeight;
+    const int clippedWidth = min(tileWidth, width - tileX);
+    const int clippedHeight = min(tileHeight, height - tileY);
+
+    for (int index = localId; index < SUB_HISTOGRAMS * HISTOGRAM_BINS; index += localSize)
+    {
+        subHistograms[index] = 0;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    /* [Privatized histogram] */
+    __local uint* subHistogram = subHistograms + (localId % SUB_HISTOGRAMS) * HISTOGRAM_BINS;
+    const int tilePixels = clippedWidth * clippedHeight;
+    for (int index = slice * localSize + localId; index < tilePixels; index += slicesPerTile * localSize)
+    {
+        const int x = tileX + index % clippedWidth;
+        const int y = tileY + index / clippedWidth;
+        atomic_inc(&subHistogram[luminance[x + y * width]]);
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+    /* [Privatized histogram] */
+
+    /* Merge the sub-histograms and write this work-group's partial histogram. */
+    for (int bin = localId; bin < HISTOGRAM_BINS; bin += localSize)
+    {
+        uint count = 0;
+        for (int copy = 0; copy < SUB_HISTOGRAMS; copy++)
+        {
+            count += subHistograms[copy * HISTOGRAM_BINS + bin];
+        }
+        partialHistograms[group * HISTOGRAM_BINS + bin] = count;
+    }
+}
+
+/**
+ * \brief Histogram merge and statistics kernel function.
+ * \details Each work-group handles one tile. The partial histograms of its slices are added together,
+ *          then the count, minimum, maximum, sum, sum of squares and the requested percentiles are read
+ *          from the histogram. For 8-bit data these are exact, so the image is not read again.
+ * \param[in] partialHistograms Output of histogram_tiles.
+ * \param[in] slicesPerTile Number of partial histograms per tile.
+ * \param[out] histograms HISTOGRAM_BINS counts for every tile.
+ * \param[out] moments A TileMoments for every tile.
+ * \param[in] percentiles Fractions of the pixels (0 to 1) to find the percentile values for.
+ * \param[in] numberOfPercentiles Number of values in percentiles.
+ * \param[out] percentileValues numberOfPercentiles values for every tile: the smallest luminance at or below which
+ *                              at least that fraction of the pixels of the tile lie.
+ */
+__kernel void histogram_statistics(__global const uint* restrict partialHistograms,
+                                   const int slicesPerTile,
+                                   __global uint* restrict histograms,
+                                   __global TileMoments* restrict moments,
+                                   __global const float* restrict percentiles,
+                                   const int numberOfPercentiles,
+                                   __global uchar* restrict percentileValues)
+{
+    __local uint histogram[HISTOGRAM_BINS];
+
+    const int localId = get_local_id(0);
+    const int tile = get_group_id(0);
+
+    for (int bin = localId; bin < HISTOGRAM_BINS; bin += get_local_size(0))
+    {
+        uint count = 0;
+        for (int slice = 0; slice < slicesPerTile; slice++)
+        {
+            count += partialHistograms[(tile * slicesPerTile + slice) * HISTOGRAM_BINS + bin];
+        }
+        histogram[bin] = count;
+        histograms[tile * HISTOGRAM_BINS + bin] = count;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    /* A single pass over 256 bins is cheap compared with the histogram, so one work-item calculates the statistics. */
+    if (localId != 0)
+    {
+        return;
+    }
+
+    TileMoments result;
+    result.sum = 0;
+    result.sumOfSquares = 0;
+    result.count = 0;
+    result.minimum = HISTOGRAM_BINS - 1;
+    result.maximum = 0;
+    result.padding = 0;
+    for (int bin = 0; bin < HISTOGRAM_BINS; bin++)
+    {
+        const uint count = histogram[bin];
+        if (count != 0)
+        {
+            result.minimum = min(result.minimum, (uint)bin);
+            result.maximum = (uint)bin;
+        }
+        result.count += count;
+        result.sum += (ulong)count * bin;
+        result.sumOfSquares += (ulong)count * (bin * bin);
+    }
+    moments[tile] = result;
+
+    /* [Percentiles] */
+    for (int index = 0; index < numberOfPercentiles; index++)
+    {
+        /* The rank of the pixel at the percentile, at least the first pixel. */
+        const uint rank = max((uint)1, (uint)ceil(percentiles[index] * result.count));
+        uint cumulative = 0;
+        int bin = 0;
+        while (bin < HISTOGRAM_BINS - 1)
+        {
+            cumulative += histogram[bin];
+            if (cumulative >= rank)
+            {
+                break;
+            }
+            bin++;
+        }
+        percentileValues[tile * numberOfPercentiles + index] = (uchar)bin;
+    }
+    /* [Percentiles] */
+}
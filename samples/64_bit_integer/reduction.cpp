@@ -0,0 +1,272 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "reduction.h"
+#include "common.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+/*
+ * Work-groups of reduce_partial. Each work-item strides over the input, so this only needs to be enough to fill the device;
+ * it also bounds the work done by the single work-group of reduce_final.
+ */
+static const size_t maximumNumberOfWorkGroups = 256;
+
+/* Largest work-group size used by the reduction kernels. */
+static const size_t maximumWorkGroupSize = 256;
+
+/**
+ * \brief OpenCL C name of a reduction type.
+ * \param[in] type The type.
+ * \return The name of the type.
+ */
+static const char* reductionTypeName(ReductionType type)
+{
+    switch (type)
+    {
+        case REDUCTION_TYPE_UCHAR: return "uchar";
+        case REDUCTION_TYPE_INT: return "int";
+        case REDUCTION_TYPE_UINT: return "uint";
+        case REDUCTION_TYPE_LONG: return "long";
+        case REDUCTION_TYPE_ULONG: return "ulong";
+        default: return "float";
+    }
+}
+
+/**
+ * \brief Size of a reduction type in bytes.
+ * \param[in] type The type.
+ * \return The size of the type.
+ */
+static size_t reductionTypeSize(ReductionType type)
+{
+    switch (type)
+    {
+        case REDUCTION_TYPE_UCHAR: return sizeof(cl_uchar);
+        case REDUCTION_TYPE_INT: return sizeof(cl_int);
+        case REDUCTION_TYPE_UINT: return sizeof(cl_uint);
+        case REDUCTION_TYPE_LONG: return sizeof(cl_long);
+        case REDUCTION_TYPE_ULONG: return sizeof(cl_ulong);
+        default: return sizeof(cl_float);
+    }
+}
+
+/**
+ * \brief Value of a type which does not change the result of an operation, as an OpenCL C expression.
+ * \param[in] operation The operation.
+ * \param[in] type The accumulator type.
+ * \return The identity value.
+ */
+static const char* reductionIdentity(ReductionOperation operation, ReductionType type)
+{
+    if (operation == REDUCTION_MIN)
+    {
+        switch (type)
+        {
+            case REDUCTION_TYPE_UCHAR: return "UCHAR_MAX";
+            case REDUCTION_TYPE_INT: return "INT_MAX";
+            case REDUCTION_TYPE_UINT: return "UINT_MAX";
+            case REDUCTION_TYPE_LONG: return "LONG_MAX";
+            case REDUCTION_TYPE_ULONG: return "ULONG_MAX";
+            default: return "INFINITY";
+        }
+    }
+    if (operation == REDUCTION_MAX)
+    {
+        switch (type)
+        {
+            case REDUCTION_TYPE_INT: return "INT_MIN";
+            case REDUCTION_TYPE_LONG: return "LONG_MIN";
+            case REDUCTION_TYPE_FLOAT: return "(-INFINITY)";
+            default: return "0";
+        }
+    }
+    return "0";
+}
+
+bool releaseReduction(Reduction* reduction)
+{
+    bool returnValue = true;
+    if (reduction->partialKernel != 0)
+    {
+        returnValue &= checkSuccess(clReleaseKernel(reduction->partialKernel));
+        reduction->partialKernel = 0;
+    }
+    if (reduction->finalKernel != 0)
+    {
+        returnValue &= checkSuccess(clReleaseKernel(reduction->finalKernel));
+        reduction->finalKernel = 0;
+    }
+    if (reduction->program != 0)
+    {
+        returnValue &= checkSuccess(clReleaseProgram(reduction->program));
+        reduction->program = 0;
+    }
+    if (reduction->partials != 0)
+    {
+        returnValue &= checkSuccess(clReleaseMemObject(reduction->partials));
+        reduction->partials = 0;
+    }
+    if (reduction->result != 0)
+    {
+        returnValue &= checkSuccess(clReleaseMemObject(reduction->result));
+        reduction->result = 0;
+    }
+    return returnValue;
+}
+
+bool createReduction(cl_context context, cl_device_id device, ReductionOperation operation, ReductionType inputType, ReductionType accumulatorType, Reduction* reduction)
+{
+    cl_int errorNumber = 0;
+
+    reduction->program = 0;
+    reduction->partialKernel = 0;
+    reduction->finalKernel = 0;
+    reduction->partials = 0;
+    reduction->result = 0;
+
+    /* [Build options] */
+    ostringstream buildOptions;
+    buildOptions << "-DREDUCTION_OPERATION=" << operation
+                 << " -DINPUT_TYPE=" << reductionTypeName(inputType)
+                 << " -DREDUCTION_TYPE=" << reductionTypeName(accumulatorType)
+                 << " -DREDUCTION_IDENTITY=" << reductionIdentity(operation, accumulatorType);
+    /* [Build options] */
+
+    if (!createProgram(context, device, "assets/reduction.cl", &reduction->program, buildOptions.str()))
+    {
+        reduction->program = 0;
+        cerr << "Failed to create the reduction program. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    reduction->partialKernel = clCreateKernel(reduction->program, "reduce_partial", &errorNumber);
+    bool createKernelsSuccess = checkSuccess(errorNumber);
+    reduction->finalKernel = clCreateKernel(reduction->program, "reduce_final", &errorNumber);
+    createKernelsSuccess &= checkSuccess(errorNumber);
+    if (!createKernelsSuccess)
+    {
+        releaseReduction(reduction);
+        cerr << "Failed to create the reduction kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* The local memory reduction halves the number of work-items each step, so the work-group size must be a power of 2. */
+    size_t partialWorkGroupSize = 0;
+    size_t finalWorkGroupSize = 0;
+    bool queryInfoSuccess = true;
+    queryInfoSuccess &= checkSuccess(clGetKernelWorkGroupInfo(reduction->partialKernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &partialWorkGroupSize, NULL));
+    queryInfoSuccess &= checkSuccess(clGetKernelWorkGroupInfo(reduction->finalKernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &finalWorkGroupSize, NULL));
+    if (!queryInfoSuccess)
+    {
+        releaseReduction(reduction);
+        cerr << "Failed to query the reduction work-group size. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    reduction->workGroupSize = 1;
+    while (reduction->workGroupSize * 2 <= maximumWorkGroupSize &&
+           reduction->workGroupSize * 2 <= partialWorkGroupSize &&
+           reduction->workGroupSize * 2 <= finalWorkGroupSize)
+    {
+        reduction->workGroupSize *= 2;
+    }
+    reduction->numberOfWorkGroups = maximumNumberOfWorkGroups;
+
+    const size_t accumulatorSize = reductionTypeSize(accumulatorType) * (operation == REDUCTION_MOMENTS ? 2 : 1);
+    reduction->resultSize = accumulatorSize;
+
+    bool createMemoryObjectsSuccess = true;
+    reduction->partials = clCreateBuffer(context, CL_MEM_READ_WRITE, maximumNumberOfWorkGroups * accumulatorSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    reduction->result = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, accumulatorSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+
+    if (!createMemoryObjectsSuccess)
+    {
+        releaseReduction(reduction);
+        cerr << "Failed to create the reduction buffers. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* Only the input and count change between runs, so the other arguments are set once. */
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(reduction->partialKernel, 2, sizeof(cl_mem), &reduction->partials));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(reduction->partialKernel, 3, reduction->workGroupSize * accumulatorSize, NULL));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(reduction->finalKernel, 0, sizeof(cl_mem), &reduction->partials));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(reduction->finalKernel, 2, sizeof(cl_mem), &reduction->result));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(reduction->finalKernel, 3, reduction->workGroupSize * accumulatorSize, NULL));
+    if (!setKernelArgumentsSuccess)
+    {
+        releaseReduction(reduction);
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool enqueueReduction(cl_command_queue commandQueue, Reduction* reduction, cl_mem input, cl_int count, cl_event events[2])
+{
+    /* Small inputs do not need every work-group: each work-item should have at least one vector of 8 values. */
+    size_t workGroups = (count / 8 + reduction->workGroupSize - 1) / reduction->workGroupSize;
+    if (workGroups < 1)
+    {
+        workGroups = 1;
+    }
+    if (workGroups > reduction->numberOfWorkGroups)
+    {
+        workGroups = reduction->numberOfWorkGroups;
+    }
+    const cl_int numberOfPartials = workGroups;
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(reduction->partialKernel, 0, sizeof(cl_mem), &input));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(reduction->partialKernel, 1, sizeof(cl_int), &count));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(reduction->finalKernel, 1, sizeof(cl_int), &numberOfPartials));
+    if (!setKernelArgumentsSuccess)
+    {
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* [Enqueue the passes] */
+    size_t partialGlobalWorksize[1] = {workGroups * reduction->workGroupSize};
+    size_t localWorksize[1] = {reduction->workGroupSize};
+    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, reduction->partialKernel, 1, NULL, partialGlobalWorksize, localWorksize, 0, NULL, &events[0])))
+    {
+        cerr << "Failed enqueuing the reduction kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, reduction->finalKernel, 1, NULL, localWorksize, localWorksize, 1, &events[0], &events[1])))
+    {
+        /* The caller only releases the events of passes which were all enqueued. */
+        clReleaseEvent(events[0]);
+        events[0] = 0;
+        cerr << "Failed enqueuing the reduction kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    /* [Enqueue the passes] */
+
+    return true;
+}
+
+bool readReductionResult(cl_command_queue commandQueue, const Reduction* reduction, void* result)
+{
+    if (!checkSuccess(clEnqueueReadBuffer(commandQueue, reduction->result, CL_TRUE, 0, reduction->resultSize, result, 0, NULL, NULL)))
+    {
+        cerr << "Failed reading the reduction result. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return true;
+}
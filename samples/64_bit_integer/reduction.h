@@ -0,0 +1,104 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include <CL/cl.h>
+
+/**
+ * \file reduction.h
+ * \brief Hierarchical reductions (sum, sum of squares, minimum, maximum and moments) of OpenCL buffers.
+ */
+
+/**
+ * \brief Operations supported by the reduction kernels in assets/reduction.cl.
+ */
+enum ReductionOperation
+{
+    REDUCTION_SUM = 0, /**< \brief Sum of the values. */
+    REDUCTION_SUM_OF_SQUARES = 1, /**< \brief Sum of the squares of the values. */
+    REDUCTION_MIN = 2, /**< \brief Smallest value. */
+    REDUCTION_MAX = 3, /**< \brief Largest value. */
+    REDUCTION_MOMENTS = 4 /**< \brief Sum and sum of squares together, in that order, for the mean and variance. */
+};
+
+/**
+ * \brief Scalar types for the input and the accumulators of a reduction.
+ */
+enum ReductionType
+{
+    REDUCTION_TYPE_UCHAR,
+    REDUCTION_TYPE_INT,
+    REDUCTION_TYPE_UINT,
+    REDUCTION_TYPE_LONG,
+    REDUCTION_TYPE_ULONG,
+    REDUCTION_TYPE_FLOAT
+};
+
+/**
+ * \brief A reduction of one operation and type, built and ready to be enqueued.
+ */
+struct Reduction
+{
+    cl_program program; /**< \brief assets/reduction.cl built for the operation and types. */
+    cl_kernel partialKernel; /**< \brief The reduce_partial kernel. */
+    cl_kernel finalKernel; /**< \brief The reduce_final kernel. */
+    cl_mem partials; /**< \brief One partial result per work-group of reduce_partial. */
+    cl_mem result; /**< \brief The result of reduce_final. */
+    size_t workGroupSize; /**< \brief Work-group size of both kernels, a power of 2. */
+    size_t numberOfWorkGroups; /**< \brief Number of work-groups of reduce_partial. */
+    size_t resultSize; /**< \brief Size of the result in bytes. */
+};
+
+/**
+ * \brief Build the reduction kernels for an operation and pair of types.
+ * \details The operation and types are compiled into the program, so every combination is a separate program.
+ *          Create each reduction once and enqueue it as often as needed.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] device The OpenCL device to build the kernels for.
+ * \param[in] operation The operation to perform.
+ * \param[in] inputType Type of the values in the input buffer.
+ * \param[in] accumulatorType Type the values are accumulated in. Must be large enough to hold the result without overflowing.
+ * \param[out] reduction The created reduction. Must be released with releaseReduction.
+ * \return False if an error occurred, otherwise true.
+ */
+bool createReduction(cl_context context, cl_device_id device, ReductionOperation operation, ReductionType inputType, ReductionType accumulatorType, Reduction* reduction);
+
+/**
+ * \brief Enqueue a reduction of a buffer.
+ * \details Enqueues reduce_partial, in which each work-item first reduces vectors of 8 values and each work-group then reduces
+ *          in local memory to one partial result, followed by reduce_final which reduces the partial results in a single work-group.
+ * \param[in] commandQueue The command queue to use.
+ * \param[in] reduction The reduction to run.
+ * \param[in] input Buffer holding the values to reduce.
+ * \param[in] count Number of values in input.
+ * \param[out] events Events of the partial and final passes. Must be released by the caller if the function succeeds.
+ * \return False if an error occurred, otherwise true.
+ */
+bool enqueueReduction(cl_command_queue commandQueue, Reduction* reduction, cl_mem input, cl_int count, cl_event events[2]);
+
+/**
+ * \brief Read the result of a reduction, waiting for it to complete.
+ * \param[in] commandQueue The command queue the reduction was enqueued on.
+ * \param[in] reduction The reduction.
+ * \param[out] result Memory of reduction->resultSize bytes: one value of the accumulator type, or two for REDUCTION_MOMENTS.
+ * \return False if an error occurred, otherwise true.
+ */
+bool readReductionResult(cl_command_queue commandQueue, const Reduction* reduction, void* result);
+
+/**
+ * \brief Release the OpenCL objects of a reduction.
+ * \param[in] reduction The reduction to release.
+ * \return False if an error occurred, otherwise true.
+ */
+bool releaseReduction(Reduction* reduction);
+
+#endif
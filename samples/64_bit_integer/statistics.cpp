@@ -0,0 +1,232 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "statistics.h"
+#include "common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+/* Largest work-group size used by the statistics kernels. One work-item per bin is enough to merge the histograms. */
+static const size_t maximumWorkGroupSize = 256;
+
+/* Number of pixels each work-item of histogram_tiles should process, used to choose the number of slices per tile. */
+static const int pixelsPerWorkItem = 64;
+
+bool releaseImageStatistics(ImageStatistics* statistics)
+{
+    bool returnValue = true;
+    cl_kernel kernels[2] = {statistics->histogramKernel, statistics->statisticsKernel};
+    for (int index = 0; index < 2; index++)
+    {
+        if (kernels[index] != 0)
+        {
+            returnValue &= checkSuccess(clReleaseKernel(kernels[index]));
+        }
+    }
+    if (statistics->program != 0)
+    {
+        returnValue &= checkSuccess(clReleaseProgram(statistics->program));
+    }
+
+    cl_mem memoryObjects[5] = {statistics->partialHistograms, statistics->histograms, statistics->moments, statistics->percentiles, statistics->percentileValues};
+    for (int index = 0; index < 5; index++)
+    {
+        if (memoryObjects[index] != 0)
+        {
+            returnValue &= checkSuccess(clReleaseMemObject(memoryObjects[index]));
+        }
+    }
+
+    *statistics = ImageStatistics();
+    return returnValue;
+}
+
+bool createImageStatistics(cl_context context, cl_device_id device, int width, int height, int tileWidth, int tileHeight,
+                           const float* percentiles, int numberOfPercentiles, ImageStatistics* statistics)
+{
+    cl_int errorNumber = 0;
+    *statistics = ImageStatistics();
+
+    if (width <= 0 || height <= 0 || tileWidth <= 0 || tileHeight <= 0 || numberOfPercentiles < 0)
+    {
+        cerr << "Invalid image or tile size. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    statistics->width = width;
+    statistics->height = height;
+    statistics->tileWidth = min(tileWidth, width);
+    statistics->tileHeight = min(tileHeight, height);
+    statistics->numberOfTiles = ((width + statistics->tileWidth - 1) / statistics->tileWidth) * ((height + statistics->tileHeight - 1) / statistics->tileHeight);
+    statistics->numberOfPercentiles = numberOfPercentiles;
+
+    if (!createProgram(context, device, "assets/statistics.cl", &statistics->program))
+    {
+        statistics->program = 0;
+        cerr << "Failed to create the statistics program. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    statistics->histogramKernel = clCreateKernel(statistics->program, "histogram_tiles", &errorNumber);
+    bool createKernelsSuccess = checkSuccess(errorNumber);
+    statistics->statisticsKernel = clCreateKernel(statistics->program, "histogram_statistics", &errorNumber);
+    createKernelsSuccess &= checkSuccess(errorNumber);
+    if (!createKernelsSuccess)
+    {
+        releaseImageStatistics(statistics);
+        cerr << "Failed to create the statistics kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    size_t histogramWorkGroupSize = 0;
+    size_t statisticsWorkGroupSize = 0;
+    bool queryInfoSuccess = true;
+    queryInfoSuccess &= checkSuccess(clGetKernelWorkGroupInfo(statistics->histogramKernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &histogramWorkGroupSize, NULL));
+    queryInfoSuccess &= checkSuccess(clGetKernelWorkGroupInfo(statistics->statisticsKernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &statisticsWorkGroupSize, NULL));
+    if (!queryInfoSuccess)
+    {
+        releaseImageStatistics(statistics);
+        cerr << "Failed to query the statistics work-group size. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    statistics->workGroupSize = max((size_t)1, min(maximumWorkGroupSize, min(histogramWorkGroupSize, statisticsWorkGroupSize)));
+
+    /* [Slices per tile] */
+    /*
+     * Large tiles (such as a whole frame) are split between several work-groups so the device is kept busy,
+     * small tiles are handled by one work-group each.
+     */
+    const int tilePixels = statistics->tileWidth * statistics->tileHeight;
+    const int pixelsPerWorkGroup = statistics->workGroupSize * pixelsPerWorkItem;
+    statistics->slicesPerTile = max(1, (tilePixels + pixelsPerWorkGroup - 1) / pixelsPerWorkGroup);
+    /* [Slices per tile] */
+
+    const size_t numberOfTiles = statistics->numberOfTiles;
+    bool createMemoryObjectsSuccess = true;
+    statistics->partialHistograms = clCreateBuffer(context, CL_MEM_READ_WRITE, numberOfTiles * statistics->slicesPerTile * histogramBins * sizeof(cl_uint), NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    statistics->histograms = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, numberOfTiles * histogramBins * sizeof(cl_uint), NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    statistics->moments = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, numberOfTiles * sizeof(TileMoments), NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+
+    /* Buffers cannot be empty, so there is always room for at least one percentile. */
+    vector<float> percentileFractions(max(1, numberOfPercentiles), 0.5f);
+    copy(percentiles, percentiles + numberOfPercentiles, percentileFractions.begin());
+    statistics->percentiles = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, percentileFractions.size() * sizeof(float), &percentileFractions[0], &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    statistics->percentileValues = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, numberOfTiles * percentileFractions.size() * sizeof(cl_uchar), NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    if (!createMemoryObjectsSuccess)
+    {
+        releaseImageStatistics(statistics);
+        cerr << "Failed to create the statistics buffers. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* Only the input image changes between frames, so the other arguments are set once. */
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->histogramKernel, 1, sizeof(cl_int), &statistics->width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->histogramKernel, 2, sizeof(cl_int), &statistics->height));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->histogramKernel, 3, sizeof(cl_int), &statistics->tileWidth));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->histogramKernel, 4, sizeof(cl_int), &statistics->tileHeight));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->histogramKernel, 5, sizeof(cl_int), &statistics->slicesPerTile));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->histogramKernel, 6, sizeof(cl_mem), &statistics->partialHistograms));
+
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->statisticsKernel, 0, sizeof(cl_mem), &statistics->partialHistograms));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->statisticsKernel, 1, sizeof(cl_int), &statistics->slicesPerTile));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->statisticsKernel, 2, sizeof(cl_mem), &statistics->histograms));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->statisticsKernel, 3, sizeof(cl_mem), &statistics->moments));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->statisticsKernel, 4, sizeof(cl_mem), &statistics->percentiles));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->statisticsKernel, 5, sizeof(cl_int), &statistics->numberOfPercentiles));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(statistics->statisticsKernel, 6, sizeof(cl_mem), &statistics->percentileValues));
+    if (!setKernelArgumentsSuccess)
+    {
+        releaseImageStatistics(statistics);
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool enqueueImageStatistics(cl_command_queue commandQueue, ImageStatistics* statistics, cl_mem luminance, cl_event events[2])
+{
+    if (!checkSuccess(clSetKernelArg(statistics->histogramKernel, 0, sizeof(cl_mem), &luminance)))
+    {
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* [Enqueue the passes] */
+    /* One work-group per slice of each tile, then one work-group per tile. */
+    size_t localWorksize[1] = {statistics->workGroupSize};
+    size_t histogramGlobalWorksize[1] = {statistics->numberOfTiles * statistics->slicesPerTile * statistics->workGroupSize};
+    size_t statisticsGlobalWorksize[1] = {statistics->numberOfTiles * statistics->workGroupSize};
+    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, statistics->histogramKernel, 1, NULL, histogramGlobalWorksize, localWorksize, 0, NULL, &events[0])))
+    {
+        cerr << "Failed enqueuing the statistics kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, statistics->statisticsKernel, 1, NULL, statisticsGlobalWorksize, localWorksize, 1, &events[0], &events[1])))
+    {
+        /* The caller only releases the events of passes which were all enqueued. */
+        clReleaseEvent(events[0]);
+        events[0] = 0;
+        cerr << "Failed enqueuing the statistics kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    /* [Enqueue the passes] */
+
+    return true;
+}
+
+bool readImageStatistics(cl_command_queue commandQueue, const ImageStatistics* statistics, vector<TileStatistics>& tiles)
+{
+    const int numberOfPercentiles = max(1, statistics->numberOfPercentiles);
+    vector<unsigned int> histograms(statistics->numberOfTiles * histogramBins);
+    vector<TileMoments> moments(statistics->numberOfTiles);
+    vector<cl_uchar> percentileValues(statistics->numberOfTiles * numberOfPercentiles);
+
+    bool readResultsSuccess = true;
+    readResultsSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, statistics->histograms, CL_FALSE, 0, histograms.size() * sizeof(unsigned int), &histograms[0], 0, NULL, NULL));
+    readResultsSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, statistics->moments, CL_FALSE, 0, moments.size() * sizeof(TileMoments), &moments[0], 0, NULL, NULL));
+    readResultsSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, statistics->percentileValues, CL_FALSE, 0, percentileValues.size(), &percentileValues[0], 0, NULL, NULL));
+    /* Wait for the reads even if one failed, as the others may still be writing to the vectors. */
+    readResultsSuccess &= checkSuccess(clFinish(commandQueue));
+    if (!readResultsSuccess)
+    {
+        cerr << "Failed reading the statistics. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    const int tilesPerRow = (statistics->width + statistics->tileWidth - 1) / statistics->tileWidth;
+    tiles.resize(statistics->numberOfTiles);
+    for (int tile = 0; tile < statistics->numberOfTiles; tile++)
+    {
+        TileStatistics& result = tiles[tile];
+        result.x = (tile % tilesPerRow) * statistics->tileWidth;
+        result.y = (tile / tilesPerRow) * statistics->tileHeight;
+        result.width = min(statistics->tileWidth, statistics->width - result.x);
+        result.height = min(statistics->tileHeight, statistics->height - result.y);
+        result.moments = moments[tile];
+        copy(&histograms[tile * histogramBins], &histograms[tile * histogramBins] + histogramBins, result.histogram);
+        result.percentiles.assign(&percentileValues[tile * numberOfPercentiles], &percentileValues[tile * numberOfPercentiles] + statistics->numberOfPercentiles);
+
+        const double count = max((cl_uint)1, result.moments.count);
+        result.mean = result.moments.sum / count;
+        result.standardDeviation = sqrt(max(0.0, result.moments.sumOfSquares / count - result.mean * result.mean));
+    }
+    return true;
+}
@@ -0,0 +1,123 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <CL/cl.h>
+#include <vector>
+
+/**
+ * \file statistics.h
+ * \brief Histograms and statistics of 8-bit luminance images, per frame or per tile.
+ */
+
+/**
+ * \brief Number of bins in a luminance histogram.
+ */
+const int histogramBins = 256;
+
+/**
+ * \brief Statistics calculated on the device for one tile. Must match TileMoments in assets/statistics.cl.
+ */
+struct TileMoments
+{
+    cl_ulong sum; /**< \brief Sum of the luminance values. */
+    cl_ulong sumOfSquares; /**< \brief Sum of the squares of the luminance values. */
+    cl_uint count; /**< \brief Number of pixels in the tile. */
+    cl_uint minimum; /**< \brief Smallest luminance value. */
+    cl_uint maximum; /**< \brief Largest luminance value. */
+    cl_uint padding; /**< \brief Unused, keeps the layout the same as the kernel. */
+};
+
+/**
+ * \brief Statistics of one tile, as returned by readImageStatistics.
+ */
+struct TileStatistics
+{
+    cl_int x; /**< \brief First column of the tile. */
+    cl_int y; /**< \brief First row of the tile. */
+    cl_int width; /**< \brief Width of the tile, clipped to the image. */
+    cl_int height; /**< \brief Height of the tile, clipped to the image. */
+    TileMoments moments; /**< \brief Count, sums, minimum and maximum. */
+    double mean; /**< \brief Mean luminance. */
+    double standardDeviation; /**< \brief Standard deviation of the luminance. */
+    cl_uint histogram[histogramBins]; /**< \brief Number of pixels with each luminance value. */
+    std::vector<cl_uchar> percentiles; /**< \brief The luminance at each of the percentiles requested in createImageStatistics. */
+};
+
+/**
+ * \brief Kernels and buffers to calculate the statistics of images of one size and tiling.
+ */
+struct ImageStatistics
+{
+    cl_program program; /**< \brief Program built from assets/statistics.cl. */
+    cl_kernel histogramKernel; /**< \brief The histogram_tiles kernel. */
+    cl_kernel statisticsKernel; /**< \brief The histogram_statistics kernel. */
+    cl_mem partialHistograms; /**< \brief One histogram per work-group of histogram_tiles. */
+    cl_mem histograms; /**< \brief One histogram per tile. */
+    cl_mem moments; /**< \brief One TileMoments per tile. */
+    cl_mem percentiles; /**< \brief The requested percentiles, as fractions. */
+    cl_mem percentileValues; /**< \brief The luminance at each percentile, for each tile. */
+    cl_int width; /**< \brief Width of the images. */
+    cl_int height; /**< \brief Height of the images. */
+    cl_int tileWidth; /**< \brief Width of the tiles. */
+    cl_int tileHeight; /**< \brief Height of the tiles. */
+    cl_int numberOfTiles; /**< \brief Number of tiles in an image. */
+    cl_int slicesPerTile; /**< \brief Number of work-groups of histogram_tiles sharing each tile. */
+    cl_int numberOfPercentiles; /**< \brief Number of percentiles requested. */
+    size_t workGroupSize; /**< \brief Work-group size of both kernels. */
+};
+
+/**
+ * \brief Build the statistics kernels and allocate the buffers for an image size and tiling.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] device The OpenCL device to build the kernels for.
+ * \param[in] width Width of the images.
+ * \param[in] height Height of the images.
+ * \param[in] tileWidth Width of the tiles. Use the image width (and height) for statistics of the whole frame.
+ * \param[in] tileHeight Height of the tiles.
+ * \param[in] percentiles Percentiles to calculate, as fractions between 0 and 1 (for example 0.5 for the median).
+ * \param[in] numberOfPercentiles Number of values in percentiles.
+ * \param[out] statistics The created statistics object. Must be released with releaseImageStatistics.
+ * \return False if an error occurred, otherwise true.
+ */
+bool createImageStatistics(cl_context context, cl_device_id device, int width, int height, int tileWidth, int tileHeight,
+                           const float* percentiles, int numberOfPercentiles, ImageStatistics* statistics);
+
+/**
+ * \brief Enqueue the calculation of the statistics of an image.
+ * \details Makes one pass over the image to build privatized local memory histograms per tile,
+ *          followed by a small pass which merges them and derives the other statistics from the histograms.
+ * \param[in] commandQueue The command queue to use.
+ * \param[in] statistics The statistics object.
+ * \param[in] luminance Buffer holding the image, one byte per pixel.
+ * \param[out] events Events of the histogram and statistics passes. Must be released by the caller if the function succeeds.
+ * \return False if an error occurred, otherwise true.
+ */
+bool enqueueImageStatistics(cl_command_queue commandQueue, ImageStatistics* statistics, cl_mem luminance, cl_event events[2]);
+
+/**
+ * \brief Read the statistics of every tile, waiting for them to be calculated.
+ * \param[in] commandQueue The command queue the statistics were enqueued on.
+ * \param[in] statistics The statistics object.
+ * \param[out] tiles The statistics of each tile, in row order.
+ * \return False if an error occurred, otherwise true.
+ */
+bool readImageStatistics(cl_command_queue commandQueue, const ImageStatistics* statistics, std::vector<TileStatistics>& tiles);
+
+/**
+ * \brief Release the OpenCL objects of a statistics object.
+ * \param[in] statistics The statistics object to release.
+ * \return False if an error occurred, otherwise true.
+ */
+bool releaseImageStatistics(ImageStatistics* statistics);
+
+#endif
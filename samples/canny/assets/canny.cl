@@ -0,0 +1,276 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+/*
+ * The 3x3 Gaussian is separable: [1 2 1] / 4 along the rows, then [1 2 1] / 4 along the columns.
+ * GW_SIDE and GW_MIDDLE are the weights of that 1D filter.
+ */
+#define GW_SIDE 0.25f
+#define GW_MIDDLE 0.5f
+
+/*
+ * Values stored in the edge state buffer.
+ * Hysteresis promotes WEAK_EDGE pixels which touch a STRONG_EDGE pixel.
+ */
+#define NO_EDGE 0
+#define WEAK_EDGE 1
+#define STRONG_EDGE 2
+
+/*
+ * tan(22.5 degrees) and tan(67.5 degrees).
+ * Used to quantize the gradient direction into one of four sectors without calling atan2.
+ */
+#define TAN_22_5 0.4142135f
+#define TAN_67_5 2.4142135f
+
+/**
+ * \brief Load the three overlapping vectors of a 6x1 window row.
+ * \details The data0, data1, data2 loads of firBlock in the fir_float sample, with clamping added.
+ *          When the window overlaps the left or right edge of the image, the columns are clamped.
+ * \param[in] rowData Pointer to the start of the row.
+ * \param[in] column First of the four output columns.
+ * \param[in] width Width of the image.
+ * \param[out] data0 Columns [column - 1, column + 2].
+ * \param[out] data1 Columns [column, column + 3].
+ * \param[out] data2 Columns [column + 1, column + 4].
+ */
+void loadWindowRow(__global const float* restrict rowData, const int column, const int width,
+                   float4* data0, float4* data1, float4* data2)
+{
+    if (column > 0 && column + 4 < width)
+    {
+        *data0 = vload4(0, rowData + column - 1);
+        *data2 = vload4(0, rowData + column + 1);
+    }
+    else
+    {
+        /* Border path: only the first and last work-items in a row take this branch. */
+        *data0 = (float4)(rowData[max(column - 1, 0)], rowData[column], rowData[column + 1], rowData[column + 2]);
+        *data2 = (float4)(rowData[column + 1], rowData[column + 2], rowData[column + 3], rowData[min(column + 4, width - 1)]);
+    }
+    *data1 = (float4)((*data0).s12, (*data2).s12);
+}
+
+/**
+ * \brief Filter four pixels of a row with the 1D Gaussian.
+ * \param[in] rowData Pointer to the start of the row.
+ * \param[in] column First of the four columns.
+ * \param[in] width Width of the image.
+ * \return The filtered pixels.
+ */
+float4 gaussianRow(__global const float* restrict rowData, const int column, const int width)
+{
+    float4 data0;
+    float4 data1;
+    float4 data2;
+    loadWindowRow(rowData, column, width, &data0, &data1, &data2);
+    return (data0 + data2) * GW_SIDE + data1 * GW_MIDDLE;
+}
+
+/**
+ * \brief Gaussian pre-blur kernel function.
+ * \details Works on 4 pixels at a time over a 6x3 window like the fir_float kernel, but with a centred window,
+ *          so the output is not shifted. Instead of the nine multiply-adds of a general 3x3 filter,
+ *          each row is filtered with the 1D Gaussian and the three rows are then combined with it.
+ *          Rows and columns outside the image are clamped to the nearest edge.
+ * \param[in] input Input image data in row-major format. Width must be a multiple of 4.
+ * \param[out] output Blurred image data.
+ * \param[in] width Width of the image.
+ * \param[in] height Height of the image.
+ */
+__kernel void gaussian_blur(__global const float* restrict input,
+                            __global float* restrict output,
+                            const int width,
+                            const int height)
+{
+    const int column = get_global_id(0) * 4;
+    const int row = get_global_id(1);
+
+    const float4 above = gaussianRow(input + max(row - 1, 0) * width, column, width);
+    const float4 centre = gaussianRow(input + row * width, column, width);
+    const float4 below = gaussianRow(input + min(row + 1, height - 1) * width, column, width);
+
+    vstore4((above + below) * GW_SIDE + centre * GW_MIDDLE, 0, output + row * width + column);
+}
+
+/**
+ * \brief Fused Sobel kernel function.
+ * \details Calculates the X and Y gradients, the gradient magnitude and the quantized gradient direction
+ *          in one pass so the individual gradients never have to be written to memory.
+ *          The one pixel wide border of the image has no complete 3x3 neighbourhood and is set to zero.
+ * \param[in] input Blurred image data in row-major format.
+ * \param[out] magnitude Gradient magnitude of each pixel.
+ * \param[out] direction Gradient direction of each pixel quantized to 0 (horizontal), 1 (diagonal down-right),
+ *                       2 (vertical) or 3 (diagonal down-left).
+ * \param[in] width Width of the image.
+ * \param[in] height Height of the image.
+ */
+__kernel void sobel_magnitude(__global const float* restrict input,
+                              __global float* restrict magnitude,
+                              __global uchar* restrict direction,
+                              const int width,
+                              const int height)
+{
+    const int column = get_global_id(0);
+    const int row = get_global_id(1);
+    const int offset = row * width + column;
+
+    if (column == 0 || row == 0 || column == width - 1 || row == height - 1)
+    {
+        magnitude[offset] = 0.0f;
+        direction[offset] = 0;
+        return;
+    }
+
+    const float topLeft = input[offset - width - 1];
+    const float top = input[offset - width];
+    const float topRight = input[offset - width + 1];
+    const float left = input[offset - 1];
+    const float right = input[offset + 1];
+    const float bottomLeft = input[offset + width - 1];
+    const float bottom = input[offset + width];
+    const float bottomRight = input[offset + width + 1];
+
+    const float dx = (topRight + 2.0f * right + bottomRight) - (topLeft + 2.0f * left + bottomLeft);
+    const float dy = (bottomLeft + 2.0f * bottom + bottomRight) - (topLeft + 2.0f * top + topRight);
+
+    magnitude[offset] = hypot(dx, dy);
+
+    /* Quantize the direction by comparing |dy| / |dx| against tan(22.5) and tan(67.5). */
+    const float absoluteDx = fabs(dx);
+    const float absoluteDy = fabs(dy);
+    uchar sector;
+    if (absoluteDy <= absoluteDx * TAN_22_5)
+    {
+        sector = 0;
+    }
+    else if (absoluteDy >= absoluteDx * TAN_67_5)
+    {
+        sector = 2;
+    }
+    else
+    {
+        sector = (dx * dy > 0.0f) ? 1 : 3;
+    }
+    direction[offset] = sector;
+}
+
+/**
+ * \brief Non-maximum suppression and double threshold kernel function.
+ * \details Keeps a pixel only if its magnitude is a local maximum along the gradient direction.
+ *          Surviving pixels above highThreshold are marked STRONG_EDGE and appended to the work-list,
+ *          those above lowThreshold are marked WEAK_EDGE.
+ * \param[in] magnitude Gradient magnitude from sobel_magnitude.
+ * \param[in] direction Quantized gradient direction from sobel_magnitude.
+ * \param[out] edges Edge state of each pixel (NO_EDGE, WEAK_EDGE or STRONG_EDGE).
+ * \param[out] workList Indices of the STRONG_EDGE pixels. Must have space for width * height entries.
+ * \param[in,out] workListCount Number of entries in workList. Must be zero before the kernel is run.
+ * \param[in] width Width of the image.
+ * \param[in] height Height of the image.
+ * \param[in] lowThreshold Minimum magnitude of a WEAK_EDGE pixel.
+ * \param[in] highThreshold Minimum magnitude of a STRONG_EDGE pixel.
+ */
+__kernel void non_maximum_suppression(__global const float* restrict magnitude,
+                                      __global const uchar* restrict direction,
+                                      __global int* restrict edges,
+                                      __global int* restrict workList,
+                                      __global int* restrict workListCount,
+                                      const int width,
+                                      const int height,
+                                      const float lowThreshold,
+                                      const float highThreshold)
+{
+    const int column = get_global_id(0);
+    const int row = get_global_id(1);
+    const int offset = row * width + column;
+
+    if (column == 0 || row == 0 || column == width - 1 || row == height - 1)
+    {
+        edges[offset] = NO_EDGE;
+        return;
+    }
+
+    /* Offsets of the two neighbours along the gradient direction. */
+    int neighbour;
+    switch (direction[offset])
+    {
+        case 0:
+            neighbour = 1;
+            break;
+        case 1:
+            neighbour = width + 1;
+            break;
+        case 2:
+            neighbour = width;
+            break;
+        default:
+            neighbour = width - 1;
+            break;
+    }
+
+    const float value = magnitude[offset];
+    int state = NO_EDGE;
+    if (value >= lowThreshold && value >= magnitude[offset - neighbour] && value > magnitude[offset + neighbour])
+    {
+        if (value >= highThreshold)
+        {
+            state = STRONG_EDGE;
+            workList[atomic_inc(workListCount)] = offset;
+        }
+        else
+        {
+            state = WEAK_EDGE;
+        }
+    }
+    edges[offset] = state;
+}
+
+/**
+ * \brief One pass of work-list hysteresis.
+ * \details Each work-item takes one STRONG_EDGE pixel from inputList and promotes any WEAK_EDGE neighbours.
+ *          atomic_cmpxchg guarantees a pixel is promoted (and appended to outputList) exactly once,
+ *          so the host can repeat the pass until outputCount stays at zero.
+ *          Border pixels are never edges, so the 8 neighbours of every list entry are inside the image.
+ * \param[in,out] edges Edge state of each pixel.
+ * \param[in] inputList Pixels promoted by the previous pass. The global work size is the number of entries.
+ * \param[out] outputList Pixels promoted by this pass.
+ * \param[in,out] outputCount Number of entries in outputList. Must be zero before the kernel is run.
+ * \param[in] width Width of the image.
+ */
+__kernel void hysteresis(__global int* restrict edges,
+                         __global const int* restrict inputList,
+                         __global int* restrict outputList,
+                         __global int* restrict outputCount,
+                         const int width)
+{
+    const int offset = inputList[get_global_id(0)];
+
+    const int neighbours[8] = {-width - 1, -width, -width + 1, -1, 1, width - 1, width, width + 1};
+    for (int i = 0; i < 8; i++)
+    {
+        const int neighbour = offset + neighbours[i];
+        if (atomic_cmpxchg(edges + neighbour, WEAK_EDGE, STRONG_EDGE) == WEAK_EDGE)
+        {
+            outputList[atomic_inc(outputCount)] = neighbour;
+        }
+    }
+}
+
+/**
+ * \brief Convert the edge states into an 8-bit luminance image.
+ * \param[in] edges Edge state of each pixel after hysteresis.
+ * \param[out] output 255 for STRONG_EDGE pixels, 0 otherwise.
+ */
+__kernel void edge_output(__global const int* restrict edges,
+                          __global uchar* restrict output)
+{
+    const int i = get_global_id(0);
+    output[i] = (edges[i] == STRONG_EDGE) ? 255 : 0;
+}
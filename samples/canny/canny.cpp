@@ -0,0 +1,444 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "common.h"
+#include "image.h"
+#include "trace.h"
+
+#include <CL/cl.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstddef>
+#include <cmath>
+
+using namespace std;
+
+/* Number of kernels in the edge detection pipeline. */
+const int numberOfKernels = 5;
+
+/**
+ * \brief Release all the kernels and the other OpenCL objects used by the sample.
+ * \details cleanUpOpenCL only releases a single kernel, the remaining pipeline kernels are released here.
+ * \return False if an error occurred, otherwise true.
+ */
+bool cleanUpCanny(cl_context context, cl_command_queue commandQueue, cl_program program, cl_kernel* kernels, cl_mem* memoryObjects, int numberOfMemoryObjects)
+{
+    bool returnValue = true;
+    for (int index = 1; index < numberOfKernels; index++)
+    {
+        if (kernels[index] != 0 && !checkSuccess(clReleaseKernel(kernels[index])))
+        {
+            cerr << "Releasing the OpenCL kernel " << index << " failed. " << __FILE__ << ":"<< __LINE__ << endl;
+            returnValue = false;
+        }
+    }
+    returnValue &= cleanUpOpenCL(context, commandQueue, program, kernels[0], memoryObjects, numberOfMemoryObjects);
+    return returnValue;
+}
+
+/**
+ * \brief Release the events which were created before an error, skipping the ones which were not.
+ * \param[in] events The events, 0 for the ones which were not created.
+ * \param[in] numberOfEvents Number of events.
+ */
+void releaseCannyEvents(const cl_event* events, int numberOfEvents)
+{
+    for (int index = 0; index < numberOfEvents; index++)
+    {
+        if (events[index] != 0)
+        {
+            clReleaseEvent(events[index]);
+        }
+    }
+}
+
+/**
+ * \brief Canny edge detection OpenCL sample.
+ * \details A sample which extends the Sobel sample into a full edge detector.
+ *          The input image is loaded from assets/input.bmp and passed through a chain of kernels:
+ *          - a Gaussian pre-blur using the vectorised convolution from the fir_float sample,
+ *          - a fused Sobel kernel which outputs the gradient magnitude and quantized direction,
+ *          - non-maximum suppression with a double threshold, which seeds a work-list with the strong edges,
+ *          - iterative hysteresis which grows the strong edges into connected weak edges until the work-list is empty.
+ *          All intermediate buffers stay on the device and each stage waits on the event of the previous one.
+ *          The resulting edge map is stored in output.bmp.
+ * \return The exit code of the application, non-zero if a problem occurred.
+ */
+int main(void)
+{
+    /*
+     * Name of the bitmap to load and run the edge detection on.
+     * Its width must be divisible by 4.
+     */
+    string filename = "assets/input.bmp";
+
+    cl_context context = 0;
+    cl_command_queue commandQueue = 0;
+    cl_program program = 0;
+    cl_device_id device = 0;
+
+    /* Index values for the kernels. */
+    const int blurKernelIndex = 0;
+    const int sobelKernelIndex = 1;
+    const int suppressionKernelIndex = 2;
+    const int hysteresisKernelIndex = 3;
+    const int outputKernelIndex = 4;
+    const char* kernelNames[numberOfKernels] = {"gaussian_blur", "sobel_magnitude", "non_maximum_suppression", "hysteresis", "edge_output"};
+    cl_kernel kernels[numberOfKernels] = {0, 0, 0, 0, 0};
+
+    /* Index values for the memory objects. */
+    const int numberOfMemoryObjects = 10;
+    const int inputIndex = 0;
+    const int blurredIndex = 1;
+    const int magnitudeIndex = 2;
+    const int directionIndex = 3;
+    const int edgesIndex = 4;
+    const int workListIndex = 5;
+    /* Two work-lists and two counters are used in a ping-pong fashion by the hysteresis passes. */
+    const int workListCountIndex = 7;
+    const int outputIndex = 9;
+    cl_mem memoryObjects[numberOfMemoryObjects] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    cl_int errorNumber;
+
+    /* Thresholds for the gradient magnitude of the normalized [0, 1] input. */
+    cl_float lowThreshold = 0.2f;
+    cl_float highThreshold = 0.4f;
+
+    if (!createContext(&context))
+    {
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create an OpenCL context. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!createCommandQueue(context, &commandQueue, &device))
+    {
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create the OpenCL command queue. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!createProgram(context, device, "assets/canny.cl", &program))
+    {
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create OpenCL program." << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    for (int index = 0; index < numberOfKernels; index++)
+    {
+        kernels[index] = clCreateKernel(program, kernelNames[index], &errorNumber);
+        if (!checkSuccess(errorNumber))
+        {
+            cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+            cerr << "Failed to create OpenCL kernel " << kernelNames[index] << ". " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
+    }
+
+    /* Load 24-bits per pixel RGB data from a bitmap. */
+    cl_int width;
+    cl_int height;
+    unsigned char* loadedRGBData = NULL;
+    if (!loadFromBitmap(filename, &width, &height, &loadedRGBData))
+    {
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed loading bitmap. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (width % 4 != 0)
+    {
+        delete [] loadedRGBData;
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "The width of the image must be divisible by 4. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Convert 24-bits per pixel RGB into 8-bits per pixel luminance data. */
+    const int numberOfPixels = width * height;
+    unsigned char* inputLuminance = new unsigned char [numberOfPixels];
+    RGBToLuminance(loadedRGBData, inputLuminance, width, height);
+    delete [] loadedRGBData;
+
+    /*
+     * Only the input and the final output are accessed from the host.
+     * The intermediate buffers are never mapped so they are not allocated with CL_MEM_ALLOC_HOST_PTR.
+     */
+    const size_t floatBufferSize = numberOfPixels * sizeof(cl_float);
+    const size_t intBufferSize = numberOfPixels * sizeof(cl_int);
+    const size_t charBufferSize = numberOfPixels * sizeof(cl_uchar);
+
+    bool createMemoryObjectsSuccess = true;
+    memoryObjects[inputIndex] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, floatBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[blurredIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE, floatBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[magnitudeIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE, floatBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[directionIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE, charBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[edgesIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE, intBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    for (int list = 0; list < 2; list++)
+    {
+        memoryObjects[workListIndex + list] = clCreateBuffer(context, CL_MEM_READ_WRITE, intBufferSize, NULL, &errorNumber);
+        createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+        memoryObjects[workListCountIndex + list] = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(cl_int), NULL, &errorNumber);
+        createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    }
+    memoryObjects[outputIndex] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, charBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    if (!createMemoryObjectsSuccess)
+    {
+        delete [] inputLuminance;
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create OpenCL buffers. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Map the input memory object to a host side pointer. Commands are recorded on the timeline when tracing is enabled (CL_TRACE_FILE). */
+    cl_event mapEvent = 0;
+    cl_float* inputImageData = (cl_float*)clEnqueueMapBuffer(commandQueue, memoryObjects[inputIndex], CL_TRUE, CL_MAP_WRITE, 0, floatBufferSize, 0, NULL, traceEvent(&mapEvent), &errorNumber);
+    traceAndReleaseCommand(mapEvent, "map input", floatBufferSize);
+    if (!checkSuccess(errorNumber))
+    {
+       delete [] inputLuminance;
+       cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+       cerr << "Mapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+       return 1;
+    }
+
+    /* Convert the luminance data into normalized floats as in the fir_float sample. */
+    luminanceToFloat(inputLuminance, inputImageData, width, height);
+
+    delete [] inputLuminance;
+
+    cl_event unmapEvent = 0;
+    bool unmapInputSuccess = checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[inputIndex], inputImageData, 0, NULL, traceEvent(&unmapEvent)));
+    traceAndReleaseCommand(unmapEvent, "unmap input", floatBufferSize);
+    if (!unmapInputSuccess)
+    {
+       cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+       cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+       return 1;
+    }
+
+    /* The first work-list is filled by non_maximum_suppression so its counter must start at zero. */
+    const cl_int zero = 0;
+    cl_event counterEvent = 0;
+    bool resetCounterSuccess = checkSuccess(clEnqueueWriteBuffer(commandQueue, memoryObjects[workListCountIndex], CL_TRUE, 0, sizeof(cl_int), &zero, 0, NULL, traceEvent(&counterEvent)));
+    traceAndReleaseCommand(counterEvent, "reset work-list counter", sizeof(cl_int));
+    if (!resetCounterSuccess)
+    {
+       cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+       cerr << "Failed to reset the work-list counter. " << __FILE__ << ":"<< __LINE__ << endl;
+       return 1;
+    }
+
+    /* Setup the arguments of all the kernels with fixed arguments. */
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[blurKernelIndex], 0, sizeof(cl_mem), &memoryObjects[inputIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[blurKernelIndex], 1, sizeof(cl_mem), &memoryObjects[blurredIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[blurKernelIndex], 2, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[blurKernelIndex], 3, sizeof(cl_int), &height));
+
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[sobelKernelIndex], 0, sizeof(cl_mem), &memoryObjects[blurredIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[sobelKernelIndex], 1, sizeof(cl_mem), &memoryObjects[magnitudeIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[sobelKernelIndex], 2, sizeof(cl_mem), &memoryObjects[directionIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[sobelKernelIndex], 3, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[sobelKernelIndex], 4, sizeof(cl_int), &height));
+
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[suppressionKernelIndex], 0, sizeof(cl_mem), &memoryObjects[magnitudeIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[suppressionKernelIndex], 1, sizeof(cl_mem), &memoryObjects[directionIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[suppressionKernelIndex], 2, sizeof(cl_mem), &memoryObjects[edgesIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[suppressionKernelIndex], 3, sizeof(cl_mem), &memoryObjects[workListIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[suppressionKernelIndex], 4, sizeof(cl_mem), &memoryObjects[workListCountIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[suppressionKernelIndex], 5, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[suppressionKernelIndex], 6, sizeof(cl_int), &height));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[suppressionKernelIndex], 7, sizeof(cl_float), &lowThreshold));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[suppressionKernelIndex], 8, sizeof(cl_float), &highThreshold));
+
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[hysteresisKernelIndex], 0, sizeof(cl_mem), &memoryObjects[edgesIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[hysteresisKernelIndex], 4, sizeof(cl_int), &width));
+
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[outputKernelIndex], 0, sizeof(cl_mem), &memoryObjects[edgesIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[outputKernelIndex], 1, sizeof(cl_mem), &memoryObjects[outputIndex]));
+    if (!setKernelArgumentsSuccess)
+    {
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /*
+     * Events for each stage of the pipeline.
+     * Each stage waits on the event of the previous one, so the ordering is kept
+     * even if the command queue is created with out-of-order execution enabled.
+     */
+    cl_event blurEvent = 0;
+    cl_event sobelEvent = 0;
+    cl_event suppressionEvent = 0;
+
+    /* [Kernel size] */
+    /* The blur works on 4 pixels per work-item (as in the fir_float sample), the other stages on a single pixel. */
+    size_t blurWorksize[2] = {(size_t)width / 4, (size_t)height};
+    size_t pixelWorksize[2] = {(size_t)width, (size_t)height};
+    /* [Kernel size] */
+
+    bool enqueueSuccess = true;
+    enqueueSuccess &= checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernels[blurKernelIndex], 2, NULL, blurWorksize, NULL, 0, NULL, &blurEvent));
+    enqueueSuccess &= checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernels[sobelKernelIndex], 2, NULL, pixelWorksize, NULL, 1, &blurEvent, &sobelEvent));
+    enqueueSuccess &= checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernels[suppressionKernelIndex], 2, NULL, pixelWorksize, NULL, 1, &sobelEvent, &suppressionEvent));
+    if (!enqueueSuccess)
+    {
+        const cl_event events[3] = {blurEvent, sobelEvent, suppressionEvent};
+        releaseCannyEvents(events, 3);
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed enqueuing the kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    traceKernel(blurEvent, kernels[blurKernelIndex], 2, blurWorksize, NULL);
+    traceKernel(sobelEvent, kernels[sobelKernelIndex], 2, pixelWorksize, NULL);
+    traceKernel(suppressionEvent, kernels[suppressionKernelIndex], 2, pixelWorksize, NULL);
+
+    /*
+     * The number of strong edges decides the size of the first hysteresis pass,
+     * so this is the first point where the host has to wait for the device.
+     */
+    cl_int workListCount = 0;
+    bool readCounterSuccess = checkSuccess(clEnqueueReadBuffer(commandQueue, memoryObjects[workListCountIndex], CL_TRUE, 0, sizeof(cl_int), &workListCount, 1, &suppressionEvent, traceEvent(&counterEvent)));
+    traceAndReleaseCommand(counterEvent, "read work-list counter", sizeof(cl_int));
+    if (!readCounterSuccess)
+    {
+        const cl_event events[3] = {blurEvent, sobelEvent, suppressionEvent};
+        releaseCannyEvents(events, 3);
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed reading the work-list counter. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    cout << "Gaussian blur ";
+    printProfilingInfo(blurEvent);
+    cout << "Sobel ";
+    printProfilingInfo(sobelEvent);
+    cout << "Non-maximum suppression ";
+    printProfilingInfo(suppressionEvent);
+    cout << "Strong edge pixels: " << workListCount << endl;
+
+    /* [Hysteresis] */
+    /*
+     * Each pass consumes the pixels promoted by the previous pass and produces a new work-list.
+     * Every weak pixel can only be promoted once, so the loop finishes after at most width * height passes
+     * (in practice it is bounded by the length of the longest weak edge chain).
+     */
+    cl_event previousEvent = suppressionEvent;
+    int pass = 0;
+    bool hysteresisSuccess = true;
+    while (hysteresisSuccess && workListCount > 0)
+    {
+        const int inputList = pass % 2;
+        const int outputList = 1 - inputList;
+
+        hysteresisSuccess &= checkSuccess(clEnqueueWriteBuffer(commandQueue, memoryObjects[workListCountIndex + outputList], CL_TRUE, 0, sizeof(cl_int), &zero, 0, NULL, traceEvent(&counterEvent)));
+        traceAndReleaseCommand(counterEvent, "reset work-list counter", sizeof(cl_int));
+        hysteresisSuccess &= checkSuccess(clSetKernelArg(kernels[hysteresisKernelIndex], 1, sizeof(cl_mem), &memoryObjects[workListIndex + inputList]));
+        hysteresisSuccess &= checkSuccess(clSetKernelArg(kernels[hysteresisKernelIndex], 2, sizeof(cl_mem), &memoryObjects[workListIndex + outputList]));
+        hysteresisSuccess &= checkSuccess(clSetKernelArg(kernels[hysteresisKernelIndex], 3, sizeof(cl_mem), &memoryObjects[workListCountIndex + outputList]));
+
+        size_t hysteresisWorksize[1] = {(size_t)workListCount};
+        cl_event hysteresisEvent = 0;
+        if (!hysteresisSuccess || !checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernels[hysteresisKernelIndex], 1, NULL, hysteresisWorksize, NULL, 1, &previousEvent, &hysteresisEvent)))
+        {
+            hysteresisSuccess = false;
+            break;
+        }
+        traceKernel(hysteresisEvent, kernels[hysteresisKernelIndex], 1, hysteresisWorksize, NULL);
+        hysteresisSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, memoryObjects[workListCountIndex + outputList], CL_TRUE, 0, sizeof(cl_int), &workListCount, 1, &hysteresisEvent, traceEvent(&counterEvent)));
+        traceAndReleaseCommand(counterEvent, "read work-list counter", sizeof(cl_int));
+
+        cout << "Hysteresis pass " << pass << " (" << hysteresisWorksize[0] << " pixels) ";
+        printProfilingInfo(hysteresisEvent);
+
+        hysteresisSuccess &= checkSuccess(clReleaseEvent(previousEvent));
+        previousEvent = hysteresisEvent;
+        pass++;
+    }
+    /* [Hysteresis] */
+
+    cl_event outputEvent = 0;
+    size_t outputWorksize[1] = {(size_t)numberOfPixels};
+    if (!hysteresisSuccess || !checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernels[outputKernelIndex], 1, NULL, outputWorksize, NULL, 1, &previousEvent, &outputEvent)))
+    {
+        const cl_event events[3] = {blurEvent, sobelEvent, previousEvent};
+        releaseCannyEvents(events, 3);
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed running the hysteresis passes. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    traceKernel(outputEvent, kernels[outputKernelIndex], 1, outputWorksize, NULL);
+
+    /* Wait for completion */
+    if (!checkSuccess(clFinish(commandQueue)))
+    {
+        const cl_event events[4] = {blurEvent, sobelEvent, previousEvent, outputEvent};
+        releaseCannyEvents(events, 4);
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed waiting for kernel execution to finish. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    cout << "Edge output ";
+    printProfilingInfo(outputEvent);
+
+    /* Release the event objects. */
+    bool releaseEventsSuccess = true;
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(blurEvent));
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(sobelEvent));
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(previousEvent));
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(outputEvent));
+    if (!releaseEventsSuccess)
+    {
+        cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed releasing the event objects. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Map the edge map to a host side pointer. */
+    cl_uchar* output = (cl_uchar*)clEnqueueMapBuffer(commandQueue, memoryObjects[outputIndex], CL_TRUE, CL_MAP_READ, 0, charBufferSize, 0, NULL, traceEvent(&mapEvent), &errorNumber);
+    traceAndReleaseCommand(mapEvent, "map output", charBufferSize);
+    if (!checkSuccess(errorNumber))
+    {
+       cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+       cerr << "Mapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+       return 1;
+    }
+
+    /* Convert the output luminance array to RGB and save it out to a file. */
+    unsigned char* rgbOut = new unsigned char[numberOfPixels * 3];
+    luminanceToRGB(output, rgbOut, width, height);
+    saveToBitmap("output.bmp", width, height, rgbOut);
+    delete [] rgbOut;
+
+    bool unmapOutputSuccess = checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[outputIndex], output, 0, NULL, traceEvent(&unmapEvent)));
+    traceAndReleaseCommand(unmapEvent, "unmap output", charBufferSize);
+    if (!unmapOutputSuccess)
+    {
+       cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+       cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+       return 1;
+    }
+
+    /* Release OpenCL objects. */
+    cleanUpCanny(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+
+    return 0;
+}
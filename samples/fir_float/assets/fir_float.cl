@@ -21,27 +21,17 @@
 #define FW_BR (40.0f * FW_SCALE)
 
 /**
- * \brief FIR filter kernel function.
+ * \brief FIR filter of 4 pixels in a row.
+ * \details Reads the 6x3 window of input starting at offset, see the comments below.
  * \param[in] input Input image data in row-major format.
  * \param[in] width Width of the image passed in as input.
- * \param[out] output Output image after FIR has been applied. Resulting image depends on the coefficients used.
+ * \param[in] offset Position in input of the first of the 4 pixels.
+ * \return The filtered pixels.
  */
-__kernel void fir_float(__global const float* restrict input,
-                        __global float* restrict output,
-                        const int width)
+float4 firBlock(__global const float* restrict input,
+                const int width,
+                const int offset)
 {
-    /* [Kernel size] */
-    /*
-     * Each kernel calculates 4 output pixels in the same row (hence the '* 4').
-     * column is in the range [0, width] in steps of 4.
-     * row is in the range [0, height].
-     */
-    const int column = get_global_id(0) * 4;
-    const int row = get_global_id(1);
-    /* Offset calculates the position in the linear data for the row and the column. */
-    const int offset = row * width + column;
-    /* [Kernel size] */
-
     /* Accumulator array of 4 floats. */
     float4 accumulator = (float4)0.0f;
 
@@ -102,8 +92,65 @@ __kernel void fir_float(__global const float* restrict input,
     accumulator += data2 * FW_BR;
     /* [Load and filter second and third row] */
 
+    return accumulator;
+}
+
+/**
+ * \brief FIR filter kernel function.
+ * \param[in] input Input image data in row-major format.
+ * \param[in] width Width of the image passed in as input.
+ * \param[out] output Output image after FIR has been applied. Resulting image depends on the coefficients used.
+ */
+__kernel void fir_float(__global const float* restrict input,
+                        __global float* restrict output,
+                        const int width)
+{
+    /* [Kernel size] */
+    /*
+     * Each kernel calculates 4 output pixels in the same row (hence the '* 4').
+     * column is in the range [0, width] in steps of 4.
+     * row is in the range [0, height].
+     */
+    const int column = get_global_id(0) * 4;
+    const int row = get_global_id(1);
+    /* Offset calculates the position in the linear data for the row and the column. */
+    const int offset = row * width + column;
+    /* [Kernel size] */
+
+    const float4 accumulator = firBlock(input, width, offset);
+
     /* [Store] */
     /* Store the accumulator. */
     vstore4(accumulator, 0, output + offset);
     /* [Store] */
-}
\ No newline at end of file
+}
+
+/**
+ * \brief FIR filter kernel function for a batch of images packed into one buffer.
+ * \details The third dimension of the NDRange is the index of the image. The first two cover the largest image in the batch.
+ *          Only the pixels whose whole 6x3 window lies inside their image are written, so the reads never cross into the next image:
+ *          the last 2 rows and the last (partial) blocks of 4 columns of each output image are left untouched.
+ * \param[in] inputImages The images, one after the other, each in row-major format. The widths must be multiples of 4.
+ * \param[in] images Offset of the first pixel, width and height of each image.
+ * \param[out] outputImages Output images after FIR has been applied, with the same layout as inputImages.
+ */
+__kernel void fir_float_batched(__global const float* restrict inputImages,
+                                __global const int4* restrict images,
+                                __global float* restrict outputImages)
+{
+    /* [Batch index] */
+    const int4 image = images[get_global_id(2)];
+    const int width = image.y;
+    const int height = image.z;
+    /* [Batch index] */
+
+    const int column = get_global_id(0) * 4;
+    const int row = get_global_id(1);
+    if (column + 6 > width || row + 3 > height)
+    {
+        return;
+    }
+
+    const int offset = image.x + row * width + column;
+    vstore4(firBlock(inputImages, width, offset), 0, outputImages + offset);
+}
@@ -8,8 +8,11 @@
  * by a licensing agreement from ARM Limited.
  */
 
+#include "batch.h"
 #include "common.h"
 #include "image.h"
+#include "pipeline.h"
+#include "trace.h"
 
 #include <CL/cl.h>
 #include <iostream>
@@ -17,14 +20,333 @@
 #include <sstream>
 #include <cstddef>
 #include <cmath>
+#include <vector>
+#include <algorithm>
+#include <sys/time.h>
 
 using namespace std;
 
+/* Number of frames streamed through the pipeline after the single run. */
+const int numberOfFrames = 60;
+
+/* Number of thumbnails filtered one by one and then in one batched launch. */
+const int numberOfThumbnails = 64;
+
+/**
+ * \brief State shared by the callbacks of the FIR filter pipeline.
+ */
+struct FirStream
+{
+    const unsigned char* rgbData; /**< \brief The input frame, converted for every frame as a camera frame would be. */
+    unsigned char* luminance; /**< \brief Scratch space for the luminance of a frame. */
+    cl_int width; /**< \brief Width of the frames. */
+    cl_int height; /**< \brief Height of the frames. */
+    const unsigned char* reference; /**< \brief Output of the single run, to check every frame against. */
+    int mismatchedFrames; /**< \brief Number of frames which differ from the single run. */
+    cl_ulong firstStart; /**< \brief Start time of the kernel of the first frame. */
+    cl_ulong lastEnd; /**< \brief End time of the kernel of the last consumed frame. */
+};
+
+/**
+ * \brief Convert the RGB frame to normalized floats in the mapped input buffer of the pipeline.
+ * \details Runs on the host while the kernels of the previous frames run on the device.
+ * \return False if an error occurred, otherwise true.
+ */
+bool prepareFirFrame(void* userData, int frame, void* const* inputs)
+{
+    FirStream* stream = (FirStream*)userData;
+    cl_float* inputImageData = (cl_float*)inputs[0];
+
+    return RGBToLuminance(stream->rgbData, stream->luminance, stream->width, stream->height) &&
+           luminanceToFloat(stream->luminance, inputImageData, stream->width, stream->height);
+}
+
+/**
+ * \brief Check the output of a frame against the single run and record the kernel times.
+ * \return False if an error occurred, otherwise true.
+ */
+bool consumeFirFrame(void* userData, int frame, void* const* outputs, cl_event kernelEvent)
+{
+    FirStream* stream = (FirStream*)userData;
+    const cl_float* output = (const cl_float*)outputs[0];
+
+    for (int i = 0; i < stream->width * stream->height; i++)
+    {
+        if ((unsigned char)(output[i] * 255.0f) != stream->reference[i])
+        {
+            stream->mismatchedFrames++;
+            break;
+        }
+    }
+
+    bool returnValue = true;
+    if (frame == 0)
+    {
+        returnValue &= checkSuccess(clGetEventProfilingInfo(kernelEvent, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &stream->firstStart, NULL));
+    }
+    returnValue &= checkSuccess(clGetEventProfilingInfo(kernelEvent, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &stream->lastEnd, NULL));
+    return returnValue;
+}
+
+/**
+ * \brief Stream frames through the FIR filter kernel with a triple-buffered pipeline.
+ * \details The program, the kernels and the buffers are created once. For every frame, the host conversion to floats
+ *          overlaps with the kernels of the previous frames and the non-blocking readback of the frames before them.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] device The OpenCL device to build the kernel for.
+ * \param[in] commandQueue The in-order command queue to use.
+ * \param[in] stream The frame and the result of the single run.
+ * \return False if an error occurred, otherwise true.
+ */
+bool runFirPipeline(cl_context context, cl_device_id device, cl_command_queue commandQueue, FirStream* stream)
+{
+    const size_t bufferSize = stream->width * stream->height * sizeof(cl_float);
+
+    /* [Describe the pipeline] */
+    PipelineDescription description;
+    description.filename = "assets/fir_float.cl";
+    description.kernelName = "fir_float";
+    description.depth = 3;
+    description.numberOfInputs = 1;
+    description.inputSizes[0] = bufferSize;
+    description.inputArguments[0] = 0;
+    description.numberOfOutputs = 1;
+    description.outputSizes[0] = bufferSize;
+    description.outputArguments[0] = 1;
+    description.workDimensions = 2;
+    description.globalWorksize[0] = (size_t)stream->width / 4;
+    description.globalWorksize[1] = (size_t)stream->height;
+    description.prepare = prepareFirFrame;
+    description.consume = consumeFirFrame;
+    description.userData = stream;
+    /* [Describe the pipeline] */
+
+    Pipeline pipeline;
+    if (!createPipeline(context, device, commandQueue, &description, &pipeline))
+    {
+        cerr << "Failed to create the FIR filter pipeline. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    bool pipelineSuccess = setPipelineKernelArgument(&pipeline, 2, sizeof(cl_int), &stream->width);
+
+    /* [Stream the frames] */
+    for (int frame = 0; pipelineSuccess && frame < numberOfFrames; frame++)
+    {
+        pipelineSuccess &= submitPipelineFrame(&pipeline);
+    }
+    pipelineSuccess = pipelineSuccess && finishPipeline(&pipeline);
+    /* [Stream the frames] */
+
+    pipelineSuccess &= releasePipeline(&pipeline);
+    if (!pipelineSuccess)
+    {
+        cerr << "Failed streaming frames through the FIR filter pipeline. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    const double frameTime = (double)(stream->lastEnd - stream->firstStart) / numberOfFrames / 1000000.0;
+    cout << "Streamed " << numberOfFrames << " frames: " << frameTime << " ms per frame on the device";
+    if (frameTime > 0.0)
+    {
+        cout << " (" << 1000.0 / frameTime << " frames per second)";
+    }
+    cout << ", " << stream->mismatchedFrames << " frames differ from the single run." << endl;
+    return true;
+}
+
+/**
+ * \brief Filter many thumbnails, once with a launch per thumbnail and once with a single batched launch.
+ * \details Small images don't give the device enough work to hide the cost of a launch.
+ *          The thumbnails are packed into one buffer (see batch.h) and fir_float_batched filters all of them in one 3D NDRange,
+ *          with get_global_id(2) as the thumbnail index.
+ *          Both runs only filter the pixels whose 6x3 window lies inside the thumbnail, and their results are compared.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] commandQueue The in-order command queue to use, with profiling enabled.
+ * \param[in] program The program holding the fir_float and fir_float_batched kernels.
+ * \param[in] kernel The fir_float kernel. Its arguments are changed.
+ * \param[in] luminance The frame the thumbnails are cropped from.
+ * \param[in] width Width of the frame.
+ * \param[in] height Height of the frame.
+ * \return False if an error occurred, otherwise true.
+ */
+bool runFirThumbnails(cl_context context, cl_command_queue commandQueue, cl_program program, cl_kernel kernel,
+                      const unsigned char* luminance, cl_int width, cl_int height)
+{
+    cl_int errorNumber = CL_SUCCESS;
+
+    /* [Pack the thumbnails] */
+    /* Crops of a few small sizes from across the frame stand in for the thumbnails. Widths are multiples of 4, the pixels per work-item. */
+    const cl_int thumbnailSizes[4][2] = {{48, 32}, {64, 48}, {32, 32}, {80, 64}};
+    ImageBatch batch;
+    initializeImageBatch(&batch);
+    vector<float> packedImages;
+    for (int index = 0; index < numberOfThumbnails; index++)
+    {
+        const cl_int thumbnailWidth = min(thumbnailSizes[index % 4][0], width & ~3);
+        const cl_int thumbnailHeight = min(thumbnailSizes[index % 4][1], height);
+        const cl_int left = (index * 37) % (width - thumbnailWidth + 1);
+        const cl_int top = (index * 23) % (height - thumbnailHeight + 1);
+        addImageToBatch(&batch, thumbnailWidth, thumbnailHeight);
+        for (cl_int row = 0; row < thumbnailHeight; row++)
+        {
+            for (cl_int column = 0; column < thumbnailWidth; column++)
+            {
+                packedImages.push_back((float)luminance[(size_t)(top + row) * width + left + column] / 255.0f);
+            }
+        }
+    }
+    const size_t batchSize = batch.elements * sizeof(cl_float);
+    /* [Pack the thumbnails] */
+
+    vector<cl_mem> memoryObjects;
+    vector<cl_event> events;
+    bool thumbnailSuccess = true;
+
+    /* [One launch per thumbnail] */
+    vector<float> singleOutput(batch.elements);
+    timeval start;
+    timeval end;
+    gettimeofday(&start, NULL);
+    for (size_t index = 0; thumbnailSuccess && index < batch.numberOfImages; index++)
+    {
+        const size_t offset = getBatchImageOffset(&batch, index);
+        cl_int thumbnailWidth = batch.table[index * 4 + 1];
+        const cl_int thumbnailHeight = batch.table[index * 4 + 2];
+        const size_t thumbnailSize = (size_t)thumbnailWidth * thumbnailHeight * sizeof(cl_float);
+
+        cl_mem input = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, thumbnailSize, &packedImages[offset], &errorNumber);
+        thumbnailSuccess &= checkSuccess(errorNumber);
+        cl_mem output = clCreateBuffer(context, CL_MEM_WRITE_ONLY, thumbnailSize, NULL, &errorNumber);
+        thumbnailSuccess &= checkSuccess(errorNumber);
+        memoryObjects.push_back(input);
+        memoryObjects.push_back(output);
+
+        thumbnailSuccess = thumbnailSuccess && checkSuccess(clSetKernelArg(kernel, 0, sizeof(cl_mem), &input));
+        thumbnailSuccess = thumbnailSuccess && checkSuccess(clSetKernelArg(kernel, 1, sizeof(cl_mem), &output));
+        thumbnailSuccess = thumbnailSuccess && checkSuccess(clSetKernelArg(kernel, 2, sizeof(cl_int), &thumbnailWidth));
+
+        /* Leave out the last column of work-items and the last two rows, whose windows would read past the end of the thumbnail. */
+        cl_event event = 0;
+        size_t globalWorksize[2] = {(size_t)thumbnailWidth / 4 - 1, (size_t)thumbnailHeight - 2};
+        thumbnailSuccess = thumbnailSuccess && checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernel, 2, NULL, globalWorksize, NULL, 0, NULL, &event));
+        if (thumbnailSuccess)
+        {
+            events.push_back(event);
+            traceKernel(event, kernel, 2, globalWorksize, NULL);
+            cl_event readEvent = 0;
+            thumbnailSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, output, CL_FALSE, 0, thumbnailSize, &singleOutput[offset], 0, NULL, traceEvent(&readEvent)));
+            traceAndReleaseCommand(readEvent, "read thumbnail", thumbnailSize);
+        }
+    }
+    thumbnailSuccess = thumbnailSuccess && checkSuccess(clFinish(commandQueue));
+    gettimeofday(&end, NULL);
+    const double singleHostTime = millisecondsBetween(start, end);
+
+    double singleDeviceTime = 0.0;
+    for (size_t index = 0; thumbnailSuccess && index < events.size(); index++)
+    {
+        thumbnailSuccess &= addKernelMilliseconds(events[index], &singleDeviceTime);
+    }
+    thumbnailSuccess &= releaseBatchObjects(memoryObjects, events);
+    /* [One launch per thumbnail] */
+
+    if (!thumbnailSuccess)
+    {
+        cerr << "Failed filtering the thumbnails one by one. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* [One batched launch] */
+    cl_kernel batchedKernel = clCreateKernel(program, "fir_float_batched", &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        cerr << "Failed to create the batched FIR filter kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    vector<float> batchedOutput(batch.elements);
+    gettimeofday(&start, NULL);
+    cl_mem inputImages = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, batchSize, &packedImages[0], &errorNumber);
+    thumbnailSuccess &= checkSuccess(errorNumber);
+    cl_mem outputImages = clCreateBuffer(context, CL_MEM_WRITE_ONLY, batchSize, NULL, &errorNumber);
+    thumbnailSuccess &= checkSuccess(errorNumber);
+    cl_mem images = NULL;
+    thumbnailSuccess = thumbnailSuccess && createImageBatchTable(context, &batch, &images);
+    memoryObjects.push_back(inputImages);
+    memoryObjects.push_back(outputImages);
+    if (images != NULL)
+    {
+        memoryObjects.push_back(images);
+    }
+
+    thumbnailSuccess = thumbnailSuccess && checkSuccess(clSetKernelArg(batchedKernel, 0, sizeof(cl_mem), &inputImages));
+    thumbnailSuccess = thumbnailSuccess && checkSuccess(clSetKernelArg(batchedKernel, 1, sizeof(cl_mem), &images));
+    thumbnailSuccess = thumbnailSuccess && checkSuccess(clSetKernelArg(batchedKernel, 2, sizeof(cl_mem), &outputImages));
+
+    /* The first two dimensions cover the largest thumbnail, the third is the thumbnail index. */
+    size_t batchWorksize[3];
+    getImageBatchWorksize(&batch, 4, batchWorksize);
+    cl_event event = 0;
+    thumbnailSuccess = thumbnailSuccess && checkSuccess(clEnqueueNDRangeKernel(commandQueue, batchedKernel, 3, NULL, batchWorksize, NULL, 0, NULL, &event));
+    if (thumbnailSuccess)
+    {
+        events.push_back(event);
+        traceKernel(event, batchedKernel, 3, batchWorksize, NULL);
+        cl_event readEvent = 0;
+        thumbnailSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, outputImages, CL_FALSE, 0, batchSize, &batchedOutput[0], 0, NULL, traceEvent(&readEvent)));
+        traceAndReleaseCommand(readEvent, "read batch", batchSize);
+    }
+    thumbnailSuccess = thumbnailSuccess && checkSuccess(clFinish(commandQueue));
+    gettimeofday(&end, NULL);
+    const double batchedHostTime = millisecondsBetween(start, end);
+
+    double batchedDeviceTime = 0.0;
+    if (thumbnailSuccess)
+    {
+        thumbnailSuccess &= addKernelMilliseconds(event, &batchedDeviceTime);
+    }
+    thumbnailSuccess &= releaseBatchObjects(memoryObjects, events);
+    thumbnailSuccess &= checkSuccess(clReleaseKernel(batchedKernel));
+    /* [One batched launch] */
+
+    if (!thumbnailSuccess)
+    {
+        cerr << "Failed filtering the batch of thumbnails. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* Only the pixels both runs filtered are compared. */
+    bool match = true;
+    for (size_t index = 0; match && index < batch.numberOfImages; index++)
+    {
+        const size_t offset = getBatchImageOffset(&batch, index);
+        const cl_int thumbnailWidth = batch.table[index * 4 + 1];
+        const cl_int thumbnailHeight = batch.table[index * 4 + 2];
+        for (cl_int row = 0; match && row + 3 <= thumbnailHeight; row++)
+        {
+            for (cl_int column = 0; match && column + 6 <= thumbnailWidth; column++)
+            {
+                const size_t pixel = offset + (size_t)row * thumbnailWidth + column;
+                match = singleOutput[pixel] == batchedOutput[pixel];
+            }
+        }
+    }
+
+    cout << "Filtered " << batch.numberOfImages << " thumbnails one by one: " << singleDeviceTime << " ms on the device, " << singleHostTime << " ms on the host\n";
+    cout << "Filtered them in one batched launch: " << batchedDeviceTime << " ms on the device, " << batchedHostTime << " ms on the host, "
+         << (match ? "same results." : "results differ.") << endl;
+    return true;
+}
+
 /**
  * \brief Simple FIR filter OpenCL sample.
  * \details A sample which loads an image from assets/input.bmp and then passes it to the GPU.
  *          An OpenCL kernel applies FIR filtering on the data and
  *          the output image data is stored in output.bmp on the target.
+ *          The same frame is then streamed numberOfFrames times through a triple-buffered pipeline (see pipeline.h),
+ *          as a camera application would, and every frame is checked against the single run.
+ *          Finally, small crops of the frame are filtered as thumbnails, once with a launch each and once all in one batched launch.
  * \return The exit code of the application, non-zero if a problem occurred.
  */
 int main(void)
@@ -84,7 +406,6 @@ int main(void)
     /* Convert 24-bits per pixel RGB into 8-bits per pixel luminance data. */
     unsigned char* inputLuminance = new unsigned char [width * height];
     RGBToLuminance(loadedRGBData, inputLuminance, width, height);
-    delete [] loadedRGBData;
 
     /* All buffers are the size of the image data. */
     size_t bufferSize = width * height * sizeof(float);
@@ -102,8 +423,10 @@ int main(void)
         return 1;
     }
 
-    /* Map the input memory object to a host side pointer. */
-    cl_float* inputImageData = (cl_float*)clEnqueueMapBuffer(commandQueue, memoryObjects[0], CL_TRUE, CL_MAP_WRITE, 0, bufferSize, 0, NULL, NULL, &errorNumber);
+    /* Map the input memory object to a host side pointer. Commands are recorded on the timeline when tracing is enabled (CL_TRACE_FILE). */
+    cl_event mapEvent = 0;
+    cl_float* inputImageData = (cl_float*)clEnqueueMapBuffer(commandQueue, memoryObjects[0], CL_TRUE, CL_MAP_WRITE, 0, bufferSize, 0, NULL, traceEvent(&mapEvent), &errorNumber);
+    traceAndReleaseCommand(mapEvent, "map input", bufferSize);
     if (!checkSuccess(errorNumber))
     {
        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
@@ -112,15 +435,13 @@ int main(void)
     }
 
     /* Converting luminance data into float. A real world application would use real floating point data.*/
-    for(int i = 0; i < width * height; i++)
-    {
-        inputImageData[i] = (float)inputLuminance[i] / 255.0f;
-    }
-
-    delete [] inputLuminance;
+    luminanceToFloat(inputLuminance, inputImageData, width, height);
 
     /* Unmap the memory so we can pass it to the kernel. */
-    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[0], inputImageData, 0, NULL, NULL)))
+    cl_event unmapEvent = 0;
+    bool unmapInputSuccess = checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[0], inputImageData, 0, NULL, traceEvent(&unmapEvent)));
+    traceAndReleaseCommand(unmapEvent, "unmap input", bufferSize);
+    if (!unmapInputSuccess)
     {
        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
        cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
@@ -157,6 +478,7 @@ int main(void)
         cerr << "Failed enqueuing the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
+    traceKernel(event, kernel, 2, globalWorksize, NULL);
 
     /* Wait for kernel execution completion. */
     if (!checkSuccess(clFinish(commandQueue)))
@@ -177,7 +499,8 @@ int main(void)
     }
 
     /* Map the output memory to a host side pointer. */
-    cl_float* output = (cl_float*)clEnqueueMapBuffer(commandQueue, memoryObjects[1], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, NULL, &errorNumber);
+    cl_float* output = (cl_float*)clEnqueueMapBuffer(commandQueue, memoryObjects[1], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, traceEvent(&mapEvent), &errorNumber);
+    traceAndReleaseCommand(mapEvent, "map output", bufferSize);
     if (!checkSuccess(errorNumber))
     {
        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
@@ -187,19 +510,40 @@ int main(void)
 
     /* Convert the float output to unsigned char for saving to bitmap. */
     unsigned char *outputData= new unsigned char[width * height];
-    for(int i = 0; i< width * height; i++)
-    {
-        outputData[i] = (unsigned char)(output[i] * 255.0f);
-    }
+    floatToLuminance(output, outputData, width, height);
 
     /* Unmap the output. */
-    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[1], output, 0, NULL, NULL)))
+    bool unmapOutputSuccess = checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[1], output, 0, NULL, traceEvent(&unmapEvent)));
+    traceAndReleaseCommand(unmapEvent, "unmap output", bufferSize);
+    if (!unmapOutputSuccess)
     {
        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
        cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
        return 1;
     }
 
+    /* [Run the pipeline] */
+    FirStream stream = {loadedRGBData, inputLuminance, width, height, outputData, 0, 0, 0};
+    if (!runFirPipeline(context, device, commandQueue, &stream))
+    {
+       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+       cerr << "Running the FIR filter pipeline failed " << __FILE__ << ":"<< __LINE__ << endl;
+       return 1;
+    }
+    /* [Run the pipeline] */
+
+    /* [Batched thumbnails] */
+    if (!runFirThumbnails(context, commandQueue, program, kernel, inputLuminance, width, height))
+    {
+       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+       cerr << "Filtering the thumbnails failed " << __FILE__ << ":"<< __LINE__ << endl;
+       return 1;
+    }
+    /* [Batched thumbnails] */
+
+    delete [] loadedRGBData;
+    delete [] inputLuminance;
+
     /* Release OpenCL objects. */
     cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
 
@@ -0,0 +1,87 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+/*
+ * Element-wise kernel.
+ * A generalization of the int4 addition in hello_world_vector.cl to any type, vector width and array size.
+ * The operation and the types are chosen when the program is built (see createElementwiseKernel in elementwise.cpp):
+ * - TYPE: scalar type of the arrays, int or float.
+ * - VEC: number of elements per work-item, 1, 2, 4, 8 or 16. Normally the preferred vector width of the device.
+ * - NUMBER_OF_INPUTS: number of input arrays read by EXPRESSION, 1 to 3.
+ * - EXPRESSION: the fused chain of operations, in terms of the inputs a, b and c and the scalar alpha.
+ *   It is evaluated on vectors of VEC elements, and on single elements at the end of the arrays.
+ */
+
+#define CONCATENATE_EXPANDED(a, b) a##b
+#define CONCATENATE(a, b) CONCATENATE_EXPANDED(a, b)
+
+/* [Vector width] */
+#if VEC == 1
+    #define VECTOR_TYPE TYPE
+    #define LOAD(index, pointer) ((pointer)[index])
+    #define STORE(value, index, pointer) ((pointer)[index] = (value))
+#else
+    #define VECTOR_TYPE CONCATENATE(TYPE, VEC)
+    #define LOAD(index, pointer) CONCATENATE(vload, VEC)(index, pointer)
+    #define STORE(value, index, pointer) CONCATENATE(vstore, VEC)(value, index, pointer)
+#endif
+/* [Vector width] */
+
+/**
+ * \brief Element-wise kernel function.
+ * \details Each work-item evaluates EXPRESSION for VEC consecutive elements with vector loads and stores.
+ *          When the count is not a multiple of VEC, the last work-item evaluates the remaining elements one at a time.
+ * \param[in] inputA First input array.
+ * \param[in] inputB Second input array. Only read if NUMBER_OF_INPUTS is at least 2.
+ * \param[in] inputC Third input array. Only read if NUMBER_OF_INPUTS is 3.
+ * \param[in] alpha Scalar used by saxpy.
+ * \param[out] output Output array.
+ * \param[in] count Number of elements in the arrays.
+ */
+__kernel void elementwise(__global const TYPE* restrict inputA,
+                          __global const TYPE* restrict inputB,
+                          __global const TYPE* restrict inputC,
+                          const TYPE alpha,
+                          __global TYPE* restrict output,
+                          const int count)
+{
+    const int i = get_global_id(0);
+    const int first = i * VEC;
+
+    /* [Vector path] */
+    if (first + VEC <= count)
+    {
+        const VECTOR_TYPE a = LOAD(i, inputA);
+#if NUMBER_OF_INPUTS > 1
+        const VECTOR_TYPE b = LOAD(i, inputB);
+#endif
+#if NUMBER_OF_INPUTS > 2
+        const VECTOR_TYPE c = LOAD(i, inputC);
+#endif
+        STORE(EXPRESSION, i, output);
+    }
+    /* [Vector path] */
+    /* [Tail] */
+    else
+    {
+        for (int index = first; index < count; index++)
+        {
+            const TYPE a = inputA[index];
+#if NUMBER_OF_INPUTS > 1
+            const TYPE b = inputB[index];
+#endif
+#if NUMBER_OF_INPUTS > 2
+            const TYPE c = inputC[index];
+#endif
+            output[index] = EXPRESSION;
+        }
+    }
+    /* [Tail] */
+}
@@ -0,0 +1,249 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "elementwise.h"
+#include "common.h"
+#include "device.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+/* Widest vector type in OpenCL C. */
+static const cl_uint maximumVectorWidth = 16;
+
+/**
+ * \brief OpenCL C name of an element-wise type.
+ * \param[in] type The type.
+ * \return The name of the type.
+ */
+static const char* elementwiseTypeName(ElementwiseType type)
+{
+    return type == ELEMENTWISE_TYPE_INT ? "int" : "float";
+}
+
+/**
+ * \brief OpenCL C expression for an operand of a step.
+ * \param[in] operand The operand.
+ * \param[in] previous Expression of the previous step.
+ * \return The expression.
+ */
+static string operandExpression(ElementwiseOperand operand, const string& previous)
+{
+    switch (operand)
+    {
+        case ELEMENTWISE_INPUT_A: return "a";
+        case ELEMENTWISE_INPUT_B: return "b";
+        case ELEMENTWISE_INPUT_C: return "c";
+        default: return previous;
+    }
+}
+
+/**
+ * \brief Fuse a chain of steps into a single OpenCL C expression.
+ * \details Each step is substituted into the next wherever it uses ELEMENTWISE_PREVIOUS, so the intermediate
+ *          results stay in registers. The expression has no spaces, so it can be passed as a build option.
+ * \param[in] type Type of the arrays.
+ * \param[in] steps The chain of operations.
+ * \param[in] numberOfSteps Number of steps in the chain.
+ * \param[out] expression The fused expression.
+ * \param[out] numberOfInputs Number of input arrays the expression reads (the highest input used, plus one).
+ * \return False if the chain is not valid, otherwise true.
+ */
+static bool fuseElementwiseSteps(ElementwiseType type, const ElementwiseStep* steps, int numberOfSteps, string* expression, int* numberOfInputs)
+{
+    string previous;
+    *numberOfInputs = 1;
+
+    for (int index = 0; index < numberOfSteps; index++)
+    {
+        const ElementwiseStep& step = steps[index];
+        const int numberOfOperands = step.operation == ELEMENTWISE_FMA ? 3 : 2;
+
+        string operands[3];
+        for (int operand = 0; operand < numberOfOperands; operand++)
+        {
+            if (step.operands[operand] == ELEMENTWISE_PREVIOUS && index == 0)
+            {
+                cerr << "The first step of an element-wise chain cannot use the previous result. " << __FILE__ << ":"<< __LINE__ << endl;
+                return false;
+            }
+            if (step.operands[operand] != ELEMENTWISE_PREVIOUS && step.operands[operand] + 1 > *numberOfInputs)
+            {
+                *numberOfInputs = step.operands[operand] + 1;
+            }
+            operands[operand] = operandExpression(step.operands[operand], previous);
+        }
+
+        /* [Operations] */
+        ostringstream current;
+        switch (step.operation)
+        {
+            case ELEMENTWISE_ADD:
+                current << "(" << operands[0] << "+" << operands[1] << ")";
+                break;
+            case ELEMENTWISE_MUL:
+                current << "(" << operands[0] << "*" << operands[1] << ")";
+                break;
+            case ELEMENTWISE_FMA:
+                /* The fma built-in is only defined for floating point types. */
+                if (type == ELEMENTWISE_TYPE_FLOAT)
+                {
+                    current << "fma(" << operands[0] << "," << operands[1] << "," << operands[2] << ")";
+                }
+                else
+                {
+                    current << "(" << operands[0] << "*" << operands[1] << "+" << operands[2] << ")";
+                }
+                break;
+            default:
+                current << "(alpha*" << operands[0] << "+" << operands[1] << ")";
+                break;
+        }
+        /* [Operations] */
+        previous = current.str();
+    }
+
+    *expression = previous;
+    return true;
+}
+
+bool releaseElementwiseKernel(ElementwiseKernel* elementwiseKernel)
+{
+    bool returnValue = true;
+    if (elementwiseKernel->kernel != 0)
+    {
+        returnValue &= checkSuccess(clReleaseKernel(elementwiseKernel->kernel));
+        elementwiseKernel->kernel = 0;
+    }
+    if (elementwiseKernel->program != 0)
+    {
+        returnValue &= checkSuccess(clReleaseProgram(elementwiseKernel->program));
+        elementwiseKernel->program = 0;
+    }
+    return returnValue;
+}
+
+bool createElementwiseKernel(cl_context context, cl_device_id device, ElementwiseType type, const ElementwiseStep* steps, int numberOfSteps,
+                             cl_uint vectorWidth, ElementwiseKernel* elementwiseKernel)
+{
+    cl_int errorNumber = 0;
+
+    elementwiseKernel->program = 0;
+    elementwiseKernel->kernel = 0;
+    elementwiseKernel->type = type;
+
+    if (numberOfSteps < 1)
+    {
+        cerr << "An element-wise chain needs at least one step. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    int numberOfInputs = 1;
+    if (!fuseElementwiseSteps(type, steps, numberOfSteps, &elementwiseKernel->expression, &numberOfInputs))
+    {
+        return false;
+    }
+
+    /* [Query preferred vector width] */
+    /*
+     * Query the device to find out its preferred vector width for the type.
+     * Vector types only exist for widths 1, 2, 3, 4, 8 and 16, so other values are rounded down to a power of 2.
+     */
+    if (vectorWidth == 0)
+    {
+        const DeviceInfo* deviceInfo = NULL;
+        if (!getDeviceInfo(device, &deviceInfo))
+        {
+            cerr << "Failed to query the preferred vector width. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+        vectorWidth = (type == ELEMENTWISE_TYPE_INT) ? deviceInfo->preferredVectorWidthInt : deviceInfo->preferredVectorWidthFloat;
+    }
+    elementwiseKernel->vectorWidth = 1;
+    while (elementwiseKernel->vectorWidth * 2 <= vectorWidth && elementwiseKernel->vectorWidth * 2 <= maximumVectorWidth)
+    {
+        elementwiseKernel->vectorWidth *= 2;
+    }
+    /* [Query preferred vector width] */
+
+    /* [Build options] */
+    ostringstream buildOptions;
+    buildOptions << "-DTYPE=" << elementwiseTypeName(type)
+                 << " -DVEC=" << elementwiseKernel->vectorWidth
+                 << " -DNUMBER_OF_INPUTS=" << numberOfInputs
+                 << " -DEXPRESSION=" << elementwiseKernel->expression;
+    /* [Build options] */
+
+    if (!createProgram(context, device, "assets/elementwise.cl", &elementwiseKernel->program, buildOptions.str()))
+    {
+        elementwiseKernel->program = 0;
+        cerr << "Failed to create the element-wise program. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    elementwiseKernel->kernel = clCreateKernel(elementwiseKernel->program, "elementwise", &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        releaseElementwiseKernel(elementwiseKernel);
+        cerr << "Failed to create the element-wise kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool enqueueElementwiseKernel(cl_command_queue commandQueue, ElementwiseKernel* elementwiseKernel, const cl_mem inputs[3], cl_mem output, cl_int count,
+                              float alpha, cl_event* event)
+{
+    if (count < 1)
+    {
+        cerr << "The element-wise arrays must not be empty. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* The scalar argument has the type of the arrays. */
+    const cl_int integerAlpha = (cl_int)alpha;
+    const cl_float floatAlpha = alpha;
+
+    bool setKernelArgumentsSuccess = true;
+    for (int index = 0; index < 3; index++)
+    {
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(elementwiseKernel->kernel, index, sizeof(cl_mem), &inputs[index]));
+    }
+    if (elementwiseKernel->type == ELEMENTWISE_TYPE_INT)
+    {
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(elementwiseKernel->kernel, 3, sizeof(cl_int), &integerAlpha));
+    }
+    else
+    {
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(elementwiseKernel->kernel, 3, sizeof(cl_float), &floatAlpha));
+    }
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(elementwiseKernel->kernel, 4, sizeof(cl_mem), &output));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(elementwiseKernel->kernel, 5, sizeof(cl_int), &count));
+    if (!setKernelArgumentsSuccess)
+    {
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* [Global work size] */
+    /* One work-item per vector, rounded up so the last work-item handles the tail of the arrays. */
+    size_t globalWorksize[1] = {((size_t)count + elementwiseKernel->vectorWidth - 1) / elementwiseKernel->vectorWidth};
+    /* [Global work size] */
+    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, elementwiseKernel->kernel, 1, NULL, globalWorksize, NULL, 0, NULL, event)))
+    {
+        cerr << "Failed enqueuing the element-wise kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,113 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef ELEMENTWISE_H
+#define ELEMENTWISE_H
+
+#include <CL/cl.h>
+#include <string>
+
+/**
+ * \file elementwise.h
+ * \brief Element-wise array kernels built for the preferred vector width of the device, with chains of operations fused into one kernel.
+ */
+
+/**
+ * \brief Operations supported by the element-wise kernels.
+ */
+enum ElementwiseOperator
+{
+    ELEMENTWISE_ADD, /**< \brief x + y. */
+    ELEMENTWISE_MUL, /**< \brief x * y. */
+    ELEMENTWISE_FMA, /**< \brief x * y + z. Fused (a single rounding) for floats. */
+    ELEMENTWISE_SAXPY /**< \brief alpha * x + y, where alpha is a scalar argument of the kernel. */
+};
+
+/**
+ * \brief Operands of an element-wise operation.
+ */
+enum ElementwiseOperand
+{
+    ELEMENTWISE_INPUT_A = 0, /**< \brief The first input array. */
+    ELEMENTWISE_INPUT_B = 1, /**< \brief The second input array. */
+    ELEMENTWISE_INPUT_C = 2, /**< \brief The third input array. */
+    ELEMENTWISE_PREVIOUS = 3 /**< \brief The result of the previous step of the chain. */
+};
+
+/**
+ * \brief Scalar types of the arrays.
+ */
+enum ElementwiseType
+{
+    ELEMENTWISE_TYPE_INT,
+    ELEMENTWISE_TYPE_FLOAT
+};
+
+/**
+ * \brief One step of a chain of element-wise operations.
+ * \details Only the operands used by the operation are read: two for add, mul and saxpy, three for fma.
+ */
+struct ElementwiseStep
+{
+    ElementwiseOperator operation; /**< \brief The operation. */
+    ElementwiseOperand operands[3]; /**< \brief x, y and z of the operation. */
+};
+
+/**
+ * \brief A chain of element-wise operations compiled into a single kernel.
+ */
+struct ElementwiseKernel
+{
+    cl_program program; /**< \brief assets/elementwise.cl built for the chain, type and vector width. */
+    cl_kernel kernel; /**< \brief The elementwise kernel. */
+    ElementwiseType type; /**< \brief Type of the arrays. */
+    cl_uint vectorWidth; /**< \brief Number of elements each work-item processes with vector loads and stores. */
+    std::string expression; /**< \brief The fused OpenCL C expression, for information. */
+};
+
+/**
+ * \brief Build a kernel which evaluates a chain of element-wise operations.
+ * \details The steps are fused into one expression, so the kernel reads each input and writes the output once,
+ *          however long the chain is. The first step must not use ELEMENTWISE_PREVIOUS.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] device The OpenCL device to build the kernel for.
+ * \param[in] type Type of the arrays.
+ * \param[in] steps The chain of operations, evaluated in order.
+ * \param[in] numberOfSteps Number of steps in the chain.
+ * \param[in] vectorWidth Elements per work-item: 1, 2, 4, 8 or 16. Zero selects the preferred vector width of the device for the type.
+ * \param[out] elementwiseKernel The created kernel. Must be released with releaseElementwiseKernel.
+ * \return False if an error occurred, otherwise true.
+ */
+bool createElementwiseKernel(cl_context context, cl_device_id device, ElementwiseType type, const ElementwiseStep* steps, int numberOfSteps,
+                             cl_uint vectorWidth, ElementwiseKernel* elementwiseKernel);
+
+/**
+ * \brief Enqueue an element-wise kernel.
+ * \details Any count is supported: the work-item at the end of the arrays handles the elements after the last whole vector.
+ * \param[in] commandQueue The command queue to use.
+ * \param[in] elementwiseKernel The kernel to run.
+ * \param[in] inputs The three input arrays. Inputs which are not used by the chain may be 0.
+ * \param[out] output The output array. Must not be one of the inputs.
+ * \param[in] count Number of elements in the arrays.
+ * \param[in] alpha Scalar for ELEMENTWISE_SAXPY, converted to the type of the arrays.
+ * \param[out] event Event of the kernel, may be NULL. Must be released by the caller.
+ * \return False if an error occurred, otherwise true.
+ */
+bool enqueueElementwiseKernel(cl_command_queue commandQueue, ElementwiseKernel* elementwiseKernel, const cl_mem inputs[3], cl_mem output, cl_int count,
+                              float alpha, cl_event* event);
+
+/**
+ * \brief Release the OpenCL objects of an element-wise kernel.
+ * \param[in] elementwiseKernel The kernel to release.
+ * \return False if an error occurred, otherwise true.
+ */
+bool releaseElementwiseKernel(ElementwiseKernel* elementwiseKernel);
+
+#endif
@@ -10,75 +10,126 @@
 
 #include "common.h"
 #include "image.h"
+#include "elementwise.h"
 
 #include <CL/cl.h>
 #include <iostream>
+#include <cmath>
 
 using namespace std;
 
+/**
+ * \brief Number of element-wise kernels used by the sample: the integer addition, the fused chain and the two unfused steps of the chain.
+ */
+const int numberOfElementwiseKernels = 4;
+
+/**
+ * \brief Release the element-wise kernels and the other OpenCL objects used by the sample.
+ * \param[in] context The OpenCL context to release.
+ * \param[in] commandQueue The OpenCL command queue to release.
+ * \param[in] elementwiseKernels The numberOfElementwiseKernels kernels to release.
+ * \param[in] memoryObjects An array of OpenCL memory objects to release.
+ * \param[in] numberOfMemoryObjects The number of memory objects in memoryObjects.
+ * \return False if an error occurred, otherwise true.
+ */
+bool cleanUpHelloWorldVector(cl_context context, cl_command_queue commandQueue, ElementwiseKernel* elementwiseKernels, cl_mem* memoryObjects, int numberOfMemoryObjects)
+{
+    bool returnValue = true;
+    for (int index = 0; index < numberOfElementwiseKernels; index++)
+    {
+        returnValue &= releaseElementwiseKernel(&elementwiseKernels[index]);
+    }
+    returnValue &= cleanUpOpenCL(context, commandQueue, 0, 0, memoryObjects, numberOfMemoryObjects);
+    return returnValue;
+}
+
 /**
  * \brief Basic integer array addition implemented in OpenCL.
  * \details A sample which shows how to add two integer arrays and store the result in a third array.
  *          The main calculation code is in an OpenCL kernel which is executed on a GPU device.
- *          The OpenCL kernel makes use of vectors for improved performance.
+ *          The OpenCL kernel makes use of vectors for improved performance: it is built (see elementwise.h)
+ *          for the preferred vector width of the device, and handles arrays of any size.
+ *          assets/hello_world_vector.cl keeps the fixed int4 kernel of the vectorization tutorial, which it generalizes.
+ *          The sample then evaluates the chain (alpha * a + b) * c on float arrays, once as a single fused kernel
+ *          and once as two kernels with an intermediate array, and compares the results and the timings.
  * \return The exit code of the application, non-zero if a problem occurred.
  */
 int main(void)
 {
     cl_context context = 0;
     cl_command_queue commandQueue = 0;
-    cl_program program = 0;
     cl_device_id device = 0;
-    cl_kernel kernel = 0;
-    int numberOfMemoryObjects = 3;
-    cl_mem memoryObjects[3] = {0, 0, 0};
+
+    /* Index values for the element-wise kernels. */
+    const int addIndex = 0;
+    const int fusedIndex = 1;
+    const int saxpyIndex = 2;
+    const int mulIndex = 3;
+    ElementwiseKernel elementwiseKernels[numberOfElementwiseKernels] = {ElementwiseKernel(), ElementwiseKernel(), ElementwiseKernel(), ElementwiseKernel()};
+
+    /* Index values for the memory objects. */
+    const int numberOfMemoryObjects = 9;
+    const int inputAIndex = 0;
+    const int inputBIndex = 1;
+    const int outputIndex = 2;
+    const int floatInputIndex = 3;
+    const int intermediateIndex = 6;
+    const int fusedOutputIndex = 7;
+    const int unfusedOutputIndex = 8;
+    cl_mem memoryObjects[numberOfMemoryObjects] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
     cl_int errorNumber;
 
     if (!createContext(&context))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create an OpenCL context. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
     if (!createCommandQueue(context, &commandQueue, &device))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create the OpenCL command queue. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
-    if (!createProgram(context, device, "assets/hello_world_vector.cl", &program))
+    /* [Create the element-wise kernels] */
+    /*
+     * A vector width of 0 builds each kernel for the preferred vector width of the device (CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT
+     * or CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT), instead of always using int4.
+     */
+    const ElementwiseStep addSteps[] = {{ELEMENTWISE_ADD, {ELEMENTWISE_INPUT_A, ELEMENTWISE_INPUT_B}}};
+    const ElementwiseStep fusedSteps[] = {{ELEMENTWISE_SAXPY, {ELEMENTWISE_INPUT_A, ELEMENTWISE_INPUT_B}},
+                                          {ELEMENTWISE_MUL, {ELEMENTWISE_PREVIOUS, ELEMENTWISE_INPUT_C}}};
+    const ElementwiseStep saxpySteps[] = {{ELEMENTWISE_SAXPY, {ELEMENTWISE_INPUT_A, ELEMENTWISE_INPUT_B}}};
+    const ElementwiseStep mulSteps[] = {{ELEMENTWISE_MUL, {ELEMENTWISE_INPUT_A, ELEMENTWISE_INPUT_B}}};
+
+    bool createKernelsSuccess = true;
+    createKernelsSuccess &= createElementwiseKernel(context, device, ELEMENTWISE_TYPE_INT, addSteps, 1, 0, &elementwiseKernels[addIndex]);
+    createKernelsSuccess &= createElementwiseKernel(context, device, ELEMENTWISE_TYPE_FLOAT, fusedSteps, 2, 0, &elementwiseKernels[fusedIndex]);
+    createKernelsSuccess &= createElementwiseKernel(context, device, ELEMENTWISE_TYPE_FLOAT, saxpySteps, 1, 0, &elementwiseKernels[saxpyIndex]);
+    createKernelsSuccess &= createElementwiseKernel(context, device, ELEMENTWISE_TYPE_FLOAT, mulSteps, 1, 0, &elementwiseKernels[mulIndex]);
+    if (!createKernelsSuccess)
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed to create OpenCL program." << __FILE__ << ":"<< __LINE__ << endl;
+        cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create the element-wise kernels. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
+    /* [Create the element-wise kernels] */
 
-    kernel = clCreateKernel(program, "hello_world_vector", &errorNumber);
-    if (!checkSuccess(errorNumber))
-    {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed to create OpenCL kernel. " << __FILE__ << ":"<< __LINE__ << endl;
-        return 1;
-    }
+    cout << "Vector width for integers: " << elementwiseKernels[addIndex].vectorWidth << endl;
+    cout << "Vector width for floats: " << elementwiseKernels[fusedIndex].vectorWidth << endl;
+    cout << "Fused expression: " << elementwiseKernels[fusedIndex].expression << endl;
 
-    /* [Query preferred vector width] */
     /*
-     * Query the device to find out it's prefered integer vector width.
-     * Although we are only printing the value here, it can be used to select between
-     * different versions of a kernel.
+     * Number of elements in the arrays of input and output data.
+     * It does not have to be a multiple of the vector width.
      */
-    cl_uint integerVectorWidth;
-    clGetDeviceInfo(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT, sizeof(cl_uint), &integerVectorWidth, NULL);
-    cout << "Prefered vector width for integers: " << integerVectorWidth << endl;
-    /* [Query preferred vector width] */
-
-    /* Number of elements in the arrays of input and output data. */
-    cl_int arraySize = 1000000;
+    cl_int arraySize = 1000003;
 
     /* The buffers are the size of the arrays. */
     size_t bufferSize = arraySize * sizeof(cl_int);
+    size_t floatBufferSize = arraySize * sizeof(cl_float);
 
     /*
      * Ask the OpenCL implementation to allocate buffers for the data.
@@ -88,19 +139,35 @@ int main(void)
      */
     bool createMemoryObjectsSuccess = true;
     /* [Create buffer] */
-    memoryObjects[0] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, bufferSize, NULL, &errorNumber);
+    memoryObjects[inputAIndex] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, bufferSize, NULL, &errorNumber);
     createMemoryObjectsSuccess &= checkSuccess(errorNumber);
 
-    memoryObjects[1] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, bufferSize, NULL, &errorNumber);
+    memoryObjects[inputBIndex] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, bufferSize, NULL, &errorNumber);
     createMemoryObjectsSuccess &= checkSuccess(errorNumber);
 
-    memoryObjects[2] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, bufferSize, NULL, &errorNumber);
+    memoryObjects[outputIndex] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, bufferSize, NULL, &errorNumber);
     createMemoryObjectsSuccess &= checkSuccess(errorNumber);
     /* [Create buffer] */
 
+    for (int index = 0; index < 3; index++)
+    {
+        memoryObjects[floatInputIndex + index] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, floatBufferSize, NULL, &errorNumber);
+        createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    }
+
+    /* The intermediate array of the unfused chain is never accessed by the host. */
+    memoryObjects[intermediateIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE, floatBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+
+    memoryObjects[fusedOutputIndex] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, floatBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+
+    memoryObjects[unfusedOutputIndex] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, floatBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+
     if (!createMemoryObjectsSuccess)
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create OpenCL buffer. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
@@ -109,16 +176,23 @@ int main(void)
     bool mapMemoryObjectsSuccess = true;
 
     /* [Map buffer] */
-    cl_int* inputA = (cl_int*)clEnqueueMapBuffer(commandQueue, memoryObjects[0], CL_TRUE, CL_MAP_WRITE, 0, bufferSize, 0, NULL, NULL, &errorNumber);
+    cl_int* inputA = (cl_int*)clEnqueueMapBuffer(commandQueue, memoryObjects[inputAIndex], CL_TRUE, CL_MAP_WRITE, 0, bufferSize, 0, NULL, NULL, &errorNumber);
     mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
 
-    cl_int* inputB = (cl_int*)clEnqueueMapBuffer(commandQueue, memoryObjects[1], CL_TRUE, CL_MAP_WRITE, 0, bufferSize, 0, NULL, NULL, &errorNumber);
+    cl_int* inputB = (cl_int*)clEnqueueMapBuffer(commandQueue, memoryObjects[inputBIndex], CL_TRUE, CL_MAP_WRITE, 0, bufferSize, 0, NULL, NULL, &errorNumber);
     mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
     /* [Map buffer] */
 
+    cl_float* floatInputs[3] = {NULL, NULL, NULL};
+    for (int index = 0; index < 3; index++)
+    {
+        floatInputs[index] = (cl_float*)clEnqueueMapBuffer(commandQueue, memoryObjects[floatInputIndex + index], CL_TRUE, CL_MAP_WRITE, 0, floatBufferSize, 0, NULL, NULL, &errorNumber);
+        mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    }
+
     if (!mapMemoryObjectsSuccess)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+       cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
        cerr << "Failed to map buffer. " << __FILE__ << ":"<< __LINE__ << endl;
        return 1;
     }
@@ -128,6 +202,9 @@ int main(void)
     {
        inputA[i] = i;
        inputB[i] = i;
+       floatInputs[0][i] = (float)(i % 1000);
+       floatInputs[1][i] = (float)(i % 7);
+       floatInputs[2][i] = (float)(i % 5) * 0.25f;
     }
     /* [Initialize the input data] */
 
@@ -138,75 +215,91 @@ int main(void)
      * - the OpenCL implementation cannot free the memory when it is finished.
      */
     /* [Un-map buffer] */
-    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[0], inputA, 0, NULL, NULL)))
+    bool unmapMemoryObjectsSuccess = true;
+    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[inputAIndex], inputA, 0, NULL, NULL));
+    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[inputBIndex], inputB, 0, NULL, NULL));
+    for (int index = 0; index < 3; index++)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-       cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
-       return 1;
+        unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[floatInputIndex + index], floatInputs[index], 0, NULL, NULL));
     }
-
-    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[1], inputB, 0, NULL, NULL)))
+    if (!unmapMemoryObjectsSuccess)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+       cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
        cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
        return 1;
     }
     /* [Un-map buffer] */
 
-    /* Set the kernel arguments. */
-    bool setKernelArgumentsSuccess = true;
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 0, sizeof(cl_mem), &memoryObjects[0]));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 1, sizeof(cl_mem), &memoryObjects[1]));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 2, sizeof(cl_mem), &memoryObjects[2]));
-
-    if (!setKernelArgumentsSuccess)
-    {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
-        return 1;
-    }
-
-    /* An event to associate with the Kernel. Allows us to retreive profiling information later. */
-    cl_event event = 0;
-
-    /* [Global work size] */
+    /* [Enqueue the kernels] */
     /*
-     * Each instance of our OpenCL kernel now operates on 4 elements of each array so the number of
-     * instances needed is the number of elements in the array divided by 4.
+     * Events to associate with the kernels. Allow us to retreive profiling information later.
+     * The fused chain reads three arrays and writes one; the unfused chain also writes and reads back the intermediate array.
      */
-    size_t globalWorksize[1] = {arraySize / 4};
-    /* Enqueue the kernel */
-    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernel, 1, NULL, globalWorksize, NULL, 0, NULL, &event)))
+    const cl_float alpha = 2.0f;
+    const cl_mem addInputs[3] = {memoryObjects[inputAIndex], memoryObjects[inputBIndex], 0};
+    const cl_mem fusedInputs[3] = {memoryObjects[floatInputIndex], memoryObjects[floatInputIndex + 1], memoryObjects[floatInputIndex + 2]};
+    const cl_mem saxpyInputs[3] = {memoryObjects[floatInputIndex], memoryObjects[floatInputIndex + 1], 0};
+    const cl_mem mulInputs[3] = {memoryObjects[intermediateIndex], memoryObjects[floatInputIndex + 2], 0};
+    cl_event addEvent = 0;
+    cl_event fusedEvent = 0;
+    cl_event saxpyEvent = 0;
+    cl_event mulEvent = 0;
+
+    bool enqueueSuccess = true;
+    enqueueSuccess &= enqueueElementwiseKernel(commandQueue, &elementwiseKernels[addIndex], addInputs, memoryObjects[outputIndex], arraySize, 0.0f, &addEvent);
+    enqueueSuccess &= enqueueElementwiseKernel(commandQueue, &elementwiseKernels[fusedIndex], fusedInputs, memoryObjects[fusedOutputIndex], arraySize, alpha, &fusedEvent);
+    enqueueSuccess &= enqueueElementwiseKernel(commandQueue, &elementwiseKernels[saxpyIndex], saxpyInputs, memoryObjects[intermediateIndex], arraySize, alpha, &saxpyEvent);
+    enqueueSuccess &= enqueueElementwiseKernel(commandQueue, &elementwiseKernels[mulIndex], mulInputs, memoryObjects[unfusedOutputIndex], arraySize, 0.0f, &mulEvent);
+    if (!enqueueSuccess)
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed enqueuing the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed enqueuing the kernels. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
-    /* [Global work size] */
+    /* [Enqueue the kernels] */
 
     /* Wait for kernel execution completion. */
     if (!checkSuccess(clFinish(commandQueue)))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed waiting for kernel execution to finish. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
-    /* Print the profiling information for the event. */
-    printProfilingInfo(event);
-    /* Release the event object. */
-    if (!checkSuccess(clReleaseEvent(event)))
+    /* Print the profiling information for the events. */
+    cout << "Integer addition ";
+    printProfilingInfo(addEvent);
+    cout << "Fused chain ";
+    printProfilingInfo(fusedEvent);
+    cout << "Unfused chain, saxpy ";
+    printProfilingInfo(saxpyEvent);
+    cout << "Unfused chain, mul ";
+    printProfilingInfo(mulEvent);
+
+    /* Release the event objects. */
+    bool releaseEventsSuccess = true;
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(addEvent));
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(fusedEvent));
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(saxpyEvent));
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(mulEvent));
+    if (!releaseEventsSuccess)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-       cerr << "Failed releasing the event object. " << __FILE__ << ":"<< __LINE__ << endl;
+       cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
+       cerr << "Failed releasing the event objects. " << __FILE__ << ":"<< __LINE__ << endl;
        return 1;
     }
 
-    /* Get a pointer to the output data. */
-    cl_int* output = (cl_int*)clEnqueueMapBuffer(commandQueue, memoryObjects[2], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, NULL, &errorNumber);
-    if (!checkSuccess(errorNumber))
+    /* Get pointers to the output data. */
+    mapMemoryObjectsSuccess = true;
+    cl_int* output = (cl_int*)clEnqueueMapBuffer(commandQueue, memoryObjects[outputIndex], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, NULL, &errorNumber);
+    mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    cl_float* fusedOutput = (cl_float*)clEnqueueMapBuffer(commandQueue, memoryObjects[fusedOutputIndex], CL_TRUE, CL_MAP_READ, 0, floatBufferSize, 0, NULL, NULL, &errorNumber);
+    mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    cl_float* unfusedOutput = (cl_float*)clEnqueueMapBuffer(commandQueue, memoryObjects[unfusedOutputIndex], CL_TRUE, CL_MAP_READ, 0, floatBufferSize, 0, NULL, NULL, &errorNumber);
+    mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    if (!mapMemoryObjectsSuccess)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+       cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
        cerr << "Failed to map buffer. " << __FILE__ << ":"<< __LINE__ << endl;
        return 1;
     }
@@ -219,14 +312,39 @@ int main(void)
     }
     */
 
-    /* Unmap the memory object as we are finished using them from the CPU side. */
-    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[2], output, 0, NULL, NULL)))
+    /* [Verify the results] */
+    /* Every element, including the tail after the last whole vector, must have been written. */
+    int additionErrors = 0;
+    int chainErrors = 0;
+    for (int i = 0; i < arraySize; i++)
+    {
+        if (output[i] != 2 * i)
+        {
+            additionErrors++;
+        }
+
+        const float expected = (alpha * (float)(i % 1000) + (float)(i % 7)) * ((float)(i % 5) * 0.25f);
+        if (fabs(fusedOutput[i] - expected) > 1e-5f * fabs(expected) || fabs(unfusedOutput[i] - expected) > 1e-5f * fabs(expected))
+        {
+            chainErrors++;
+        }
+    }
+    cout << "Integer addition errors: " << additionErrors << endl;
+    cout << "Fused and unfused chain errors: " << chainErrors << endl;
+    /* [Verify the results] */
+
+    /* Unmap the memory objects as we are finished using them from the CPU side. */
+    bool unmapOutputsSuccess = true;
+    unmapOutputsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[outputIndex], output, 0, NULL, NULL));
+    unmapOutputsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[fusedOutputIndex], fusedOutput, 0, NULL, NULL));
+    unmapOutputsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[unfusedOutputIndex], unfusedOutput, 0, NULL, NULL));
+    if (!unmapOutputsSuccess)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+       cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
        cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
        return 1;
     }
 
     /* Release OpenCL objects. */
-    cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+    cleanUpHelloWorldVector(context, commandQueue, elementwiseKernels, memoryObjects, numberOfMemoryObjects);
 }
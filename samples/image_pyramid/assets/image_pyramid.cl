@@ -0,0 +1,91 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+/* [Define a sampler] */
+/*
+ * Pyramid levels are packed into larger arena images, so the kernels work in pixel (non-normalized) coordinates
+ * relative to the origin of each level. Bilinear filtering lets one read return a weighted sum of 4 pixels.
+ */
+const sampler_t sampler = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_EDGE | CLK_FILTER_LINEAR;
+/* [Define a sampler] */
+
+/**
+ * \brief Read a bilinearly filtered value from one level of an arena image.
+ * \details The coordinate is clamped to the centres of the edge pixels of the level,
+ *          so the filter never blends in pixels from a neighbouring level in the arena.
+ * \param[in] image Arena image containing the level.
+ * \param[in] origin Top left pixel of the level in the arena.
+ * \param[in] size Width and height of the level.
+ * \param[in] coordinate Position relative to the origin of the level, in pixels (pixel centres are at .5).
+ * \return The filtered colour.
+ */
+float4 readLevel(__read_only image2d_t image, const int2 origin, const int2 size, float2 coordinate)
+{
+    coordinate = clamp(coordinate, (float2)(0.5f), convert_float2(size) - 0.5f);
+    return read_imagef(image, sampler, convert_float2(origin) + coordinate);
+}
+
+/**
+ * \brief Gaussian pyramid downsample kernel function.
+ * \details Produces one pixel of the next (half size) level with a 4x4 binomial [1 3 3 1] filter.
+ *          Sampling between two pixels at 1/4 and 3/4 gives weights of 3/4 and 1/4,
+ *          so the 16-tap filter is built from 4 bilinear reads at offsets 0.25 and 1.75.
+ * \param[in] source Arena image holding the previous level.
+ * \param[in] sourceOrigin Top left pixel of the previous level in source.
+ * \param[in] sourceSize Width and height of the previous level.
+ * \param[out] destination Arena image holding the new level.
+ * \param[in] destinationOrigin Top left pixel of the new level in destination.
+ */
+__kernel void pyramid_downsample(__read_only image2d_t source,
+                                 const int2 sourceOrigin,
+                                 const int2 sourceSize,
+                                 __write_only image2d_t destination,
+                                 const int2 destinationOrigin)
+{
+    const int2 coordinate = (int2)(get_global_id(0), get_global_id(1));
+    const float2 sourceCoordinate = convert_float2(coordinate * 2);
+
+    float4 colour = readLevel(source, sourceOrigin, sourceSize, sourceCoordinate + (float2)(0.25f, 0.25f));
+    colour += readLevel(source, sourceOrigin, sourceSize, sourceCoordinate + (float2)(1.75f, 0.25f));
+    colour += readLevel(source, sourceOrigin, sourceSize, sourceCoordinate + (float2)(0.25f, 1.75f));
+    colour += readLevel(source, sourceOrigin, sourceSize, sourceCoordinate + (float2)(1.75f, 1.75f));
+
+    write_imagef(destination, destinationOrigin + coordinate, colour * 0.25f);
+}
+
+/**
+ * \brief Laplacian pyramid kernel function.
+ * \details Subtracts the bilinearly upsampled coarse level from the fine level.
+ * \param[in] fine Arena (or input) image holding the fine Gaussian level.
+ * \param[in] fineOrigin Top left pixel of the fine level.
+ * \param[in] coarse Arena image holding the next, half size, Gaussian level.
+ * \param[in] coarseOrigin Top left pixel of the coarse level.
+ * \param[in] coarseSize Width and height of the coarse level.
+ * \param[out] laplacian Arena image receiving the signed difference. Must be a floating point format.
+ * \param[in] laplacianOrigin Top left pixel of the Laplacian level.
+ */
+__kernel void pyramid_laplacian(__read_only image2d_t fine,
+                                const int2 fineOrigin,
+                                __read_only image2d_t coarse,
+                                const int2 coarseOrigin,
+                                const int2 coarseSize,
+                                __write_only image2d_t laplacian,
+                                const int2 laplacianOrigin)
+{
+    const int2 coordinate = (int2)(get_global_id(0), get_global_id(1));
+
+    /* Pixel centres are at .5, so the centre of fine pixel x lies at (x + 0.5) / 2 in the coarse level. */
+    const float2 coarseCoordinate = (convert_float2(coordinate) + 0.5f) * 0.5f;
+    const float4 upsampled = readLevel(coarse, coarseOrigin, coarseSize, coarseCoordinate);
+
+    const float4 original = read_imagef(fine, sampler, convert_float2(fineOrigin + coordinate) + 0.5f);
+
+    write_imagef(laplacian, laplacianOrigin + coordinate, original - upsampled);
+}
@@ -0,0 +1,549 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "common.h"
+#include "image.h"
+
+#include <CL/cl.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+/* The largest number of levels an ImagePyramid can hold. */
+const int maximumNumberOfLevels = 12;
+
+/* Index values for the arena images. */
+const int evenGaussianArenaIndex = 0;
+const int oddGaussianArenaIndex = 1;
+const int laplacianArenaIndex = 2;
+const int numberOfArenas = 3;
+
+/**
+ * \brief Location of one pyramid level inside an arena image.
+ */
+struct PyramidLevel
+{
+    cl_mem image; /**< \brief Image holding the level. Owned by the pyramid arena (or the caller for level 0). */
+    cl_int2 origin; /**< \brief Top left pixel of the level in image. */
+    cl_int2 size; /**< \brief Width and height of the level. */
+};
+
+/**
+ * \brief A Gaussian and Laplacian image pyramid.
+ * \details All levels are allocated once by createImagePyramid and reused by every call to buildImagePyramid.
+ *          OpenCL 1.1 cannot read and write the same image in one kernel, so the arena is made of three images:
+ *          the odd and the even Gaussian levels live in two different images (so each level can read the previous one),
+ *          and all the Laplacian levels share a third image. Inside an arena image the levels are stacked vertically.
+ *          Gaussian level 0 is the input image, the last Laplacian level is the coarsest Gaussian level.
+ */
+struct ImagePyramid
+{
+    int numberOfLevels; /**< \brief Number of Gaussian levels, including the input image. */
+    cl_mem arena[numberOfArenas]; /**< \brief The images all the levels are allocated from. */
+    PyramidLevel gaussian[maximumNumberOfLevels]; /**< \brief Gaussian levels, gaussian[0] is the input image. */
+    PyramidLevel laplacian[maximumNumberOfLevels]; /**< \brief Laplacian levels, numberOfLevels - 1 of them. */
+    cl_kernel downsampleKernel; /**< \brief The pyramid_downsample kernel. */
+    cl_kernel laplacianKernel; /**< \brief The pyramid_laplacian kernel. */
+    cl_event downsampleEvents[maximumNumberOfLevels]; /**< \brief Events of the last build, downsampleEvents[0] is unused. */
+    cl_event laplacianEvents[maximumNumberOfLevels]; /**< \brief Events of the last build. */
+};
+
+/**
+ * \brief Release the OpenCL objects owned by a pyramid.
+ * \param[in] pyramid The pyramid to release. Safe to call on a partially created pyramid.
+ * \return False if an error occurred, otherwise true.
+ */
+bool releaseImagePyramid(ImagePyramid* pyramid)
+{
+    bool returnValue = true;
+    for (int level = 0; level < maximumNumberOfLevels; level++)
+    {
+        if (pyramid->downsampleEvents[level] != 0)
+        {
+            returnValue &= checkSuccess(clReleaseEvent(pyramid->downsampleEvents[level]));
+            pyramid->downsampleEvents[level] = 0;
+        }
+        if (pyramid->laplacianEvents[level] != 0)
+        {
+            returnValue &= checkSuccess(clReleaseEvent(pyramid->laplacianEvents[level]));
+            pyramid->laplacianEvents[level] = 0;
+        }
+    }
+    for (int index = 0; index < numberOfArenas; index++)
+    {
+        if (pyramid->arena[index] != 0)
+        {
+            returnValue &= checkSuccess(clReleaseMemObject(pyramid->arena[index]));
+            pyramid->arena[index] = 0;
+        }
+    }
+    if (pyramid->downsampleKernel != 0)
+    {
+        returnValue &= checkSuccess(clReleaseKernel(pyramid->downsampleKernel));
+        pyramid->downsampleKernel = 0;
+    }
+    if (pyramid->laplacianKernel != 0)
+    {
+        returnValue &= checkSuccess(clReleaseKernel(pyramid->laplacianKernel));
+        pyramid->laplacianKernel = 0;
+    }
+    return returnValue;
+}
+
+/**
+ * \brief Allocate the arena images and kernels of a pyramid.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] program A built program created from assets/image_pyramid.cl.
+ * \param[in] width Width of the input image.
+ * \param[in] height Height of the input image.
+ * \param[in] numberOfLevels Number of Gaussian levels, including the input image. Must be in the range [2, maximumNumberOfLevels].
+ * \param[out] pyramid The created pyramid. Must be released with releaseImagePyramid.
+ * \return False if an error occurred, otherwise true.
+ */
+bool createImagePyramid(cl_context context, cl_program program, int width, int height, int numberOfLevels, ImagePyramid* pyramid)
+{
+    cl_int errorNumber = 0;
+
+    *pyramid = ImagePyramid();
+    if (numberOfLevels < 2 || numberOfLevels > maximumNumberOfLevels)
+    {
+        cerr << "The number of pyramid levels must be in the range [2, " << maximumNumberOfLevels << "]. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    pyramid->numberOfLevels = numberOfLevels;
+
+    /* [Lay out the levels] */
+    /*
+     * Work out the size of every level and where it goes in its arena.
+     * arenaSize is the size each arena has to be to hold all its levels.
+     */
+    int arenaSize[numberOfArenas][2] = {{0, 0}, {0, 0}, {0, 0}};
+    int levelWidth = width;
+    int levelHeight = height;
+    for (int level = 0; level < numberOfLevels; level++)
+    {
+        /* Gaussian level 0 is the input image, which is not part of the arena. */
+        if (level > 0)
+        {
+            int arena = (level % 2 == 0) ? evenGaussianArenaIndex : oddGaussianArenaIndex;
+            PyramidLevel& gaussian = pyramid->gaussian[level];
+            gaussian.origin.s[0] = 0;
+            gaussian.origin.s[1] = arenaSize[arena][1];
+            gaussian.size.s[0] = levelWidth;
+            gaussian.size.s[1] = levelHeight;
+            arenaSize[arena][0] = max(arenaSize[arena][0], levelWidth);
+            arenaSize[arena][1] += levelHeight;
+        }
+        else
+        {
+            pyramid->gaussian[0].size.s[0] = levelWidth;
+            pyramid->gaussian[0].size.s[1] = levelHeight;
+        }
+
+        /* There is one Laplacian level less than there are Gaussian levels. */
+        if (level < numberOfLevels - 1)
+        {
+            PyramidLevel& laplacian = pyramid->laplacian[level];
+            laplacian.origin.s[0] = 0;
+            laplacian.origin.s[1] = arenaSize[laplacianArenaIndex][1];
+            laplacian.size.s[0] = levelWidth;
+            laplacian.size.s[1] = levelHeight;
+            arenaSize[laplacianArenaIndex][0] = max(arenaSize[laplacianArenaIndex][0], levelWidth);
+            arenaSize[laplacianArenaIndex][1] += levelHeight;
+        }
+
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+    /* [Lay out the levels] */
+
+    /* [Allocate the arena] */
+    /*
+     * The Gaussian levels use the same format as the input image.
+     * The Laplacian levels are signed so they are stored as floats.
+     */
+    cl_image_format gaussianFormat;
+    gaussianFormat.image_channel_data_type = CL_UNORM_INT8;
+    gaussianFormat.image_channel_order = CL_RGBA;
+
+    cl_image_format laplacianFormat;
+    laplacianFormat.image_channel_data_type = CL_FLOAT;
+    laplacianFormat.image_channel_order = CL_RGBA;
+
+    bool createMemoryObjectsSuccess = true;
+    for (int arena = 0; arena < numberOfArenas; arena++)
+    {
+        /* With only two levels the even Gaussian arena has nothing in it. */
+        if (arenaSize[arena][0] == 0)
+        {
+            continue;
+        }
+        const cl_image_format* format = (arena == laplacianArenaIndex) ? &laplacianFormat : &gaussianFormat;
+        pyramid->arena[arena] = clCreateImage2D(context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, format, arenaSize[arena][0], arenaSize[arena][1], 0, NULL, &errorNumber);
+        createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    }
+    if (!createMemoryObjectsSuccess)
+    {
+        releaseImagePyramid(pyramid);
+        cerr << "Failed creating the pyramid arena images. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    /* [Allocate the arena] */
+
+    for (int level = 1; level < numberOfLevels; level++)
+    {
+        pyramid->gaussian[level].image = pyramid->arena[(level % 2 == 0) ? evenGaussianArenaIndex : oddGaussianArenaIndex];
+    }
+    for (int level = 0; level < numberOfLevels - 1; level++)
+    {
+        pyramid->laplacian[level].image = pyramid->arena[laplacianArenaIndex];
+    }
+
+    pyramid->downsampleKernel = clCreateKernel(program, "pyramid_downsample", &errorNumber);
+    bool createKernelsSuccess = checkSuccess(errorNumber);
+    pyramid->laplacianKernel = clCreateKernel(program, "pyramid_laplacian", &errorNumber);
+    createKernelsSuccess &= checkSuccess(errorNumber);
+    if (!createKernelsSuccess)
+    {
+        releaseImagePyramid(pyramid);
+        cerr << "Failed to create the pyramid kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * \brief Build all the Gaussian and Laplacian levels of a pyramid.
+ * \details Every level is enqueued in one chain without waiting on the host:
+ *          each downsample waits on the event of the previous level and each Laplacian level waits on the two
+ *          Gaussian levels it reads. The events are kept in the pyramid so the timing of each level can be reported.
+ * \param[in] commandQueue The command queue to use. Must have profiling enabled to use printImagePyramidProfilingInfo.
+ * \param[in] sourceImage The input image (Gaussian level 0). Must match the size the pyramid was created with.
+ * \param[in,out] pyramid The pyramid to build.
+ * \return False if an error occurred, otherwise true.
+ */
+bool buildImagePyramid(cl_command_queue commandQueue, cl_mem sourceImage, ImagePyramid* pyramid)
+{
+    /* Release the events of any previous build. */
+    for (int level = 0; level < maximumNumberOfLevels; level++)
+    {
+        if (pyramid->downsampleEvents[level] != 0)
+        {
+            clReleaseEvent(pyramid->downsampleEvents[level]);
+            pyramid->downsampleEvents[level] = 0;
+        }
+        if (pyramid->laplacianEvents[level] != 0)
+        {
+            clReleaseEvent(pyramid->laplacianEvents[level]);
+            pyramid->laplacianEvents[level] = 0;
+        }
+    }
+
+    pyramid->gaussian[0].image = sourceImage;
+
+    /* [Gaussian levels] */
+    for (int level = 1; level < pyramid->numberOfLevels; level++)
+    {
+        const PyramidLevel& source = pyramid->gaussian[level - 1];
+        const PyramidLevel& destination = pyramid->gaussian[level];
+
+        bool setKernelArgumentsSuccess = true;
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->downsampleKernel, 0, sizeof(cl_mem), &source.image));
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->downsampleKernel, 1, sizeof(cl_int2), &source.origin));
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->downsampleKernel, 2, sizeof(cl_int2), &source.size));
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->downsampleKernel, 3, sizeof(cl_mem), &destination.image));
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->downsampleKernel, 4, sizeof(cl_int2), &destination.origin));
+        if (!setKernelArgumentsSuccess)
+        {
+            cerr << "Failed setting the downsample kernel arguments for level " << level << ". " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+
+        /* One work-item per pixel of the new level. The first level has no previous event to wait for. */
+        size_t globalWorkSize[2] = {(size_t)destination.size.s[0], (size_t)destination.size.s[1]};
+        cl_uint numberOfEventsInWaitList = (level > 1) ? 1 : 0;
+        const cl_event* eventWaitList = (level > 1) ? &pyramid->downsampleEvents[level - 1] : NULL;
+        if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, pyramid->downsampleKernel, 2, NULL, globalWorkSize, NULL,
+                                                 numberOfEventsInWaitList, eventWaitList, &pyramid->downsampleEvents[level])))
+        {
+            cerr << "Failed enqueuing the downsample kernel for level " << level << ". " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+    }
+    /* [Gaussian levels] */
+
+    /* [Laplacian levels] */
+    for (int level = 0; level < pyramid->numberOfLevels - 1; level++)
+    {
+        const PyramidLevel& fine = pyramid->gaussian[level];
+        const PyramidLevel& coarse = pyramid->gaussian[level + 1];
+        const PyramidLevel& destination = pyramid->laplacian[level];
+
+        bool setKernelArgumentsSuccess = true;
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->laplacianKernel, 0, sizeof(cl_mem), &fine.image));
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->laplacianKernel, 1, sizeof(cl_int2), &fine.origin));
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->laplacianKernel, 2, sizeof(cl_mem), &coarse.image));
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->laplacianKernel, 3, sizeof(cl_int2), &coarse.origin));
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->laplacianKernel, 4, sizeof(cl_int2), &coarse.size));
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->laplacianKernel, 5, sizeof(cl_mem), &destination.image));
+        setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(pyramid->laplacianKernel, 6, sizeof(cl_int2), &destination.origin));
+        if (!setKernelArgumentsSuccess)
+        {
+            cerr << "Failed setting the Laplacian kernel arguments for level " << level << ". " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+
+        /* The coarse level is always produced by a downsample, the fine level only when it is not the input image. */
+        cl_event eventWaitList[2] = {pyramid->downsampleEvents[level + 1], pyramid->downsampleEvents[level]};
+        cl_uint numberOfEventsInWaitList = (level > 0) ? 2 : 1;
+        size_t globalWorkSize[2] = {(size_t)destination.size.s[0], (size_t)destination.size.s[1]};
+        if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, pyramid->laplacianKernel, 2, NULL, globalWorkSize, NULL,
+                                                 numberOfEventsInWaitList, eventWaitList, &pyramid->laplacianEvents[level])))
+        {
+            cerr << "Failed enqueuing the Laplacian kernel for level " << level << ". " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+    }
+    /* [Laplacian levels] */
+
+    return true;
+}
+
+/**
+ * \brief Print the profiling information of every level of the last build.
+ * \param[in] pyramid A pyramid which has been built and whose commands have finished.
+ * \return False if an error occurred, otherwise true.
+ */
+bool printImagePyramidProfilingInfo(const ImagePyramid* pyramid)
+{
+    bool returnValue = true;
+    for (int level = 1; level < pyramid->numberOfLevels; level++)
+    {
+        cout << "Gaussian level " << level << " (" << pyramid->gaussian[level].size.s[0] << "x" << pyramid->gaussian[level].size.s[1] << ") ";
+        returnValue &= printProfilingInfo(pyramid->downsampleEvents[level]);
+    }
+    for (int level = 0; level < pyramid->numberOfLevels - 1; level++)
+    {
+        cout << "Laplacian level " << level << " (" << pyramid->laplacian[level].size.s[0] << "x" << pyramid->laplacian[level].size.s[1] << ") ";
+        returnValue &= printProfilingInfo(pyramid->laplacianEvents[level]);
+    }
+    return returnValue;
+}
+
+/**
+ * \brief Map one level of a pyramid and save it as a bitmap.
+ * \details Laplacian levels are signed, they are shifted by 0.5 so that zero maps to mid-grey.
+ * \param[in] commandQueue The command queue to use.
+ * \param[in] level The level to save.
+ * \param[in] isLaplacian True if the level is stored as floats in the Laplacian arena.
+ * \param[in] filename The name of the bitmap to write.
+ * \return False if an error occurred, otherwise true.
+ */
+bool saveImagePyramidLevel(cl_command_queue commandQueue, const PyramidLevel& level, bool isLaplacian, string filename)
+{
+    cl_int errorNumber = 0;
+    const int width = level.size.s[0];
+    const int height = level.size.s[1];
+
+    /* Only the region of the arena which holds the level is mapped. */
+    size_t origin[3] = {(size_t)level.origin.s[0], (size_t)level.origin.s[1], 0};
+    size_t region[3] = {(size_t)width, (size_t)height, 1};
+    size_t rowPitch = 0;
+    unsigned char* mappedData = (unsigned char*)clEnqueueMapImage(commandQueue, level.image, CL_TRUE, CL_MAP_READ, origin, region, &rowPitch, NULL, 0, NULL, NULL, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        cerr << "Failed mapping the pyramid level. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /*
+     * The arena is wider than most of its levels, so unlike the image_scaling sample
+     * the rowPitch must be used to step from one row of the level to the next.
+     */
+    unsigned char* rgbData = new unsigned char[width * height * 3];
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char* row = mappedData + y * rowPitch;
+        for (int x = 0; x < width; x++)
+        {
+            for (int channel = 0; channel < 3; channel++)
+            {
+                unsigned char value;
+                if (isLaplacian)
+                {
+                    float difference = ((const float*)row)[4 * x + channel] + 0.5f;
+                    value = (unsigned char)(min(max(difference, 0.0f), 1.0f) * 255.0f);
+                }
+                else
+                {
+                    value = row[4 * x + channel];
+                }
+                rgbData[3 * (y * width + x) + channel] = value;
+            }
+        }
+    }
+
+    bool returnValue = checkSuccess(clEnqueueUnmapMemObject(commandQueue, level.image, mappedData, 0, NULL, NULL));
+    returnValue &= saveToBitmap(filename, width, height, rgbData);
+    delete [] rgbData;
+
+    return returnValue;
+}
+
+/**
+ * \brief OpenCL image pyramid sample code.
+ * \details Builds a Gaussian and a Laplacian pyramid from assets/input.bmp.
+ *          All the levels are produced from one chain of enqueued kernels, reading the previous level's image object,
+ *          and are allocated from one arena which is created once and could be reused for every frame.
+ *          Every level is saved as output-gaussian-N.bmp and output-laplacian-N.bmp.
+ * \return The exit code of the application, non-zero if a problem occurred.
+ */
+int main(void)
+{
+    cl_context context = 0;
+    cl_command_queue commandQueue = 0;
+    cl_program program = 0;
+    cl_device_id device = 0;
+    cl_kernel kernel = 0;
+    const int numMemoryObjects = 1;
+    cl_mem memoryObjects[numMemoryObjects] = {0};
+    cl_int errorNumber;
+    ImagePyramid pyramid = ImagePyramid();
+
+    /* Number of Gaussian levels to build, including the input image. */
+    const int numberOfLevels = 6;
+
+    if (!createContext(&context))
+    {
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed to create an OpenCL context. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!createCommandQueue(context, &commandQueue, &device))
+    {
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed to create the OpenCL command queue. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!createProgram(context, device, "assets/image_pyramid.cl", &program))
+    {
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed to create OpenCL program." << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Load the input image data. */
+    unsigned char* inputImage = NULL;
+    int width, height;
+    if (!loadFromBitmap("assets/input.bmp", &width, &height, &inputImage))
+    {
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed loading bitmap. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!createImagePyramid(context, program, width, height, numberOfLevels, &pyramid))
+    {
+        delete[] inputImage;
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed creating the image pyramid. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* The input image uses the same RGBA8888 format as the image_scaling sample. */
+    cl_image_format format;
+    format.image_channel_data_type = CL_UNORM_INT8;
+    format.image_channel_order = CL_RGBA;
+
+    memoryObjects[0] = clCreateImage2D(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, &format, width, height, 0, NULL, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        delete[] inputImage;
+        releaseImagePyramid(&pyramid);
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed creating the image. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    size_t origin[3] = {0, 0, 0};
+    size_t region[3] = {(size_t)width, (size_t)height, 1};
+    size_t rowPitch;
+    unsigned char* inputImageRGBA = (unsigned char*)clEnqueueMapImage(commandQueue, memoryObjects[0], CL_TRUE, CL_MAP_WRITE, origin, region, &rowPitch, NULL, 0, NULL, NULL, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        delete[] inputImage;
+        releaseImagePyramid(&pyramid);
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed mapping the input image. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Convert the input data from RGB to RGBA (moves it to the OpenCL allocated memory at the same time). */
+    RGBToRGBA(inputImage, inputImageRGBA, width, height);
+    delete[] inputImage;
+
+    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[0], inputImageRGBA, 0, NULL, NULL)))
+    {
+        releaseImagePyramid(&pyramid);
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed unmapping the input image. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Enqueue every level and only then wait for the device. */
+    if (!buildImagePyramid(commandQueue, memoryObjects[0], &pyramid))
+    {
+        releaseImagePyramid(&pyramid);
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed building the image pyramid. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!checkSuccess(clFinish(commandQueue)))
+    {
+        releaseImagePyramid(&pyramid);
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed waiting for kernel execution to finish. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    printImagePyramidProfilingInfo(&pyramid);
+
+    bool saveSuccess = true;
+    for (int level = 1; level < numberOfLevels; level++)
+    {
+        ostringstream filename;
+        filename << "output-gaussian-" << level << ".bmp";
+        saveSuccess &= saveImagePyramidLevel(commandQueue, pyramid.gaussian[level], false, filename.str());
+    }
+    for (int level = 0; level < numberOfLevels - 1; level++)
+    {
+        ostringstream filename;
+        filename << "output-laplacian-" << level << ".bmp";
+        saveSuccess &= saveImagePyramidLevel(commandQueue, pyramid.laplacian[level], true, filename.str());
+    }
+    if (!saveSuccess)
+    {
+        releaseImagePyramid(&pyramid);
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed saving the pyramid levels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    releaseImagePyramid(&pyramid);
+    cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+/* [Define a sampler] */
+/*
+ * The filter weights are applied in the kernel, so the hardware filtering is turned off and
+ * integer pixel coordinates are used. Taps which fall outside the image are clamped to the edge pixels.
+ */
+const sampler_t sampler = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_EDGE | CLK_FILTER_NEAREST;
+/* [Define a sampler] */
+
+/**
+ * \brief Horizontal pass of the separable resampling filter.
+ * \details Every destination column x is a weighted sum of taps source columns starting at starts[x].
+ *          The weights are precomputed on the host for the filter and scale factor in use.
+ * \param[in] source Input image object.
+ * \param[out] destination Image with the destination width and the source height.
+ * \param[in] starts First source column of each destination column.
+ * \param[in] weights taps weights for each destination column.
+ * \param[in] taps Number of source columns contributing to a destination column.
+ */
+__kernel void resample_horizontal(__read_only image2d_t source,
+                                  __write_only image2d_t destination,
+                                  __global const int* restrict starts,
+                                  __global const float* restrict weights,
+                                  const int taps)
+{
+    const int x = get_global_id(0);
+    const int y = get_global_id(1);
+
+    const int start = starts[x];
+    __global const float* restrict columnWeights = weights + x * taps;
+
+    float4 colour = (float4)0.0f;
+    for (int tap = 0; tap < taps; tap++)
+    {
+        colour += columnWeights[tap] * read_imagef(source, sampler, (int2)(start + tap, y));
+    }
+
+    write_imagef(destination, (int2)(x, y), colour);
+}
+
+/**
+ * \brief Vertical pass of the separable resampling filter.
+ * \details Every destination row y is a weighted sum of taps source rows starting at starts[y].
+ *          Bicubic and Lanczos weights can be negative, the result is clamped when written to a normalized image.
+ * \param[in] source Output of the horizontal pass.
+ * \param[out] destination Re-sized output image object.
+ * \param[in] starts First source row of each destination row.
+ * \param[in] weights taps weights for each destination row.
+ * \param[in] taps Number of source rows contributing to a destination row.
+ */
+__kernel void resample_vertical(__read_only image2d_t source,
+                                __write_only image2d_t destination,
+                                __global const int* restrict starts,
+                                __global const float* restrict weights,
+                                const int taps)
+{
+    const int x = get_global_id(0);
+    const int y = get_global_id(1);
+
+    const int start = starts[y];
+    __global const float* restrict rowWeights = weights + y * taps;
+
+    float4 colour = (float4)0.0f;
+    for (int tap = 0; tap < taps; tap++)
+    {
+        colour += rowWeights[tap] * read_imagef(source, sampler, (int2)(x, start + tap));
+    }
+
+    write_imagef(destination, (int2)(x, y), colour);
+}
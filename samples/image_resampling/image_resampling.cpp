@@ -0,0 +1,582 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "common.h"
+#include "image.h"
+
+#include <CL/cl.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * \brief The resampling filters supported by resampleImage.
+ */
+enum ResamplingFilter
+{
+    RESAMPLING_FILTER_AREA, /**< \brief Average of the source pixels covered by each destination pixel. Intended for downscaling. */
+    RESAMPLING_FILTER_BICUBIC, /**< \brief Catmull-Rom bicubic filter (a = -0.5). Intended for upscaling. */
+    RESAMPLING_FILTER_LANCZOS3 /**< \brief Lanczos filter with 3 lobes. Intended for upscaling. */
+};
+
+/**
+ * \brief Weight table for one axis, uploaded to the device.
+ */
+struct ResamplingTable
+{
+    cl_mem starts; /**< \brief First source pixel of each destination pixel (cl_int). */
+    cl_mem weights; /**< \brief taps weights for each destination pixel (cl_float). */
+    cl_int taps; /**< \brief Number of source pixels contributing to a destination pixel. */
+};
+
+/**
+ * \brief Key of the weight table cache: the filter and the scale pair (source size, destination size) of one axis.
+ */
+struct ResamplingTableKey
+{
+    ResamplingFilter filter;
+    int sourceSize;
+    int destinationSize;
+
+    bool operator<(const ResamplingTableKey& other) const
+    {
+        if (filter != other.filter)
+        {
+            return filter < other.filter;
+        }
+        if (sourceSize != other.sourceSize)
+        {
+            return sourceSize < other.sourceSize;
+        }
+        return destinationSize < other.destinationSize;
+    }
+};
+
+/**
+ * \brief State kept between calls to resampleImage.
+ * \details The weight tables are computed and uploaded the first time a (filter, source size, destination size)
+ *          combination is used and then reused, as is the intermediate image between the two passes.
+ *          Repeated frames at the same size only set kernel arguments and enqueue the two passes.
+ */
+struct Resampler
+{
+    cl_context context; /**< \brief Context the tables and intermediate image are allocated in. */
+    cl_kernel horizontalKernel; /**< \brief The resample_horizontal kernel. */
+    cl_kernel verticalKernel; /**< \brief The resample_vertical kernel. */
+    map<ResamplingTableKey, ResamplingTable> tables; /**< \brief Weight tables indexed by filter and scale pair. */
+    cl_mem intermediateImage; /**< \brief Output of the horizontal pass. */
+    int intermediateWidth; /**< \brief Width of intermediateImage. */
+    int intermediateHeight; /**< \brief Height of intermediateImage. */
+    int tableCacheHits; /**< \brief Number of weight table lookups served from the cache. */
+    int tableCacheMisses; /**< \brief Number of weight tables computed and uploaded. */
+};
+
+/**
+ * \brief Catmull-Rom cubic filter kernel.
+ * \param[in] x Distance from the sample position, in source pixels.
+ * \return The filter weight.
+ */
+float bicubicWeight(float x)
+{
+    const float a = -0.5f;
+    x = fabs(x);
+    if (x < 1.0f)
+    {
+        return ((a + 2.0f) * x - (a + 3.0f)) * x * x + 1.0f;
+    }
+    if (x < 2.0f)
+    {
+        return ((a * x - 5.0f * a) * x + 8.0f * a) * x - 4.0f * a;
+    }
+    return 0.0f;
+}
+
+/**
+ * \brief Lanczos-3 filter kernel.
+ * \param[in] x Distance from the sample position, in source pixels.
+ * \return The filter weight.
+ */
+float lanczos3Weight(float x)
+{
+    const float pi = 3.14159265358979f;
+    x = fabs(x);
+    if (x < 1e-6f)
+    {
+        return 1.0f;
+    }
+    if (x < 3.0f)
+    {
+        return 3.0f * sin(pi * x) * sin(pi * x / 3.0f) / (pi * pi * x * x);
+    }
+    return 0.0f;
+}
+
+/**
+ * \brief Compute the separable weight table for one axis.
+ * \details For the area filter each destination pixel covers scale source pixels and every source pixel is
+ *          weighted by how much of it is covered. For the bicubic and Lanczos filters the kernel is centred on the
+ *          destination pixel and, when downscaling, stretched by the scale factor to avoid aliasing.
+ *          Every row of the table is normalized so its weights sum to 1.
+ * \param[in] filter The filter to use.
+ * \param[in] sourceSize Number of source pixels along the axis.
+ * \param[in] destinationSize Number of destination pixels along the axis.
+ * \param[out] starts First source pixel of each destination pixel.
+ * \param[out] weights taps weights for each destination pixel.
+ * \param[out] taps Number of source pixels contributing to each destination pixel.
+ */
+void computeResamplingWeights(ResamplingFilter filter, int sourceSize, int destinationSize, vector<int>& starts, vector<float>& weights, cl_int* taps)
+{
+    const float scale = (float)sourceSize / destinationSize;
+    starts.resize(destinationSize);
+
+    if (filter == RESAMPLING_FILTER_AREA)
+    {
+        /* The widest footprint decides the number of taps, narrower rows are padded with zero weights. */
+        *taps = 1;
+        for (int i = 0; i < destinationSize; i++)
+        {
+            int first = (int)floor(i * scale);
+            int last = (int)ceil((i + 1) * scale);
+            *taps = max(*taps, last - first);
+        }
+
+        weights.assign(destinationSize * *taps, 0.0f);
+        for (int i = 0; i < destinationSize; i++)
+        {
+            const float left = i * scale;
+            const float right = (i + 1) * scale;
+            starts[i] = (int)floor(left);
+            for (int tap = 0; tap < *taps; tap++)
+            {
+                const float pixel = (float)(starts[i] + tap);
+                const float coverage = min(pixel + 1.0f, right) - max(pixel, left);
+                weights[i * *taps + tap] = max(coverage, 0.0f) / scale;
+            }
+        }
+        return;
+    }
+
+    const float filterSupport = (filter == RESAMPLING_FILTER_BICUBIC) ? 2.0f : 3.0f;
+    const float filterScale = max(scale, 1.0f);
+    const float support = filterSupport * filterScale;
+    *taps = 2 * (int)ceil(support);
+
+    weights.assign(destinationSize * *taps, 0.0f);
+    for (int i = 0; i < destinationSize; i++)
+    {
+        /* Position of the centre of destination pixel i in source pixel indices. */
+        const float centre = (i + 0.5f) * scale - 0.5f;
+        starts[i] = (int)floor(centre - support) + 1;
+
+        float sum = 0.0f;
+        for (int tap = 0; tap < *taps; tap++)
+        {
+            const float distance = (starts[i] + tap - centre) / filterScale;
+            const float weight = (filter == RESAMPLING_FILTER_BICUBIC) ? bicubicWeight(distance) : lanczos3Weight(distance);
+            weights[i * *taps + tap] = weight;
+            sum += weight;
+        }
+        for (int tap = 0; tap < *taps; tap++)
+        {
+            weights[i * *taps + tap] /= sum;
+        }
+    }
+}
+
+/**
+ * \brief Find the weight table for a filter and scale pair, computing and uploading it if it is not cached.
+ * \param[in,out] resampler The resampler holding the cache.
+ * \param[in] filter The filter to use.
+ * \param[in] sourceSize Number of source pixels along the axis.
+ * \param[in] destinationSize Number of destination pixels along the axis.
+ * \param[out] table The cached table.
+ * \return False if an error occurred, otherwise true.
+ */
+bool getResamplingTable(Resampler* resampler, ResamplingFilter filter, int sourceSize, int destinationSize, ResamplingTable* table)
+{
+    ResamplingTableKey key;
+    key.filter = filter;
+    key.sourceSize = sourceSize;
+    key.destinationSize = destinationSize;
+
+    map<ResamplingTableKey, ResamplingTable>::const_iterator cached = resampler->tables.find(key);
+    if (cached != resampler->tables.end())
+    {
+        resampler->tableCacheHits++;
+        *table = cached->second;
+        return true;
+    }
+
+    vector<int> starts;
+    vector<float> weights;
+    ResamplingTable newTable = {0, 0, 0};
+    computeResamplingWeights(filter, sourceSize, destinationSize, starts, weights, &newTable.taps);
+
+    /* The tables never change once created, so they are copied to the device once and only read by the kernels. */
+    cl_int errorNumber = 0;
+    bool createMemoryObjectsSuccess = true;
+    newTable.starts = clCreateBuffer(resampler->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, starts.size() * sizeof(int), &starts[0], &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    newTable.weights = clCreateBuffer(resampler->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, weights.size() * sizeof(float), &weights[0], &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    if (!createMemoryObjectsSuccess)
+    {
+        if (newTable.starts != 0)
+        {
+            clReleaseMemObject(newTable.starts);
+        }
+        if (newTable.weights != 0)
+        {
+            clReleaseMemObject(newTable.weights);
+        }
+        cerr << "Failed to create the resampling weight table. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    resampler->tableCacheMisses++;
+    resampler->tables[key] = newTable;
+    *table = newTable;
+    return true;
+}
+
+/**
+ * \brief Release every OpenCL object owned by a resampler.
+ * \param[in] resampler The resampler to release.
+ * \return False if an error occurred, otherwise true.
+ */
+bool releaseResampler(Resampler* resampler)
+{
+    bool returnValue = true;
+    for (map<ResamplingTableKey, ResamplingTable>::iterator table = resampler->tables.begin(); table != resampler->tables.end(); ++table)
+    {
+        returnValue &= checkSuccess(clReleaseMemObject(table->second.starts));
+        returnValue &= checkSuccess(clReleaseMemObject(table->second.weights));
+    }
+    resampler->tables.clear();
+
+    if (resampler->intermediateImage != 0)
+    {
+        returnValue &= checkSuccess(clReleaseMemObject(resampler->intermediateImage));
+        resampler->intermediateImage = 0;
+    }
+    if (resampler->horizontalKernel != 0)
+    {
+        returnValue &= checkSuccess(clReleaseKernel(resampler->horizontalKernel));
+        resampler->horizontalKernel = 0;
+    }
+    if (resampler->verticalKernel != 0)
+    {
+        returnValue &= checkSuccess(clReleaseKernel(resampler->verticalKernel));
+        resampler->verticalKernel = 0;
+    }
+    return returnValue;
+}
+
+/**
+ * \brief Create the kernels used by a resampler.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] program A built program created from assets/image_resampling.cl.
+ * \param[out] resampler The created resampler. Must be released with releaseResampler.
+ * \return False if an error occurred, otherwise true.
+ */
+bool createResampler(cl_context context, cl_program program, Resampler* resampler)
+{
+    cl_int errorNumber = 0;
+
+    resampler->context = context;
+    resampler->intermediateImage = 0;
+    resampler->intermediateWidth = 0;
+    resampler->intermediateHeight = 0;
+    resampler->tableCacheHits = 0;
+    resampler->tableCacheMisses = 0;
+
+    resampler->horizontalKernel = clCreateKernel(program, "resample_horizontal", &errorNumber);
+    bool createKernelsSuccess = checkSuccess(errorNumber);
+    resampler->verticalKernel = clCreateKernel(program, "resample_vertical", &errorNumber);
+    createKernelsSuccess &= checkSuccess(errorNumber);
+    if (!createKernelsSuccess)
+    {
+        releaseResampler(resampler);
+        cerr << "Failed to create the resampling kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Resize an image with one of the separable resampling filters.
+ * \details Runs a horizontal pass into an intermediate floating point image (so the negative lobes of the
+ *          bicubic and Lanczos filters are not clamped between passes), followed by a vertical pass.
+ * \param[in] commandQueue The command queue to use.
+ * \param[in,out] resampler The resampler holding the cached tables and intermediate image.
+ * \param[in] filter The filter to use.
+ * \param[in] sourceImage Input image object.
+ * \param[in] sourceWidth Width of sourceImage.
+ * \param[in] sourceHeight Height of sourceImage.
+ * \param[out] destinationImage Output image object.
+ * \param[in] destinationWidth Width of destinationImage.
+ * \param[in] destinationHeight Height of destinationImage.
+ * \param[out] events Events of the horizontal and vertical passes. Must be released by the caller.
+ * \return False if an error occurred, otherwise true.
+ */
+bool resampleImage(cl_command_queue commandQueue, Resampler* resampler, ResamplingFilter filter,
+                   cl_mem sourceImage, int sourceWidth, int sourceHeight,
+                   cl_mem destinationImage, int destinationWidth, int destinationHeight,
+                   cl_event events[2])
+{
+    cl_int errorNumber = 0;
+
+    ResamplingTable horizontalTable;
+    ResamplingTable verticalTable;
+    if (!getResamplingTable(resampler, filter, sourceWidth, destinationWidth, &horizontalTable) ||
+        !getResamplingTable(resampler, filter, sourceHeight, destinationHeight, &verticalTable))
+    {
+        return false;
+    }
+
+    /* The intermediate image has the destination width and the source height. It is only recreated when that changes. */
+    if (resampler->intermediateWidth != destinationWidth || resampler->intermediateHeight != sourceHeight)
+    {
+        if (resampler->intermediateImage != 0)
+        {
+            clReleaseMemObject(resampler->intermediateImage);
+        }
+
+        cl_image_format format;
+        format.image_channel_data_type = CL_FLOAT;
+        format.image_channel_order = CL_RGBA;
+        resampler->intermediateImage = clCreateImage2D(resampler->context, CL_MEM_READ_WRITE, &format, destinationWidth, sourceHeight, 0, NULL, &errorNumber);
+        if (!checkSuccess(errorNumber))
+        {
+            resampler->intermediateImage = 0;
+            resampler->intermediateWidth = 0;
+            resampler->intermediateHeight = 0;
+            cerr << "Failed creating the intermediate image. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+        resampler->intermediateWidth = destinationWidth;
+        resampler->intermediateHeight = sourceHeight;
+    }
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(resampler->horizontalKernel, 0, sizeof(cl_mem), &sourceImage));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(resampler->horizontalKernel, 1, sizeof(cl_mem), &resampler->intermediateImage));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(resampler->horizontalKernel, 2, sizeof(cl_mem), &horizontalTable.starts));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(resampler->horizontalKernel, 3, sizeof(cl_mem), &horizontalTable.weights));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(resampler->horizontalKernel, 4, sizeof(cl_int), &horizontalTable.taps));
+
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(resampler->verticalKernel, 0, sizeof(cl_mem), &resampler->intermediateImage));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(resampler->verticalKernel, 1, sizeof(cl_mem), &destinationImage));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(resampler->verticalKernel, 2, sizeof(cl_mem), &verticalTable.starts));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(resampler->verticalKernel, 3, sizeof(cl_mem), &verticalTable.weights));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(resampler->verticalKernel, 4, sizeof(cl_int), &verticalTable.taps));
+    if (!setKernelArgumentsSuccess)
+    {
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    size_t horizontalWorkSize[2] = {(size_t)destinationWidth, (size_t)sourceHeight};
+    size_t verticalWorkSize[2] = {(size_t)destinationWidth, (size_t)destinationHeight};
+    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, resampler->horizontalKernel, 2, NULL, horizontalWorkSize, NULL, 0, NULL, &events[0])) ||
+        !checkSuccess(clEnqueueNDRangeKernel(commandQueue, resampler->verticalKernel, 2, NULL, verticalWorkSize, NULL, 1, &events[0], &events[1])))
+    {
+        cerr << "Failed enqueuing the resampling kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * \brief OpenCL image resampling sample code.
+ * \details Extends the image_scaling sample with higher quality filters than the hardware bilinear filter:
+ *          area averaging for downscaling and bicubic and Lanczos-3 for upscaling.
+ *          Each filter is run twice to show that the second frame reuses the cached weight tables.
+ *          The results are stored in output-area.bmp, output-bicubic.bmp and output-lanczos3.bmp.
+ * \return The exit code of the application, non-zero if a problem occurred.
+ */
+int main(void)
+{
+    cl_context context = 0;
+    cl_command_queue commandQueue = 0;
+    cl_program program = 0;
+    cl_device_id device = 0;
+    cl_kernel kernel = 0;
+    const int numMemoryObjects = 3;
+    const int inputIndex = 0;
+    const int downscaledIndex = 1;
+    const int upscaledIndex = 2;
+    cl_mem memoryObjects[numMemoryObjects] = {0, 0, 0};
+    cl_int errorNumber;
+    Resampler resampler = Resampler();
+
+    /* Factors to resize the image by. Bilinear filtering aliases badly below 0.5. */
+    const float downscaleFactor = 0.3f;
+    const float upscaleFactor = 3.0f;
+    const int numberOfFrames = 2;
+
+    if (!createContext(&context))
+    {
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed to create an OpenCL context. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!createCommandQueue(context, &commandQueue, &device))
+    {
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed to create the OpenCL command queue. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!createProgram(context, device, "assets/image_resampling.cl", &program))
+    {
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed to create OpenCL program." << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!createResampler(context, program, &resampler))
+    {
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed to create the resampler. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Load the input image data. */
+    unsigned char* inputImage = NULL;
+    int width, height;
+    if (!loadFromBitmap("assets/input.bmp", &width, &height, &inputImage))
+    {
+        releaseResampler(&resampler);
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed loading bitmap. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    const int downscaledWidth = max(1, (int)(width * downscaleFactor));
+    const int downscaledHeight = max(1, (int)(height * downscaleFactor));
+    const int upscaledWidth = (int)(width * upscaleFactor);
+    const int upscaledHeight = (int)(height * upscaleFactor);
+
+    /* RGB888 is not a supported OpenCL image format, so RGBA8888 is used as in the image_scaling sample. */
+    cl_image_format format;
+    format.image_channel_data_type = CL_UNORM_INT8;
+    format.image_channel_order = CL_RGBA;
+
+    bool createMemoryObjectsSuccess = true;
+    memoryObjects[inputIndex] = clCreateImage2D(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, &format, width, height, 0, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[downscaledIndex] = clCreateImage2D(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, &format, downscaledWidth, downscaledHeight, 0, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[upscaledIndex] = clCreateImage2D(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, &format, upscaledWidth, upscaledHeight, 0, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    if (!createMemoryObjectsSuccess)
+    {
+        delete[] inputImage;
+        releaseResampler(&resampler);
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed creating the images. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    size_t origin[3] = {0, 0, 0};
+    size_t region[3] = {(size_t)width, (size_t)height, 1};
+    size_t rowPitch;
+    unsigned char* inputImageRGBA = (unsigned char*)clEnqueueMapImage(commandQueue, memoryObjects[inputIndex], CL_TRUE, CL_MAP_WRITE, origin, region, &rowPitch, NULL, 0, NULL, NULL, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        delete[] inputImage;
+        releaseResampler(&resampler);
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed mapping the input image. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    RGBToRGBA(inputImage, inputImageRGBA, width, height);
+    delete[] inputImage;
+
+    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[inputIndex], inputImageRGBA, 0, NULL, NULL)))
+    {
+        releaseResampler(&resampler);
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "Failed unmapping the input image. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    const int numberOfFilters = 3;
+    const ResamplingFilter filters[numberOfFilters] = {RESAMPLING_FILTER_AREA, RESAMPLING_FILTER_BICUBIC, RESAMPLING_FILTER_LANCZOS3};
+    const char* filterNames[numberOfFilters] = {"area", "bicubic", "lanczos3"};
+
+    for (int filterIndex = 0; filterIndex < numberOfFilters; filterIndex++)
+    {
+        /* Area averaging is used for downscaling, the other filters for upscaling. */
+        const bool downscale = (filters[filterIndex] == RESAMPLING_FILTER_AREA);
+        const int outputIndex = downscale ? downscaledIndex : upscaledIndex;
+        const int outputWidth = downscale ? downscaledWidth : upscaledWidth;
+        const int outputHeight = downscale ? downscaledHeight : upscaledHeight;
+
+        for (int frame = 0; frame < numberOfFrames; frame++)
+        {
+            cl_event events[2] = {0, 0};
+            if (!resampleImage(commandQueue, &resampler, filters[filterIndex], memoryObjects[inputIndex], width, height,
+                               memoryObjects[outputIndex], outputWidth, outputHeight, events) ||
+                !checkSuccess(clFinish(commandQueue)))
+            {
+                releaseResampler(&resampler);
+                cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+                cerr << "Failed resampling the image. " << __FILE__ << ":"<< __LINE__ << endl;
+                return 1;
+            }
+
+            cout << filterNames[filterIndex] << " frame " << frame << ", horizontal pass ";
+            printProfilingInfo(events[0]);
+            cout << filterNames[filterIndex] << " frame " << frame << ", vertical pass ";
+            printProfilingInfo(events[1]);
+            clReleaseEvent(events[0]);
+            clReleaseEvent(events[1]);
+        }
+
+        size_t outputRegion[3] = {(size_t)outputWidth, (size_t)outputHeight, 1};
+        unsigned char* outputImage = (unsigned char*)clEnqueueMapImage(commandQueue, memoryObjects[outputIndex], CL_TRUE, CL_MAP_READ, origin, outputRegion, &rowPitch, NULL, 0, NULL, NULL, &errorNumber);
+        if (!checkSuccess(errorNumber))
+        {
+            releaseResampler(&resampler);
+            cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+            cerr << "Failed mapping the output image. " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
+
+        unsigned char* outputImageRGB = new unsigned char[outputWidth * outputHeight * 3];
+        RGBAToRGB(outputImage, outputImageRGB, outputWidth, outputHeight);
+        saveToBitmap(string("output-") + filterNames[filterIndex] + ".bmp", outputWidth, outputHeight, outputImageRGB);
+        delete[] outputImageRGB;
+
+        if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[outputIndex], outputImage, 0, NULL, NULL)))
+        {
+            releaseResampler(&resampler);
+            cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+            cerr << "Failed unmapping the output image. " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
+    }
+
+    cout << "Weight tables computed: " << resampler.tableCacheMisses << ", reused: " << resampler.tableCacheHits << endl;
+
+    releaseResampler(&resampler);
+    cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+
+    return 0;
+}
@@ -10,6 +10,7 @@
 
 #include "common.h"
 #include "image.h"
+#include "device.h"
 
 #include <CL/cl.h>
 #include <iostream>
@@ -96,6 +97,15 @@ int main(void)
     format.image_channel_data_type = CL_UNORM_INT8;
     format.image_channel_order = CL_RGBA;
 
+    /* The formats were cached when they were printed, so this doesn't query the context again. */
+    if (!isImageFormatSupported(context, format))
+    {
+        delete [] inputImage;
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numMemoryObjects);
+        cerr << "CL_RGBA, CL_UNORM_INT8 images are not supported. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
     /* Allocate memory for the input image that can be accessed by the CPU and GPU. */
     bool createMemoryObjectsSuccess = true;
 
@@ -0,0 +1,181 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+/*
+ * SCAN_TYPE is the accumulator type of the integral image, chosen when the program is built:
+ * uint when the sum of the whole image fits in 32 bits, otherwise ulong.
+ */
+#ifndef SCAN_TYPE
+#define SCAN_TYPE ulong
+#endif
+
+/**
+ * \brief Row scan kernel function.
+ * \details Each work-group computes the inclusive prefix sum of one row with the work-efficient Blelloch scan:
+ *          an up-sweep builds partial sums in a balanced tree in local memory, a down-sweep turns them into
+ *          an exclusive scan, and each element then adds its own value. Rows longer than 2 * the work-group size
+ *          are scanned in chunks, carrying the total of the previous chunks into the next.
+ * \param[in] input Luminance image, one byte per pixel.
+ * \param[in] width Width of the image.
+ * \param[out] output Image of the prefix sums of each row.
+ * \param[in] scratch Local memory for 2 * the work-group size values. The work-group size must be a power of 2.
+ */
+__kernel void scan_rows(__global const uchar* restrict input,
+                        const int width,
+                        __global SCAN_TYPE* restrict output,
+                        __local SCAN_TYPE* restrict scratch)
+{
+    const int localId = get_local_id(0);
+    const int halfSize = get_local_size(0);
+    const int chunkSize = 2 * halfSize;
+    const int rowStart = get_group_id(0) * width;
+
+    SCAN_TYPE carry = 0;
+    for (int chunk = 0; chunk < width; chunk += chunkSize)
+    {
+        /* Each work-item loads two elements, padding past the end of the row with zeros. */
+        const int first = chunk + localId;
+        const int second = first + halfSize;
+        const SCAN_TYPE firstValue = (first < width) ? input[rowStart + first] : 0;
+        const SCAN_TYPE secondValue = (second < width) ? input[rowStart + second] : 0;
+        scratch[localId] = firstValue;
+        scratch[localId + halfSize] = secondValue;
+
+        /* [Up-sweep] */
+        int offset = 1;
+        for (int active = halfSize; active > 0; active >>= 1)
+        {
+            barrier(CLK_LOCAL_MEM_FENCE);
+            if (localId < active)
+            {
+                const int left = offset * (2 * localId + 1) - 1;
+                const int right = offset * (2 * localId + 2) - 1;
+                scratch[right] += scratch[left];
+            }
+            offset <<= 1;
+        }
+        /* [Up-sweep] */
+
+        /* The root of the tree is the total of the chunk. */
+        barrier(CLK_LOCAL_MEM_FENCE);
+        const SCAN_TYPE total = scratch[chunkSize - 1];
+        barrier(CLK_LOCAL_MEM_FENCE);
+        if (localId == 0)
+        {
+            scratch[chunkSize - 1] = 0;
+        }
+
+        /* [Down-sweep] */
+        for (int active = 1; active < chunkSize; active <<= 1)
+        {
+            offset >>= 1;
+            barrier(CLK_LOCAL_MEM_FENCE);
+            if (localId < active)
+            {
+                const int left = offset * (2 * localId + 1) - 1;
+                const int right = offset * (2 * localId + 2) - 1;
+                const SCAN_TYPE leftValue = scratch[left];
+                scratch[left] = scratch[right];
+                scratch[right] += leftValue;
+            }
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+        /* [Down-sweep] */
+
+        /* The exclusive scan plus the element itself gives the inclusive scan. */
+        if (first < width)
+        {
+            output[rowStart + first] = carry + scratch[localId] + firstValue;
+        }
+        if (second < width)
+        {
+            output[rowStart + second] = carry + scratch[localId + halfSize] + secondValue;
+        }
+        carry += total;
+
+        /* The next chunk overwrites the scratch memory. */
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+}
+
+/**
+ * \brief Column scan kernel function.
+ * \details Each work-item adds up one column of the row scans in place, which completes the integral image.
+ *          Adjacent work-items read adjacent columns, so every row is read with contiguous accesses.
+ * \param[in,out] integral Row scans on input, integral image on output.
+ * \param[in] width Width of the image.
+ * \param[in] height Height of the image.
+ */
+__kernel void scan_columns(__global SCAN_TYPE* restrict integral,
+                           const int width,
+                           const int height)
+{
+    const int x = get_global_id(0);
+    if (x >= width)
+    {
+        return;
+    }
+
+    SCAN_TYPE sum = 0;
+    for (int y = 0; y < height; y++)
+    {
+        sum += integral[x + y * width];
+        integral[x + y * width] = sum;
+    }
+}
+
+/**
+ * \brief Read the integral image, treating everything above or to the left of the image as 0.
+ * \param[in] integral The integral image.
+ * \param[in] width Width of the image.
+ * \param[in] x Column, may be -1.
+ * \param[in] y Row, may be -1.
+ * \return The sum of the pixels in the rectangle from (0, 0) to (x, y) inclusive.
+ */
+SCAN_TYPE integralAt(__global const SCAN_TYPE* restrict integral, int width, int x, int y)
+{
+    return (x < 0 || y < 0) ? 0 : integral[x + y * width];
+}
+
+/**
+ * \brief Box filter kernel function.
+ * \details Averages the (2 * radius + 1)^2 square around each pixel, clipped to the image,
+ *          using 4 reads of the integral image whatever the radius.
+ * \param[in] integral The integral image.
+ * \param[in] width Width of the image.
+ * \param[in] height Height of the image.
+ * \param[in] radius Radius of the filter in pixels.
+ * \param[out] output Filtered luminance image, one byte per pixel.
+ */
+__kernel void box_filter(__global const SCAN_TYPE* restrict integral,
+                         const int width,
+                         const int height,
+                         const int radius,
+                         __global uchar* restrict output)
+{
+    const int x = get_global_id(0);
+    const int y = get_global_id(1);
+
+    /* The box covers the pixels after (left, top) up to and including (right, bottom). */
+    const int left = max(x - radius - 1, -1);
+    const int top = max(y - radius - 1, -1);
+    const int right = min(x + radius, width - 1);
+    const int bottom = min(y + radius, height - 1);
+
+    /* [Four loads] */
+    const SCAN_TYPE sum = integralAt(integral, width, right, bottom)
+                        - integralAt(integral, width, left, bottom)
+                        - integralAt(integral, width, right, top)
+                        + integralAt(integral, width, left, top);
+    /* [Four loads] */
+
+    const uint area = (right - left) * (bottom - top);
+    output[x + y * width] = (uchar)((sum + area / 2) / area);
+}
@@ -0,0 +1,328 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "common.h"
+#include "image.h"
+
+#include <CL/cl.h>
+#include <iostream>
+#include <string>
+#include <cstddef>
+#include <climits>
+
+using namespace std;
+
+/* Number of kernels used by the sample. */
+const int numberOfKernels = 3;
+
+/**
+ * \brief Release all the kernels and the other OpenCL objects used by the sample.
+ * \details cleanUpOpenCL only releases a single kernel, the remaining kernels are released here.
+ * \return False if an error occurred, otherwise true.
+ */
+bool cleanUpIntegralImage(cl_context context, cl_command_queue commandQueue, cl_program program, cl_kernel* kernels, cl_mem* memoryObjects, int numberOfMemoryObjects)
+{
+    bool returnValue = true;
+    for (int index = 1; index < numberOfKernels; index++)
+    {
+        if (kernels[index] != 0 && !checkSuccess(clReleaseKernel(kernels[index])))
+        {
+            cerr << "Releasing the OpenCL kernel " << index << " failed. " << __FILE__ << ":"<< __LINE__ << endl;
+            returnValue = false;
+        }
+    }
+    returnValue &= cleanUpOpenCL(context, commandQueue, program, kernels[0], memoryObjects, numberOfMemoryObjects);
+    return returnValue;
+}
+
+/**
+ * \brief Integral image OpenCL sample.
+ * \details Builds the integral image (summed-area table) of the luminance of assets/input.bmp:
+ *          a work-efficient (Blelloch) scan along each row followed by a running sum down each column.
+ *          Every value of the integral image is the sum of all the pixels above and to the left of it,
+ *          so a box filter of any radius then costs 4 loads per pixel.
+ *          32-bit accumulators are used when the sum of the whole image fits, otherwise the 64-bit (ulong) path.
+ *          The result of a box filter is stored in output.bmp.
+ * \return The exit code of the application, non-zero if a problem occurred.
+ */
+int main(void)
+{
+    /* Name of the bitmap to load and filter. */
+    string filename = "assets/input.bmp";
+
+    /* Radius of the box filter in pixels. Any radius costs the same. */
+    cl_int radius = 8;
+
+    cl_context context = 0;
+    cl_command_queue commandQueue = 0;
+    cl_program program = 0;
+    cl_device_id device = 0;
+
+    /* Index values for the kernels. */
+    const int rowsKernelIndex = 0;
+    const int columnsKernelIndex = 1;
+    const int boxFilterKernelIndex = 2;
+    const char* kernelNames[numberOfKernels] = {"scan_rows", "scan_columns", "box_filter"};
+    cl_kernel kernels[numberOfKernels] = {0, 0, 0};
+
+    /* Index values for the memory objects. */
+    const int numberOfMemoryObjects = 3;
+    const int inputIndex = 0;
+    const int integralIndex = 1;
+    const int outputIndex = 2;
+    cl_mem memoryObjects[numberOfMemoryObjects] = {0, 0, 0};
+    cl_int errorNumber;
+
+    if (!createContext(&context))
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create an OpenCL context. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    if (!createCommandQueue(context, &commandQueue, &device))
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create the OpenCL command queue. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Load 24-bits per pixel RGB data from a bitmap. */
+    cl_int width;
+    cl_int height;
+    unsigned char* loadedRGBData = NULL;
+    if (!loadFromBitmap(filename, &width, &height, &loadedRGBData))
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed loading bitmap. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    const int numberOfPixels = width * height;
+
+    /* [Choose the accumulator] */
+    /*
+     * The bottom right value of the integral image is the sum of every pixel, at most 255 * width * height.
+     * Images up to about 16 million pixels fit in 32 bits, larger ones need the 64-bit path.
+     */
+    const bool use64Bits = (cl_ulong)numberOfPixels * 255 > UINT_MAX;
+    const size_t scanTypeSize = use64Bits ? sizeof(cl_ulong) : sizeof(cl_uint);
+    const string buildOptions = use64Bits ? "-DSCAN_TYPE=ulong" : "-DSCAN_TYPE=uint";
+    /* [Choose the accumulator] */
+
+    if (!createProgram(context, device, "assets/integral_image.cl", &program, buildOptions))
+    {
+        delete [] loadedRGBData;
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create OpenCL program." << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    for (int index = 0; index < numberOfKernels; index++)
+    {
+        kernels[index] = clCreateKernel(program, kernelNames[index], &errorNumber);
+        if (!checkSuccess(errorNumber))
+        {
+            delete [] loadedRGBData;
+            cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+            cerr << "Failed to create OpenCL kernel " << kernelNames[index] << ". " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
+    }
+
+    /* [Scan work-group size] */
+    /*
+     * The Blelloch scan needs a power of 2 work-group size.
+     * Each work-item scans two elements, so a work-group handles 2 * scanWorkGroupSize pixels of a row at a time.
+     */
+    size_t maximumWorkGroupSize;
+    if (!checkSuccess(clGetKernelWorkGroupInfo(kernels[rowsKernelIndex], device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &maximumWorkGroupSize, NULL)))
+    {
+        delete [] loadedRGBData;
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to get the kernel work-group size. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    size_t scanWorkGroupSize = 1;
+    while (scanWorkGroupSize * 2 <= maximumWorkGroupSize && scanWorkGroupSize * 2 <= 256 && scanWorkGroupSize * 4 <= (size_t)width)
+    {
+        scanWorkGroupSize *= 2;
+    }
+    /* [Scan work-group size] */
+
+    const size_t charBufferSize = numberOfPixels * sizeof(cl_uchar);
+    const size_t integralBufferSize = numberOfPixels * scanTypeSize;
+
+    /* The integral image is only read back for verification, so it is not allocated with CL_MEM_ALLOC_HOST_PTR. */
+    bool createMemoryObjectsSuccess = true;
+    memoryObjects[inputIndex] = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, charBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[integralIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE, integralBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[outputIndex] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, charBufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    if (!createMemoryObjectsSuccess)
+    {
+        delete [] loadedRGBData;
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to create OpenCL buffers. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Map the input memory object to a host side pointer. */
+    cl_uchar* inputLuminance = (cl_uchar*)clEnqueueMapBuffer(commandQueue, memoryObjects[inputIndex], CL_TRUE, CL_MAP_WRITE, 0, charBufferSize, 0, NULL, NULL, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        delete [] loadedRGBData;
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Mapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Convert 24-bits per pixel RGB into 8-bits per pixel luminance data, keeping the total for verification. */
+    RGBToLuminance(loadedRGBData, inputLuminance, width, height);
+    delete [] loadedRGBData;
+
+    cl_ulong expectedTotal = 0;
+    for (int i = 0; i < numberOfPixels; i++)
+    {
+        expectedTotal += inputLuminance[i];
+    }
+
+    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[inputIndex], inputLuminance, 0, NULL, NULL)))
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Setup the kernel arguments. */
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[rowsKernelIndex], 0, sizeof(cl_mem), &memoryObjects[inputIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[rowsKernelIndex], 1, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[rowsKernelIndex], 2, sizeof(cl_mem), &memoryObjects[integralIndex]));
+    /* Local memory for the scan tree: two values per work-item. */
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[rowsKernelIndex], 3, 2 * scanWorkGroupSize * scanTypeSize, NULL));
+
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[columnsKernelIndex], 0, sizeof(cl_mem), &memoryObjects[integralIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[columnsKernelIndex], 1, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[columnsKernelIndex], 2, sizeof(cl_int), &height));
+
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[boxFilterKernelIndex], 0, sizeof(cl_mem), &memoryObjects[integralIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[boxFilterKernelIndex], 1, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[boxFilterKernelIndex], 2, sizeof(cl_int), &height));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[boxFilterKernelIndex], 3, sizeof(cl_int), &radius));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[boxFilterKernelIndex], 4, sizeof(cl_mem), &memoryObjects[outputIndex]));
+    if (!setKernelArgumentsSuccess)
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* [Kernel size] */
+    /* One work-group per row for the row scan, one work-item per column for the column scan, one per pixel for the filter. */
+    size_t rowsGlobalWorksize[1] = {scanWorkGroupSize * (size_t)height};
+    size_t rowsLocalWorksize[1] = {scanWorkGroupSize};
+    size_t columnsGlobalWorksize[1] = {(size_t)width};
+    size_t filterGlobalWorksize[2] = {(size_t)width, (size_t)height};
+    /* [Kernel size] */
+
+    /* Each pass waits on the event of the previous one. */
+    cl_event rowsEvent = 0;
+    cl_event columnsEvent = 0;
+    cl_event filterEvent = 0;
+
+    bool enqueueSuccess = true;
+    enqueueSuccess &= checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernels[rowsKernelIndex], 1, NULL, rowsGlobalWorksize, rowsLocalWorksize, 0, NULL, &rowsEvent));
+    enqueueSuccess &= checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernels[columnsKernelIndex], 1, NULL, columnsGlobalWorksize, NULL, 1, &rowsEvent, &columnsEvent));
+    enqueueSuccess &= checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernels[boxFilterKernelIndex], 2, NULL, filterGlobalWorksize, NULL, 1, &columnsEvent, &filterEvent));
+    if (!enqueueSuccess)
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed enqueuing the kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Wait for completion */
+    if (!checkSuccess(clFinish(commandQueue)))
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed waiting for kernel execution to finish. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    cout << "Integral image uses " << (use64Bits ? 64 : 32) << "-bit accumulators." << endl;
+    cout << "Row scan ";
+    printProfilingInfo(rowsEvent);
+    cout << "Column scan ";
+    printProfilingInfo(columnsEvent);
+    cout << "Box filter (radius " << radius << ") ";
+    printProfilingInfo(filterEvent);
+
+    /* Release the event objects. */
+    bool releaseEventsSuccess = true;
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(rowsEvent));
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(columnsEvent));
+    releaseEventsSuccess &= checkSuccess(clReleaseEvent(filterEvent));
+    if (!releaseEventsSuccess)
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed releasing the event objects. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* [Verify the integral image] */
+    /* The bottom right value of the integral image must be the sum of all the pixels. */
+    cl_ulong total = 0;
+    cl_uint total32 = 0;
+    void* totalPointer = use64Bits ? (void*)&total : (void*)&total32;
+    if (!checkSuccess(clEnqueueReadBuffer(commandQueue, memoryObjects[integralIndex], CL_TRUE, integralBufferSize - scanTypeSize, scanTypeSize, totalPointer, 0, NULL, NULL)))
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed reading the integral image. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    if (!use64Bits)
+    {
+        total = total32;
+    }
+
+    cout << "Sum of the pixel values: " << total << (total == expectedTotal ? " (matches the host)" : " (does not match the host)") << endl;
+    /* [Verify the integral image] */
+
+    /* Map the filtered image to a host side pointer. */
+    cl_uchar* output = (cl_uchar*)clEnqueueMapBuffer(commandQueue, memoryObjects[outputIndex], CL_TRUE, CL_MAP_READ, 0, charBufferSize, 0, NULL, NULL, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Mapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Convert the output luminance array to RGB and save it out to a file. */
+    unsigned char* rgbOut = new unsigned char[numberOfPixels * 3];
+    luminanceToRGB(output, rgbOut, width, height);
+    saveToBitmap("output.bmp", width, height, rgbOut);
+    delete [] rgbOut;
+
+    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[outputIndex], output, 0, NULL, NULL)))
+    {
+        cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* Release OpenCL objects. */
+    cleanUpIntegralImage(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+
+    return 0;
+}
@@ -118,3 +118,486 @@ __kernel void mandelbrot(__global uchar* restrict output,
     vstore4(convert_uchar4(iterationsPerPixel), 0, output + x + y * width);
     /* [Store] */
 }
+
+/*
+ * Width and height of the tiles used by mandelbrot_tiled.
+ * Small tiles balance the load better, large tiles let more of the image be filled from the borders.
+ */
+#define TILE_SIZE 16
+
+/**
+ * \brief Count the iterations for a single pixel.
+ * \details Uses the same mapping from pixels to the complex plane and the same iteration count as the mandelbrot kernel,
+ *          so both kernels produce identical values for every pixel they calculate.
+ * \param[in] x Pixel column.
+ * \param[in] y Pixel row.
+ * \param[in] width Width of the data required.
+ * \param[in] height Height of the data required.
+ * \return The number of iterations before the point escaped, or MAX_ITER if it did not escape.
+ */
+int mandelbrotIterations(int x, int y, int width, int height)
+{
+    const float initialReal = -2 + (x / (float)width * 2.5f);
+    const float initialImaginary = -1 + (y / (float)height * 2);
+
+    float real = initialReal;
+    float imaginary = initialImaginary;
+
+    int iterations = 0;
+    while (iterations < MAX_ITER)
+    {
+        float oldReal = real;
+        real = real * real - imaginary * imaginary + initialReal;
+        imaginary = 2 * oldReal * imaginary + initialImaginary;
+
+        if (real * real + imaginary * imaginary >= 4.0f)
+        {
+            break;
+        }
+        iterations++;
+    }
+    return iterations;
+}
+
+/**
+ * \brief Tiled Mandelbrot kernel function using a persistent-threads work queue.
+ * \details The image is split into TILE_SIZE x TILE_SIZE tiles. Only enough work-groups to fill the device are launched,
+ *          and each one repeatedly takes the next tile from a global counter until all tiles are done. Tiles deep inside the
+ *          set therefore no longer hold up the work-groups around them, which was the main imbalance of the mandelbrot kernel.
+ *
+ *          Each tile is rendered with the Mariani-Silver method: the pixels on the border of the tile are calculated first.
+ *          If they all have the same iteration count the interior is filled with that value without iterating it.
+ *          The Mandelbrot set is connected, so this is exact for tiles bordered by points in the set;
+ *          for tiles bordered by a single escape band it can miss tiny details that are entirely enclosed by the tile.
+ * \param[out] output Output data buffer. Must be width * height * sizeof(cl_uchar) in size.
+ * \param[in] width Width of the data required.
+ * \param[in] height Height of the data required.
+ * \param[in,out] tileCounters Two counters which must be 0 before the kernel is enqueued.
+ *                The first is the index of the next tile to render, the second counts the tiles filled from their border.
+ */
+__kernel void mandelbrot_tiled(__global uchar* restrict output,
+                               const int width,
+                               const int height,
+                               __global int* restrict tileCounters)
+{
+    __local int tileIndex;
+    __local int borderMinimum;
+    __local int borderMaximum;
+
+    const int localId = get_local_id(0);
+    const int localSize = get_local_size(0);
+
+    const int tilesPerRow = (width + TILE_SIZE - 1) / TILE_SIZE;
+    const int numberOfTiles = tilesPerRow * ((height + TILE_SIZE - 1) / TILE_SIZE);
+
+    while (true)
+    {
+        /* [Fetch a tile] */
+        if (localId == 0)
+        {
+            tileIndex = atomic_inc(&tileCounters[0]);
+            borderMinimum = MAX_ITER;
+            borderMaximum = 0;
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        /* Every work-item of the work-group reads the same tile index, so they all leave the loop together. */
+        const int tile = tileIndex;
+        if (tile >= numberOfTiles)
+        {
+            break;
+        }
+        /* [Fetch a tile] */
+
+        /* Tiles on the right and bottom edges are clipped to the image. */
+        const int tileX = (tile % tilesPerRow) * TILE_SIZE;
+        const int tileY = (tile / tilesPerRow) * TILE_SIZE;
+        const int tileWidth = min(TILE_SIZE, width - tileX);
+        const int tileHeight = min(TILE_SIZE, height - tileY);
+
+        /* [Border] */
+        /*
+         * The border is walked as the top row, the bottom row and then the left and right columns (alternating).
+         * A tile which is a single row only has a top row.
+         */
+        const int borderLength = (tileHeight > 1) ? 2 * tileWidth + 2 * (tileHeight - 2) : tileWidth;
+        for (int index = localId; index < borderLength; index += localSize)
+        {
+            int x;
+            int y;
+            if (index < tileWidth)
+            {
+                x = index;
+                y = 0;
+            }
+            else if (index < 2 * tileWidth)
+            {
+                x = index - tileWidth;
+                y = tileHeight - 1;
+            }
+            else
+            {
+                const int sideIndex = index - 2 * tileWidth;
+                x = (sideIndex & 1) ? tileWidth - 1 : 0;
+                y = 1 + sideIndex / 2;
+            }
+
+            const int iterations = mandelbrotIterations(tileX + x, tileY + y, width, height);
+            output[tileX + x + (tileY + y) * width] = (uchar)iterations;
+            atomic_min(&borderMinimum, iterations);
+            atomic_max(&borderMaximum, iterations);
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+        /* [Border] */
+
+        /* [Interior] */
+        const bool uniform = (borderMinimum == borderMaximum);
+        const int interiorWidth = tileWidth - 2;
+        const int interiorSize = (tileWidth > 2 && tileHeight > 2) ? interiorWidth * (tileHeight - 2) : 0;
+
+        if (uniform && localId == 0)
+        {
+            atomic_inc(&tileCounters[1]);
+        }
+
+        for (int index = localId; index < interiorSize; index += localSize)
+        {
+            const int x = tileX + 1 + index % interiorWidth;
+            const int y = tileY + 1 + index / interiorWidth;
+            output[x + y * width] = (uchar)(uniform ? borderMinimum : mandelbrotIterations(x, y, width, height));
+        }
+        /* [Interior] */
+
+        /* The local variables are overwritten when the next tile is fetched, so wait until every work-item is finished with them. */
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+}
+
+/**
+ * \brief Convert an iteration count to the 8-bit output range.
+ * \param[in] iterations Number of iterations before the point escaped.
+ * \param[in] maxIterations Number of iterations after which a point is assumed to be in the set.
+ * \return The output value, 255 for points in the set.
+ */
+uchar scaleIterations(int iterations, int maxIterations)
+{
+    return (uchar)((iterations * 255) / maxIterations);
+}
+
+#ifdef cl_khr_fp64
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+
+/**
+ * \brief Count the iterations for a point given in double precision.
+ * \param[in] initialReal Real coordinate of the point.
+ * \param[in] initialImaginary Imaginary coordinate of the point.
+ * \param[in] maxIterations Number of iterations after which a point is assumed to be in the set.
+ * \return The number of iterations before the point escaped, or maxIterations if it did not escape.
+ */
+int viewportIterations(double initialReal, double initialImaginary, int maxIterations)
+{
+    double real = initialReal;
+    double imaginary = initialImaginary;
+
+    int iterations = 0;
+    while (iterations < maxIterations)
+    {
+        double oldReal = real;
+        real = real * real - imaginary * imaginary + initialReal;
+        imaginary = 2 * oldReal * imaginary + initialImaginary;
+
+        if (real * real + imaginary * imaginary >= 4.0)
+        {
+            break;
+        }
+        iterations++;
+    }
+    return iterations;
+}
+
+/**
+ * \brief Count the iterations for one pixel of a viewport.
+ * \param[in] x Pixel column.
+ * \param[in] y Pixel row.
+ * \param[in] width Width of the data required.
+ * \param[in] height Height of the data required.
+ * \param[in] centre Centre of the viewport as (real high, real low, imaginary high, imaginary low).
+ * \param[in] pixelScale Distance between adjacent pixels in the complex plane.
+ * \param[in] maxIterations Number of iterations after which a point is assumed to be in the set.
+ * \return The number of iterations before the point escaped, or maxIterations if it did not escape.
+ */
+int viewportPixelIterations(int x, int y, int width, int height, float4 centre, float pixelScale, int maxIterations)
+{
+    const double initialReal = ((double)centre.x + centre.y) + (double)(x - width / 2) * pixelScale;
+    const double initialImaginary = ((double)centre.z + centre.w) + (double)(y - height / 2) * pixelScale;
+
+    return viewportIterations(initialReal, initialImaginary, maxIterations);
+}
+
+#else
+
+/*
+ * Double-float arithmetic. A value is stored as the unevaluated sum of two floats (high, low) in a float2,
+ * which gives 48 bits of mantissa on devices without double precision support.
+ */
+
+/**
+ * \brief Add two floats exactly.
+ * \param[in] a First value.
+ * \param[in] b Second value.
+ * \return The rounded sum and its rounding error.
+ */
+float2 doubleFloatTwoSum(float a, float b)
+{
+    const float sum = a + b;
+    const float bVirtual = sum - a;
+    const float error = (a - (sum - bVirtual)) + (b - bVirtual);
+    return (float2)(sum, error);
+}
+
+/**
+ * \brief Add two floats exactly, where |a| >= |b|.
+ * \param[in] a Larger value.
+ * \param[in] b Smaller value.
+ * \return The rounded sum and its rounding error.
+ */
+float2 doubleFloatQuickTwoSum(float a, float b)
+{
+    const float sum = a + b;
+    return (float2)(sum, b - (sum - a));
+}
+
+/**
+ * \brief Add two double-float values.
+ * \param[in] a First value.
+ * \param[in] b Second value.
+ * \return a + b.
+ */
+float2 doubleFloatAdd(float2 a, float2 b)
+{
+    float2 sum = doubleFloatTwoSum(a.x, b.x);
+    sum.y += a.y + b.y;
+    return doubleFloatQuickTwoSum(sum.x, sum.y);
+}
+
+/**
+ * \brief Multiply two double-float values.
+ * \details fma is correctly rounded, so fma(a, b, -(a * b)) is the exact error of the product of the high parts.
+ * \param[in] a First value.
+ * \param[in] b Second value.
+ * \return a * b.
+ */
+float2 doubleFloatMultiply(float2 a, float2 b)
+{
+    const float product = a.x * b.x;
+    float error = fma(a.x, b.x, -product);
+    error += a.x * b.y + a.y * b.x;
+    return doubleFloatQuickTwoSum(product, error);
+}
+
+/**
+ * \brief Count the iterations for a point given in double-float precision.
+ * \param[in] initialReal Real coordinate of the point.
+ * \param[in] initialImaginary Imaginary coordinate of the point.
+ * \param[in] maxIterations Number of iterations after which a point is assumed to be in the set.
+ * \return The number of iterations before the point escaped, or maxIterations if it did not escape.
+ */
+int viewportIterations(float2 initialReal, float2 initialImaginary, int maxIterations)
+{
+    float2 real = initialReal;
+    float2 imaginary = initialImaginary;
+
+    int iterations = 0;
+    while (iterations < maxIterations)
+    {
+        const float2 realSquared = doubleFloatMultiply(real, real);
+        const float2 imaginarySquared = doubleFloatMultiply(imaginary, imaginary);
+        const float2 realTimesImaginary = doubleFloatMultiply(real, imaginary);
+
+        real = doubleFloatAdd(doubleFloatAdd(realSquared, -imaginarySquared), initialReal);
+        imaginary = doubleFloatAdd(realTimesImaginary + realTimesImaginary, initialImaginary);
+
+        /* The escape test only needs float precision. */
+        if (real.x * real.x + imaginary.x * imaginary.x >= 4.0f)
+        {
+            break;
+        }
+        iterations++;
+    }
+    return iterations;
+}
+
+/**
+ * \brief Count the iterations for one pixel of a viewport.
+ * \param[in] x Pixel column.
+ * \param[in] y Pixel row.
+ * \param[in] width Width of the data required.
+ * \param[in] height Height of the data required.
+ * \param[in] centre Centre of the viewport as (real high, real low, imaginary high, imaginary low).
+ * \param[in] pixelScale Distance between adjacent pixels in the complex plane.
+ * \param[in] maxIterations Number of iterations after which a point is assumed to be in the set.
+ * \return The number of iterations before the point escaped, or maxIterations if it did not escape.
+ */
+int viewportPixelIterations(int x, int y, int width, int height, float4 centre, float pixelScale, int maxIterations)
+{
+    /* The pixel offsets are small and exact enough in float, only adding them to the centre needs double-float precision. */
+    const float2 initialReal = doubleFloatAdd(centre.xy, (float2)((x - width / 2) * pixelScale, 0.0f));
+    const float2 initialImaginary = doubleFloatAdd(centre.zw, (float2)((y - height / 2) * pixelScale, 0.0f));
+
+    return viewportIterations(initialReal, initialImaginary, maxIterations);
+}
+
+#endif
+
+/**
+ * \brief Viewport Mandelbrot kernel function.
+ * \details Renders the area of size (width, height) * pixelScale around centre.
+ *          Devices which support cl_khr_fp64 iterate in double precision, other devices use double-float arithmetic,
+ *          which is slower but has nearly the same precision. Both allow around 10^8 times more zoom than float.
+ * \param[out] output Output data buffer. Must be width * height * sizeof(cl_uchar) in size.
+ * \param[in] width Width of the data required.
+ * \param[in] height Height of the data required.
+ * \param[in] centre Real and imaginary coordinate of the centre of the image, each split into a high and low float:
+ *                   (real high, real low, imaginary high, imaginary low).
+ * \param[in] pixelScale Distance between adjacent pixels in the complex plane.
+ * \param[in] maxIterations Number of iterations after which a point is assumed to be in the set.
+ */
+__kernel void mandelbrot_viewport(__global uchar* restrict output,
+                                  const int width,
+                                  const int height,
+                                  const float4 centre,
+                                  const float pixelScale,
+                                  const int maxIterations)
+{
+    const int x = get_global_id(0);
+    const int y = get_global_id(1);
+
+    output[x + y * width] = scaleIterations(viewportPixelIterations(x, y, width, height, centre, pixelScale, maxIterations), maxIterations);
+}
+
+/**
+ * \brief Perturbation Mandelbrot kernel function for deep zooms.
+ * \details At deep zooms the pixels differ from each other by less than the precision of any hardware type,
+ *          but their differences from a nearby reference point are still representable in float.
+ *          The host calculates the orbit Z of the reference point (the centre of the image) in high precision,
+ *          and each pixel c = C + dc iterates only its difference d = z - Z from the reference orbit:
+ *          d' = 2 * Z * d + d * d + dc, which stays accurate in float.
+ *          When the pixel gets closer to 0 than its difference (or the reference orbit has escaped), the difference
+ *          is rebased onto the start of the reference orbit, which avoids the glitches of plain perturbation.
+ * \param[out] output Output data buffer. Must be width * height * sizeof(cl_uchar) in size.
+ * \param[in] width Width of the data required.
+ * \param[in] height Height of the data required.
+ * \param[in] referenceOrbit The reference orbit Z_0 = 0, Z_1, ... as (real, imaginary) pairs.
+ * \param[in] referenceLength Number of points in referenceOrbit, at least 2.
+ * \param[in] pixelScale Distance between adjacent pixels in the complex plane.
+ * \param[in] maxIterations Number of iterations after which a point is assumed to be in the set.
+ */
+__kernel void mandelbrot_perturbation(__global uchar* restrict output,
+                                      const int width,
+                                      const int height,
+                                      __global const float2* restrict referenceOrbit,
+                                      const int referenceLength,
+                                      const float pixelScale,
+                                      const int maxIterations)
+{
+    const int x = get_global_id(0);
+    const int y = get_global_id(1);
+
+    const float2 deltaC = (float2)((x - width / 2) * pixelScale, (y - height / 2) * pixelScale);
+    float2 delta = (float2)(0.0f, 0.0f);
+    int referenceIndex = 0;
+
+    int iterations = 0;
+    while (iterations < maxIterations)
+    {
+        /* d' = (2 * Z + d) * d + dc. */
+        const float2 factor = 2.0f * referenceOrbit[referenceIndex] + delta;
+        delta = (float2)(factor.x * delta.x - factor.y * delta.y, factor.x * delta.y + factor.y * delta.x) + deltaC;
+        referenceIndex++;
+
+        const float2 value = referenceOrbit[referenceIndex] + delta;
+        const float magnitude = dot(value, value);
+        if (magnitude >= 4.0f)
+        {
+            break;
+        }
+        iterations++;
+
+        if (magnitude < dot(delta, delta) || referenceIndex == referenceLength - 1)
+        {
+            delta = value;
+            referenceIndex = 0;
+        }
+    }
+
+    output[x + y * width] = scaleIterations(iterations, maxIterations);
+}
+
+/*
+ * Spacing of the pixels calculated by the first pass of mandelbrot_progressive.
+ * Each later pass halves the spacing, so the image is complete after log2(PROGRESSIVE_FIRST_STEP) + 1 passes.
+ */
+#define PROGRESSIVE_FIRST_STEP 8
+
+/**
+ * \brief Progressive Mandelbrot kernel function.
+ * \details Calculates the pixels whose coordinates are multiples of step. The first pass (step == PROGRESSIVE_FIRST_STEP)
+ *          calculates a coarse image; every later pass only calculates the pixels which are not on the grid of the previous pass.
+ *          Those pixels reuse the earlier results: when the (up to) four surrounding pixels of the previous pass
+ *          have the same value, it is copied instead of iterated. As with Mariani-Silver tiles this is exact inside
+ *          the set and can only miss details smaller than the grid of the previous pass.
+ *          The work-size covers the grid of step, so a global offset can be used to render part of the rows.
+ * \param[in,out] output Output data buffer. Must be width * height * sizeof(cl_uchar) in size and hold the results of the earlier passes.
+ * \param[in] width Width of the data required.
+ * \param[in] height Height of the data required.
+ * \param[in] centre Real and imaginary coordinate of the centre of the image, each split into a high and low float:
+ *                   (real high, real low, imaginary high, imaginary low).
+ * \param[in] pixelScale Distance between adjacent pixels in the complex plane.
+ * \param[in] maxIterations Number of iterations after which a point is assumed to be in the set.
+ * \param[in] step Spacing of the pixels calculated by this pass: PROGRESSIVE_FIRST_STEP, then half of the previous step down to 1.
+ */
+__kernel void mandelbrot_progressive(__global uchar* restrict output,
+                                     const int width,
+                                     const int height,
+                                     const float4 centre,
+                                     const float pixelScale,
+                                     const int maxIterations,
+                                     const int step)
+{
+    const int x = get_global_id(0) * step;
+    const int y = get_global_id(1) * step;
+
+    /* The work-size is rounded up to cover the last partial step of the image. */
+    if (x >= width || y >= height)
+    {
+        return;
+    }
+
+    if (step < PROGRESSIVE_FIRST_STEP)
+    {
+        const int previousStep = step * 2;
+        const int left = x - x % previousStep;
+        const int top = y - y % previousStep;
+
+        /* This pixel was calculated by an earlier pass. */
+        if (left == x && top == y)
+        {
+            return;
+        }
+
+        /* The surrounding pixels of the previous pass, clamped to the image. */
+        const int right = (left + previousStep < width) ? left + previousStep : left;
+        const int bottom = (top + previousStep < height) ? top + previousStep : top;
+
+        const uchar topLeft = output[left + top * width];
+        if (topLeft == output[right + top * width] &&
+            topLeft == output[left + bottom * width] &&
+            topLeft == output[right + bottom * width])
+        {
+            output[x + y * width] = topLeft;
+            return;
+        }
+    }
+
+    output[x + y * width] = scaleIterations(viewportPixelIterations(x, y, width, height, centre, pixelScale, maxIterations), maxIterations);
+}
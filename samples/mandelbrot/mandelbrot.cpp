@@ -10,6 +10,9 @@
 
 #include "common.h"
 #include "image.h"
+#include "binding.h"
+#include "pool.h"
+#include "device.h"
 
 #include <CL/cl.h>
 #include <iostream>
@@ -17,10 +20,472 @@
 #include <sstream>
 #include <cstddef>
 #include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
 #include <sys/time.h>
 
 using namespace std;
 
+/**
+ * \brief Number of kernels used by the sample: mandelbrot, mandelbrot_tiled, mandelbrot_viewport, mandelbrot_perturbation and mandelbrot_progressive.
+ */
+const int numberOfKernels = 5;
+
+/**
+ * \brief Width and height of the tiles rendered by mandelbrot_tiled. Must match TILE_SIZE in assets/mandelbrot.cl.
+ */
+const int tileSize = 16;
+
+/**
+ * \brief Spacing of the pixels calculated by the first progressive pass. Must match PROGRESSIVE_FIRST_STEP in assets/mandelbrot.cl.
+ */
+const int progressiveFirstStep = 8;
+
+/**
+ * \brief Number of rows in each tile streamed by renderMandelbrotProgressive. Must be a multiple of progressiveFirstStep.
+ */
+const int progressiveTileHeight = 64;
+
+/**
+ * \brief Release the OpenCL objects used by the sample.
+ * \details Releases the kernels which cleanUpOpenCL does not know about, then calls cleanUpOpenCL.
+ * \param[in] context The OpenCL context to release.
+ * \param[in] commandQueue The OpenCL command queue to release.
+ * \param[in] program The OpenCL program to release.
+ * \param[in] kernels The numberOfKernels OpenCL kernels to release.
+ * \param[in] memoryObjects An array of OpenCL memory objects to release.
+ * \param[in] numberOfMemoryObjects The number of memory objects in memoryObjects.
+ * \return False if an error occurred, otherwise true.
+ */
+bool cleanUpMandelbrot(cl_context context, cl_command_queue commandQueue, cl_program program, cl_kernel* kernels, cl_mem* memoryObjects, int numberOfMemoryObjects)
+{
+    bool returnValue = true;
+    for (int index = 1; index < numberOfKernels; index++)
+    {
+        if (kernels[index] != 0 && !checkSuccess(clReleaseKernel(kernels[index])))
+        {
+            cerr << "Releasing the OpenCL kernel " << index << " failed. " << __FILE__ << ":"<< __LINE__ << endl;
+            returnValue = false;
+        }
+    }
+    returnValue &= cleanUpOpenCL(context, commandQueue, program, kernels[0], memoryObjects, numberOfMemoryObjects);
+    return returnValue;
+}
+
+/**
+ * \brief The area of the complex plane to render.
+ * \details The centre is held in long double so that deep zoom positions can be given to more digits than a double holds
+ *          on platforms where long double is wider. The reference orbit used by perturbation is calculated in the same precision.
+ */
+struct MandelbrotViewport
+{
+    long double centreReal; /**< \brief Real coordinate of the centre of the image. */
+    long double centreImaginary; /**< \brief Imaginary coordinate of the centre of the image. */
+    long double pixelScale; /**< \brief Distance between adjacent pixels in the complex plane. */
+    cl_int width; /**< \brief Width of the image in pixels. */
+    cl_int height; /**< \brief Height of the image in pixels. */
+    cl_int maxIterations; /**< \brief Number of iterations after which a point is assumed to be in the set. */
+};
+
+/**
+ * \brief How renderMandelbrotViewport calculates the pixels.
+ */
+enum MandelbrotMode
+{
+    MANDELBROT_MODE_DIRECT, /**< \brief Iterate every pixel in double precision, or double-float where cl_khr_fp64 is not supported. */
+    MANDELBROT_MODE_PERTURBATION /**< \brief Iterate float differences from a reference orbit calculated on the host. */
+};
+
+/**
+ * \brief Choose the rendering mode for a viewport.
+ * \details Direct iteration needs no host work, but it is limited by the precision it iterates in:
+ *          53 bits for double and about 48 bits for double-float. Once the pixels are closer together than about 2^-44
+ *          of the magnitude of the centre, which leaves a few bits of either to tell neighbouring pixels apart,
+ *          perturbation is used instead, which keeps the per-pixel work in float at any zoom.
+ * \param[in] viewport The viewport to render.
+ * \return The mode to use.
+ */
+MandelbrotMode chooseMandelbrotMode(const MandelbrotViewport& viewport)
+{
+    const long double magnitude = max(max(fabsl(viewport.centreReal), fabsl(viewport.centreImaginary)), 1.0L);
+    return (viewport.pixelScale < magnitude * ldexpl(1.0L, -44)) ? MANDELBROT_MODE_PERTURBATION : MANDELBROT_MODE_DIRECT;
+}
+
+/**
+ * \brief Calculate the orbit of the centre of a viewport.
+ * \details Iterates z = z * z + c from z = 0 in long double until the orbit escapes or maxIterations is reached.
+ *          The points are only needed to float precision by mandelbrot_perturbation, as it adds small differences to them.
+ * \param[in] viewport The viewport to calculate the reference orbit for.
+ * \param[out] orbit The orbit as (real, imaginary) pairs, starting with 0.
+ */
+void computeReferenceOrbit(const MandelbrotViewport& viewport, vector<float>& orbit)
+{
+    long double real = 0.0L;
+    long double imaginary = 0.0L;
+
+    orbit.clear();
+    orbit.push_back(0.0f);
+    orbit.push_back(0.0f);
+    for (int iteration = 0; iteration < viewport.maxIterations; iteration++)
+    {
+        long double oldReal = real;
+        real = real * real - imaginary * imaginary + viewport.centreReal;
+        imaginary = 2 * oldReal * imaginary + viewport.centreImaginary;
+
+        orbit.push_back((float)real);
+        orbit.push_back((float)imaginary);
+
+        if (real * real + imaginary * imaginary >= 4.0L)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * \brief Split the centre of a viewport into high and low floats.
+ * \details The kernels add the parts back together in double or double-float precision.
+ * \param[in] viewport The viewport.
+ * \return The centre as (real high, real low, imaginary high, imaginary low).
+ */
+cl_float4 splitViewportCentre(const MandelbrotViewport& viewport)
+{
+    cl_float4 centre;
+    centre.s[0] = (cl_float)viewport.centreReal;
+    centre.s[1] = (cl_float)(viewport.centreReal - centre.s[0]);
+    centre.s[2] = (cl_float)viewport.centreImaginary;
+    centre.s[3] = (cl_float)(viewport.centreImaginary - centre.s[2]);
+    return centre;
+}
+
+/**
+ * \brief Arguments of the mandelbrot_viewport kernel.
+ */
+typedef KernelSignature<cl_mem, int, int, cl_float4, float, int> MandelbrotViewportSignature;
+
+/**
+ * \brief Arguments of the mandelbrot_perturbation kernel.
+ */
+typedef KernelSignature<cl_mem, int, int, cl_mem, int, float, int> MandelbrotPerturbationSignature;
+
+/**
+ * \brief Render a viewport into a buffer.
+ * \param[in,out] orbitPool Pool the reference orbit buffer is allocated from.
+ * \param[in] commandQueue The command queue to use.
+ * \param[in,out] viewportBinding Binding of the mandelbrot_viewport kernel.
+ * \param[in,out] perturbationBinding Binding of the mandelbrot_perturbation kernel.
+ * \param[in] viewport The viewport to render.
+ * \param[in] mode How to calculate the pixels, usually chooseMandelbrotMode(viewport).
+ * \param[out] output Output buffer. Must be viewport.width * viewport.height * sizeof(cl_uchar) in size.
+ * \param[out] event Event for the kernel. Must be released by the caller.
+ * \return False if an error occurred, otherwise true.
+ */
+bool renderMandelbrotViewport(BufferPool* orbitPool, cl_command_queue commandQueue, KernelBinding* viewportBinding, KernelBinding* perturbationBinding,
+                              const MandelbrotViewport& viewport, MandelbrotMode mode, cl_mem output, cl_event* event)
+{
+    size_t globalWorksize[2] = {(size_t)viewport.width, (size_t)viewport.height};
+    const cl_float pixelScale = (cl_float)viewport.pixelScale;
+    bool setKernelArgumentsSuccess = true;
+
+    if (mode == MANDELBROT_MODE_DIRECT)
+    {
+        const cl_float4 centre = splitViewportCentre(viewport);
+
+        /* Only the arguments which differ from the previous frame reach the driver. */
+        setKernelArgumentsSuccess &= setKernelArguments<MandelbrotViewportSignature>(viewportBinding, output, viewport.width, viewport.height,
+                                                                                    centre, pixelScale, viewport.maxIterations);
+        if (!setKernelArgumentsSuccess)
+        {
+            cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+
+        if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, viewportBinding->kernel, 2, NULL, globalWorksize, NULL, 0, NULL, event)))
+        {
+            cerr << "Failed enqueuing the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+            return false;
+        }
+        return true;
+    }
+
+    vector<float> orbit;
+    computeReferenceOrbit(viewport, orbit);
+    const cl_int referenceLength = orbit.size() / 2;
+
+    /*
+     * The orbit buffer is recycled from frame to frame. The queue is in-order,
+     * so the write waits for the previous kernel reading the buffer to finish.
+     */
+    cl_mem referenceOrbit = NULL;
+    if (!allocatePoolBuffer(orbitPool, orbit.size() * sizeof(float), &referenceOrbit) ||
+        !checkSuccess(clEnqueueWriteBuffer(commandQueue, referenceOrbit, CL_TRUE, 0, orbit.size() * sizeof(float), &orbit[0], 0, NULL, NULL)))
+    {
+        if (referenceOrbit != NULL)
+        {
+            releasePoolBuffer(orbitPool, referenceOrbit);
+        }
+        cerr << "Failed to create the reference orbit buffer. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    setKernelArgumentsSuccess &= setKernelArguments<MandelbrotPerturbationSignature>(perturbationBinding, output, viewport.width, viewport.height,
+                                                                                    referenceOrbit, referenceLength, pixelScale, viewport.maxIterations);
+
+    bool enqueueSuccess = setKernelArgumentsSuccess &&
+                          checkSuccess(clEnqueueNDRangeKernel(commandQueue, perturbationBinding->kernel, 2, NULL, globalWorksize, NULL, 0, NULL, event));
+
+    /* A recycled buffer is the same memory object, so the binding can skip setting it again next frame. */
+    releasePoolBuffer(orbitPool, referenceOrbit);
+
+    if (!enqueueSuccess)
+    {
+        cerr << "Failed enqueuing the perturbation kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief A part of the image delivered by renderMandelbrotProgressive.
+ * \details Only the pixels whose coordinates are multiples of step are valid.
+ *          A viewer can show the tile immediately by drawing each of them as a step x step block.
+ */
+struct MandelbrotTile
+{
+    cl_int pass; /**< \brief Index of the pass, 0 for the coarse pass. */
+    cl_int step; /**< \brief Spacing of the valid pixels. 1 when the tile is final. */
+    cl_int x; /**< \brief First column of the tile. */
+    cl_int y; /**< \brief First row of the tile. */
+    cl_int width; /**< \brief Number of columns in the tile. */
+    cl_int height; /**< \brief Number of rows in the tile. */
+    cl_int rowPitch; /**< \brief Distance between the rows of data in bytes. */
+    const cl_uchar* data; /**< \brief The first pixel of the tile. Only valid during the callback. */
+};
+
+/**
+ * \brief Function called by renderMandelbrotProgressive for every completed tile.
+ * \details Tiles are delivered in order: every tile of a pass before any tile of the next pass.
+ *          The kernels of the next pass run while the callback is executing.
+ * \param[in] tile The completed tile.
+ * \param[in] userData The pointer passed to renderMandelbrotProgressive.
+ */
+typedef void (*MandelbrotTileCallback)(const MandelbrotTile& tile, void* userData);
+
+/**
+ * \brief Wait for the tiles of one progressive pass to be read back and pass them to the callback.
+ * \param[in,out] readEvents Events of the reads of each tile, in order. Released by this function.
+ * \param[in] image Host copy of the image the tiles are read into.
+ * \param[in] width Width of the image.
+ * \param[in] height Height of the image.
+ * \param[in] pass Index of the pass.
+ * \param[in] step Spacing of the pixels calculated by the pass.
+ * \param[in] callback Function to call for each tile.
+ * \param[in] userData Pointer passed to callback.
+ * \return False if an error occurred, otherwise true.
+ */
+bool deliverProgressiveTiles(vector<cl_event>& readEvents, const vector<cl_uchar>& image, int width, int height, int pass, int step,
+                             MandelbrotTileCallback callback, void* userData)
+{
+    bool returnValue = true;
+    for (size_t index = 0; index < readEvents.size(); index++)
+    {
+        if (returnValue && checkSuccess(clWaitForEvents(1, &readEvents[index])))
+        {
+            MandelbrotTile tile;
+            tile.pass = pass;
+            tile.step = step;
+            tile.x = 0;
+            tile.y = index * progressiveTileHeight;
+            tile.width = width;
+            tile.height = min(progressiveTileHeight, height - tile.y);
+            tile.rowPitch = width;
+            tile.data = &image[tile.y * width];
+            callback(tile, userData);
+        }
+        else
+        {
+            returnValue = false;
+        }
+        clReleaseEvent(readEvents[index]);
+    }
+    readEvents.clear();
+    return returnValue;
+}
+
+/**
+ * \brief Render a viewport progressively, streaming the tiles of each pass as soon as they are complete.
+ * \details The first pass calculates every progressiveFirstStep-th pixel in each direction, so the whole image can be shown
+ *          after 1/64 of the work. Each following pass halves the spacing and reuses the results of the earlier passes
+ *          (see mandelbrot_progressive). Every pass is split into tiles of progressiveTileHeight rows, each of which is read back
+ *          as soon as its kernel finishes. The next pass is enqueued before the tiles of the current pass are delivered,
+ *          so the device keeps working while the callback runs. Tiles are read into two host images used by alternate passes.
+ *          Only direct iteration is supported, so viewports for which chooseMandelbrotMode picks perturbation are rejected.
+ * \param[in] commandQueue The command queue to use. Must be in-order.
+ * \param[in] progressiveKernel The mandelbrot_progressive kernel.
+ * \param[in] viewport The viewport to render.
+ * \param[out] output Output buffer. Must be viewport.width * viewport.height * sizeof(cl_uchar) in size. Holds the final image on return.
+ * \param[in] callback Function called for every completed tile.
+ * \param[in] userData Pointer passed to callback.
+ * \return False if an error occurred, otherwise true.
+ */
+bool renderMandelbrotProgressive(cl_command_queue commandQueue, cl_kernel progressiveKernel, const MandelbrotViewport& viewport,
+                                 cl_mem output, MandelbrotTileCallback callback, void* userData)
+{
+    if (chooseMandelbrotMode(viewport) != MANDELBROT_MODE_DIRECT)
+    {
+        cerr << "The viewport is too deep for progressive rendering. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    const cl_float4 centre = splitViewportCentre(viewport);
+    const cl_float pixelScale = (cl_float)viewport.pixelScale;
+    const int width = viewport.width;
+    const int height = viewport.height;
+
+    bool setKernelArgumentsSuccess = true;
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(progressiveKernel, 0, sizeof(cl_mem), &output));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(progressiveKernel, 1, sizeof(cl_int), &viewport.width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(progressiveKernel, 2, sizeof(cl_int), &viewport.height));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(progressiveKernel, 3, sizeof(cl_float4), &centre));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(progressiveKernel, 4, sizeof(cl_float), &pixelScale));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(progressiveKernel, 5, sizeof(cl_int), &viewport.maxIterations));
+    if (!setKernelArgumentsSuccess)
+    {
+        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    vector<cl_uchar> images[2];
+    images[0].resize(width * height);
+    images[1].resize(width * height);
+    vector<cl_event> readEvents[2];
+
+    bool returnValue = true;
+    int pass = 0;
+    for (cl_int step = progressiveFirstStep; step >= 1 && returnValue; step /= 2, pass++)
+    {
+        vector<cl_uchar>& image = images[pass % 2];
+
+        /* Kernel arguments are captured when a kernel is enqueued, so the step can be changed between passes. */
+        returnValue &= checkSuccess(clSetKernelArg(progressiveKernel, 6, sizeof(cl_int), &step));
+        for (int tileY = 0; tileY < height && returnValue; tileY += progressiveTileHeight)
+        {
+            const int tileHeight = min(progressiveTileHeight, height - tileY);
+            size_t globalWorkOffset[2] = {0, (size_t)(tileY / step)};
+            size_t globalWorksize[2] = {(size_t)((width + step - 1) / step), (size_t)((tileHeight + step - 1) / step)};
+
+            cl_event readEvent = 0;
+            returnValue &= checkSuccess(clEnqueueNDRangeKernel(commandQueue, progressiveKernel, 2, globalWorkOffset, globalWorksize, NULL, 0, NULL, NULL));
+            returnValue &= checkSuccess(clEnqueueReadBuffer(commandQueue, output, CL_FALSE, tileY * width, tileHeight * width, &image[tileY * width], 0, NULL, &readEvent));
+            if (readEvent != 0)
+            {
+                readEvents[pass % 2].push_back(readEvent);
+            }
+        }
+
+        /* Deliver the previous pass while this one runs. */
+        if (pass > 0 && returnValue)
+        {
+            returnValue &= deliverProgressiveTiles(readEvents[(pass - 1) % 2], images[(pass - 1) % 2], width, height, pass - 1, step * 2, callback, userData);
+        }
+    }
+
+    if (returnValue)
+    {
+        returnValue &= deliverProgressiveTiles(readEvents[(pass - 1) % 2], images[(pass - 1) % 2], width, height, pass - 1, 1, callback, userData);
+    }
+
+    if (!returnValue)
+    {
+        /* Reads may still be writing to the host images, so wait for them before the images are freed. */
+        clFinish(commandQueue);
+        for (int index = 0; index < 2; index++)
+        {
+            for (size_t event = 0; event < readEvents[index].size(); event++)
+            {
+                clReleaseEvent(readEvents[index][event]);
+            }
+        }
+        cerr << "Failed rendering the progressive passes. " << __FILE__ << ":"<< __LINE__ << endl;
+    }
+    return returnValue;
+}
+
+/**
+ * \brief Information gathered by recordProgressiveTile.
+ */
+struct ProgressiveStatistics
+{
+    timeval start; /**< \brief When rendering started. */
+    double firstTileMilliseconds; /**< \brief Time from start to the first tile, or a negative value before it arrives. */
+    int tiles; /**< \brief Number of tiles delivered. */
+    FILE* stream; /**< \brief File or pipe to write the tiles to, or NULL. */
+};
+
+/**
+ * \brief Example MandelbrotTileCallback which measures the time to the first tile and optionally streams the tiles.
+ * \details Each tile is written to the stream as 6 cl_ints (pass, step, x, y, width, height) followed by height rows of width bytes,
+ *          so a viewer reading from a named pipe can show every pass as it arrives.
+ * \param[in] tile The completed tile.
+ * \param[in] userData A ProgressiveStatistics.
+ */
+void recordProgressiveTile(const MandelbrotTile& tile, void* userData)
+{
+    ProgressiveStatistics* statistics = (ProgressiveStatistics*)userData;
+    if (statistics->firstTileMilliseconds < 0)
+    {
+        timeval now;
+        gettimeofday(&now, NULL);
+        statistics->firstTileMilliseconds = (now.tv_sec - statistics->start.tv_sec) * 1000.0 + (now.tv_usec - statistics->start.tv_usec) / 1000.0;
+    }
+    statistics->tiles++;
+
+    if (statistics->stream != NULL)
+    {
+        const cl_int header[6] = {tile.pass, tile.step, tile.x, tile.y, tile.width, tile.height};
+        fwrite(header, sizeof(header), 1, statistics->stream);
+        for (int row = 0; row < tile.height; row++)
+        {
+            fwrite(tile.data + row * tile.rowPitch, 1, tile.width, statistics->stream);
+        }
+        fflush(statistics->stream);
+    }
+}
+
+/**
+ * \brief Save Mandelbrot data from a buffer as a greyscale bitmap.
+ * \param[in] commandQueue The command queue to use.
+ * \param[in] buffer Buffer holding width * height iteration counts.
+ * \param[in] width Width of the data.
+ * \param[in] height Height of the data.
+ * \param[in] filename Name of the bitmap to write.
+ * \return False if an error occurred, otherwise true.
+ */
+bool saveMandelbrot(cl_command_queue commandQueue, cl_mem buffer, int width, int height, const char* filename)
+{
+    cl_int errorNumber = 0;
+    cl_uchar* output = (cl_uchar*)clEnqueueMapBuffer(commandQueue, buffer, CL_TRUE, CL_MAP_READ, 0, width * height * sizeof(cl_uchar), 0, NULL, NULL, &errorNumber);
+    if (!checkSuccess(errorNumber))
+    {
+        cerr << "Mapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    unsigned char* rgbOut = new unsigned char[width * height * 3];
+    luminanceToRGB(output, rgbOut, width, height);
+    bool returnValue = saveToBitmap(filename, width, height, rgbOut);
+    delete [] rgbOut;
+
+    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, buffer, output, 0, NULL, NULL)))
+    {
+        cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+    return returnValue;
+}
+
 /**
  * \brief A sample which generates Mandelbrot data for a given data size.
  * \details For a given height and width, the sample will test each pixel
@@ -28,79 +493,137 @@ using namespace std;
  *          value is not part of the Mandelbrot set. This data is output
  *          as a greyscale bitmap image. White pixels could not be ruled out
  *          of the Mandelbrot set in the number of iterations used.
+ *          The data is generated twice: once by the mandelbrot kernel, which calculates every pixel,
+ *          and once by the mandelbrot_tiled kernel, which uses a persistent-threads tile queue
+ *          and fills tiles with a uniform border without iterating their interior.
+ *          The run times and the number of pixels where the two results differ are printed.
+ *          Two zoomed viewports are then rendered with mandelbrot_viewport and mandelbrot_perturbation
+ *          and saved as output-viewport.bmp and output-deep-zoom.bmp.
+ *          Finally the first viewport is rendered progressively and saved as output-progressive.bmp,
+ *          printing the time until the coarse pass is available.
+ * \param[in] argc Number of command line arguments.
+ * \param[in] argv Optionally the width and height of the images to render (the width must be a multiple of 4),
+ *                 followed by a file or named pipe to stream the progressive tiles to.
  * \return The exit code of the application, non-zero if a problem occurred.
  */
-int main(void)
+int main(int argc, char** argv)
 {
     cl_context context = 0;
     cl_command_queue commandQueue = 0;
     cl_program program = 0;
     cl_device_id device = 0;
-    cl_kernel kernel = 0;
-    const unsigned int numberOfMemoryObjects = 1;
-    cl_mem memoryObjects[numberOfMemoryObjects] = {0};
+    cl_kernel kernels[numberOfKernels] = {0, 0, 0, 0, 0};
+    const char* kernelNames[numberOfKernels] = {"mandelbrot", "mandelbrot_tiled", "mandelbrot_viewport", "mandelbrot_perturbation", "mandelbrot_progressive"};
+    const unsigned int numberOfMemoryObjects = 3;
+    const int referenceOutputIndex = 0;
+    const int tiledOutputIndex = 1;
+    const int tileCountersIndex = 2;
+    cl_mem memoryObjects[numberOfMemoryObjects] = {0, 0, 0};
     cl_int errorNumber;
 
+    /* Width and height of the Mandelbrot data you want to be produced. */
+    cl_int width = 4096;
+    cl_int height = 3280;
+    if (argc >= 3)
+    {
+        width = atoi(argv[1]);
+        height = atoi(argv[2]);
+    }
+    /* The mandelbrot kernel calculates 4 pixels per work-item. */
+    if (argc == 2 || argc > 4 || width <= 0 || height <= 0 || width % 4 != 0)
+    {
+        cerr << "Usage: " << argv[0] << " [width height [tile stream]], where width is a multiple of 4. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
     if (!createContext(&context))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create an OpenCL context. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
     if (!createCommandQueue(context, &commandQueue, &device))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create the OpenCL command queue. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
     if (!createProgram(context, device, "assets/mandelbrot.cl", &program))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create OpenCL program." << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
-    kernel = clCreateKernel(program, "mandelbrot", &errorNumber);
-    if (!checkSuccess(errorNumber))
+    for (int index = 0; index < numberOfKernels; index++)
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed to create OpenCL kernel. " << __FILE__ << ":"<< __LINE__ << endl;
-        return 1;
+        kernels[index] = clCreateKernel(program, kernelNames[index], &errorNumber);
+        if (!checkSuccess(errorNumber))
+        {
+            cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+            cerr << "Failed to create OpenCL kernel " << kernelNames[index] << ". " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
     }
 
-    /* Width and height of the Mandelbrot data you want to be produced. */
-    cl_int width = 4096;
-    cl_int height = 3280;
-
     /* The output buffer is the size of the Mandelbrot data. */
     size_t bufferSize = width * height * sizeof(cl_uchar);
 
-    /* Create an output buffer for final data. */
-    memoryObjects[0] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, bufferSize, NULL, &errorNumber);
-    if (!checkSuccess(errorNumber))
+    /* Create an output buffer for each kernel, and the tile counters used by mandelbrot_tiled. */
+    bool createMemoryObjectsSuccess = true;
+    memoryObjects[referenceOutputIndex] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, bufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[tiledOutputIndex] = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR, bufferSize, NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    memoryObjects[tileCountersIndex] = clCreateBuffer(context, CL_MEM_READ_WRITE, 2 * sizeof(cl_int), NULL, &errorNumber);
+    createMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    if (!createMemoryObjectsSuccess)
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create OpenCL buffer. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
     /* Setup the kernel arguments. */
     bool setKernelArgumentsSuccess = true;
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 0, sizeof(cl_mem), &memoryObjects[0]));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 1, sizeof(cl_int), &width));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 2, sizeof(cl_int), &height));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[0], 0, sizeof(cl_mem), &memoryObjects[referenceOutputIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[0], 1, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[0], 2, sizeof(cl_int), &height));
+
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[1], 0, sizeof(cl_mem), &memoryObjects[tiledOutputIndex]));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[1], 1, sizeof(cl_int), &width));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[1], 2, sizeof(cl_int), &height));
+    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernels[1], 3, sizeof(cl_mem), &memoryObjects[tileCountersIndex]));
 
     if (!setKernelArgumentsSuccess)
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
-    /* An event to associate with the Kernel. Allows us to retreive profiling information later. */
-    cl_event event = 0;
+    /* [Persistent work size] */
+    /*
+     * mandelbrot_tiled loops over tiles until there are none left, so only enough work-groups to keep every
+     * compute unit busy are launched. A few work-groups per compute unit hide the latency of the barriers.
+     */
+    const DeviceInfo* deviceInfo = NULL;
+    size_t maximumWorkGroupSize = 0;
+    bool queryInfoSuccess = getDeviceInfo(device, &deviceInfo);
+    queryInfoSuccess &= checkSuccess(clGetKernelWorkGroupInfo(kernels[1], device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &maximumWorkGroupSize, NULL));
+    if (!queryInfoSuccess)
+    {
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to query the device and kernel limits. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    const size_t workGroupsPerComputeUnit = 4;
+    size_t tiledLocalWorksize[1] = {min((size_t)64, maximumWorkGroupSize)};
+    size_t tiledGlobalWorksize[1] = {max((cl_uint)1, deviceInfo->computeUnits) * workGroupsPerComputeUnit * tiledLocalWorksize[0]};
+    /* [Persistent work size] */
 
     /* [Kernel size] */
     /*
@@ -110,56 +633,241 @@ int main(void)
     size_t globalWorksize[2] = {width / 4, height};
     /* [Kernel size] */
 
-    /* Enqueue the kernel */
-    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernel, 2, NULL, globalWorksize, NULL, 0, NULL, &event)))
+    /* The tile queue starts at the first tile every time the tiled kernel is enqueued. */
+    cl_int initialTileCounters[2] = {0, 0};
+
+    /* Events to associate with the kernels. Allows us to retreive profiling information later. */
+    const int numberOfComparedKernels = 2;
+    cl_event events[numberOfComparedKernels] = {0, 0};
+
+    /* Enqueue the kernels */
+    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernels[0], 2, NULL, globalWorksize, NULL, 0, NULL, &events[0])) ||
+        !checkSuccess(clEnqueueWriteBuffer(commandQueue, memoryObjects[tileCountersIndex], CL_FALSE, 0, sizeof(initialTileCounters), initialTileCounters, 0, NULL, NULL)) ||
+        !checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernels[1], 1, NULL, tiledGlobalWorksize, tiledLocalWorksize, 0, NULL, &events[1])))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed enqueuing the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed enqueuing the kernels. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
     /* Wait for kernel execution completion. */
     if (!checkSuccess(clFinish(commandQueue)))
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed waiting for kernel execution to finish. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
-    /* Print the profiling information for the event. */
-    printProfilingInfo(event);
-    /* Release the event object. */
-    if (!checkSuccess(clReleaseEvent(event)))
+    /* Print the profiling information for the events. */
+    for (int index = 0; index < numberOfComparedKernels; index++)
     {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed releasing the event object. " << __FILE__ << ":"<< __LINE__ << endl;
+        cout << kernelNames[index] << ": ";
+        printProfilingInfo(events[index]);
+        /* Release the event object. */
+        if (!checkSuccess(clReleaseEvent(events[index])))
+        {
+            cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+            cerr << "Failed releasing the event object. " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
+    }
+
+    cl_int tileCounters[2] = {0, 0};
+    if (!checkSuccess(clEnqueueReadBuffer(commandQueue, memoryObjects[tileCountersIndex], CL_TRUE, 0, sizeof(tileCounters), tileCounters, 0, NULL, NULL)))
+    {
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed to read the tile counters. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
-    /* Map the output memory to a host side pointer. */
-    cl_uchar* output = (cl_uchar*)clEnqueueMapBuffer(commandQueue, memoryObjects[0], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, NULL, &errorNumber);
-    if (!checkSuccess(errorNumber))
+    /* Map the output memory to host side pointers. */
+    cl_uchar* referenceOutput = (cl_uchar*)clEnqueueMapBuffer(commandQueue, memoryObjects[referenceOutputIndex], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, NULL, &errorNumber);
+    bool mapMemoryObjectsSuccess = checkSuccess(errorNumber);
+    cl_uchar* output = (cl_uchar*)clEnqueueMapBuffer(commandQueue, memoryObjects[tiledOutputIndex], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, NULL, &errorNumber);
+    mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    if (!mapMemoryObjectsSuccess)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+       cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
        cerr << "Mapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
        return 1;
     }
 
+    /*
+     * Filling a tile from its border is exact for tiles bordered by the set,
+     * but can miss details enclosed by a tile of a single escape band, so report how often that happened.
+     */
+    int differentPixels = 0;
+    for (int index = 0; index < width * height; index++)
+    {
+        if (output[index] != referenceOutput[index])
+        {
+            differentPixels++;
+        }
+    }
+    const int numberOfTiles = ((width + tileSize - 1) / tileSize) * ((height + tileSize - 1) / tileSize);
+    cout << "Tiles filled from their border: " << tileCounters[1] << " of " << numberOfTiles << endl;
+    cout << "Pixels different from the mandelbrot kernel: " << differentPixels << endl;
+
     /* Convert the output luminance array to RGB and save it out to a file. */
     unsigned char* rgbOut = new unsigned char[width * height * 3];
     luminanceToRGB(output, rgbOut, width, height);
     saveToBitmap("output.bmp", width, height, rgbOut);
 
-    /* Unmap the output. */
-    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[0], output, 0, NULL, NULL)))
+    /* Unmap the outputs. */
+    bool unmapMemoryObjectsSuccess = true;
+    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[referenceOutputIndex], referenceOutput, 0, NULL, NULL));
+    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[tiledOutputIndex], output, 0, NULL, NULL));
+    if (!unmapMemoryObjectsSuccess)
     {
-       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+       delete [] rgbOut;
+       cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
        cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
        return 1;
     }
 
+    /* [Viewports] */
+    /*
+     * A view of Seahorse Valley, zoomed in 10^4 times, is shallow enough for direct iteration in double or double-float.
+     * The deep zoom into the same area is zoomed in 10^12 times, beyond double precision, and uses perturbation.
+     */
+    const int numberOfViewports = 2;
+    MandelbrotViewport viewports[numberOfViewports];
+    const char* viewportFilenames[numberOfViewports] = {"output-viewport.bmp", "output-deep-zoom.bmp"};
+    for (int index = 0; index < numberOfViewports; index++)
+    {
+        viewports[index].centreReal = -0.743643887037158704752191506114774L;
+        viewports[index].centreImaginary = 0.131825904205311970493132056385139L;
+        viewports[index].width = width;
+        viewports[index].height = height;
+    }
+    viewports[0].pixelScale = 2.5e-4L / width;
+    viewports[0].maxIterations = 1000;
+    viewports[1].pixelScale = 2.5e-12L / width;
+    viewports[1].maxIterations = 5000;
+    /* [Viewports] */
+
+    KernelBinding viewportBinding;
+    KernelBinding perturbationBinding;
+    if (!initializeKernelBinding(kernels[2], &viewportBinding) || !initializeKernelBinding(kernels[3], &perturbationBinding))
+    {
+        delete [] rgbOut;
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed binding the viewport kernels. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    /* [Orbit pool] */
+    /* Reference orbits are at most 2 * maxIterations floats, so one slab holds several of them. */
+    BufferPool orbitPool;
+    if (!createBufferPool(context, device, CL_MEM_READ_ONLY, 256 * 1024, &orbitPool))
+    {
+        delete [] rgbOut;
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed creating the reference orbit pool. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    /* [Orbit pool] */
+
+    cout << "Double precision: " << (isExtensionSupported(device, "cl_khr_fp64") ? "cl_khr_fp64" : "double-float") << endl;
+    for (int index = 0; index < numberOfViewports; index++)
+    {
+        const MandelbrotMode mode = chooseMandelbrotMode(viewports[index]);
+        cl_event event = 0;
+        if (!renderMandelbrotViewport(&orbitPool, commandQueue, &viewportBinding, &perturbationBinding, viewports[index], mode, memoryObjects[tiledOutputIndex], &event) ||
+            !checkSuccess(clFinish(commandQueue)))
+        {
+            delete [] rgbOut;
+            releaseBufferPool(&orbitPool);
+            cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+            cerr << "Failed rendering the viewport. " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
+
+        cout << viewportFilenames[index] << " (" << (mode == MANDELBROT_MODE_DIRECT ? "direct" : "perturbation") << "): ";
+        printProfilingInfo(event);
+        clReleaseEvent(event);
+
+        if (!saveMandelbrot(commandQueue, memoryObjects[tiledOutputIndex], width, height, viewportFilenames[index]))
+        {
+            delete [] rgbOut;
+            releaseBufferPool(&orbitPool);
+            cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+            cerr << "Failed saving the viewport. " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
+    }
+
+    /* [Pan] */
+    /*
+     * Pan the first viewport across a few frames, as an interactive viewer would.
+     * Only the centre changes between frames, so the binding skips the other arguments.
+     */
+    const int numberOfPanFrames = 8;
+    MandelbrotViewport pan = viewports[0];
+    for (int frame = 0; frame < numberOfPanFrames; frame++)
+    {
+        pan.centreReal += pan.pixelScale * width / 100;
+        cl_event event = 0;
+        if (!renderMandelbrotViewport(&orbitPool, commandQueue, &viewportBinding, &perturbationBinding, pan, chooseMandelbrotMode(pan), memoryObjects[tiledOutputIndex], &event) ||
+            !checkSuccess(clWaitForEvents(1, &event)))
+        {
+            if (event != 0)
+            {
+                clReleaseEvent(event);
+            }
+            delete [] rgbOut;
+            releaseBufferPool(&orbitPool);
+            cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+            cerr << "Failed panning the viewport. " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
+        clReleaseEvent(event);
+    }
+    cout << "Kernel arguments: " << viewportBinding.skipped + perturbationBinding.skipped << " of "
+         << viewportBinding.calls + perturbationBinding.calls << " clSetKernelArg calls skipped as unchanged" << endl;
+    printBufferPoolStatistics(&orbitPool);
+    releaseBufferPool(&orbitPool);
+    /* [Pan] */
+
+    /* [Progressive] */
+    /* The first viewport is shallow enough for direct iteration, which is all mandelbrot_progressive does. */
+    ProgressiveStatistics statistics;
+    statistics.firstTileMilliseconds = -1.0;
+    statistics.tiles = 0;
+    statistics.stream = NULL;
+    if (argc == 4)
+    {
+        statistics.stream = fopen(argv[3], "wb");
+        if (statistics.stream == NULL)
+        {
+            cerr << "Failed to open " << argv[3] << " for the tile stream. " << __FILE__ << ":"<< __LINE__ << endl;
+        }
+    }
+
+    gettimeofday(&statistics.start, NULL);
+    bool progressiveSuccess = renderMandelbrotProgressive(commandQueue, kernels[4], viewports[0], memoryObjects[tiledOutputIndex], recordProgressiveTile, &statistics);
+    timeval end;
+    gettimeofday(&end, NULL);
+    if (statistics.stream != NULL)
+    {
+        fclose(statistics.stream);
+    }
+
+    if (!progressiveSuccess || !saveMandelbrot(commandQueue, memoryObjects[tiledOutputIndex], width, height, "output-progressive.bmp"))
+    {
+        delete [] rgbOut;
+        cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed rendering the progressive viewport. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+
+    const double totalMilliseconds = (end.tv_sec - statistics.start.tv_sec) * 1000.0 + (end.tv_usec - statistics.start.tv_usec) / 1000.0;
+    cout << "Progressive rendering: first tile after " << statistics.firstTileMilliseconds << "ms, "
+         << statistics.tiles << " tiles in " << totalMilliseconds << "ms" << endl;
+    /* [Progressive] */
+
     /* Release OpenCL objects. */
-    cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+    cleanUpMandelbrot(context, commandQueue, program, kernels, memoryObjects, numberOfMemoryObjects);
 
     delete [] rgbOut;
 
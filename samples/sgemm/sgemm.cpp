@@ -10,6 +10,7 @@
 
 #include "common.h"
 #include "image.h"
+#include "parallel.h"
 
 #include <CL/cl.h>
 #include <iostream>
@@ -22,34 +23,63 @@
 using namespace std;
 
 /**
- * \brief Initialize the input matrices with random values.
- * \param[in] matrixOrder The order of the matrices (number of rows and columns). Matrices have to be symmetric.
- * \param[in] matrixA First input matrix.
- * \param[in] matrixB Second input matrix.
- * \param[in] matrixC Third input matrix.
- * \return matrixA, matrixB and matrixC with random values.
+ * \brief The input matrices, shared by the host threads filling them.
  */
-void sgemmInitialize (int matrixOrder, float* matrixA, float* matrixB, float * matrixC)
+struct SgemmMatrices
+{
+    int matrixOrder;
+    float* matrixA;
+    float* matrixB;
+    float* matrixC;
+};
+
+/**
+ * \brief Fill a range of rows of the input matrices with random values.
+ * \details Each row has its own random sequence, so the matrices are the same whichever threads fill which rows.
+ * \param[in] userData The SgemmMatrices.
+ * \param[in] begin First row.
+ * \param[in] end One past the last row.
+ */
+static void sgemmInitializeRows(void* userData, size_t begin, size_t end)
 {
-    for (int i = 0; i < matrixOrder; i++)
+    const SgemmMatrices* matrices = (const SgemmMatrices*)userData;
+    const int matrixOrder = matrices->matrixOrder;
+
+    for (size_t i = begin; i < end; i++)
     {
+        unsigned int seed = (unsigned int)i * 2654435761u + 1;
         for (int j = 0; j < matrixOrder; j++)
         {
             int index = i * matrixOrder + j;
 
             /* Keep the values in the range [-1, 1]. */
-            float randomeNumber = rand() / (float) RAND_MAX * 2 - 1;
-            matrixA[index] = randomeNumber;
+            float randomeNumber = rand_r(&seed) / (float) RAND_MAX * 2 - 1;
+            matrices->matrixA[index] = randomeNumber;
 
-            randomeNumber = rand() / (float) RAND_MAX * 2 - 1;
-            matrixB[index] = randomeNumber;
+            randomeNumber = rand_r(&seed) / (float) RAND_MAX * 2 - 1;
+            matrices->matrixB[index] = randomeNumber;
 
-            randomeNumber = rand() / (float) RAND_MAX * 2 - 1;
-            matrixC[index] = randomeNumber;
+            randomeNumber = rand_r(&seed) / (float) RAND_MAX * 2 - 1;
+            matrices->matrixC[index] = randomeNumber;
         }
     }
 }
 
+/**
+ * \brief Initialize the input matrices with random values.
+ * \details The rows are filled on all the host threads (see parallel.h).
+ * \param[in] matrixOrder The order of the matrices (number of rows and columns). Matrices have to be symmetric.
+ * \param[in] matrixA First input matrix.
+ * \param[in] matrixB Second input matrix.
+ * \param[in] matrixC Third input matrix.
+ * \return matrixA, matrixB and matrixC with random values.
+ */
+void sgemmInitialize (int matrixOrder, float* matrixA, float* matrixB, float * matrixC)
+{
+    SgemmMatrices matrices = {matrixOrder, matrixA, matrixB, matrixC};
+    parallelFor(0, matrixOrder > 0 ? matrixOrder : 0, 0, sgemmInitializeRows, &matrices);
+}
+
 /**
  * \brief Simple SGEMM OpenCL sample.
  * \details A sample which calculates the following SGEMM equation:
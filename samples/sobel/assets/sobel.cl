@@ -9,29 +9,94 @@
  */
 
 /**
- * \brief Sobel filter kernel function.
+ * \brief Scalar Sobel calculation for the pixels the vector path cannot handle.
+ * \details Used for the first block of each row and for the last, possibly partial, block.
+ *          Columns outside the image are clamped to the nearest edge column and only pixels inside the image are written.
  * \param[in] inputImage Input image data in row-major format.
  * \param[in] width Width of the image passed in as inputImage.
+ * \param[in] rowAbove Offset of the (clamped) row above the output row.
+ * \param[in] rowCentre Offset of the output row.
+ * \param[in] rowBelow Offset of the (clamped) row below the output row.
+ * \param[in] column First column of the block.
  * \param[out] outputImageDX Output image of the calculated gradient in the X direction.
  * \param[out] outputImageDY Output image of the calculated gradient in the Y direction.
  */
-__kernel void sobel(__global const uchar* restrict inputImage,
-                    const int width,
-                    __global char* restrict outputImageDX,
-                    __global char* restrict outputImageDY)
+void sobelTail(__global const uchar* restrict inputImage,
+               const int width,
+               const int rowAbove,
+               const int rowCentre,
+               const int rowBelow,
+               const int column,
+               __global char* restrict outputImageDX,
+               __global char* restrict outputImageDY)
+{
+    const int lastColumn = min(column + 16, width);
+    for (int x = column; x < lastColumn; x++)
+    {
+        const int left = max(x - 1, 0);
+        const int right = min(x + 1, width - 1);
+
+        const short topLeft = inputImage[rowAbove + left];
+        const short top = inputImage[rowAbove + x];
+        const short topRight = inputImage[rowAbove + right];
+        const short centreLeft = inputImage[rowCentre + left];
+        const short centreRight = inputImage[rowCentre + right];
+        const short bottomLeft = inputImage[rowBelow + left];
+        const short bottom = inputImage[rowBelow + x];
+        const short bottomRight = inputImage[rowBelow + right];
+
+        /* Same masks (and signs) as the vector path. */
+        const short dx = (topRight - topLeft) + (centreRight - centreLeft) * (short)2 + (bottomRight - bottomLeft);
+        const short dy = (topRight + topLeft + top * (short)2) - (bottomRight + bottomLeft + bottom * (short)2);
+
+        outputImageDX[rowCentre + x] = convert_char(dx >> 3);
+        outputImageDY[rowCentre + x] = convert_char(dy >> 3);
+    }
+}
+
+/**
+ * \brief Sobel filter of one block of 16 pixels in a row.
+ * \details Works for any image width and height: the rows above and below the image are clamped to the edge rows,
+ *          and blocks which would read or write past the left or right edge of the image take a scalar tail path.
+ * \param[in] inputImage Input image data in row-major format.
+ * \param[in] width Width of the image passed in as inputImage.
+ * \param[in] height Height of the image passed in as inputImage.
+ * \param[in] column First column of the block.
+ * \param[in] row Row of the block.
+ * \param[out] outputImageDX Output image of the calculated gradient in the X direction.
+ * \param[out] outputImageDY Output image of the calculated gradient in the Y direction.
+ */
+void sobelBlock(__global const uchar* restrict inputImage,
+                const int width,
+                const int height,
+                const int column,
+                const int row,
+                __global char* restrict outputImageDX,
+                __global char* restrict outputImageDY)
 {
-    /* [Kernel size] */
     /*
-     * Each kernel calculates 16 output pixels in the same row (hence the '* 16').
-     * column is in the range [0, width] in steps of 16.
-     * row is in the range [0, height].
+     * Offsets of the three input rows used for the output row.
+     * The rows above the first row and below the last row are clamped to the edge of the image.
      */
-    const int column = get_global_id(0) * 16;
-    const int row = get_global_id(1) * 1;
+    const int rowAbove = max(row - 1, 0) * width;
+    const int rowCentre = row * width;
+    const int rowBelow = min(row + 1, height - 1) * width;
 
-    /* Offset calculates the position in the linear data for the row and the column. */
-    const int offset = row * width + column;
-    /* [Kernel size] */
+    /* [Tail path] */
+    /*
+     * The vector loads read the columns [column - 1, column + 16].
+     * The first block of a row and the last block (which may be partial when width is not a multiple of 16)
+     * would read or write outside the row, so they are handled one pixel at a time.
+     */
+    if (column < 1 || column + 17 > width)
+    {
+        sobelTail(inputImage, width, rowAbove, rowCentre, rowBelow, column, outputImageDX, outputImageDY);
+        return;
+    }
+
+    /* Offset calculates the position in the linear data of the top left corner of the 3x3 window. */
+    const int offset = rowAbove + column - 1;
+    /* [Tail path] */
 
     /* [Load row] */
     /*
@@ -74,11 +139,11 @@ __kernel void sobel(__global const uchar* restrict inputImage,
 
     /*
      * Second row of input.
-     * By adding the 'width * 1' to the offset we get the next row of data at the same column position.
+     * By adding the offset of the next row we get the next row of data at the same column position.
      * middleData is not loaded because it is not used in any of the calculations.
      */
-    leftLoad = vload16(0, inputImage + (offset + width * 1 + 0));
-    rightLoad = vload16(0, inputImage + (offset + width * 1 + 2));
+    leftLoad = vload16(0, inputImage + (offset + (rowCentre - rowAbove) + 0));
+    rightLoad = vload16(0, inputImage + (offset + (rowCentre - rowAbove) + 2));
 
     leftData = convert_short16(leftLoad);
     rightData = convert_short16(rightLoad);
@@ -91,9 +156,9 @@ __kernel void sobel(__global const uchar* restrict inputImage,
     dx += (rightData - leftData) * (short)2;
 
     /* Third row of input. */
-    leftLoad = vload16(0, inputImage + (offset + width * 2 + 0));
-    middleLoad = vload16(0, inputImage + (offset + width * 2 + 1));
-    rightLoad = vload16(0, inputImage + (offset + width * 2 + 2));
+    leftLoad = vload16(0, inputImage + (offset + (rowBelow - rowAbove) + 0));
+    middleLoad = vload16(0, inputImage + (offset + (rowBelow - rowAbove) + 1));
+    rightLoad = vload16(0, inputImage + (offset + (rowBelow - rowAbove) + 2));
 
     leftData = convert_short16(leftLoad);
     middleData = convert_short16(middleLoad);
@@ -116,7 +181,66 @@ __kernel void sobel(__global const uchar* restrict inputImage,
      * (signed/unsigned, seperate/combined gradients) it is possible to do more of the calculations on the GPU using OpenCL.
      * In this sample we're assuming that the application requires signed uncombined gradient outputs.
      */
-    vstore16(convert_char16(dx >> 3), 0, outputImageDX + offset + width + 1);
-    vstore16(convert_char16(dy >> 3), 0, outputImageDY + offset + width + 1);
+    vstore16(convert_char16(dx >> 3), 0, outputImageDX + rowCentre + column);
+    vstore16(convert_char16(dy >> 3), 0, outputImageDY + rowCentre + column);
     /* [Store] */
 }
+
+/**
+ * \brief Sobel filter kernel function.
+ * \details Works for any image width and height, see sobelBlock.
+ * \param[in] inputImage Input image data in row-major format.
+ * \param[in] width Width of the image passed in as inputImage.
+ * \param[in] height Height of the image passed in as inputImage.
+ * \param[out] outputImageDX Output image of the calculated gradient in the X direction.
+ * \param[out] outputImageDY Output image of the calculated gradient in the Y direction.
+ */
+__kernel void sobel(__global const uchar* restrict inputImage,
+                    const int width,
+                    const int height,
+                    __global char* restrict outputImageDX,
+                    __global char* restrict outputImageDY)
+{
+    /* [Kernel size] */
+    /*
+     * Each kernel calculates 16 output pixels in the same row (hence the '* 16').
+     * column is in the range [0, width] in steps of 16.
+     * row is in the range [0, height].
+     */
+    const int column = get_global_id(0) * 16;
+    const int row = get_global_id(1) * 1;
+    /* [Kernel size] */
+
+    sobelBlock(inputImage, width, height, column, row, outputImageDX, outputImageDY);
+}
+
+/**
+ * \brief Sobel filter kernel function for a batch of images packed into one buffer.
+ * \details The third dimension of the NDRange is the index of the image. The first two cover the largest image in the batch,
+ *          so work-items past the right or bottom edge of a smaller image do nothing.
+ * \param[in] inputImages The images, one after the other, each in row-major format.
+ * \param[in] images Offset of the first pixel, width and height of each image.
+ * \param[out] outputImagesDX Output images of the calculated gradient in the X direction, with the same layout as inputImages.
+ * \param[out] outputImagesDY Output images of the calculated gradient in the Y direction, with the same layout as inputImages.
+ */
+__kernel void sobel_batched(__global const uchar* restrict inputImages,
+                            __global const int4* restrict images,
+                            __global char* restrict outputImagesDX,
+                            __global char* restrict outputImagesDY)
+{
+    /* [Batch index] */
+    const int4 image = images[get_global_id(2)];
+    const int offset = image.x;
+    const int width = image.y;
+    const int height = image.z;
+    /* [Batch index] */
+
+    const int column = get_global_id(0) * 16;
+    const int row = get_global_id(1);
+    if (column >= width || row >= height)
+    {
+        return;
+    }
+
+    sobelBlock(inputImages + offset, width, height, column, row, outputImagesDX + offset, outputImagesDY + offset);
+}
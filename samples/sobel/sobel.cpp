@@ -8,8 +8,15 @@
  * by a licensing agreement from ARM Limited.
  */
 
+#include "batch.h"
 #include "common.h"
 #include "image.h"
+#include "parallel.h"
+#include "pipeline.h"
+#include "roofline.h"
+#include "trace.h"
+#include "worksize.h"
+#include "sobel_kernels.h"
 
 #include <CL/cl.h>
 #include <iostream>
@@ -17,9 +24,359 @@
 #include <sstream>
 #include <cstddef>
 #include <cmath>
+#include <vector>
+#include <algorithm>
+#include <sys/time.h>
 
 using namespace std;
 
+/* Number of frames streamed through the pipeline after the single run. */
+const int numberOfFrames = 60;
+
+/* Number of thumbnails filtered one by one and then in one batched launch. */
+const int numberOfThumbnails = 64;
+
+/**
+ * \brief State shared by the callbacks of the Sobel pipeline.
+ */
+struct SobelStream
+{
+    const unsigned char* rgbData; /**< \brief The input frame, converted to luminance for every frame as a camera frame would be. */
+    cl_int width; /**< \brief Width of the frames. */
+    cl_int height; /**< \brief Height of the frames. */
+    const unsigned char* referenceDX; /**< \brief Absolute X gradients of the single run, to check every frame against. */
+    const unsigned char* referenceDY; /**< \brief Absolute Y gradients of the single run. */
+    int mismatchedFrames; /**< \brief Number of frames which differ from the single run. */
+    cl_ulong firstStart; /**< \brief Start time of the kernel of the first frame. */
+    cl_ulong lastEnd; /**< \brief End time of the kernel of the last consumed frame. */
+};
+
+/**
+ * \brief Convert the RGB frame to luminance in the mapped input buffer of the pipeline.
+ * \details Runs on the host while the kernels of the previous frames run on the device.
+ * \return False if an error occurred, otherwise true.
+ */
+bool prepareSobelFrame(void* userData, int frame, void* const* inputs)
+{
+    SobelStream* stream = (SobelStream*)userData;
+    return RGBToLuminance(stream->rgbData, (unsigned char*)inputs[0], stream->width, stream->height);
+}
+
+/**
+ * \brief Check the gradients of a frame against the single run and record the kernel times.
+ * \return False if an error occurred, otherwise true.
+ */
+bool consumeSobelFrame(void* userData, int frame, void* const* outputs, cl_event kernelEvent)
+{
+    SobelStream* stream = (SobelStream*)userData;
+    const cl_char* outputDx = (const cl_char*)outputs[0];
+    const cl_char* outputDy = (const cl_char*)outputs[1];
+
+    for (int i = 0; i < stream->width * stream->height; i++)
+    {
+        if (abs(outputDx[i]) != stream->referenceDX[i] || abs(outputDy[i]) != stream->referenceDY[i])
+        {
+            stream->mismatchedFrames++;
+            break;
+        }
+    }
+
+    bool returnValue = true;
+    if (frame == 0)
+    {
+        returnValue &= checkSuccess(clGetEventProfilingInfo(kernelEvent, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &stream->firstStart, NULL));
+    }
+    returnValue &= checkSuccess(clGetEventProfilingInfo(kernelEvent, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &stream->lastEnd, NULL));
+    return returnValue;
+}
+
+/**
+ * \brief Stream frames through the Sobel kernel with a triple-buffered pipeline.
+ * \details The program, the kernels and the buffers are created once. For every frame, the host conversion to luminance
+ *          overlaps with the kernels of the previous frames and the non-blocking readback of the frames before them.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] device The OpenCL device to build the kernel for.
+ * \param[in] commandQueue The in-order command queue to use.
+ * \param[in] stream The frame and the results of the single run.
+ * \return False if an error occurred, otherwise true.
+ */
+bool runSobelPipeline(cl_context context, cl_device_id device, cl_command_queue commandQueue, SobelStream* stream)
+{
+    const size_t bufferSize = stream->width * stream->height * sizeof(cl_uchar);
+
+    /* [Describe the pipeline] */
+    PipelineDescription description;
+    description.filename = "assets/sobel.cl";
+    description.kernelName = "sobel";
+    description.depth = 3;
+    description.numberOfInputs = 1;
+    description.inputSizes[0] = bufferSize;
+    description.inputArguments[0] = 0;
+    description.numberOfOutputs = 2;
+    description.outputSizes[0] = bufferSize;
+    description.outputArguments[0] = 3;
+    description.outputSizes[1] = bufferSize;
+    description.outputArguments[1] = 4;
+    description.workDimensions = 2;
+    description.globalWorksize[0] = (size_t)(stream->width + 15) / 16;
+    description.globalWorksize[1] = (size_t)stream->height;
+    description.prepare = prepareSobelFrame;
+    description.consume = consumeSobelFrame;
+    description.userData = stream;
+    /* [Describe the pipeline] */
+
+    Pipeline pipeline;
+    if (!createPipeline(context, device, commandQueue, &description, &pipeline))
+    {
+        cerr << "Failed to create the Sobel pipeline. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    bool pipelineSuccess = true;
+    pipelineSuccess &= setPipelineKernelArgument(&pipeline, 1, sizeof(cl_int), &stream->width);
+    pipelineSuccess &= setPipelineKernelArgument(&pipeline, 2, sizeof(cl_int), &stream->height);
+
+    /* [Stream the frames] */
+    for (int frame = 0; pipelineSuccess && frame < numberOfFrames; frame++)
+    {
+        pipelineSuccess &= submitPipelineFrame(&pipeline);
+    }
+    pipelineSuccess = pipelineSuccess && finishPipeline(&pipeline);
+    /* [Stream the frames] */
+
+    pipelineSuccess &= releasePipeline(&pipeline);
+    if (!pipelineSuccess)
+    {
+        cerr << "Failed streaming frames through the Sobel pipeline. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    const double frameTime = (double)(stream->lastEnd - stream->firstStart) / numberOfFrames / 1000000.0;
+    cout << "Streamed " << numberOfFrames << " frames: " << frameTime << " ms per frame on the device";
+    if (frameTime > 0.0)
+    {
+        cout << " (" << 1000.0 / frameTime << " frames per second)";
+    }
+    cout << ", " << stream->mismatchedFrames << " frames differ from the single run." << endl;
+    return true;
+}
+
+/**
+ * \brief Filter many thumbnails, once with a launch per thumbnail and once with a single batched launch.
+ * \details Small images don't give the device enough work to hide the cost of a launch.
+ *          The thumbnails are packed into one buffer (see batch.h) and sobel_batched filters all of them in one 3D NDRange,
+ *          with get_global_id(2) as the thumbnail index. The results of both runs are compared.
+ * \param[in] context The OpenCL context to use.
+ * \param[in] commandQueue The in-order command queue to use, with profiling enabled.
+ * \param[in] program The program holding the sobel and sobel_batched kernels.
+ * \param[in] sobel The launcher of the sobel kernel.
+ * \param[in] rgbData The frame the thumbnails are cropped from.
+ * \param[in] width Width of the frame.
+ * \param[in] height Height of the frame.
+ * \return False if an error occurred, otherwise true.
+ */
+bool runSobelThumbnails(cl_context context, cl_command_queue commandQueue, cl_program program, SobelKernel* sobel,
+                        const unsigned char* rgbData, cl_int width, cl_int height)
+{
+    cl_int errorNumber = CL_SUCCESS;
+
+    /* [Pack the thumbnails] */
+    vector<unsigned char> luminance((size_t)width * height);
+    RGBToLuminance(rgbData, &luminance[0], width, height);
+
+    /* Crops of a few small sizes from across the frame stand in for the thumbnails. The kernels take any width, so narrow frames are not rounded down. */
+    const cl_int thumbnailSizes[4][2] = {{48, 32}, {64, 48}, {32, 32}, {80, 64}};
+    ImageBatch batch;
+    initializeImageBatch(&batch);
+    vector<unsigned char> packedImages;
+    for (int index = 0; index < numberOfThumbnails; index++)
+    {
+        const cl_int thumbnailWidth = min(thumbnailSizes[index % 4][0], width);
+        const cl_int thumbnailHeight = min(thumbnailSizes[index % 4][1], height);
+        const cl_int left = (index * 37) % (width - thumbnailWidth + 1);
+        const cl_int top = (index * 23) % (height - thumbnailHeight + 1);
+        addImageToBatch(&batch, thumbnailWidth, thumbnailHeight);
+        for (cl_int row = 0; row < thumbnailHeight; row++)
+        {
+            const unsigned char* source = &luminance[(size_t)(top + row) * width + left];
+            packedImages.insert(packedImages.end(), source, source + thumbnailWidth);
+        }
+    }
+    /* [Pack the thumbnails] */
+
+    vector<cl_mem> memoryObjects;
+    vector<cl_event> events;
+    bool thumbnailSuccess = true;
+
+    /* [One launch per thumbnail] */
+    vector<cl_char> singleDX(batch.elements);
+    vector<cl_char> singleDY(batch.elements);
+    timeval start;
+    timeval end;
+    gettimeofday(&start, NULL);
+    for (size_t index = 0; thumbnailSuccess && index < batch.numberOfImages; index++)
+    {
+        const size_t offset = getBatchImageOffset(&batch, index);
+        const cl_int thumbnailWidth = batch.table[index * 4 + 1];
+        const cl_int thumbnailHeight = batch.table[index * 4 + 2];
+        const size_t thumbnailSize = (size_t)thumbnailWidth * thumbnailHeight;
+
+        cl_mem input = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, thumbnailSize, &packedImages[offset], &errorNumber);
+        thumbnailSuccess &= checkSuccess(errorNumber);
+        cl_mem outputDX = clCreateBuffer(context, CL_MEM_WRITE_ONLY, thumbnailSize, NULL, &errorNumber);
+        thumbnailSuccess &= checkSuccess(errorNumber);
+        cl_mem outputDY = clCreateBuffer(context, CL_MEM_WRITE_ONLY, thumbnailSize, NULL, &errorNumber);
+        thumbnailSuccess &= checkSuccess(errorNumber);
+        memoryObjects.push_back(input);
+        memoryObjects.push_back(outputDX);
+        memoryObjects.push_back(outputDY);
+
+        cl_event event = 0;
+        size_t globalWorksize[2] = {coveringWorksize(thumbnailWidth, 16), (size_t)thumbnailHeight};
+        thumbnailSuccess = thumbnailSuccess && enqueueSobelKernel(commandQueue, sobel, input, thumbnailWidth, thumbnailHeight, outputDX, outputDY, 2, globalWorksize, NULL, &event);
+        if (thumbnailSuccess)
+        {
+            events.push_back(event);
+            traceKernel(event, sobel->kernel, 2, globalWorksize, NULL);
+            cl_event readEvents[2];
+            thumbnailSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, outputDX, CL_FALSE, 0, thumbnailSize, &singleDX[offset], 0, NULL, traceEvent(&readEvents[0])));
+            thumbnailSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, outputDY, CL_FALSE, 0, thumbnailSize, &singleDY[offset], 0, NULL, traceEvent(&readEvents[1])));
+            traceAndReleaseCommand(readEvents[0], "read thumbnail dX", thumbnailSize);
+            traceAndReleaseCommand(readEvents[1], "read thumbnail dY", thumbnailSize);
+        }
+    }
+    thumbnailSuccess = thumbnailSuccess && checkSuccess(clFinish(commandQueue));
+    gettimeofday(&end, NULL);
+    const double singleHostTime = millisecondsBetween(start, end);
+
+    double singleDeviceTime = 0.0;
+    for (size_t index = 0; thumbnailSuccess && index < events.size(); index++)
+    {
+        thumbnailSuccess &= addKernelMilliseconds(events[index], &singleDeviceTime);
+    }
+    thumbnailSuccess &= releaseBatchObjects(memoryObjects, events);
+    /* [One launch per thumbnail] */
+
+    if (!thumbnailSuccess)
+    {
+        cerr << "Failed filtering the thumbnails one by one. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    /* [One batched launch] */
+    SobelBatchedKernel sobelBatched;
+    if (!createSobelBatchedKernel(program, &sobelBatched))
+    {
+        cerr << "Failed to create the batched Sobel kernel. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    vector<cl_char> batchedDX(batch.elements);
+    vector<cl_char> batchedDY(batch.elements);
+    gettimeofday(&start, NULL);
+    cl_mem inputImages = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, batch.elements, &packedImages[0], &errorNumber);
+    thumbnailSuccess &= checkSuccess(errorNumber);
+    cl_mem outputImagesDX = clCreateBuffer(context, CL_MEM_WRITE_ONLY, batch.elements, NULL, &errorNumber);
+    thumbnailSuccess &= checkSuccess(errorNumber);
+    cl_mem outputImagesDY = clCreateBuffer(context, CL_MEM_WRITE_ONLY, batch.elements, NULL, &errorNumber);
+    thumbnailSuccess &= checkSuccess(errorNumber);
+    cl_mem images = NULL;
+    thumbnailSuccess = thumbnailSuccess && createImageBatchTable(context, &batch, &images);
+    memoryObjects.push_back(inputImages);
+    memoryObjects.push_back(outputImagesDX);
+    memoryObjects.push_back(outputImagesDY);
+    if (images != NULL)
+    {
+        memoryObjects.push_back(images);
+    }
+
+    /* The first two dimensions cover the largest thumbnail, the third is the thumbnail index. */
+    size_t batchWorksize[3];
+    getImageBatchWorksize(&batch, 16, batchWorksize);
+    cl_event event = 0;
+    thumbnailSuccess = thumbnailSuccess && enqueueSobelBatchedKernel(commandQueue, &sobelBatched, inputImages, images, outputImagesDX, outputImagesDY, 3, batchWorksize, NULL, &event);
+    if (thumbnailSuccess)
+    {
+        events.push_back(event);
+        traceKernel(event, sobelBatched.kernel, 3, batchWorksize, NULL);
+        cl_event readEvents[2];
+        thumbnailSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, outputImagesDX, CL_FALSE, 0, batch.elements, &batchedDX[0], 0, NULL, traceEvent(&readEvents[0])));
+        thumbnailSuccess &= checkSuccess(clEnqueueReadBuffer(commandQueue, outputImagesDY, CL_FALSE, 0, batch.elements, &batchedDY[0], 0, NULL, traceEvent(&readEvents[1])));
+        traceAndReleaseCommand(readEvents[0], "read batch dX", batch.elements);
+        traceAndReleaseCommand(readEvents[1], "read batch dY", batch.elements);
+    }
+    thumbnailSuccess = thumbnailSuccess && checkSuccess(clFinish(commandQueue));
+    gettimeofday(&end, NULL);
+    const double batchedHostTime = millisecondsBetween(start, end);
+
+    double batchedDeviceTime = 0.0;
+    if (thumbnailSuccess)
+    {
+        thumbnailSuccess &= addKernelMilliseconds(event, &batchedDeviceTime);
+    }
+    thumbnailSuccess &= releaseBatchObjects(memoryObjects, events);
+    thumbnailSuccess &= releaseSobelBatchedKernel(&sobelBatched);
+    /* [One batched launch] */
+
+    if (!thumbnailSuccess)
+    {
+        cerr << "Failed filtering the batch of thumbnails. " << __FILE__ << ":"<< __LINE__ << endl;
+        return false;
+    }
+
+    const bool match = singleDX == batchedDX && singleDY == batchedDY;
+    cout << "Filtered " << batch.numberOfImages << " thumbnails one by one: " << singleDeviceTime << " ms on the device, " << singleHostTime << " ms on the host\n";
+    cout << "Filtered them in one batched launch: " << batchedDeviceTime << " ms on the device, " << batchedHostTime << " ms on the host, "
+         << (match ? "same results." : "results differ.") << endl;
+    return true;
+}
+
+/* Pixels per chunk of the host loops over the gradients. */
+const size_t gradientGrainSize = 16384;
+
+/**
+ * \brief The gradients and the images made from them on the host, shared by the host threads.
+ */
+struct SobelGradients
+{
+    const cl_char* outputDx; /**< \brief X gradients from the kernel. */
+    const cl_char* outputDy; /**< \brief Y gradients from the kernel. */
+    unsigned char* absDX; /**< \brief Absolute X gradients. */
+    unsigned char* absDY; /**< \brief Absolute Y gradients. */
+    unsigned char* totalOutput; /**< \brief Total gradients. */
+};
+
+/**
+ * \brief Take the absolute values of a range of gradients.
+ * \param[in] userData The SobelGradients.
+ * \param[in] begin First pixel.
+ * \param[in] end One past the last pixel.
+ */
+void absoluteGradients(void* userData, size_t begin, size_t end)
+{
+    const SobelGradients* gradients = (const SobelGradients*)userData;
+    for (size_t i = begin; i < end; i++)
+    {
+        gradients->absDX[i] = abs(gradients->outputDx[i]);
+        gradients->absDY[i] = abs(gradients->outputDy[i]);
+    }
+}
+
+/**
+ * \brief Combine a range of absolute gradients into total gradients.
+ * \param[in] userData The SobelGradients.
+ * \param[in] begin First pixel.
+ * \param[in] end One past the last pixel.
+ */
+void totalGradients(void* userData, size_t begin, size_t end)
+{
+    const SobelGradients* gradients = (const SobelGradients*)userData;
+    for (size_t index = begin; index < end; index++)
+    {
+        gradients->totalOutput[index] = sqrt(pow(gradients->absDX[index], 2) + pow(gradients->absDY[index], 2));
+    }
+}
+
 /**
  * \brief Simple Sobel filter OpenCL sample.
  * \details A sample which loads a bitmap and then passes it to the GPU.
@@ -29,13 +386,16 @@ using namespace std;
  *          The input image is loaded from assets/input.bmp. The output gradients in X and Y,
  *          as well as the combined gradient image are stored in output-dX.bmp, output-dY.bmp
  *          and output.bmp respectively.
+ *          The same frame is then streamed numberOfFrames times through a triple-buffered pipeline (see pipeline.h),
+ *          as a camera application would, and every frame is checked against the single run.
+ *          Finally, small crops of the frame are filtered as thumbnails, once with a launch each and once all in one batched launch.
  * \return The exit code of the application, non-zero if a problem occurred.
  */
 int main(void)
 {
     /*
      * Name of the bitmap to load and run the sobel filter on.
-     * It's width must be divisible by 16.
+     * Any width and height is supported, the kernel handles the borders and partial blocks itself.
      */
     string filename = "assets/input.bmp";
 
@@ -69,8 +429,14 @@ int main(void)
         return 1;
     }
 
-    kernel = clCreateKernel(program, "sobel", &errorNumber);
-    if (!checkSuccess(errorNumber))
+    /*
+     * The launcher is generated from the kernel signature in assets/sobel.cl at build time,
+     * so the arguments passed to it are checked against the kernel by the compiler.
+     */
+    SobelKernel sobel;
+    const bool createKernelSuccess = createSobelKernel(program, &sobel);
+    kernel = sobel.kernel;
+    if (!createKernelSuccess)
     {
         cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create OpenCL kernel. " << __FILE__ << ":"<< __LINE__ << endl;
@@ -106,8 +472,10 @@ int main(void)
         return 1;
     }
 
-    /* Map the input luminance memory object to a host side pointer. */
-    cl_uchar* luminance = (cl_uchar*)clEnqueueMapBuffer(commandQueue, memoryObjects[0], CL_TRUE, CL_MAP_WRITE, 0, bufferSize, 0, NULL, NULL, &errorNumber);
+    /* Map the input luminance memory object to a host side pointer. Memory commands are recorded on the timeline when tracing is enabled. */
+    cl_event mapEvent = 0;
+    cl_uchar* luminance = (cl_uchar*)clEnqueueMapBuffer(commandQueue, memoryObjects[0], CL_TRUE, CL_MAP_WRITE, 0, bufferSize, 0, NULL, traceEvent(&mapEvent), &errorNumber);
+    traceAndReleaseCommand(mapEvent, "map luminance", bufferSize);
     if (!checkSuccess(errorNumber))
     {
        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
@@ -118,48 +486,52 @@ int main(void)
     /* Convert 24-bits per pixel RGB into 8-bits per pixel luminance data. */
     RGBToLuminance(imageData, luminance, width, height);
 
-    delete [] imageData;
-
     /* Unmap the memory so we can pass it to the kernel. */
-    if (!checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[0], luminance, 0, NULL, NULL)))
+    cl_event unmapEvent = 0;
+    bool unmapLuminanceSuccess = checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[0], luminance, 0, NULL, traceEvent(&unmapEvent)));
+    traceAndReleaseCommand(unmapEvent, "unmap luminance", bufferSize);
+    if (!unmapLuminanceSuccess)
     {
        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
        cerr << "Unmapping memory objects failed " << __FILE__ << ":"<< __LINE__ << endl;
        return 1;
     }
 
-    bool setKernelArgumentsSuccess = true;
-    /* Setup the kernel arguments. */
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 0, sizeof(cl_mem), &memoryObjects[0]));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 1, sizeof(cl_int), &width));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 2, sizeof(cl_mem), &memoryObjects[1]));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 3, sizeof(cl_mem), &memoryObjects[2]));
-    if (!setKernelArgumentsSuccess)
-    {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
-        return 1;
-    }
-
     /* An event to associate with the Kernel. Allows us to retreive profiling information later. */
     cl_event event = 0;
 
     /* [Kernel size] */
     /*
      * Each instance of the kernel operates on a 16 * 1 portion of the image.
-     * Therefore, the global work size must be width / 16 by height / 1 work items.
+     * Therefore, the global work size must be width / 16 (rounded up to cover the partial block at the end of each row)
+     * by height / 1 work items.
      */
-    size_t globalWorksize[2] = {width / 16, height / 1};
+    size_t globalWorksize[2] = {coveringWorksize(width, 16), (size_t)height / 1};
     /* [Kernel size] */
 
-    /* Enqueue the kernel */
-    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernel, 2, NULL, globalWorksize, NULL, 0, NULL, &event)))
+    /* [Local work size] */
+    /* The kernel does not check its row, so the global work size can't be padded and the work-group must divide it. */
+    size_t localWorksize[2] = {1, 1};
+    size_t paddedGlobalWorksize[2] = {0, 0};
+    if (!chooseLocalWorksize(kernel, device, 2, globalWorksize, false, localWorksize, paddedGlobalWorksize))
+    {
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed choosing the local work size. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    /* [Local work size] */
+
+    /* Set the kernel arguments and enqueue the kernel. */
+    if (!enqueueSobelKernel(commandQueue, &sobel, memoryObjects[0], width, height, memoryObjects[1], memoryObjects[2], 2, globalWorksize, localWorksize, &event))
     {
         cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed enqueuing the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
         return 1;
     }
 
+    /* Record the launch on the timeline when tracing is enabled (CL_TRACE_FILE). */
+    traceKernel(event, kernel, 2, globalWorksize, localWorksize);
+
     /* Wait for completion */
     if (!checkSuccess(clFinish(commandQueue)))
     {
@@ -170,6 +542,21 @@ int main(void)
 
     /* Print the profiling information for the event. */
     printProfilingInfo(event);
+
+    /* [Kernel statistics] */
+    /*
+     * Both Sobel samples declare the same work per launch so their metrics are comparable:
+     * every luminance pixel is read once and both gradients are written once,
+     * and each output pixel costs about 15 integer operations (the additions and doublings of both 3x3 masks).
+     */
+    KernelStats stats;
+    initializeKernelStats(&stats, "sobel", (double)width * height, 2.0 * width * height, 15.0 * width * height);
+    if (addKernelStatsEvent(&stats, event))
+    {
+        printKernelStats(&stats);
+    }
+    /* [Kernel statistics] */
+
     /* Release the event object. */
     if (!checkSuccess(clReleaseEvent(event)))
     {
@@ -180,10 +567,12 @@ int main(void)
 
     /* Map the arrays holding the output gradients. */
     bool mapMemoryObjectsSuccess = true;
-    cl_char* outputDx = (cl_char*)clEnqueueMapBuffer(commandQueue, memoryObjects[1], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, NULL, &errorNumber);
+    cl_char* outputDx = (cl_char*)clEnqueueMapBuffer(commandQueue, memoryObjects[1], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, traceEvent(&mapEvent), &errorNumber);
     mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
-    cl_char* outputDy = (cl_char*)clEnqueueMapBuffer(commandQueue, memoryObjects[2], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, NULL, &errorNumber);
+    traceAndReleaseCommand(mapEvent, "map dX", bufferSize);
+    cl_char* outputDy = (cl_char*)clEnqueueMapBuffer(commandQueue, memoryObjects[2], CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, traceEvent(&mapEvent), &errorNumber);
     mapMemoryObjectsSuccess &= checkSuccess(errorNumber);
+    traceAndReleaseCommand(mapEvent, "map dY", bufferSize);
     if (!mapMemoryObjectsSuccess)
     {
        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
@@ -201,16 +590,15 @@ int main(void)
     /* To visualise the data we take the absolute values of the gradients. */
     unsigned char *absDX = new unsigned char[width * height];
     unsigned char *absDY = new unsigned char[width * height];
-    for (int i = 0; i < width * height; i++)
-    {
-        absDX[i] = abs(outputDx[i]);
-        absDY[i] = abs(outputDy[i]);
-    }
+    SobelGradients gradients = {outputDx, outputDy, absDX, absDY, NULL};
+    parallelFor(0, (size_t)width * height, gradientGrainSize, absoluteGradients, &gradients);
 
     /* Unmap the memory. */
     bool unmapMemoryObjectsSuccess = true;
-    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[1], outputDx, 0, NULL, NULL));
-    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[2], outputDy, 0, NULL, NULL));
+    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[1], outputDx, 0, NULL, traceEvent(&unmapEvent)));
+    traceAndReleaseCommand(unmapEvent, "unmap dX", bufferSize);
+    unmapMemoryObjectsSuccess &= checkSuccess(clEnqueueUnmapMemObject(commandQueue, memoryObjects[2], outputDy, 0, NULL, traceEvent(&unmapEvent)));
+    traceAndReleaseCommand(unmapEvent, "unmap dY", bufferSize);
     if (!unmapMemoryObjectsSuccess)
     {
        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
@@ -218,6 +606,27 @@ int main(void)
        return 1;
     }
 
+    /* [Run the pipeline] */
+    SobelStream stream = {imageData, width, height, absDX, absDY, 0, 0, 0};
+    if (!runSobelPipeline(context, device, commandQueue, &stream))
+    {
+       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+       cerr << "Running the Sobel pipeline failed " << __FILE__ << ":"<< __LINE__ << endl;
+       return 1;
+    }
+    /* [Run the pipeline] */
+
+    /* [Batched thumbnails] */
+    if (!runSobelThumbnails(context, commandQueue, program, &sobel, imageData, width, height))
+    {
+       cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+       cerr << "Filtering the thumbnails failed " << __FILE__ << ":"<< __LINE__ << endl;
+       return 1;
+    }
+    /* [Batched thumbnails] */
+
+    delete [] imageData;
+
     /* Release OpenCL objects. */
     cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
 
@@ -231,10 +640,8 @@ int main(void)
 
     /* Calculate the total gradient of the image, convert it to RGB and store it out to a file. */
     unsigned char* totalOutput = new unsigned char[width * height];
-    for (int index = 0; index < width * height; index++)
-    {
-        totalOutput[index] = sqrt(pow(absDX[index], 2) + pow(absDY[index], 2));
-    }
+    gradients.totalOutput = totalOutput;
+    parallelFor(0, (size_t)width * height, gradientGrainSize, totalGradients, &gradients);
     luminanceToRGB(totalOutput, rgbOut, width, height);
     saveToBitmap("output.bmp", width, height, rgbOut);
 
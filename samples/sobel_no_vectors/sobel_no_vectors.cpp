@@ -10,6 +10,10 @@
 
 #include "common.h"
 #include "image.h"
+#include "parallel.h"
+#include "roofline.h"
+#include "worksize.h"
+#include "sobel_no_vectors_kernels.h"
 
 #include <CL/cl.h>
 #include <iostream>
@@ -20,6 +24,52 @@
 
 using namespace std;
 
+/* Pixels per chunk of the host loops over the gradients. */
+const size_t gradientGrainSize = 16384;
+
+/**
+ * \brief The gradients and the images made from them on the host, shared by the host threads.
+ */
+struct SobelGradients
+{
+    const cl_char* outputDx; /**< \brief X gradients from the kernel. */
+    const cl_char* outputDy; /**< \brief Y gradients from the kernel. */
+    unsigned char* absDX; /**< \brief Absolute X gradients. */
+    unsigned char* absDY; /**< \brief Absolute Y gradients. */
+    unsigned char* totalOutput; /**< \brief Total gradients. */
+};
+
+/**
+ * \brief Take the absolute values of a range of gradients.
+ * \param[in] userData The SobelGradients.
+ * \param[in] begin First pixel.
+ * \param[in] end One past the last pixel.
+ */
+void absoluteGradients(void* userData, size_t begin, size_t end)
+{
+    const SobelGradients* gradients = (const SobelGradients*)userData;
+    for (size_t i = begin; i < end; i++)
+    {
+        gradients->absDX[i] = abs(gradients->outputDx[i]);
+        gradients->absDY[i] = abs(gradients->outputDy[i]);
+    }
+}
+
+/**
+ * \brief Combine a range of absolute gradients into total gradients.
+ * \param[in] userData The SobelGradients.
+ * \param[in] begin First pixel.
+ * \param[in] end One past the last pixel.
+ */
+void totalGradients(void* userData, size_t begin, size_t end)
+{
+    const SobelGradients* gradients = (const SobelGradients*)userData;
+    for (size_t index = begin; index < end; index++)
+    {
+        gradients->totalOutput[index] = sqrt(pow(gradients->absDX[index], 2) + pow(gradients->absDY[index], 2));
+    }
+}
+
 /**
  * \brief Simple Sobel filter OpenCL sample which doesn't use vectors.
  * \details A sample which loads a bitmap and then passes it to the GPU.
@@ -70,8 +120,14 @@ int main(void)
         return 1;
     }
 
-    kernel = clCreateKernel(program, "sobel_no_vectors", &errorNumber);
-    if (!checkSuccess(errorNumber))
+    /*
+     * The launcher is generated from the kernel signature in assets/sobel_no_vectors.cl at build time,
+     * so the arguments passed to it are checked against the kernel by the compiler.
+     */
+    SobelNoVectorsKernel sobelNoVectors;
+    const bool createKernelSuccess = createSobelNoVectorsKernel(program, &sobelNoVectors);
+    kernel = sobelNoVectors.kernel;
+    if (!createKernelSuccess)
     {
         cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed to create OpenCL kernel. " << __FILE__ << ":"<< __LINE__ << endl;
@@ -121,19 +177,6 @@ int main(void)
 
     delete [] imageData;
 
-    /* Setup the kernel arguments. */
-    bool setKernelArgumentsSuccess = true;
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 0, sizeof(cl_mem), &memoryObjects[0]));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 1, sizeof(cl_int), &width));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 2, sizeof(cl_mem), &memoryObjects[1]));
-    setKernelArgumentsSuccess &= checkSuccess(clSetKernelArg(kernel, 3, sizeof(cl_mem), &memoryObjects[2]));
-    if (!setKernelArgumentsSuccess)
-    {
-        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
-        cerr << "Failed setting OpenCL kernel arguments. " << __FILE__ << ":"<< __LINE__ << endl;
-        return 1;
-    }
-
     /* An event to associate with the Kernel. Allows us to retreive profiling information later. */
     cl_event event = 0;
 
@@ -145,8 +188,20 @@ int main(void)
     size_t globalWorksize[2] = {width, height};
     /* [Kernel size] */
 
-    /* Enqueue the kernel */
-    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, kernel, 2, NULL, globalWorksize, NULL, 0, NULL, &event)))
+    /* [Local work size] */
+    /* The kernel has no bounds checks, so the work-group must divide the image. */
+    size_t localWorksize[2] = {1, 1};
+    size_t paddedGlobalWorksize[2] = {0, 0};
+    if (!chooseLocalWorksize(kernel, device, 2, globalWorksize, false, localWorksize, paddedGlobalWorksize))
+    {
+        cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
+        cerr << "Failed choosing the local work size. " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    /* [Local work size] */
+
+    /* Set the kernel arguments and enqueue the kernel. */
+    if (!enqueueSobelNoVectorsKernel(commandQueue, &sobelNoVectors, memoryObjects[0], width, memoryObjects[1], memoryObjects[2], 2, globalWorksize, localWorksize, &event))
     {
         cleanUpOpenCL(context, commandQueue, program, kernel, memoryObjects, numberOfMemoryObjects);
         cerr << "Failed enqueuing the kernel. " << __FILE__ << ":"<< __LINE__ << endl;
@@ -163,6 +218,21 @@ int main(void)
 
     /* Print the profiling information for the event. */
     printProfilingInfo(event);
+
+    /* [Kernel statistics] */
+    /*
+     * Both Sobel samples declare the same work per launch so their metrics are comparable:
+     * every luminance pixel is read once and both gradients are written once,
+     * and each output pixel costs about 15 integer operations (the additions and doublings of both 3x3 masks).
+     */
+    KernelStats stats;
+    initializeKernelStats(&stats, "sobel_no_vectors", (double)width * height, 2.0 * width * height, 15.0 * width * height);
+    if (addKernelStatsEvent(&stats, event))
+    {
+        printKernelStats(&stats);
+    }
+    /* [Kernel statistics] */
+
     /* Release the event object. */
     if (!checkSuccess(clReleaseEvent(event)))
     {
@@ -194,11 +264,8 @@ int main(void)
     /* To visualise the data we take the absolute values of the gradients. */
     unsigned char *absDX = new unsigned char[width * height];
     unsigned char *absDY = new unsigned char[width * height];
-    for (int i = 0; i < width * height; i++)
-    {
-        absDX[i] = abs(outputDx[i]);
-        absDY[i] = abs(outputDy[i]);
-    }
+    SobelGradients gradients = {outputDx, outputDy, absDX, absDY, NULL};
+    parallelFor(0, (size_t)width * height, gradientGrainSize, absoluteGradients, &gradients);
 
     /* Unmap the memory. */
     bool unmapMemoryObjectsSuccess = true;
@@ -224,10 +291,8 @@ int main(void)
 
     /* Calculate the total gradient of the image, convert it to RGB and store it out to a file. */
     unsigned char* totalOutput = new unsigned char[width * height];
-    for (int index = 0; index < width * height; index++)
-    {
-        totalOutput[index] = sqrt(pow(absDX[index], 2) + pow(absDY[index], 2));
-    }
+    gradients.totalOutput = totalOutput;
+    parallelFor(0, (size_t)width * height, gradientGrainSize, totalGradients, &gradients);
     luminanceToRGB(totalOutput, rgbOut, width, height);
     saveToBitmap("output.bmp", width, height, rgbOut);
 
@@ -0,0 +1,106 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "common.h"
+#include "pool.h"
+#include "test.h"
+
+#include <CL/cl.h>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * \brief Check that a pool buffer lies inside the slab it was carved from.
+ * \param[in] pool The pool.
+ * \param[in] buffer The buffer.
+ * \param[in] size The size asked for.
+ */
+static void checkPoolBuffer(const BufferPool* pool, cl_mem buffer, size_t size)
+{
+    cl_mem slab = NULL;
+    size_t offset = 0;
+    size_t bufferSize = 0;
+    CHECK(checkSuccess(clGetMemObjectInfo(buffer, CL_MEM_ASSOCIATED_MEMOBJECT, sizeof(cl_mem), &slab, NULL)));
+    CHECK(checkSuccess(clGetMemObjectInfo(buffer, CL_MEM_OFFSET, sizeof(size_t), &offset, NULL)));
+    CHECK(checkSuccess(clGetMemObjectInfo(buffer, CL_MEM_SIZE, sizeof(size_t), &bufferSize, NULL)));
+    CHECK(bufferSize >= size);
+    if (slab != NULL)
+    {
+        CHECK(offset % pool->alignment == 0);
+        CHECK(offset + bufferSize <= pool->slabSize);
+    }
+}
+
+/**
+ * \brief Test the buffer pool against the host memory objects of the stub library.
+ */
+int main(void)
+{
+    BufferPool pool;
+
+    /* A slab which is not a power of two multiple of the smallest size class is rounded up to one. */
+    CHECK(createBufferPool(NULL, NULL, CL_MEM_READ_WRITE, 768, &pool));
+    CHECK(pool.alignment == 128);
+    CHECK(pool.minimumSize == 256);
+    CHECK(pool.slabSize == 1024);
+
+    /* A request which rounds up to the whole slab. */
+    cl_mem wholeSlab = NULL;
+    CHECK(allocatePoolBuffer(&pool, 700, &wholeSlab));
+    checkPoolBuffer(&pool, wholeSlab, 700);
+
+    /* Small requests share a slab. */
+    cl_mem first = NULL;
+    cl_mem second = NULL;
+    CHECK(allocatePoolBuffer(&pool, 100, &first));
+    CHECK(allocatePoolBuffer(&pool, 300, &second));
+    checkPoolBuffer(&pool, first, 100);
+    checkPoolBuffer(&pool, second, 300);
+    CHECK(pool.slabAllocations == 2);
+    CHECK(pool.bytesInUse == 1024 + 256 + 512);
+
+    /* The sub-buffers see the memory of the slab. */
+    char pattern[100];
+    char readBack[100];
+    memset(pattern, 0x5a, sizeof(pattern));
+    CHECK(checkSuccess(clEnqueueWriteBuffer(NULL, first, CL_TRUE, 0, sizeof(pattern), pattern, 0, NULL, NULL)));
+    CHECK(checkSuccess(clEnqueueReadBuffer(NULL, first, CL_TRUE, 0, sizeof(readBack), readBack, 0, NULL, NULL)));
+    CHECK(memcmp(pattern, readBack, sizeof(pattern)) == 0);
+
+    /* A released buffer is handed out again for a request of the same size class. */
+    CHECK(releasePoolBuffer(&pool, first));
+    cl_mem recycled = NULL;
+    CHECK(allocatePoolBuffer(&pool, 200, &recycled));
+    CHECK(recycled == first);
+    CHECK(pool.reuses == 1);
+
+    /* Requests larger than a slab get a buffer of their own. */
+    cl_mem large = NULL;
+    CHECK(allocatePoolBuffer(&pool, 5000, &large));
+    checkPoolBuffer(&pool, large, 5000);
+    CHECK(pool.largeAllocations == 1);
+    CHECK(pool.highWaterMark == 1024 + 256 + 512 + 5000);
+    CHECK(releasePoolBuffer(&pool, large));
+
+    /* Buffers which did not come from the pool are refused. */
+    cl_int errorNumber = CL_SUCCESS;
+    cl_mem foreign = clCreateBuffer(NULL, CL_MEM_READ_WRITE, 64, NULL, &errorNumber);
+    CHECK(checkSuccess(errorNumber));
+    CHECK(!releasePoolBuffer(&pool, foreign));
+    CHECK(checkSuccess(clReleaseMemObject(foreign)));
+
+    CHECK(releasePoolBuffer(&pool, wholeSlab));
+    CHECK(releasePoolBuffer(&pool, second));
+    CHECK(releaseBufferPool(&pool));
+    CHECK(pool.bytesInUse == 0);
+
+    return finishTest("pool_test");
+}
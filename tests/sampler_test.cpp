@@ -0,0 +1,182 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include "common.h"
+#include "opencl_stubs.h"
+#include "test.h"
+
+#include <CL/cl.h>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * \brief Width of the test image. Not a multiple of the 4x4 tiles of the stub, so the last tiles are partial.
+ */
+static const int imageWidth = 6;
+
+/**
+ * \brief Height of the test image.
+ */
+static const int imageHeight = 5;
+
+/**
+ * \brief Value of a pixel of the red channel of the test image.
+ * \param[in] x Pixel column.
+ * \param[in] y Pixel row.
+ * \return The value, between 0 and 1.
+ */
+static float pixelValue(int x, int y)
+{
+    return (x * 10 + y * 40) / 255.0f;
+}
+
+/**
+ * \brief Sample the test image and check the result.
+ * \param[in] image The image.
+ * \param[in] sampler The sampler.
+ * \param[in] x X coordinate.
+ * \param[in] y Y coordinate.
+ * \param[in] red Expected red channel.
+ * \param[in] alpha Expected alpha channel.
+ * \return True if the sample matched, otherwise false.
+ */
+static bool checkSample(cl_mem image, cl_sampler sampler, float x, float y, float red, float alpha)
+{
+    const float coordinates[3] = {x, y, 0.0f};
+    float color[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+    if (!checkSuccess(stubReadImagef(image, sampler, coordinates, color)))
+    {
+        return false;
+    }
+    return fabs(color[0] - red) < 1e-5f && color[1] == 0.0f && color[2] == 0.0f && fabs(color[3] - alpha) < 1e-5f;
+}
+
+/**
+ * \brief Create a sampler, counting a failure if it can't be created.
+ * \param[in] normalizedCoordinates Whether coordinates are normalized.
+ * \param[in] addressingMode The addressing mode.
+ * \param[in] filterMode The filter mode.
+ * \return The sampler, or NULL.
+ */
+static cl_sampler createTestSampler(cl_bool normalizedCoordinates, cl_addressing_mode addressingMode, cl_filter_mode filterMode)
+{
+    cl_int errorNumber = CL_SUCCESS;
+    cl_sampler sampler = clCreateSampler(NULL, normalizedCoordinates, addressingMode, filterMode, &errorNumber);
+    CHECK(checkSuccess(errorNumber));
+    return sampler;
+}
+
+/**
+ * \brief Test sampling the tiled images of the stub library on the host.
+ */
+int main(void)
+{
+    cl_int errorNumber = CL_SUCCESS;
+
+    /* A single channel image, stored in tiles as it was created without a host pointer. */
+    cl_image_format format;
+    format.image_channel_order = CL_R;
+    format.image_channel_data_type = CL_UNORM_INT8;
+    cl_mem image = clCreateImage2D(NULL, CL_MEM_READ_ONLY, &format, imageWidth, imageHeight, 0, NULL, &errorNumber);
+    CHECK(checkSuccess(errorNumber));
+
+    cl_uchar pixels[imageWidth * imageHeight];
+    for (int y = 0; y < imageHeight; y++)
+    {
+        for (int x = 0; x < imageWidth; x++)
+        {
+            pixels[x + y * imageWidth] = (cl_uchar)(x * 10 + y * 40);
+        }
+    }
+    size_t origin[3] = {0, 0, 0};
+    size_t region[3] = {imageWidth, imageHeight, 1};
+    CHECK(checkSuccess(clEnqueueWriteImage(NULL, image, CL_TRUE, origin, region, 0, 0, pixels, 0, NULL, NULL)));
+
+    /* Nearest filtering picks the pixel the coordinate is in, across the tile boundary too. */
+    cl_sampler sampler = createTestSampler(CL_FALSE, CL_ADDRESS_CLAMP_TO_EDGE, CL_FILTER_NEAREST);
+    CHECK(checkSample(image, sampler, 2.5f, 1.5f, pixelValue(2, 1), 1.0f));
+    CHECK(checkSample(image, sampler, 4.9f, 4.0f, pixelValue(4, 4), 1.0f));
+    CHECK(checkSample(image, sampler, -3.0f, 1.5f, pixelValue(0, 1), 1.0f));
+    CHECK(checkSample(image, sampler, 10.0f, 10.0f, pixelValue(imageWidth - 1, imageHeight - 1), 1.0f));
+    clReleaseSampler(sampler);
+
+    /* Clamping outside the image reads the border colour, which has an alpha of 1 for CL_R. */
+    sampler = createTestSampler(CL_FALSE, CL_ADDRESS_CLAMP, CL_FILTER_NEAREST);
+    CHECK(checkSample(image, sampler, -0.5f, 1.5f, 0.0f, 1.0f));
+    CHECK(checkSample(image, sampler, 0.5f, 1.5f, pixelValue(0, 1), 1.0f));
+    clReleaseSampler(sampler);
+
+    /* Linear filtering blends the pixels either side of the coordinate, and the border for the edge pixels. */
+    sampler = createTestSampler(CL_FALSE, CL_ADDRESS_CLAMP, CL_FILTER_LINEAR);
+    CHECK(checkSample(image, sampler, 2.0f, 1.5f, (pixelValue(1, 1) + pixelValue(2, 1)) / 2, 1.0f));
+    CHECK(checkSample(image, sampler, 2.75f, 2.0f, (pixelValue(2, 1) + pixelValue(2, 2)) / 2 * 0.75f + (pixelValue(3, 1) + pixelValue(3, 2)) / 2 * 0.25f, 1.0f));
+    CHECK(checkSample(image, sampler, 0.0f, 1.5f, pixelValue(0, 1) / 2, 1.0f));
+    clReleaseSampler(sampler);
+
+    /* Normalized coordinates repeat the image, and linear filtering wraps around the edge. */
+    sampler = createTestSampler(CL_TRUE, CL_ADDRESS_REPEAT, CL_FILTER_NEAREST);
+    CHECK(checkSample(image, sampler, 1.0f + 2.5f / imageWidth, 1.5f / imageHeight, pixelValue(2, 1), 1.0f));
+    CHECK(checkSample(image, sampler, -0.5f / imageWidth, -0.5f / imageHeight, pixelValue(imageWidth - 1, imageHeight - 1), 1.0f));
+    clReleaseSampler(sampler);
+    sampler = createTestSampler(CL_TRUE, CL_ADDRESS_REPEAT, CL_FILTER_LINEAR);
+    CHECK(checkSample(image, sampler, 0.0f, 1.5f / imageHeight, (pixelValue(imageWidth - 1, 1) + pixelValue(0, 1)) / 2, 1.0f));
+    clReleaseSampler(sampler);
+
+    /* Linear filtering is not defined for integer formats. */
+    format.image_channel_data_type = CL_UNSIGNED_INT8;
+    cl_mem integerImage = clCreateImage2D(NULL, CL_MEM_READ_ONLY, &format, imageWidth, imageHeight, 0, NULL, &errorNumber);
+    CHECK(checkSuccess(errorNumber));
+    sampler = createTestSampler(CL_FALSE, CL_ADDRESS_CLAMP, CL_FILTER_LINEAR);
+    const float coordinates[3] = {1.0f, 1.0f, 0.0f};
+    float color[4];
+    CHECK(stubReadImagef(integerImage, sampler, coordinates, color) == CL_INVALID_OPERATION);
+    clReleaseSampler(sampler);
+
+    /* The channels of a BGRA image are returned as (r, g, b, a). */
+    format.image_channel_order = CL_BGRA;
+    format.image_channel_data_type = CL_UNORM_INT8;
+    cl_mem colorImage = clCreateImage2D(NULL, CL_MEM_READ_ONLY, &format, 1, 1, 0, NULL, &errorNumber);
+    CHECK(checkSuccess(errorNumber));
+    const cl_uchar bgra[4] = {0, 51, 102, 255};
+    size_t pixelRegion[3] = {1, 1, 1};
+    CHECK(checkSuccess(clEnqueueWriteImage(NULL, colorImage, CL_TRUE, origin, pixelRegion, 0, 0, bgra, 0, NULL, NULL)));
+    sampler = createTestSampler(CL_TRUE, CL_ADDRESS_CLAMP_TO_EDGE, CL_FILTER_NEAREST);
+    const float centre[3] = {0.5f, 0.5f, 0.0f};
+    CHECK(checkSuccess(stubReadImagef(colorImage, sampler, centre, color)));
+    CHECK(color[0] == 0.4f && color[1] == 0.2f && color[2] == 0.0f && color[3] == 1.0f);
+    clReleaseSampler(sampler);
+
+    /* Half floats are decoded, including subnormals (0x0200 is 2^-15), and filtered like floats. */
+    format.image_channel_order = CL_RGBA;
+    format.image_channel_data_type = CL_HALF_FLOAT;
+    cl_mem halfImage = clCreateImage2D(NULL, CL_MEM_READ_ONLY, &format, 2, 1, 0, NULL, &errorNumber);
+    CHECK(checkSuccess(errorNumber));
+    const cl_half halves[8] = {0x3C00, 0x3800, 0xC000, 0x3400, 0x4000, 0x0200, 0x8000, 0x3C00};
+    size_t halfRegion[3] = {2, 1, 1};
+    CHECK(checkSuccess(clEnqueueWriteImage(NULL, halfImage, CL_TRUE, origin, halfRegion, 0, 0, halves, 0, NULL, NULL)));
+    sampler = createTestSampler(CL_FALSE, CL_ADDRESS_CLAMP_TO_EDGE, CL_FILTER_NEAREST);
+    const float right[3] = {1.5f, 0.5f, 0.0f};
+    CHECK(checkSuccess(stubReadImagef(halfImage, sampler, right, color)));
+    CHECK(color[0] == 2.0f && color[1] == ldexpf(1.0f, -15) && color[2] == 0.0f && color[3] == 1.0f);
+    clReleaseSampler(sampler);
+    sampler = createTestSampler(CL_FALSE, CL_ADDRESS_CLAMP_TO_EDGE, CL_FILTER_LINEAR);
+    const float between[3] = {1.0f, 0.5f, 0.0f};
+    CHECK(checkSuccess(stubReadImagef(halfImage, sampler, between, color)));
+    CHECK(color[0] == 1.5f && fabs(color[1] - (0.5f + ldexpf(1.0f, -15)) / 2) < 1e-7f && color[2] == -1.0f && color[3] == 0.625f);
+    clReleaseSampler(sampler);
+
+    CHECK(checkSuccess(clReleaseMemObject(halfImage)));
+    CHECK(checkSuccess(clReleaseMemObject(colorImage)));
+    CHECK(checkSuccess(clReleaseMemObject(integerImage)));
+    CHECK(checkSuccess(clReleaseMemObject(image)));
+
+    return finishTest("sampler_test");
+}
@@ -0,0 +1,48 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *   (C) COPYRIGHT 2013 ARM Limited
+ *       ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <iostream>
+
+/**
+ * \file test.h
+ * \brief Checks for the host-side tests.
+ * \details Each test counts its failed checks in testFailures and returns non-zero from main if there were any.
+ */
+
+static int testFailures = 0;
+
+/**
+ * \brief Check a condition, reporting it if it is false.
+ */
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::cerr << "Check failed: " #condition " " << __FILE__ << ":"<< __LINE__ << std::endl; \
+            testFailures++; \
+        } \
+    } while (0)
+
+/**
+ * \brief Report the result of a test.
+ * \param[in] name Name of the test.
+ * \return The exit code of the test, non-zero if a check failed.
+ */
+inline int finishTest(const char* name)
+{
+    std::cout << name << ": " << (testFailures == 0 ? "passed" : "FAILED") << std::endl;
+    return testFailures == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+/**
+ * \brief Build tool which compiles OpenCL C sources into an executable.
+ * \details Usage: embed_sources output.cpp file.cl...
+ *          Writes a C++ file holding each source as a byte array, which registers them with registerEmbeddedSources (common.h) at startup.
+ *          createProgram then uses the embedded source for a file name given here instead of reading the file,
+ *          so the executable starts without file I/O and runs from any working directory.
+ *          Pass the files with the paths the program gives to createProgram, for example assets/sobel.cl.
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " output.cpp file.cl..." << endl;
+        return 1;
+    }
+    const string outputFilename = argv[1];
+    const int numberOfSources = argc - 2;
+
+    ostringstream output;
+    output << "/* Generated by tools/embed_sources. Do not edit. */\n\n#include \"common.h\"\n\n";
+
+    for (int index = 0; index < numberOfSources; index++)
+    {
+        const string filename = argv[index + 2];
+        ifstream input(filename.c_str(), ios::in | ios::binary);
+        if (!input.is_open())
+        {
+            cerr << "Unable to open " << filename << ". " << __FILE__ << ":"<< __LINE__ << endl;
+            return 1;
+        }
+        stringstream source;
+        source << input.rdbuf();
+        const string text = source.str();
+
+        /* Written as numbers rather than a string literal, which compilers limit in length. The extra 0 terminates the source. */
+        output << "/* " << filename << " */\nstatic const char source" << index << "[] =\n{";
+        for (size_t character = 0; character <= text.size(); character++)
+        {
+            char hex[8];
+            sprintf(hex, "0x%02x,", character < text.size() ? (unsigned char)text[character] : 0);
+            output << (character % 16 == 0 ? "\n    " : " ") << hex;
+        }
+        output << "\n};\n\n";
+    }
+
+    output << "static const EmbeddedSource embeddedSources[] =\n{\n";
+    for (int index = 0; index < numberOfSources; index++)
+    {
+        output << "    {\"" << argv[index + 2] << "\", source" << index << ", sizeof(source" << index << ") - 1},\n";
+    }
+    if (numberOfSources == 0)
+    {
+        output << "    {\"\", \"\", 0},\n";
+    }
+    output << "};\n\n"
+           << "/* Registered during static initialization, before main creates any program. */\n"
+           << "static const bool embeddedSourcesRegistered = registerEmbeddedSources(embeddedSources, " << numberOfSources << ");\n";
+
+    /* Only replace the file when it changes, so it is not rebuilt needlessly. */
+    ifstream existing(outputFilename.c_str());
+    stringstream existingContents;
+    existingContents << existing.rdbuf();
+    if (existing.is_open() && existingContents.str() == output.str())
+    {
+        return 0;
+    }
+    existing.close();
+
+    ofstream outputFile(outputFilename.c_str());
+    if (!outputFile.is_open() || !(outputFile << output.str()))
+    {
+        cerr << "Failed writing " << outputFilename << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    return 0;
+}
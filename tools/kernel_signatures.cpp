@@ -0,0 +1,479 @@
+/*
+ * This confidential and proprietary software may be used only as
+ * authorised by a licensing agreement from ARM Limited
+ *    (C) COPYRIGHT 2013 ARM Limited
+ *        ALL RIGHTS RESERVED
+ * The entire notice above must be reproduced on all authorised
+ * copies and copies may only be made to the extent permitted
+ * by a licensing agreement from ARM Limited.
+ */
+
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * \brief Build tool which generates a C++ header of typed kernel launchers from the kernels in an OpenCL C file.
+ * \details Usage: kernel_signatures input.cl output.h
+ *          For every kernel a KernelSignature typedef and a struct holding the kernel object and its KernelBinding (binding.h) are generated,
+ *          with create, enqueue and release functions. The enqueue function takes the kernel arguments with their host types,
+ *          so passing them in the wrong order or with the wrong type fails to compile instead of failing at run time.
+ *          Kernels with arguments of a type the tool cannot map (structs, types defined by macros) are left out with a warning.
+ */
+
+/**
+ * \brief An argument of a kernel.
+ */
+struct KernelArgument
+{
+    string name; /**< \brief Name in the OpenCL C source. */
+    string declaration; /**< \brief Declaration in the OpenCL C source, for the documentation. */
+    string hostType; /**< \brief Type the host passes, empty if it is not supported. */
+};
+
+/**
+ * \brief A kernel function.
+ */
+struct KernelFunction
+{
+    string name; /**< \brief Name in the OpenCL C source. */
+    vector<KernelArgument> arguments; /**< \brief The arguments in order. */
+};
+
+/**
+ * \brief Remove comments and preprocessor lines, keeping the line structure.
+ * \param[in] source OpenCL C source.
+ * \return The source without comments or preprocessor lines.
+ */
+static string stripSource(const string& source)
+{
+    string stripped;
+    bool lineStart = true;
+    for (size_t index = 0; index < source.size(); index++)
+    {
+        if (source.compare(index, 2, "/*") == 0)
+        {
+            const size_t end = source.find("*/", index + 2);
+            index = (end == string::npos) ? source.size() : end + 1;
+            stripped += ' ';
+            continue;
+        }
+        if (source.compare(index, 2, "//") == 0 || (lineStart && source[index] == '#'))
+        {
+            /* Preprocessor lines continue over escaped newlines. */
+            while (index < source.size() && !(source[index] == '\n' && source[index - 1] != '\\'))
+            {
+                index++;
+            }
+            stripped += '\n';
+            lineStart = true;
+            continue;
+        }
+        if (!isspace((unsigned char)source[index]))
+        {
+            lineStart = false;
+        }
+        else if (source[index] == '\n')
+        {
+            lineStart = true;
+        }
+        stripped += source[index];
+    }
+    return stripped;
+}
+
+/**
+ * \brief Split a declaration into identifier and punctuation tokens.
+ * \param[in] text The text.
+ * \return The tokens.
+ */
+static vector<string> tokenize(const string& text)
+{
+    vector<string> tokens;
+    for (size_t index = 0; index < text.size();)
+    {
+        if (isspace((unsigned char)text[index]))
+        {
+            index++;
+        }
+        else if (isalnum((unsigned char)text[index]) || text[index] == '_')
+        {
+            const size_t start = index;
+            while (index < text.size() && (isalnum((unsigned char)text[index]) || text[index] == '_'))
+            {
+                index++;
+            }
+            tokens.push_back(text.substr(start, index - start));
+        }
+        else
+        {
+            tokens.push_back(text.substr(index, 1));
+            index++;
+        }
+    }
+    return tokens;
+}
+
+/**
+ * \brief The host type of a scalar or vector OpenCL C type.
+ * \details Scalars map to plain C types, because the cl_ typedefs carry alignment attributes which templates ignore.
+ *          Vectors map to the cl_ vector unions, with 3 component vectors passed as 4 component ones.
+ * \param[in] type The OpenCL C type.
+ * \return The host type, or an empty string if the type is not supported.
+ */
+static string hostValueType(const string& type)
+{
+    const char* scalars[][2] =
+    {
+        {"char", "signed char"}, {"uchar", "unsigned char"}, {"short", "short"}, {"ushort", "unsigned short"},
+        {"int", "int"}, {"uint", "unsigned int"}, {"long", "long long"}, {"ulong", "unsigned long long"},
+        {"float", "float"}, {"double", "double"}, {"size_t", "size_t"}
+    };
+    for (size_t index = 0; index < sizeof(scalars) / sizeof(scalars[0]); index++)
+    {
+        if (type == scalars[index][0])
+        {
+            return scalars[index][1];
+        }
+    }
+
+    const char* vectorBases[] = {"char", "uchar", "short", "ushort", "int", "uint", "long", "ulong", "float", "double"};
+    for (size_t index = 0; index < sizeof(vectorBases) / sizeof(vectorBases[0]); index++)
+    {
+        const string base = vectorBases[index];
+        if (type.compare(0, base.size(), base) != 0)
+        {
+            continue;
+        }
+        const string width = type.substr(base.size());
+        if (width == "2" || width == "4" || width == "8" || width == "16")
+        {
+            return "cl_" + type;
+        }
+        if (width == "3")
+        {
+            return "cl_" + base + "4";
+        }
+    }
+    return "";
+}
+
+/**
+ * \brief Parse one kernel argument declaration.
+ * \param[in] declaration The declaration, for example "__global const uchar* restrict input".
+ * \return The argument.
+ */
+static KernelArgument parseArgument(const string& declaration)
+{
+    KernelArgument argument;
+    const vector<string> tokens = tokenize(declaration);
+
+    string addressSpace;
+    string type;
+    bool pointer = false;
+    for (size_t index = 0; index < tokens.size(); index++)
+    {
+        const string& token = tokens[index];
+        if (token == "__global" || token == "global" || token == "__constant" || token == "constant" ||
+            token == "__local" || token == "local" || token == "__private" || token == "private")
+        {
+            addressSpace = token[0] == '_' ? token.substr(2) : token;
+        }
+        else if (token == "*")
+        {
+            pointer = true;
+        }
+        else if (token == "unsigned" && index + 1 < tokens.size())
+        {
+            /* "unsigned int" is the same as "uint". */
+            type = "u" + tokens[++index];
+        }
+        else if (token == "const" || token == "volatile" || token == "restrict" || token == "__restrict" ||
+                 token == "__read_only" || token == "read_only" || token == "__write_only" || token == "write_only" ||
+                 token == "__read_write" || token == "read_write" || token == "struct")
+        {
+            continue;
+        }
+        else if (isalpha((unsigned char)token[0]) || token[0] == '_')
+        {
+            if (index + 1 == tokens.size())
+            {
+                argument.name = token;
+            }
+            else if (type.empty())
+            {
+                type = token;
+            }
+        }
+    }
+
+    argument.declaration = declaration;
+    if (pointer && addressSpace == "local")
+    {
+        argument.hostType = "LocalMemory";
+    }
+    else if (pointer || type == "image2d_t" || type == "image3d_t")
+    {
+        argument.hostType = "cl_mem";
+    }
+    else if (type == "sampler_t")
+    {
+        argument.hostType = "cl_sampler";
+    }
+    else
+    {
+        argument.hostType = hostValueType(type);
+    }
+    return argument;
+}
+
+/**
+ * \brief Find the kernel functions in a source.
+ * \param[in] source OpenCL C source without comments or preprocessor lines.
+ * \return The kernels in the order they appear.
+ */
+static vector<KernelFunction> findKernels(const string& source)
+{
+    vector<KernelFunction> kernels;
+    const vector<string> tokens = tokenize(source);
+    for (size_t index = 0; index < tokens.size(); index++)
+    {
+        if (tokens[index] != "__kernel" && tokens[index] != "kernel")
+        {
+            continue;
+        }
+
+        /* Skip attributes such as __attribute__((reqd_work_group_size(64, 1, 1))) up to the return type. */
+        size_t position = index + 1;
+        while (position < tokens.size() && tokens[position] != "void")
+        {
+            position++;
+        }
+        if (position + 2 >= tokens.size() || tokens[position + 2] != "(")
+        {
+            continue;
+        }
+
+        KernelFunction kernel;
+        kernel.name = tokens[position + 1];
+
+        /* Rebuild each argument declaration from its tokens, splitting at the top level commas. */
+        int depth = 0;
+        string declaration;
+        for (position += 3; position < tokens.size(); position++)
+        {
+            const string& token = tokens[position];
+            if (token == "(")
+            {
+                depth++;
+            }
+            if (depth == 0 && (token == "," || token == ")"))
+            {
+                if (!declaration.empty() && declaration != "void")
+                {
+                    kernel.arguments.push_back(parseArgument(declaration));
+                }
+                declaration.clear();
+                if (token == ")")
+                {
+                    break;
+                }
+                continue;
+            }
+            if (token == ")")
+            {
+                depth--;
+            }
+            declaration += declaration.empty() ? token : " " + token;
+        }
+        kernels.push_back(kernel);
+        index = position;
+    }
+    return kernels;
+}
+
+/**
+ * \brief Convert a kernel name like "sobel_no_vectors" to "SobelNoVectors".
+ * \param[in] name The kernel name.
+ * \return The name in upper camel case.
+ */
+static string camelCase(const string& name)
+{
+    string result;
+    bool upper = true;
+    for (size_t index = 0; index < name.size(); index++)
+    {
+        if (name[index] == '_')
+        {
+            upper = true;
+            continue;
+        }
+        result += upper ? (char)toupper((unsigned char)name[index]) : name[index];
+        upper = false;
+    }
+    return result;
+}
+
+/**
+ * \brief Write the launcher of one kernel.
+ * \param[in,out] header The generated header.
+ * \param[in] kernel The kernel.
+ * \param[in] filename The OpenCL C file the kernel is in.
+ */
+static void writeLauncher(ostream& header, const KernelFunction& kernel, const string& filename)
+{
+    const string name = camelCase(kernel.name);
+
+    header << "/**\n * \\brief Argument types of the " << kernel.name << " kernel in " << filename << ".\n */\n";
+    header << "typedef KernelSignature<";
+    for (size_t index = 0; index < kernel.arguments.size(); index++)
+    {
+        header << (index == 0 ? "" : ", ") << kernel.arguments[index].hostType;
+    }
+    header << "> " << name << "Signature;\n\n";
+
+    header << "/**\n * \\brief The " << kernel.name << " kernel object and the arguments last passed to it.\n"
+           << " * \\details Create it once with create" << name << "Kernel and launch it with enqueue" << name << "Kernel,\n"
+           << " *          which only passes the arguments which changed since the last launch to the driver.\n */\n";
+    header << "struct " << name << "Kernel\n{\n"
+           << "    cl_kernel kernel; /**< \\brief The kernel object. */\n"
+           << "    KernelBinding binding; /**< \\brief Copies of the arguments last set. */\n};\n\n";
+
+    header << "/**\n * \\brief Create the " << kernel.name << " kernel.\n"
+           << " * \\param[in] program A built program from " << filename << ".\n"
+           << " * \\param[out] launcher The kernel to create. Release it with release" << name << "Kernel.\n"
+           << " * \\return False if an error occurred, otherwise true.\n */\n";
+    header << "inline bool create" << name << "Kernel(cl_program program, " << name << "Kernel* launcher)\n{\n"
+           << "    cl_int errorNumber = 0;\n"
+           << "    launcher->kernel = clCreateKernel(program, \"" << kernel.name << "\", &errorNumber);\n"
+           << "    if (!checkSuccess(errorNumber))\n    {\n"
+           << "        std::cerr << \"Failed to create OpenCL kernel " << kernel.name << ". \" << __FILE__ << \":\"<< __LINE__ << std::endl;\n"
+           << "        return false;\n    }\n"
+           << "    return initializeKernelBinding(launcher->kernel, &launcher->binding);\n}\n\n";
+
+    header << "/**\n * \\brief Set the arguments of the " << kernel.name << " kernel and enqueue it.\n"
+           << " * \\param[in] commandQueue The command queue.\n"
+           << " * \\param[in,out] launcher The kernel, from create" << name << "Kernel.\n";
+    for (size_t index = 0; index < kernel.arguments.size(); index++)
+    {
+        header << " * \\param[in] " << kernel.arguments[index].name << " Kernel argument: " << kernel.arguments[index].declaration << ".\n";
+    }
+    header << " * \\param[in] workDimensions Number of work dimensions.\n"
+           << " * \\param[in] globalWorksize Global work size of each dimension. See coveringWorksize.\n"
+           << " * \\param[in] localWorksize Local work size of each dimension, or NULL to let the implementation choose.\n"
+           << " * \\param[out] event Event for the kernel, or NULL.\n"
+           << " * \\param[in] numberOfEventsInWaitList Number of events to wait for before the kernel starts.\n"
+           << " * \\param[in] eventWaitList Events to wait for, or NULL.\n"
+           << " * \\return False if an error occurred, otherwise true.\n */\n";
+    const string indent(string("inline bool enqueue" + name + "Kernel(").size(), ' ');
+    header << "inline bool enqueue" << name << "Kernel(cl_command_queue commandQueue, " << name << "Kernel* launcher,\n";
+    for (size_t index = 0; index < kernel.arguments.size(); index++)
+    {
+        const KernelArgument& argument = kernel.arguments[index];
+        const bool byReference = argument.hostType.compare(0, 3, "cl_") == 0 && argument.hostType != "cl_mem" && argument.hostType != "cl_sampler";
+        header << indent << (byReference ? "const " + argument.hostType + "&" : argument.hostType) << " " << argument.name << ",\n";
+    }
+    header << indent << "cl_uint workDimensions, const size_t* globalWorksize, const size_t* localWorksize, cl_event* event,\n"
+           << indent << "cl_uint numberOfEventsInWaitList = 0, const cl_event* eventWaitList = NULL)\n{\n";
+    header << "    if (!setKernelArguments<" << name << "Signature>(&launcher->binding";
+    for (size_t index = 0; index < kernel.arguments.size(); index++)
+    {
+        header << ", " << kernel.arguments[index].name;
+    }
+    header << "))\n    {\n        return false;\n    }\n"
+           << "    if (!checkSuccess(clEnqueueNDRangeKernel(commandQueue, launcher->kernel, workDimensions, NULL, globalWorksize, localWorksize,\n"
+           << "                                             numberOfEventsInWaitList, eventWaitList, event)))\n    {\n"
+           << "        std::cerr << \"Failed enqueuing the " << kernel.name << " kernel. \" << __FILE__ << \":\"<< __LINE__ << std::endl;\n"
+           << "        return false;\n    }\n    return true;\n}\n\n";
+
+    header << "/**\n * \\brief Release the " << kernel.name << " kernel.\n"
+           << " * \\param[in,out] launcher The kernel.\n"
+           << " * \\return False if an error occurred, otherwise true.\n */\n";
+    header << "inline bool release" << name << "Kernel(" << name << "Kernel* launcher)\n{\n"
+           << "    bool returnValue = launcher->kernel == 0 || checkSuccess(clReleaseKernel(launcher->kernel));\n"
+           << "    launcher->kernel = 0;\n    return returnValue;\n}\n\n";
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        cerr << "Usage: " << argv[0] << " input.cl output.h" << endl;
+        return 1;
+    }
+    const string inputFilename = argv[1];
+    const string outputFilename = argv[2];
+
+    ifstream input(inputFilename.c_str());
+    if (!input.is_open())
+    {
+        cerr << "Unable to open " << inputFilename << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    stringstream source;
+    source << input.rdbuf();
+
+    const vector<KernelFunction> kernels = findKernels(stripSource(source.str()));
+
+    /* The include guard is made from the file name of the output, "sobel_kernels.h" gives SOBEL_KERNELS_H. */
+    string guard = outputFilename.substr(outputFilename.find_last_of("/\\") + 1);
+    for (size_t index = 0; index < guard.size(); index++)
+    {
+        guard[index] = isalnum((unsigned char)guard[index]) ? (char)toupper((unsigned char)guard[index]) : '_';
+    }
+
+    ostringstream header;
+    header << "/* Generated from " << inputFilename << " by tools/kernel_signatures. Do not edit. */\n\n"
+           << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+           << "#include \"binding.h\"\n#include \"common.h\"\n\n#include <CL/cl.h>\n#include <iostream>\n\n";
+
+    for (size_t index = 0; index < kernels.size(); index++)
+    {
+        bool supported = true;
+        for (size_t argument = 0; argument < kernels[index].arguments.size(); argument++)
+        {
+            if (kernels[index].arguments[argument].hostType.empty() || kernels[index].arguments[argument].name.empty())
+            {
+                cerr << inputFilename << ": kernel " << kernels[index].name << " left out, the type of \""
+                     << kernels[index].arguments[argument].declaration << "\" is not supported." << endl;
+                header << "/* " << kernels[index].name << " is left out: the type of \"" << kernels[index].arguments[argument].declaration << "\" is not supported. */\n\n";
+                supported = false;
+                break;
+            }
+        }
+        if (kernels[index].arguments.size() > 8)
+        {
+            cerr << inputFilename << ": kernel " << kernels[index].name << " left out, it has more than 8 arguments." << endl;
+            header << "/* " << kernels[index].name << " is left out: it has more than 8 arguments. */\n\n";
+            supported = false;
+        }
+        if (supported)
+        {
+            writeLauncher(header, kernels[index], inputFilename);
+        }
+    }
+    header << "#endif\n";
+
+    /* Only replace the header when it changes, so the sources including it are not rebuilt needlessly. */
+    ifstream existing(outputFilename.c_str());
+    stringstream existingContents;
+    existingContents << existing.rdbuf();
+    if (existing.is_open() && existingContents.str() == header.str())
+    {
+        return 0;
+    }
+    existing.close();
+
+    ofstream output(outputFilename.c_str());
+    if (!output.is_open() || !(output << header.str()))
+    {
+        cerr << "Failed writing " << outputFilename << ". " << __FILE__ << ":"<< __LINE__ << endl;
+        return 1;
+    }
+    return 0;
+}